@@ -1,4 +1,4 @@
-################################################################################
+﻿################################################################################
 ##
 ## Cranberry - C++ game engine based on the Qt framework.
 ## Copyright (C) 2017 Nicolas Kogler
@@ -18,6 +18,11 @@ DEFINES        +=       CRANBERRY_VERSION=\\\"1.0.0\\\"
 TEMPLATE        =       lib
 TARGET          =       cranberry
 
+# Compiles the scoped CPU timers in; see Profiler.hpp.
+cranberry_profile {
+    DEFINES    +=       CRANBERRY_PROFILE
+}
+
 
 ################################################################################
 ## WINDOWS SETTINGS
@@ -59,12 +64,17 @@ HEADERS     +=      include/Cranberry/Config.hpp \
                     include/Cranberry/System/Debug.hpp \
                     include/Cranberry/System/GameTime.hpp \
                     include/Cranberry/System/Random.hpp \
+                    include/Cranberry/System/RandomEngines.hpp \
+                    include/Cranberry/System/Profiler.hpp \
                     include/Cranberry/System/Emitters/BackgroundEmitter.hpp \
                     include/Cranberry/System/Receivers/SpriteReceiver.hpp \
                     include/Cranberry/System/Receivers/GuiManagerReceiver.hpp \
                     include/Cranberry/System/Emitters/RenderBaseEmitter.hpp \
                     include/Cranberry/System/Emitters/TransformBaseEmitter.hpp \
                     include/Cranberry/System/Emitters/AnimationBaseEmitter.hpp \
+                    include/Cranberry/System/Emitters/AssetLoaderEmitter.hpp \
+                    include/Cranberry/System/AssetLoader.hpp \
+                    include/Cranberry/System/JobSystem.hpp \
                     include/Cranberry/System/Models/TreeModelItem.hpp \
                     include/Cranberry/System/Models/TreeModelPrivate.hpp \
                     include/Cranberry/System/Models/TreeModel.hpp \
@@ -82,14 +92,26 @@ HEADERS     +=      include/Cranberry/Config.hpp \
                     include/Cranberry/Window/WindowSettings.hpp \
                     include/Cranberry/Window/WindowPrivate.hpp \
                     include/Cranberry/Window/Window.hpp \
+                    include/Cranberry/Window/RenderCommandList.hpp \
+                    include/Cranberry/Window/RenderQueue.hpp \
+                    include/Cranberry/Window/InputRing.hpp \
                     include/Cranberry/Graphics/Base/Enumerations.hpp \
                     include/Cranberry/Graphics/Background.hpp \
                     include/Cranberry/Graphics/Base/TextureAtlas.hpp \
+                    include/Cranberry/Graphics/Base/TextureCache.hpp \
                     include/Cranberry/Graphics/GifAnimation.hpp \
                     include/Cranberry/Graphics/CranAnimation.hpp \
                     include/Cranberry/Graphics/Polygon.hpp \
                     include/Cranberry/Graphics/Ellipse.hpp \
                     include/Cranberry/Graphics/Text.hpp \
+                    include/Cranberry/Graphics/GlyphText.hpp \
+                    include/Cranberry/Graphics/GlyphBatch.hpp \
+                    include/Cranberry/Graphics/PrimitiveBatch.hpp \
+                    include/Cranberry/Graphics/PostProcessChain.hpp \
+                    include/Cranberry/Graphics/ParticleSystem.hpp \
+                    include/Cranberry/Graphics/Base/GlyphAtlas.hpp \
+                    include/Cranberry/Graphics/Base/TextCache.hpp \
+                    include/Cranberry/Graphics/Base/RenderTargetPool.hpp \
                     include/Cranberry/Graphics/SpriteBatch.hpp \
                     include/Cranberry/Graphics/Sprite.hpp \
                     include/Cranberry/Graphics/RawAnimation.hpp \
@@ -120,6 +142,13 @@ HEADERS     +=      include/Cranberry/Config.hpp \
                     include/Cranberry/Game/Mapping/MapPlayer.hpp \
                     include/Cranberry/System/Emitters/MapPlayerEmitter.hpp \
                     include/Cranberry/System/Receivers/MapPlayerReceiver.hpp \
+                    include/Cranberry/Game/Mapping/MapBitGrid.hpp \
+                    include/Cranberry/Game/Mapping/MapNavigationGrid.hpp \
+                    include/Cranberry/Game/Mapping/MapFlowField.hpp \
+                    include/Cranberry/Game/Mapping/MapPathfinder.hpp \
+                    include/Cranberry/Game/Mapping/MapPropertyTable.hpp \
+                    include/Cranberry/Game/Mapping/MapProperties.hpp \
+                    include/Cranberry/Game/Mapping/MapCollisionGrid.hpp \
     include/Cranberry/Game/Scene/Scene.hpp \
     include/Cranberry/Game/Scene/SceneManager.hpp
 
@@ -135,6 +164,10 @@ HEADERS     +=      include/Cranberry/System/StackWalkers/StackWalkerWin32.hpp
 SOURCES     +=      src/System/Debug.cpp \
                     src/System/GameTime.cpp \
                     src/System/Random.cpp \
+                    src/System/RandomEngines.cpp \
+                    src/System/Profiler.cpp \
+                    src/System/AssetLoader.cpp \
+                    src/System/JobSystem.cpp \
                     src/System/Receivers/SpriteReceiver.cpp \
                     src/System/Receivers/GuiManagerReceiver.cpp \
                     src/System/Models/TreeModelItem.cpp \
@@ -154,13 +187,25 @@ SOURCES     +=      src/System/Debug.cpp \
                     src/Window/WindowSettings.cpp \
                     src/Window/WindowPrivate.cpp \
                     src/Window/Window.cpp \
+                    src/Window/RenderCommandList.cpp \
+                    src/Window/RenderQueue.cpp \
+                    src/Window/InputRing.cpp \
                     src/Graphics/Background.cpp \
                     src/Graphics/Base/TextureAtlas.cpp \
+                    src/Graphics/Base/TextureCache.cpp \
                     src/Graphics/GifAnimation.cpp \
                     src/Graphics/CranAnimation.cpp \
                     src/Graphics/Polygon.cpp \
                     src/Graphics/Ellipse.cpp \
                     src/Graphics/Text.cpp \
+                    src/Graphics/GlyphText.cpp \
+                    src/Graphics/GlyphBatch.cpp \
+                    src/Graphics/PrimitiveBatch.cpp \
+                    src/Graphics/PostProcessChain.cpp \
+                    src/Graphics/ParticleSystem.cpp \
+                    src/Graphics/Base/GlyphAtlas.cpp \
+                    src/Graphics/Base/TextCache.cpp \
+                    src/Graphics/Base/RenderTargetPool.cpp \
                     src/Graphics/SpriteBatch.cpp \
                     src/Graphics/Sprite.cpp \
                     src/Graphics/RawAnimation.cpp \
@@ -178,7 +223,6 @@ SOURCES     +=      src/System/Debug.cpp \
                     src/Graphics/Tilemap.cpp \
                     src/Game/Mapping/MapTileset.cpp \
                     src/Game/Mapping/MapTile.cpp \
-                    src/Game/Mapping/MapTileProperties.cpp \
                     src/Game/Mapping/MapEnumerations.cpp \
                     src/Graphics/Base/GraphicsEnumerations.cpp \
                     src/Game/Mapping/Map.cpp \
@@ -190,6 +234,13 @@ SOURCES     +=      src/System/Debug.cpp \
                     src/Game/Mapping/MapObjectLayer.cpp \
                     src/Game/Mapping/MapPlayer.cpp \
                     src/System/Receivers/MapPlayerReceiver.cpp \
+                    src/Game/Mapping/MapBitGrid.cpp \
+                    src/Game/Mapping/MapNavigationGrid.cpp \
+                    src/Game/Mapping/MapFlowField.cpp \
+                    src/Game/Mapping/MapPathfinder.cpp \
+                    src/Game/Mapping/MapPropertyTable.cpp \
+                    src/Game/Mapping/MapProperties.cpp \
+                    src/Game/Mapping/MapCollisionGrid.cpp \
     src/Game/Scene/Scene.cpp \
     src/Game/Scene/SceneManager.cpp
 
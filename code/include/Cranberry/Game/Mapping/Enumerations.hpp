@@ -34,6 +34,8 @@
 #include <QVariant>
 
 // Forward declarations
+CRANBERRY_FORWARD_C(MapProperties)
+CRANBERRY_FORWARD_C(MapPropertyTable)
 CRANBERRY_FORWARD_Q(QDomElement)
 
 
@@ -162,6 +164,8 @@ CompressionMode getCompressionFromString(const QString& type);
 QVariant getPropertyValue(PropertyType type, const QString& value);
 QColor getColorFromString(QString str);
 void getTmxProperties(QDomElement* element, QMap<QString, QVariant>& p);
+void getTmxProperties(QDomElement* element, MapProperties& p);
+void getTmxProperties(QDomElement* element, MapPropertyTable& table, int row);
 
 
 CRANBERRY_END_NAMESPACE
@@ -127,9 +127,11 @@ private:
 /// order to achieve some nice functionality on your map, e.g.:
 ///
 /// \code
+/// static const MapPropertyKey solid = MapPropertyKeys::intern("solid");
+///
 /// void onAboutStepTile(const TileEvent& event)
 /// {
-///     if (event.properties().value("solid").toBool() == true)
+///     if (event.properties().toBool(solid))
 ///     {
 ///         event.reject(); // do not step on tile
 ///     }
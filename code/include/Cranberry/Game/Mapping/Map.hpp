@@ -25,6 +25,7 @@
 
 
 // Cranberry headers
+#include <Cranberry/Game/Mapping/MapCollisionGrid.hpp>
 #include <Cranberry/Game/Mapping/MapPlayer.hpp>
 #include <Cranberry/Game/Mapping/MapObject.hpp>
 #include <Cranberry/Game/Mapping/MapTileset.hpp>
@@ -32,6 +33,13 @@
 #include <Cranberry/Game/Mapping/Events/ObjectEvent.hpp>
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
 
+// Qt headers
+#include <QHash>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(MapNavigationGrid)
+CRANBERRY_FORWARD_C(MapObjectLayer)
+
 
 CRANBERRY_BEGIN_NAMESPACE
 
@@ -144,7 +152,9 @@ public:
     MapLayer* layerByName(const QString& name) const;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves an object by the given name.
+    /// Retrieves an object by the given name. If multiple objects share the
+    /// name, the one in the lowest layer is returned. Follows the changes
+    /// made through MapObject::setName().
     ///
     /// \param name Name of the object to get.
     /// \returns nullptr if an object with this name does not exist.
@@ -152,13 +162,41 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     MapObject* objectByName(const QString& name) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves all objects of the given type across all object layers.
+    /// Follows the changes made through MapObject::setType().
+    ///
+    /// \param type Type of the objects (e.g. "npc" or "warp").
+    /// \returns the objects; an empty vector if there are none.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QVector<MapObject*>& objectsByType(const QString& type) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the collision grid of the map. It is built after loading the
+    /// map, without any solid tiles; see MapCollisionGrid::create() in order
+    /// to opt into blocking by a property.
+    ///
+    /// \returns the collision grid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    MapCollisionGrid& collisionGrid();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the collision grid of the map.
+    ///
+    /// \returns the collision grid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const MapCollisionGrid& collisionGrid() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the properties of the map.
     ///
     /// \returns the map properties.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    const QMap<QString, QVariant>& properties() const;
+    const MapProperties& properties() const;
 
 
 public overridden:
@@ -194,6 +232,16 @@ public overridden:
     ////////////////////////////////////////////////////////////////////////////
     virtual void render();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the revision of the map, which includes the revisions of all
+    /// layers and of the player. Moving the player also changes it. Override
+    /// this method if you render anything else, or call markDirty().
+    ///
+    /// \returns the revision.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    virtual quint64 revision() const;
+
 
 protected overridable:
 
@@ -254,20 +302,32 @@ private:
     bool loadTilesets(QDomElement* elem);
     bool loadLayers(QDomElement* elem);
     bool loadProperties(QDomElement* elem);
+    void indexObjects(const MapObjectLayer* layer);
+    void reindexName(const QString& name);
+    void reindexType(const QString& type);
+    void updateGrids(int x, int y);
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    MapOrientation          m_orientation;
-    int                     m_width;
-    int                     m_height;
-    int                     m_tileWidth;
-    int                     m_tileHeight;
-    QColor                  m_bgColor;
-    MapPlayer*              m_player;
-    QVector<MapLayer*>      m_layers;
-    QVector<MapTileset*>    m_tilesets;
-    QMap<QString, QVariant> m_properties;
+    MapOrientation                      m_orientation;
+    int                                 m_width;
+    int                                 m_height;
+    int                                 m_tileWidth;
+    int                                 m_tileHeight;
+    QColor                              m_bgColor;
+    MapPlayer*                          m_player;
+    QVector<MapLayer*>                  m_layers;
+    QVector<MapTileset*>                m_tilesets;
+    QHash<QString, MapObject*>          m_objectsByName;
+    QHash<QString, QVector<MapObject*>> m_objectsByType;
+    MapCollisionGrid                    m_collisionGrid;
+    mutable QVector<MapNavigationGrid*> m_navigationGrids;
+    MapProperties                       m_properties;
+
+    friend class MapNavigationGrid;
+    friend class MapObjectLayer;
+    friend class MapTileLayer;
 };
 
 
@@ -0,0 +1,146 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPBITGRID_HPP
+#define CRANBERRY_GAME_MAPPING_MAPBITGRID_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QVector>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stores one bit per tile of a map, packed row by row into 64-bit words.
+///
+/// \class MapBitGrid
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapBitGrid final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(MapBitGrid)
+    CRANBERRY_DEFAULT_DTOR(MapBitGrid)
+    CRANBERRY_DEFAULT_COPY(MapBitGrid)
+    CRANBERRY_DEFAULT_MOVE(MapBitGrid)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this grid is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the width of the grid, in tiles.
+    ///
+    /// \returns the grid width.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int width() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the height of the grid, in tiles.
+    ///
+    /// \returns the grid height.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int height() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the bit of the tile at \p x and \p y.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param outside Value of tiles outside of the grid.
+    /// \returns the bit of the tile.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool bit(int x, int y, bool outside) const
+    {
+        if (uint(x) >= uint(m_width) || uint(y) >= uint(m_height))
+        {
+            return outside;
+        }
+
+        return (m_words.at(y * m_stride + (x >> 6)) >> (x & 63)) & 1;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the bit of the tile at \p x and \p y. Tiles outside of the
+    /// grid are ignored.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param value New value of the bit.
+    /// \returns true if the bit changed.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool setBit(int x, int y, bool value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Resizes the grid and sets every bit to \p value. The bits beyond the
+    /// width of a row are always cleared.
+    ///
+    /// \param width Width of the grid, in tiles.
+    /// \param height Height of the grid, in tiles.
+    /// \param value Initial value of every bit.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void allocate(int width, int height, bool value);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<quint64> m_words;   ///< Bits, row by row
+    int              m_width;   ///< Width in tiles
+    int              m_height;  ///< Height in tiles
+    int              m_stride;  ///< Words per row
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapBitGrid
+/// \ingroup Game
+///
+/// Backs the MapNavigationGrid and the MapCollisionGrid. A 1024x1024 map
+/// takes 128 KiB, so that a whole row of tiles shares a few cache lines.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
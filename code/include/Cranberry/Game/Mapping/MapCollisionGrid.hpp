@@ -0,0 +1,248 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPCOLLISIONGRID_HPP
+#define CRANBERRY_GAME_MAPPING_MAPCOLLISIONGRID_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapBitGrid.hpp>
+#include <Cranberry/Game/Mapping/MapPropertyTable.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(Map)
+CRANBERRY_FORWARD_C(MapObject)
+CRANBERRY_FORWARD_C(MapObjectLayer)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds the solid state of every tile of a map, one bit each, and the objects
+/// covering each tile.
+///
+/// \class MapCollisionGrid
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapCollisionGrid final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Refers to one object covering a tile.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct ObjectEntry
+    {
+        MapObject*            object; ///< Object covering the tile
+        const MapObjectLayer* layer;  ///< Layer the object belongs to
+    };
+
+    CRANBERRY_DECLARE_CTOR(MapCollisionGrid)
+    CRANBERRY_DEFAULT_DTOR(MapCollisionGrid)
+    CRANBERRY_DEFAULT_COPY(MapCollisionGrid)
+    CRANBERRY_DEFAULT_MOVE(MapCollisionGrid)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this grid is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the width of the grid, in tiles.
+    ///
+    /// \returns the grid width.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int width() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the height of the grid, in tiles.
+    ///
+    /// \returns the grid height.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int height() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the tile at \p x and \p y blocks movement. Tiles
+    /// outside of the grid are always solid.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \returns true if solid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool isSolid(int x, int y) const
+    {
+        return m_solid.bit(x, y, true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the objects covering the tile at \p x and \p y. The entries
+    /// are copied, so that handlers may move objects while they are visited.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param entries Receives the object entries.
+    /// \returns the amount of objects.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int objectsAt(int x, int y, QVector<ObjectEntry>& entries) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the tile at \p x and \p y blocks movement. This
+    /// overrides the value derived from the map until updateTile() is called
+    /// for this tile.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param solid True if the tile blocks movement.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSolid(int x, int y, bool solid);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the grid from \p map. If \p solidProperty is not empty, a tile
+    /// is solid if a tile or an object at that position has that boolean
+    /// property set to true; otherwise no tile is solid.
+    ///
+    /// \param map Map to build the grid from.
+    /// \param solidProperty Name of the boolean property that blocks tiles.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(const Map* map, const QString& solidProperty = QString());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Re-evaluates the tile at \p x and \p y from the map. This is done
+    /// automatically by MapTileLayer::setTile().
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void updateTile(int x, int y);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Moves \p object to the tiles it covers now and re-evaluates the tiles
+    /// it covered before. Only the affected tiles are touched. The object
+    /// layers call this whenever the position or size of one of their objects
+    /// changed and every frame while an object moves. Objects that were not
+    /// part of the map when the grid was created are ignored.
+    ///
+    /// \param object Object that was moved, resized or whose properties
+    ///        changed.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void updateObject(MapObject* object);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Link
+    {
+        ObjectEntry entry;  ///< Object covering the tile
+        bool        solid;  ///< Whether the object blocks the tile
+        int         next;   ///< Next link of the tile; -1 if none
+    };
+
+    struct ObjectSlot
+    {
+        const MapObjectLayer* layer;  ///< Layer the object belongs to
+        QRect                 tiles;  ///< Tiles the object is linked to
+        bool                  solid;  ///< Whether the object blocks tiles
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    QRect coveredTiles(const MapObject* object) const;
+    void linkObject(MapObject* object, const ObjectSlot& slot);
+    void unlinkObject(const MapObject* object, const QRect& tiles);
+    void evaluateTile(int x, int y);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    const Map*                     m_map;          ///< Map the grid was built from
+    MapPropertyKey                 m_solidKey;     ///< Key of the solid property
+    QVector<QVector<bool>>         m_solidTiles;   ///< Solid flags per tileset and tile
+    MapBitGrid                     m_solid;        ///< Solid bit per tile
+    QVector<int>                   m_firstLink;    ///< First object link per tile
+    QVector<Link>                  m_links;        ///< Object links of all tiles
+    int                            m_freeLink;     ///< First unused link; -1 if none
+    QHash<MapObject*, ObjectSlot>  m_objectSlots;  ///< Linked tiles per object
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapCollisionGrid
+/// \ingroup Game
+///
+/// The map builds its collision grid after loading, without any solid tiles.
+/// Built-in blocking is opt-in: once the grid is created again with a solid
+/// property or tiles are marked by setSolid(), the MapPlayer rejects steps
+/// onto solid tiles before any handler is able to veto them. All other steps
+/// raise the tile and object events as usual. Agents controlled by AI may
+/// query the grid directly.
+///
+/// Every tile refers to a short list of the objects covering it. Moving or
+/// resizing an object relinks it to the tiles it covers now, which costs as
+/// much as the amount of tiles it covers rather than the size of the map.
+///
+/// \code
+/// MapCollisionGrid& grid = map->collisionGrid();
+/// grid.create(map, "solid");
+///
+/// for (Agent& agent : agents)
+/// {
+///     QPoint next = agent.position() + agent.direction();
+///     if (!grid.isSolid(next.x(), next.y()))
+///     {
+///         agent.moveTo(next);
+///     }
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
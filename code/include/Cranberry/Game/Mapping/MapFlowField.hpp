@@ -0,0 +1,154 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPFLOWFIELD_HPP
+#define CRANBERRY_GAME_MAPPING_MAPFLOWFIELD_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QPoint>
+#include <QVector>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds the direction towards one goal for every tile of a navigation grid.
+///
+/// \class MapFlowField
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapFlowField final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(MapFlowField)
+    CRANBERRY_DEFAULT_DTOR(MapFlowField)
+    CRANBERRY_DEFAULT_COPY(MapFlowField)
+    CRANBERRY_DEFAULT_MOVE(MapFlowField)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this flow field is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the goal all directions of this flow field lead to.
+    ///
+    /// \returns the goal tile.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QPoint& goal() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the version of the navigation grid this flow field is valid
+    /// for. Cached flow fields are carried over to newer versions as long as
+    /// the changed tiles do not affect them.
+    ///
+    /// \returns the grid version.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    uint gridVersion() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the goal can be reached from the given tile.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \returns true if reachable.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isReachable(int x, int y) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the step to take from the given tile in order to get closer
+    /// to the goal. Each component is either -1, 0 or 1. Returns (0, 0) on
+    /// the goal itself and on tiles from which the goal is unreachable.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \returns the direction towards the goal.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QPoint direction(int x, int y) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the path cost from the given tile to the goal, where an
+    /// orthogonal step costs 10 and a diagonal step costs 14.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \returns the cost or -1 if the goal is unreachable.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int distance(int x, int y) const;
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<quint32> m_costs;       ///< Integrated cost per tile
+    QVector<quint8>  m_directions;  ///< Direction index per tile
+    QPoint           m_goal;        ///< Goal of the flow field
+    int              m_width;       ///< Width in tiles
+    int              m_height;      ///< Height in tiles
+    uint             m_gridVersion; ///< Version of the source grid
+
+    friend class MapPathfinder;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapFlowField
+/// \ingroup Game
+///
+/// Flow fields are built by the MapPathfinder and shared by all agents that
+/// walk towards the same goal, which is much cheaper than finding one path
+/// per agent.
+///
+/// \code
+/// MapFlowField field = pathfinder.flowField(QPoint(40, 12));
+/// for (MapPlayer* npc : npcs)
+/// {
+///     QPoint dir = field.direction(npc->tileX(), npc->tileY());
+///     npc->movePlayerBy(dir.x(), dir.y());
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -91,6 +91,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isVisible() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this layer may be updated in parallel with the
+    /// other layers of the map.
+    ///
+    /// \returns true if thread-safe.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isThreadSafe() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// The position (index) of the layer in the entire map.
     ///
@@ -118,6 +127,7 @@ public:
     void setName(const QString& name);
     void setOpacity(float opac);
     void setVisibility(bool visible);
+    void setThreadSafe(bool threadSafe);
     void setLayerId(int id);
     void setOffsetX(int x);
     void setOffsetY(int y);
@@ -129,6 +139,7 @@ public overridable:
     // Virtual functions
     ////////////////////////////////////////////////////////////////////////////
     virtual LayerType layerType() const = 0;
+    virtual quint64 revision() const = 0;
     virtual void update(const GameTime& time) = 0;
     virtual void render() = 0;
 
@@ -142,6 +153,7 @@ private:
     QString m_name;
     float   m_opacity;
     bool    m_isVisible;
+    bool    m_isThreadSafe;
     int     m_layerId;
     int     m_offsetX;
     int     m_offsetY;
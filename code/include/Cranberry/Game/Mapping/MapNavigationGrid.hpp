@@ -0,0 +1,244 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPNAVIGATIONGRID_HPP
+#define CRANBERRY_GAME_MAPPING_MAPNAVIGATIONGRID_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapBitGrid.hpp>
+
+// Qt headers
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(Map)
+CRANBERRY_FORWARD_C(MapTileLayer)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds a compact walkability grid of a map, one bit per tile.
+///
+/// \class MapNavigationGrid
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapNavigationGrid final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(MapNavigationGrid)
+    CRANBERRY_DECLARE_DTOR(MapNavigationGrid)
+    CRANBERRY_DECLARE_COPY(MapNavigationGrid)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this grid is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the width of the grid, in tiles.
+    ///
+    /// \returns the grid width.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int width() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the height of the grid, in tiles.
+    ///
+    /// \returns the grid height.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int height() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the version of the grid. It is incremented every time the
+    /// walkability of at least one tile changes, which allows path finders to
+    /// invalidate their cached results.
+    ///
+    /// \returns the grid version.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    uint version() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the tiles whose walkability changed after \p version. Only
+    /// the most recent changes are kept; older versions have to be treated
+    /// as if every tile changed.
+    ///
+    /// \param version Version to retrieve the changes since.
+    /// \param tiles Receives the changed tiles.
+    /// \returns false if the changes since \p version are no longer known.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool changesSince(uint version, QVector<QPoint>& tiles) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the tile at \p x and \p y can be walked on. Tiles
+    /// outside of the grid are never walkable.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \returns true if walkable.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool isWalkable(int x, int y) const
+    {
+        return m_walkable.bit(x, y, false);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the tile at \p x and \p y can be walked on. This
+    /// overrides the value derived from the map until updateTile() is
+    /// called for this tile.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param walkable True if the tile can be walked on.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setWalkable(int x, int y, bool walkable);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates an empty grid of the given size in which every tile is
+    /// walkable. Use this if walkability is determined by custom logic.
+    ///
+    /// \param width Width of the grid, in tiles.
+    /// \param height Height of the grid, in tiles.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(int width, int height);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the grid from the tile properties of \p map. A tile is not
+    /// walkable if any tile layer has a tile at that position whose boolean
+    /// property \p property is true. The grid is kept up to date by
+    /// MapTileLayer::setTile() as long as both the grid and the map exist.
+    ///
+    /// \param map Map to build the grid from.
+    /// \param property Name of the boolean tile property that blocks tiles.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(const Map* map, const QString& property = "solid");
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the grid from a designated collision layer. A tile is not
+    /// walkable if \p layer contains a non-null tile at that position. The
+    /// grid is kept up to date by MapTileLayer::setTile().
+    ///
+    /// \param map Map the collision layer belongs to.
+    /// \param layer Collision layer to build the grid from.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(const Map* map, const MapTileLayer* layer);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Re-evaluates the walkability of a single tile from the map. This is
+    /// done automatically by MapTileLayer::setTile(); call this if the map
+    /// was modified otherwise. Only the affected bit is recomputed.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void updateTile(int x, int y);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Re-evaluates the walkability of all tiles within \p region.
+    ///
+    /// \param region Region to update, in tiles.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void updateRegion(const QRect& region);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Change
+    {
+        uint   version;  ///< Version that contains the change
+        QPoint tile;     ///< Tile whose walkability changed
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    bool createInternal(const Map* map);
+    bool allocate(int width, int height);
+    bool evaluateTile(int x, int y) const;
+    bool writeTile(int x, int y, bool walkable);
+    void attach(const Map* map);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    const Map*             m_map;         ///< Map to derive walkability from
+    const MapTileLayer*    m_layer;       ///< Optional collision layer
+    QVector<QVector<bool>> m_solidTiles;  ///< Solid flags per tileset and tile
+    MapBitGrid             m_walkable;    ///< Walkability bit per tile
+    QVector<Change>        m_changes;     ///< Most recent changes
+    uint                   m_changesFrom; ///< Oldest version with known changes
+    uint                   m_version;     ///< Incremented upon every change
+
+    friend class Map;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapNavigationGrid
+/// \ingroup Game
+///
+/// The navigation grid stores one bit per tile and is shared by all agents
+/// navigating the same map. It is consumed by the MapPathfinder.
+///
+/// \code
+/// MapNavigationGrid grid;
+/// grid.create(map, "solid");
+///
+/// // A door opens; replacing the tile updates the grid incrementally.
+/// layer->setTile(12, 7, openDoorTile);
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -25,14 +25,15 @@
 
 
 // Cranberry headers
+#include <Cranberry/Game/Mapping/MapProperties.hpp>
 #include <Cranberry/Graphics/Base/TransformBase.hpp>
 
 // Qt headers
-#include <QMap>
 #include <QString>
 #include <QVariant>
 
 // Forward declarations
+CRANBERRY_FORWARD_C(MapObjectLayer)
 CRANBERRY_FORWARD_C(RenderBase)
 
 
@@ -96,7 +97,16 @@ public:
     /// \returns the value or a null QVariant.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    const QVariant& propertyValue(const QString& property) const;
+    QVariant propertyValue(const QString& property) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the value of the property \p key.
+    ///
+    /// \param key Interned key of the property.
+    /// \returns the value or a null QVariant.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVariant propertyValue(MapPropertyKey key) const;
 
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the associated render object of this object.
@@ -107,12 +117,20 @@ public:
     RenderBase* renderObject() const;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves the modifiable property map.
+    /// Retrieves the modifiable properties.
+    ///
+    /// \returns the properties.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    MapProperties& properties();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the properties.
     ///
-    /// \returns the property map.
+    /// \returns the properties.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    QMap<QString, QVariant>& properties();
+    const MapProperties& properties() const;
 
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the global ID of this object.
@@ -123,7 +141,8 @@ public:
     void setId(int id);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies the name of this object.
+    /// Specifies the name of this object. Updates the lookups of the layer
+    /// and the map the object belongs to.
     ///
     /// \param name New name of the object.
     ///
@@ -131,13 +150,23 @@ public:
     void setName(const QString& name);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies the type of this object.
+    /// Specifies the type of this object. Updates the lookups of the layer
+    /// and the map the object belongs to.
     ///
     /// \param type New type of the object.
     ///
     ////////////////////////////////////////////////////////////////////////////
     void setType(const QString& type);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the properties of this object. The object layer uses this to
+    /// place all of its objects in one shared property table.
+    ///
+    /// \param props New properties of the object.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setProperties(const MapProperties& props);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the object to be rendered when calling render(). The transform
     /// properties of it will be replaced by the transform properties of this
@@ -165,13 +194,15 @@ private:
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    int                     m_id;
-    QString                 m_name;
-    QString                 m_type;
-    QMap<QString, QVariant> m_properties;
-    RenderBase*             m_renderObject;
-    bool                    m_takeOwnership;
+    int             m_id;
+    QString         m_name;
+    QString         m_type;
+    MapProperties   m_properties;
+    MapObjectLayer* m_layer;
+    RenderBase*     m_renderObject;
+    bool            m_takeOwnership;
 
+    friend class MapObjectLayer;
 };
 
 
@@ -187,7 +218,7 @@ private:
 ///     if (!event.object().isNull())
 ///     {
 ///         // We are stepping on an actual object now
-///         if (event.object().propertyValue("type").toString() == "warp")
+///         if (event.object().type() == "warp")
 ///         {
 ///             // Extract warp data out of other properties
 ///         }
@@ -29,6 +29,8 @@
 #include <Cranberry/Game/Mapping/MapObject.hpp>
 
 // Qt headers
+#include <QExplicitlySharedDataPointer>
+#include <QHash>
 #include <QVector>
 
 // Forward declarations
@@ -63,7 +65,9 @@ public:
     MapObjectLayer(Map* parent = nullptr);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves a map object by name.
+    /// Retrieves a map object by name. If multiple objects share the name,
+    /// the first one is returned. Follows the changes made through
+    /// MapObject::setName().
     ///
     /// \param name Name of the object.
     /// \returns a nullptr if not successful.
@@ -71,6 +75,16 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     MapObject* objectByName(const QString& name) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves all map objects of the given type, in file order. Follows
+    /// the changes made through MapObject::setType().
+    ///
+    /// \param type Type of the objects (e.g. "npc" or "warp").
+    /// \returns the objects; an empty vector if there are none.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QVector<MapObject*>& objectsByType(const QString& type) const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves all objects of that layer.
     ///
@@ -95,16 +109,28 @@ public overridden:
     // Virtual functions
     ////////////////////////////////////////////////////////////////////////////
     LayerType layerType() const override;
+    quint64 revision() const override;
     void update(const GameTime& time) override;
     void render() override;
 
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void reindexName(const QString& name);
+    void reindexType(const QString& type);
+
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    QVector<MapObject*> m_objects;
+    QVector<MapObject*>                            m_objects;
+    QHash<QString, MapObject*>                     m_objectsByName;
+    QHash<QString, QVector<MapObject*>>            m_objectsByType;
+    QExplicitlySharedDataPointer<MapPropertyTable> m_properties;
+
+    friend class MapObject;
 };
 
 
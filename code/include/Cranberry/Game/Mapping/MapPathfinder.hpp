@@ -0,0 +1,227 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPPATHFINDER_HPP
+#define CRANBERRY_GAME_MAPPING_MAPPATHFINDER_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapFlowField.hpp>
+#include <Cranberry/Game/Mapping/MapNavigationGrid.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QVector>
+
+// Standard headers
+#include <vector>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Finds paths on a navigation grid, either for single agents (A* with jump
+/// point search) or for many agents sharing one goal (flow fields).
+///
+/// \class MapPathfinder
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapPathfinder final
+{
+public:
+
+    CRANBERRY_DEFAULT_DTOR(MapPathfinder)
+    CRANBERRY_DEFAULT_COPY(MapPathfinder)
+    CRANBERRY_DEFAULT_MOVE(MapPathfinder)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs a new path finder operating on \p grid.
+    ///
+    /// \param grid The navigation grid to find paths on.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    MapPathfinder(const MapNavigationGrid* grid = nullptr);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the navigation grid this path finder operates on.
+    ///
+    /// \returns the navigation grid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const MapNavigationGrid* grid() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether agents may move diagonally. Diagonal moves never
+    /// cut corners, i.e. both adjacent orthogonal tiles must be walkable.
+    ///
+    /// \returns true if diagonal movement is allowed.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool allowsDiagonalMovement() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of flow fields kept in the cache.
+    ///
+    /// \returns the cache size.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int flowFieldCacheSize() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the navigation grid to find paths on.
+    ///
+    /// \param grid The navigation grid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setGrid(const MapNavigationGrid* grid);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether agents may move diagonally. With diagonal movement,
+    /// findPath() uses jump point search; otherwise it uses plain A* on the
+    /// four orthogonal neighbours.
+    ///
+    /// \param allow True to allow diagonal movement.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setDiagonalMovement(bool allow);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the maximum amount of flow fields kept in the cache. The
+    /// least recently used flow field is discarded first.
+    ///
+    /// \default By default, this is 8.
+    /// \param size Maximum amount of cached flow fields.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setFlowFieldCacheSize(int size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Finds the shortest path from \p start to \p goal. The resulting path
+    /// contains every tile to step on, excluding \p start and including
+    /// \p goal, so it can directly be fed to MapPlayer::movePlayerBy().
+    ///
+    /// \param start Tile to start at.
+    /// \param goal Tile to walk to.
+    /// \param path Receives the path.
+    /// \returns false if there is no path.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool findPath(const QPoint& start, const QPoint& goal, QVector<QPoint>& path);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the flow field towards \p goal. The flow field is built on
+    /// first request and cached until a tile changes that it reaches or that
+    /// borders on a tile it reaches. The flow field shares its data with the
+    /// cache, so that returning it by value does not copy it; it remains
+    /// valid after the cache discarded it.
+    ///
+    /// \param goal Tile all agents walk to.
+    /// \returns the flow field or a null flow field if the goal is blocked.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    MapFlowField flowField(const QPoint& goal);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Discards all cached flow fields.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clearCache();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct OpenNode
+    {
+        quint32 cost;
+        int     index;
+
+        bool operator >(const OpenNode& other) const { return cost > other.cost; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    bool prepareSearch();
+    void pushOpen(int index, int parent, quint32 g, quint32 h);
+    int  popOpen();
+    void expandJumpPoints(int index, const QPoint& goal);
+    void expandNeighbours(int index, const QPoint& goal);
+    void relax(int from, int x, int y, const QPoint& goal);
+    int  jump(int x, int y, int dx, int dy, const QPoint& goal) const;
+    bool canStep(int x, int y, int dx, int dy) const;
+    quint32 heuristic(int x, int y, const QPoint& goal) const;
+    void reconstructPath(int goalIndex, QVector<QPoint>& path) const;
+    void buildFlowField(MapFlowField& field, const QPoint& goal);
+    void validateCache();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    const MapNavigationGrid*  m_grid;        ///< Grid to find paths on
+    QVector<quint32>          m_costs;       ///< Cost from the start per tile
+    QVector<int>              m_parents;     ///< Predecessor per tile
+    QVector<uint>             m_openStamp;   ///< Search in which a tile was seen
+    QVector<uint>             m_closedStamp; ///< Search in which a tile was closed
+    std::vector<OpenNode>     m_open;        ///< Binary heap of open tiles
+    uint                      m_search;      ///< Current search stamp
+    QHash<int, MapFlowField>  m_fields;      ///< Cached flow fields by goal
+    QList<int>                m_fieldOrder;  ///< Cached goals, least recent first
+    uint                      m_cacheVersion;///< Grid version of the cache
+    int                       m_cacheSize;   ///< Maximum cached flow fields
+    bool                      m_diagonal;    ///< Diagonal movement allowed?
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapPathfinder
+/// \ingroup Game
+///
+/// One path finder should be used per thread, since it reuses its internal
+/// buffers between searches in order to avoid heap traffic.
+///
+/// \code
+/// MapNavigationGrid grid;
+/// grid.create(map, "solid");
+///
+/// MapPathfinder pathfinder(&grid);
+/// QVector<QPoint> path;
+/// if (pathfinder.findPath(QPoint(2, 3), QPoint(60, 41), path))
+/// {
+///     // walk along the path
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
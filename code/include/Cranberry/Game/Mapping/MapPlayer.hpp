@@ -123,7 +123,11 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     /// Moves the player by \p x horizontally and \p y vertically. If the move
     /// mode is PlayerMoveTiles, x and y will be multiplied by the tile width
-    /// and the tile height of the map respectively.
+    /// and the tile height of the map respectively. Steps onto tiles marked
+    /// as solid in the map's collision grid are rejected before any event is
+    /// raised; the grid marks no tiles as solid unless told to. Tile and
+    /// object events are raised for every tile, as long as the signals have
+    /// receivers.
     ///
     /// \param x X-offset to move by, either in tiles or pixels.
     /// \param y Y-offset to move by, either in tiles or pixels.
@@ -165,6 +169,9 @@ private:
     bool exceedsMapSize(int x, int y);
     bool movePlayerByTiles(int x, int y);
     bool movePlayerByPixels(int x, int y);
+    bool stepTile(int oldX, int oldY, int newX, int newY, bool instant);
+    bool emitStartedMove(int x, int y, bool instant);
+    void emitStartedLeave(int oldX, int oldY, int newX, int newY);
     void moveFinished();
 
     ////////////////////////////////////////////////////////////////////////////
@@ -185,10 +192,14 @@ private:
 /// \class MapPlayer
 /// \ingroup Game
 ///
-/// More detailed description, code examples.
+/// Every step is resolved against the collision grid of the map, which makes
+/// it cheap enough to use one MapPlayer per AI-driven agent.
 ///
 /// \code
-/// ...
+/// MapPlayer* npc = new MapPlayer(map);
+/// npc->setTileX(4);
+/// npc->setTileY(9);
+/// npc->movePlayerBy(1, 0);
 /// \endcode
 ///
 ////////////////////////////////////////////////////////////////////////////////
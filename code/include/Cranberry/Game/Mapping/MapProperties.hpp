@@ -0,0 +1,228 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPPROPERTIES_HPP
+#define CRANBERRY_GAME_MAPPING_MAPPROPERTIES_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapPropertyTable.hpp>
+
+// Qt headers
+#include <QExplicitlySharedDataPointer>
+#include <QMap>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Provides access to the properties of one tile, object, tileset or map.
+/// The values live in one row of a MapPropertyTable which is shared by all
+/// owners of the same kind.
+///
+/// \class MapProperties
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapProperties final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(MapProperties)
+    CRANBERRY_DEFAULT_DTOR(MapProperties)
+    CRANBERRY_DEFAULT_COPY(MapProperties)
+    CRANBERRY_DEFAULT_MOVE(MapProperties)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs properties that refer to the row \p row of \p table.
+    ///
+    /// \param table Table that stores the values.
+    /// \param row Row of the owner within the table.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    MapProperties(const QExplicitlySharedDataPointer<MapPropertyTable>& table, int row);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether there is at least one property.
+    ///
+    /// \returns true if valid.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isValid() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the property \p key exists.
+    ///
+    /// \param key Key of the property.
+    /// \returns true if the property exists.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool contains(MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the property called \p name exists.
+    ///
+    /// \param name Name of the property.
+    /// \returns true if the property exists.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool contains(const QString& name) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the keys of all existing properties.
+    ///
+    /// \returns the property keys.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<MapPropertyKey> keys() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the value of the property \p key.
+    ///
+    /// \param key Key of the property.
+    /// \returns the value or a null QVariant.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVariant value(MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the value of the property called \p name. Prefer the
+    /// overload taking a key in code that runs every frame.
+    ///
+    /// \param name Name of the property.
+    /// \returns the value or a null QVariant.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVariant value(const QString& name) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Typed accessors. They never allocate and return \p def if the property
+    /// does not exist or has a different type.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool toBool(MapPropertyKey key, bool def = false) const;
+    int toInt(MapPropertyKey key, int def = 0) const;
+    float toFloat(MapPropertyKey key, float def = 0.0f) const;
+    QColor toColor(MapPropertyKey key, const QColor& def = QColor()) const;
+    const QString& toString(MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Copies all properties into a map, keyed by their names.
+    ///
+    /// \returns the property map.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QMap<QString, QVariant> toMap() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies a new value for the property \p key.
+    ///
+    /// \param key Key of the property.
+    /// \param value New value of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setValue(MapPropertyKey key, const QVariant& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies a new value for the property called \p name.
+    ///
+    /// \param name Name of the property.
+    /// \param value New value of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setValue(const QString& name, const QVariant& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies a new value for the property \p key from its TMX string
+    /// representation.
+    ///
+    /// \param key Key of the property.
+    /// \param type TMX type of the property.
+    /// \param value String value of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setValue(MapPropertyKey key, PropertyType type, const QString& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds a new property.
+    ///
+    /// \param name Name of the new property.
+    /// \param value Value of the new property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void addProperty(const QString& name, const QVariant& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the property called \p name.
+    ///
+    /// \param name Name of the property to remove.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void removeProperty(const QString& name);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void detach();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QExplicitlySharedDataPointer<MapPropertyTable> m_table; ///< Table holding the values
+    int                                            m_row;   ///< Row within the table
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapProperties
+/// \ingroup Game
+///
+/// Copies of this class share the table until one of them is written to.
+/// The writer then copies its row into a private table first, so that the
+/// other owners of the table and all copies keep their values. Properties
+/// that are not backed by a table yet (e.g. default-constructed ones) also
+/// allocate a private table on the first write.
+///
+/// \code
+/// static const MapPropertyKey warp = MapPropertyKeys::intern("warp");
+///
+/// void onStepTile(const TileEvent& event)
+/// {
+///     if (event.properties().contains(warp))
+///     {
+///         loadMap(event.properties().toString(warp));
+///     }
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -0,0 +1,276 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAME_MAPPING_MAPPROPERTYTABLE_HPP
+#define CRANBERRY_GAME_MAPPING_MAPPROPERTYTABLE_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/Enumerations.hpp>
+
+// Qt headers
+#include <QBitArray>
+#include <QColor>
+#include <QSharedData>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Identifies an interned property name. Valid keys are never negative.
+///
+////////////////////////////////////////////////////////////////////////////////
+CRANBERRY_ALIAS(int, MapPropertyKey)
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interns property names to small integer keys. The keys are process-wide
+/// and therefore identical across all maps, tilesets and objects.
+///
+/// \class MapPropertyKeys
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapPropertyKeys final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the key of the property \p name and registers the name if it
+    /// is not known yet. Call this once and store the key for hot paths.
+    ///
+    /// \param name Name of the property.
+    /// \returns the property key.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static MapPropertyKey intern(const QString& name);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the key of the property \p name without registering it.
+    ///
+    /// \param name Name of the property.
+    /// \returns the property key or -1 if the name is unknown.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static MapPropertyKey find(const QString& name);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the name of the property identified by \p key.
+    ///
+    /// \param key Key of the property.
+    /// \returns the property name or an empty string.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static QString name(MapPropertyKey key);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stores the properties of many owners (tiles, objects or tilesets) as one
+/// typed column per property key. Each owner occupies one row.
+///
+/// \class MapPropertyTable
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GAME_EXPORT MapPropertyTable final : public QSharedData
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(MapPropertyTable)
+    CRANBERRY_DEFAULT_DTOR(MapPropertyTable)
+    CRANBERRY_DEFAULT_COPY(MapPropertyTable)
+    CRANBERRY_DEFAULT_MOVE(MapPropertyTable)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of rows in this table.
+    ///
+    /// \returns the row count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int rowCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends \p count empty rows.
+    ///
+    /// \param count Amount of rows to append.
+    /// \returns the index of the first appended row.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int addRows(int count = 1);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves all keys that have a column in this table.
+    ///
+    /// \returns the property keys.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QVector<MapPropertyKey>& keys() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given row has a value for \p key.
+    ///
+    /// \param row Row of the owner.
+    /// \param key Key of the property.
+    /// \returns true if the value exists.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool contains(int row, MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given row has any value.
+    ///
+    /// \param row Row of the owner.
+    /// \returns true if the row has no values.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isEmpty(int row) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the type of the column \p key.
+    ///
+    /// \param key Key of the property.
+    /// \returns the type or PropertyTypeInvalid if there is no such column or
+    ///          if its rows hold values of different types.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    PropertyType type(MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Typed accessors. They never allocate and return \p def if the row has
+    /// no value for \p key or the type of its value does not match.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool toBool(int row, MapPropertyKey key, bool def = false) const;
+    int toInt(int row, MapPropertyKey key, int def = 0) const;
+    float toFloat(int row, MapPropertyKey key, float def = 0.0f) const;
+    QColor toColor(int row, MapPropertyKey key, const QColor& def = QColor()) const;
+    const QString& toString(int row, MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the value of \p key in the given row as QVariant.
+    ///
+    /// \param row Row of the owner.
+    /// \param key Key of the property.
+    /// \returns the value or a null QVariant.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QVariant value(int row, MapPropertyKey key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the value of \p key in the given row. The first value set for
+    /// a key determines the type of its column. Once a value of another type
+    /// is set, every row of that column keeps the type of its own value.
+    ///
+    /// \param row Row of the owner.
+    /// \param key Key of the property.
+    /// \param value New value of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setValue(int row, MapPropertyKey key, const QVariant& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the value of \p key in the given row from its TMX string
+    /// representation, without the detour over QVariant.
+    ///
+    /// \param row Row of the owner.
+    /// \param key Key of the property.
+    /// \param type TMX type of the property.
+    /// \param value String value of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setValue(int row, MapPropertyKey key, PropertyType type, const QString& value);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the value of \p key from the given row.
+    ///
+    /// \param row Row of the owner.
+    /// \param key Key of the property.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void remove(int row, MapPropertyKey key);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Column
+    {
+        PropertyType     type;    ///< Type of all values in this column
+        bool             mixed;   ///< Rows have values of different types?
+        QBitArray        present; ///< Whether a row has a value
+        QVector<qint8>   types;   ///< Type of each row, if mixed
+        QVector<qint32>  ints;    ///< Integer, boolean and color values
+        QVector<float>   floats;  ///< Float values
+        QVector<QString> strings; ///< String and file values
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    const Column* column(MapPropertyKey key) const;
+    Column& columnForWrite(MapPropertyKey key, PropertyType type);
+    void resizeColumn(Column& column);
+    void storeValue(Column& column, int row, PropertyType type);
+    static PropertyType rowType(const Column& column, int row);
+    if_debug(void checkType(int row, MapPropertyKey key, PropertyType type) const)
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<Column>         m_columns;  ///< One column per key
+    QVector<int>            m_columnOf; ///< Column index by key, -1 if none
+    QVector<MapPropertyKey> m_keys;     ///< Key of each column
+    int                     m_rows;     ///< Amount of rows
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class MapPropertyTable
+/// \ingroup Game
+///
+/// Lookups resolve the column by indexing an array with the key, so reading
+/// a property costs two array accesses and no string comparisons.
+///
+/// \code
+/// static const MapPropertyKey solid = MapPropertyKeys::intern("solid");
+/// if (tileset->tileProperties(tileId).toBool(solid))
+/// {
+///     // blocked
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -93,6 +93,18 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     Tilemap* renderObject() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Replaces the tile at \p x and \p y. The collision grid of the map and
+    /// all navigation grids built from the map are updated automatically.
+    ///
+    /// \param x X-position of the tile.
+    /// \param y Y-position of the tile.
+    /// \param tile New tile; must not be null.
+    /// \returns true if replaced successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool setTile(int x, int y, const MapTile& tile);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Parses the given layer XML element.
     ///
@@ -114,6 +126,7 @@ public overridden:
     // Virtual functions
     ////////////////////////////////////////////////////////////////////////////
     LayerType layerType() const override;
+    quint64 revision() const override;
     void update(const GameTime& time) override;
     void render() override;
 
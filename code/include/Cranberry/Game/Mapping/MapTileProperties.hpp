@@ -25,93 +25,18 @@
 
 
 // Cranberry headers
-#include <Cranberry/Config.hpp>
-
-// Qt headers
-#include <QMap>
-#include <QString>
-#include <QVariant>
+#include <Cranberry/Game/Mapping/MapProperties.hpp>
 
 
 CRANBERRY_BEGIN_NAMESPACE
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Holds properties for a single block inside a tileset.
-///
-/// \class MapTileProperties
-/// \author Nicolas Kogler
-/// \date August 15, 2017
+/// Holds properties for a single block inside a tileset. All tiles of one
+/// tileset share the same MapPropertyTable.
 ///
 ////////////////////////////////////////////////////////////////////////////////
-class CRANBERRY_GAME_EXPORT MapTileProperties final
-{
-public:
-
-    CRANBERRY_DEFAULT_CTOR(MapTileProperties)
-    CRANBERRY_DEFAULT_DTOR(MapTileProperties)
-    CRANBERRY_DEFAULT_COPY(MapTileProperties)
-    CRANBERRY_DEFAULT_MOVE(MapTileProperties)
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Determines whether this tile properties are valid.
-    ///
-    /// \returns true if valid.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    bool isValid() const;
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves value of the property called \p name.
-    ///
-    /// \param name Name of the property.
-    /// \returns the value of the property.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    const QVariant& value(const QString& name) const;
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves a modifiable reference to the properties.
-    ///
-    /// \returns a reference to the properties.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    QMap<QString, QVariant>& properties();
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Specifies a new value for the property called \p name.
-    ///
-    /// \param name Name of the property.
-    /// \param value New value of the property.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    void setValue(const QString& name, const QVariant& value);
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Adds a new tile property.
-    ///
-    /// \param name Name of the new property.
-    /// \param value Value of the new property.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    void addProperty(const QString& name, const QVariant& value);
-
-    ////////////////////////////////////////////////////////////////////////////
-    /// Removes the property called \p name.
-    ///
-    /// \param name Name of the property to remove.
-    ///
-    ////////////////////////////////////////////////////////////////////////////
-    void removeProperty(const QString& name);
-
-
-private:
-
-    ////////////////////////////////////////////////////////////////////////////
-    // Members
-    ////////////////////////////////////////////////////////////////////////////
-    QMap<QString, QVariant> m_properties; ///< Properties associated to the tile
-};
+CRANBERRY_ALIAS(MapProperties, MapTileProperties)
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -123,9 +48,12 @@ private:
 /// warping or animations.
 ///
 /// \code
+/// static const MapPropertyKey solid = MapPropertyKeys::intern("solid");
+/// static const MapPropertyKey warp = MapPropertyKeys::intern("warp");
+///
 /// void onAboutStepTile(const TileEvent& event)
 /// {
-///     if (event.properties().value("solid").toBool())
+///     if (event.properties().toBool(solid))
 ///     {
 ///         event.reject(); // do not step on tile
 ///     }
@@ -133,7 +61,7 @@ private:
 ///
 /// void onStepTile(const TileEvent& event)
 /// {
-///     if (event.properties().value("warp").isValid())
+///     if (event.properties().contains(warp))
 ///     {
 ///         // do some warp stuff
 ///     }
@@ -28,9 +28,9 @@
 #include <Cranberry/Game/Mapping/MapTileProperties.hpp>
 
 // Qt headers
-#include <QMap>
+#include <QExplicitlySharedDataPointer>
 #include <QString>
-#include <QVariant>
+#include <QVector>
 
 // Forward declarations
 CRANBERRY_FORWARD_Q(QDomElement)
@@ -135,13 +135,13 @@ public:
     /// \returns all properties.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    const QMap<QString, QVariant>& properties() const;
+    const MapProperties& properties() const;
 
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves all tile properties of the given tile.
     ///
     /// \param tileId Id of the tile which's properties to receive.
-    /// \returns all tile properties.
+    /// \returns all tile properties, invalid ones if the ID is out of range.
     ///
     ////////////////////////////////////////////////////////////////////////////
     const MapTileProperties& tileProperties(int tileId) const;
@@ -160,17 +160,18 @@ private:
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    int                          m_globalId;
-    QString                      m_imagePath;
-    QString                      m_name;
-    QOpenGLTexture*              m_texture;
-    int                          m_tileWidth;
-    int                          m_tileHeight;
-    int                          m_tileSpacing;
-    int                          m_tileMargin;
-    int                          m_tileCount;
-    QMap<QString, QVariant>      m_properties;
-    QMap<int, MapTileProperties> m_tileProps;
+    int                                            m_globalId;
+    QString                                        m_imagePath;
+    QString                                        m_name;
+    QOpenGLTexture*                                m_texture;
+    int                                            m_tileWidth;
+    int                                            m_tileHeight;
+    int                                            m_tileSpacing;
+    int                                            m_tileMargin;
+    int                                            m_tileCount;
+    MapProperties                                  m_properties;
+    QExplicitlySharedDataPointer<MapPropertyTable> m_tileTable;
+    QVector<MapTileProperties>                     m_tileProps;
 };
 
 
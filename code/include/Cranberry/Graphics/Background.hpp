@@ -184,6 +184,15 @@ public overridden:
     ////////////////////////////////////////////////////////////////////////////
     bool initializeData() override;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Loads the image as a repeating texture, which the cache keeps apart
+    /// from the clamped one.
+    ///
+    /// \returns the texture options.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    TextureCache::Options textureOptions() const override;
+
 
 protected:
 
@@ -32,8 +32,15 @@
 #include <Cranberry/System/Emitters/AnimationBaseEmitter.hpp>
 
 // Qt headers
+#include <QSharedPointer>
 #include <QVector>
 
+// Standard headers
+#include <functional>
+
+// Forward declarations
+CRANBERRY_FORWARD_P(AnimationLoad)
+
 
 CRANBERRY_BEGIN_NAMESPACE
 
@@ -72,6 +79,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isAnimating() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the frames are still being decoded or uploaded.
+    /// The animation can not be rendered until it is ready.
+    ///
+    /// \returns true if the animation is being loaded.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isLoading() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the amount of frames.
     ///
@@ -229,6 +245,13 @@ public overridable:
 
 protected:
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Decodes all frames and their durations (in milliseconds). Runs on a
+    /// worker thread, thus must neither use OpenGL nor report errors.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    using FrameDecoder = std::function<bool(QVector<QImage>&, QVector<qreal>&)>;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Creates the texture atlases internally.
     ///
@@ -260,12 +283,31 @@ protected:
             Window* renderTarget
             );
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the texture atlases asynchronously. The \p decoder and the
+    /// conversion to the texture format run on the global thread pool. The
+    /// frames are then uploaded within render(), a few milliseconds per call.
+    /// Emits AnimationBaseEmitter::readyAnimation() once all frames are
+    /// uploaded.
+    ///
+    /// \param decoder Decodes the frames on a worker thread.
+    /// \param renderTarget The target to show animation on.
+    /// \returns true if the decoding was started.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool createInternalAsync(const FrameDecoder& decoder, Window* renderTarget);
+
 private:
 
     ////////////////////////////////////////////////////////////////////////////
     // Functions
     ////////////////////////////////////////////////////////////////////////////
     TextureBase* getCurrentTexture();
+    bool insertFrame(TextureAtlas*& atlas, const QImage& img, qreal duration);
+    void finishCreation(const QSize& largestSize);
+    void continueLoading();
+    void cancelLoading();
+    void releaseFrames();
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
@@ -280,6 +322,8 @@ private:
     qreal                   m_elapsedTime;
     bool                    m_isAnimating;
     bool                    m_isEmbedded;
+
+    QSharedPointer<priv::AnimationLoad> m_load;
 };
 
 
@@ -208,6 +208,32 @@ enum MovementMode
     MovementTile
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// This enum specifies the packing methods of texture atlases.
+///
+/// \enum PackingMethod
+///
+////////////////////////////////////////////////////////////////////////////////
+enum PackingMethod
+{
+    PackMaxRects, ///< Best short side fit; packs tightest
+    PackSkyline   ///< Bottom left skyline; packs fastest
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// This enum specifies the resolutions of post-processing passes, relative to
+/// the size of the render target.
+///
+/// \enum PassResolution
+///
+////////////////////////////////////////////////////////////////////////////////
+enum PassResolution
+{
+    ResolutionFull    = 1, ///< Same size as the render target
+    ResolutionHalf    = 2, ///< Half the width and height
+    ResolutionQuarter = 4  ///< Quarter of the width and height
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Qt flags
@@ -0,0 +1,226 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_BASE_GLYPHATLAS_HPP
+#define CRANBERRY_GRAPHICS_BASE_GLYPHATLAS_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QFont>
+#include <QHash>
+#include <QMutex>
+#include <QRawFont>
+#include <QRect>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_Q(QImage)
+CRANBERRY_FORWARD_Q(QOpenGLTexture)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds signed distance fields of glyphs in a few big single-channel
+/// textures. Glyphs are rasterized the first time they are requested.
+///
+/// \class GlyphAtlas
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT GlyphAtlas final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Describes the location of one glyph within the atlas.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Glyph
+    {
+        QRectF bounds; ///< Quad relative to the pen position, at base size
+        QRectF uv;     ///< Texture coordinates of the quad
+        int    page;   ///< Page of the atlas; -1 if the glyph is blank
+    };
+
+    CRANBERRY_DECLARE_CTOR(GlyphAtlas)
+    CRANBERRY_DECLARE_DTOR(GlyphAtlas)
+    CRANBERRY_DISABLE_COPY(GlyphAtlas)
+    CRANBERRY_DISABLE_MOVE(GlyphAtlas)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the atlas shared by all windows.
+    ///
+    /// \returns the shared atlas.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static GlyphAtlas* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Pixel size at which glyphs are stored. Glyphs are scaled from this
+    /// size to the size of the font they are drawn with.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static constexpr int baseSize() { return 48; }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Maximum distance to the glyph outline that is stored, in pixels at the
+    /// base size. Outlines and blur can not grow wider than this.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static constexpr int spread() { return 6; }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Width and height of one atlas page, in pixels.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static constexpr int pageSize() { return 1024; }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the identifier of \p font within the atlas. Fonts that only
+    /// differ in size share the same identifier.
+    ///
+    /// \param font Font to look up.
+    /// \returns the font identifier.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int fontId(const QFont& font);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the raw font with the identifier \p id, at the base size.
+    ///
+    /// \param id Identifier retrieved by fontId().
+    /// \returns the raw font.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QRawFont rawFont(int id) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the glyph \p index of the font \p id. Rasterizes the glyph
+    /// and places it in the atlas if it was not requested before. May be
+    /// called without a current OpenGL context.
+    ///
+    /// \param id Identifier retrieved by fontId().
+    /// \param index Glyph index within the raw font.
+    /// \returns the glyph.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    Glyph glyph(int id, quint32 index);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of pages.
+    ///
+    /// \returns the page count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int pageCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Binds the texture of \p page to the active texture unit. Uploads all
+    /// glyphs that were added to the page since the last call.
+    ///
+    /// \param page Page to bind.
+    /// \returns false if the texture could not be created.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool bindPage(int page);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Releases the texture of \p page.
+    ///
+    /// \param page Page to release.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void releasePage(int page);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys all textures and forgets all glyphs. Requires the context the
+    /// pages were created in to be current.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Page
+    {
+        QVector<quint8> pixels;      ///< Distance values, row by row
+        QOpenGLTexture* texture;     ///< Texture; created on first bind
+        int             shelfX;      ///< X-position on the current shelf
+        int             shelfY;      ///< Y-position of the current shelf
+        int             shelfHeight; ///< Height of the current shelf
+        int             dirtyTop;    ///< First row not uploaded yet
+        int             dirtyBottom; ///< Row after the last one not uploaded
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    Glyph createGlyph(int id, quint32 index);
+    QRect allocate(int width, int height, int& page);
+    void writeDistanceField(const QImage& coverage, const QRect& rc, Page& page);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QHash<QString, int>    m_fontIds; ///< Font identifiers by font key
+    QVector<QRawFont>      m_fonts;   ///< Raw fonts at the base size
+    QHash<quint64, Glyph>  m_glyphs;  ///< Glyphs by font and glyph index
+    QVector<Page>          m_pages;   ///< Atlas pages
+    mutable QMutex         m_mutex;   ///< Guards all of the above
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class GlyphAtlas
+/// \ingroup Graphics
+///
+/// Each glyph is stored once, as a signed distance field, regardless of the
+/// size it is drawn with. This allows GlyphBatch to draw text of any size,
+/// with outlines and blur, using the same texture and one draw call.
+///
+/// \code
+/// GlyphAtlas* atlas = GlyphAtlas::instance();
+/// int id = atlas->fontId(QFont("Arial"));
+/// for (quint32 index : atlas->rawFont(id).glyphIndexesForString("Score"))
+/// {
+///     GlyphAtlas::Glyph g = atlas->glyph(id, index);
+///     ...
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -89,6 +89,42 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     const QString& name() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the layer of this object in the render queue.
+    ///
+    /// \returns the layer.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int layer() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the depth of this object within its layer.
+    ///
+    /// \returns the depth.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float depth() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object covers everything behind it without
+    /// blending, which allows the render queue to reorder it.
+    ///
+    /// \returns true if opaque.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isOpaque() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves a counter that increases whenever the appearance of this
+    /// object changes, apart from its transformation. Containers compare it
+    /// between frames in order to skip re-rendering unchanged content.
+    /// Objects composed of other objects must forward changes of them.
+    ///
+    /// \returns the revision.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    virtual quint64 revision() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the shader program. If the given program is nullptr, the
     /// default shader program will be used instead. Will NOT take ownership
@@ -117,6 +153,49 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setName(const QString& name);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the layer of this object in the render queue. Lower layers
+    /// are always rendered before higher ones.
+    ///
+    /// \param layer Layer in the range [-128, 127].
+    /// \default 0
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setLayer(int layer);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the depth of this object within its layer. Objects with a
+    /// lower depth are rendered first.
+    ///
+    /// \param depth Depth in the range [0, 1].
+    /// \default 0
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setDepth(float depth);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether this object is opaque. The render queue renders
+    /// opaque objects of the same layer and depth grouped by shader and
+    /// texture, rather than in the order they were enqueued. Only set this
+    /// for objects that neither blend nor overlap others of the same depth.
+    /// Objects with an opacity below one are never treated as opaque.
+    ///
+    /// \param opaque True if the object is opaque.
+    /// \default false
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setOpaque(bool opaque);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds this object to the render queue of its render target, instead of
+    /// rendering it immediately. The queue is rendered after
+    /// Window::onRender(), sorted by layer and depth, then in the order the
+    /// objects were enqueued; see setOpaque(). The object itself is rendered, not a copy of its state; it must
+    /// stay alive until then.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void enqueue();
+
     ////////////////////////////////////////////////////////////////////////////
     /// Provides a lightweight way to make the render target's context current.
     /// Normally, you do not need to use this, only if Qt code interferes with
@@ -176,6 +255,15 @@ public overridable:
     ////////////////////////////////////////////////////////////////////////////
     virtual void render() = 0;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the OpenGL texture this object renders, if any. The render
+    /// queue uses it to render objects of the same texture in a row.
+    ///
+    /// \returns the texture id; 0 if none.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    virtual uint textureId() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the signals for this object.
     ///
@@ -220,6 +308,13 @@ protected:
     ////////////////////////////////////////////////////////////////////////////
     void setDefaultShaderProgram(OpenGLShader* program);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Increases the revision. Call this whenever the object will look
+    /// different the next time it is rendered, e.g. when the vertices change.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void markDirty();
+
     ////////////////////////////////////////////////////////////////////////////
     // Protected members
     ////////////////////////////////////////////////////////////////////////////
@@ -238,6 +333,10 @@ private:
     OpenGLShader*     m_customProgram;  ///< Custom shader program
     QString           m_name;           ///< Name of the object
     uint              m_osRenderer;     ///< Offscreen renderer, if any
+    int               m_layer;          ///< Layer in the render queue
+    float             m_depth;          ///< Depth within the layer
+    bool              m_opaque;         ///< May be reordered by state?
+    quint64           m_revision;       ///< Increased by markDirty()
 };
 
 
@@ -0,0 +1,129 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_BASE_RENDERTARGETPOOL_HPP
+#define CRANBERRY_GRAPHICS_BASE_RENDERTARGETPOOL_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QSize>
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Recycles framebuffers process-wide. Targets are keyed by their size,
+/// sample count and depth/stencil attachment; objects acquire one for as long
+/// as they render into it and release it right afterwards, so that objects
+/// of the same size share the same memory. Must only be used from the thread
+/// that renders.
+///
+/// \class RenderTargetPool
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class RenderTargetPool final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// A framebuffer with one RGBA8 color attachment. Single-sampled targets
+    /// attach a texture, multisampled ones a renderbuffer that has to be
+    /// resolved into a single-sampled target before it can be sampled.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Target
+    {
+        uint  frameBuffer;  ///< Framebuffer object
+        uint  colorBuffer;  ///< Texture or multisampled renderbuffer
+        uint  depthBuffer;  ///< Depth/stencil renderbuffer; zero if none
+        QSize size;         ///< Size of all attachments
+        int   samples;      ///< Zero if single-sampled
+        bool  depthStencil; ///< Has a depth/stencil attachment?
+        int   idleFrames;   ///< Frames spent in the pool
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves an unused target with the given properties. Creates a new
+    /// one if there is none in the pool. The contents are undefined.
+    ///
+    /// \param size Size of the target.
+    /// \param samples Sample count; zero for a single-sampled target. Clamped
+    ///        to the maximum the driver supports.
+    /// \param depthStencil True to attach a depth/stencil buffer.
+    /// \returns the target; nullptr if it could not be created.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static Target* acquire(const QSize& size, int samples, bool depthStencil);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Gives the target back to the pool. It must not be used anymore.
+    ///
+    /// \param target Target retrieved by acquire(); may be nullptr.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void release(Target* target);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys targets that have not been acquired for a while, e.g. after
+    /// a window has been resized. Called once per frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void collect();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the approximate video memory of all targets, including the
+    /// ones currently acquired.
+    ///
+    /// \returns the memory usage in bytes.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static qint64 memoryUsage();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys all pooled targets. Acquired targets stay alive until they
+    /// are released. Requires the render context to be current.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    static Target* create(const QSize& size, int samples, bool depthStencil);
+    static void destroy(Target* target);
+    static qint64 bytes(const Target* target);
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+#endif
@@ -0,0 +1,131 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_BASE_TEXTCACHE_HPP
+#define CRANBERRY_GRAPHICS_BASE_TEXTCACHE_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QSize>
+#include <QString>
+
+// Forward declarations
+CRANBERRY_FORWARD_Q(QOpenGLFramebufferObject)
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Caches text measurements and rasterized text process-wide. Texts with the
+/// same key share one framebuffer. Framebuffers are allocated in power of two
+/// size classes and recycled once no text uses them anymore. Must only be
+/// used from the thread that renders.
+///
+/// \class TextCache
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class TextCache final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// A rasterized text, shared by all texts with the same key.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        QString                   key;  ///< Raster key of the text
+        QOpenGLFramebufferObject* fbo;  ///< Holds the text in its top-left
+        QSize                     size; ///< Size of the text within the fbo
+        int                       refs; ///< Amount of texts using this entry
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Looks up a previous measurement.
+    ///
+    /// \param key Layout key of the text.
+    /// \param size Receives the size, if any.
+    /// \returns true if the text was measured before.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static bool findSize(const QString& key, QSizeF* size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Remembers a measurement. Old measurements are evicted when the cache
+    /// is full.
+    ///
+    /// \param key Layout key of the text.
+    /// \param size Measured size.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void insertSize(const QString& key, const QSizeF& size);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the entry for \p key and increases its reference count. If
+    /// there is none yet, a new entry is created with a framebuffer of at
+    /// least \p size, and \p created is set to true; the caller must then
+    /// rasterize the text into it.
+    ///
+    /// \param key Raster key of the text.
+    /// \param size Size of the text.
+    /// \param created Receives whether the entry is new.
+    /// \returns the entry; nullptr if no framebuffer could be created.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static Entry* acquire(const QString& key, const QSize& size, bool* created);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Decreases the reference count of the entry for \p key. Recycles its
+    /// framebuffer once it is not used anymore. Does nothing if the cache was
+    /// cleared in the meantime.
+    ///
+    /// \param key Raster key passed to acquire().
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void release(const QString& key);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys all framebuffers. Requires the render context to be current.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    static QSize sizeClass(const QSize& size);
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+#endif
@@ -25,19 +25,23 @@
 
 
 // Cranberry headers
+#include <Cranberry/Graphics/Base/Enumerations.hpp>
 #include <Cranberry/Graphics/Base/TextureBase.hpp>
 
 // Qt headers
 #include <QRectF>
 #include <QVector>
 
+// Forward declarations
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
+
 
 CRANBERRY_BEGIN_NAMESPACE
 
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Defines a texture atlas that holds multiple textures in one big texture.
-/// Algorithm based on code from Jukka Jylänki with some adjustments.
+/// Algorithms based on code from Jukka Jylänki with some adjustments.
 ///
 /// \class TextureAtlas
 /// \author Nicolas Kogler
@@ -59,9 +63,14 @@ public:
     ///
     /// \param size Size of the texture, in pixels.
     /// \param renderTarget Target to render atlas on.
+    /// \param method Algorithm to find a place for new images.
     ///
     ////////////////////////////////////////////////////////////////////////////
-    TextureAtlas(int size, Window* renderTarget = nullptr);
+    TextureAtlas(
+            int size,
+            Window* renderTarget = nullptr,
+            PackingMethod method = PackMaxRects
+            );
 
     ////////////////////////////////////////////////////////////////////////////
     /// Initializes the texture atlas with an image.
@@ -73,7 +82,9 @@ public:
     TextureAtlas(const QImage& img, Window* renderTarget = nullptr);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Inserts a new image into the texture atlas.
+    /// Inserts a new image into the texture atlas. The pixels are staged in a
+    /// pixel buffer object, so that the transfer to the texture does not stall
+    /// the caller. Images that already are in RGBA8888 format are not copied.
     ///
     /// \param img Image to insert.
     /// \returns true if image could be inserted.
@@ -81,6 +92,19 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool insert(const QImage& img);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Inserts multiple images at once. The images are inserted from the
+    /// largest to the smallest one, which packs them a lot tighter than
+    /// inserting them in arbitrary order.
+    ///
+    /// \param images Images to insert.
+    /// \param rects Receives the rectangle of each image, in the order of
+    ///        \p images. Images that did not fit receive a null rectangle.
+    /// \returns the amount of images inserted.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int insert(const QVector<QImage>& images, QVector<QRect>& rects);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Determines whether another image could be inserted into the atlas.
     /// Rule of thumb: If 90% of the space is occupied, do not allow insertion.
@@ -90,6 +114,33 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool canInsert() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether an image of the given size fits into the atlas.
+    ///
+    /// \param size Size of the image.
+    /// \returns true if the image fits.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool canInsert(const QSize& size) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of the atlas covered by images, from 0 to 1.
+    ///
+    /// \returns the occupancy.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    qreal occupancy() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of the area spanned by all images that is covered
+    /// by them, from 0 to 1. Tells how tightly the images are packed,
+    /// regardless of how full the atlas is.
+    ///
+    /// \returns the packing efficiency.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    qreal efficiency() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the rectangle inserted the last.
     ///
@@ -117,26 +168,45 @@ public:
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct SkylineNode
+    {
+        int x;     ///< Left edge of the segment
+        int y;     ///< Height of the skyline at the segment
+        int width; ///< Width of the segment
+    };
+
     ////////////////////////////////////////////////////////////////////////////
     // Functions
     ////////////////////////////////////////////////////////////////////////////
-    void merge();
-    void split(const QRect& free, const QRect& used);
+    void place(const QRect& rc, int index);
+    void placeMaxRects(const QRect& rc);
+    void placeSkyline(const QRect& rc, int index);
+    void prune(int firstNew);
     void drawIntoTexture(QImage img, const QRect& src);
-    int score(int width, int height, const QRect& free);
-    QRect find(int width, int height, int& index);
+    bool fitsSkyline(int index, int width, int height, int& y) const;
+    QRect find(int width, int height, int& index) const;
+    QRect findMaxRects(int width, int height, int& index) const;
+    QRect findSkyline(int width, int height, int& index) const;
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    QOpenGLFunctions* gl;
-    QVector<QRect>    m_used;
-    QVector<QRect>    m_free;
-    qint32            m_size;
-    qint64            m_usedSpace;
-    qreal             m_occupancy;
-    quint32           m_texId;
-    TextureBase*      m_texture;
+    QOpenGLFunctions*    gl;
+    QVector<QRect>       m_used;
+    QVector<QRect>       m_free;
+    QVector<SkylineNode> m_skyline;
+    QRect                m_bounds;
+    PackingMethod        m_method;
+    qint32               m_size;
+    qint64               m_usedSpace;
+    qreal                m_occupancy;
+    quint32              m_texId;
+    TextureBase*         m_texture;
+    QOpenGLBuffer*       m_pixelBuffer;
+    bool                 m_usePixelBuffer;
 };
 
 
@@ -148,11 +218,14 @@ private:
 /// useful for classes that need to make heavy use of caching (e.g. text glyphs).
 ///
 /// \code
-/// TextureAtlas atlas;
-/// while (atlas.canInsert())
+/// TextureAtlas atlas(2048, this);
+/// QVector<QRect> rects;
+/// if (atlas.insert(myImages, rects) < myImages.size())
 /// {
-///     atlas.insert(myImages.takeFirst());
+///     // Insert the remaining images into another atlas.
 /// }
+///
+/// qDebug() << "Packed with" << atlas.efficiency() * 100 << "% efficiency";
 /// \endcode
 ///
 ////////////////////////////////////////////////////////////////////////////////
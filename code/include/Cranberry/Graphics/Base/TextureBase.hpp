@@ -27,6 +27,7 @@
 // Cranberry headers
 #include <Cranberry/Graphics/Base/Enumerations.hpp>
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
 #include <Cranberry/OpenGL/OpenGLVertex.hpp>
 
 // Forward declarations and aliases
@@ -64,7 +65,25 @@ public:
     QOpenGLTexture* texture() const;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies the region of the object to be rendered.
+    /// Retrieves the blend mode this object is rendered with.
+    ///
+    /// \returns the blending modes.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    BlendModes blendMode() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the effect this object is rendered with.
+    ///
+    /// \returns the effect.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    Effect effect() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the region of the object to be rendered. Moving a region of
+    /// the same size only changes a shader uniform; the vertices are written
+    /// again if the size changes or the shader lacks u_uvOffset.
     ///
     /// \param rc Region to render.
     ///
@@ -150,6 +169,7 @@ public overridden:
     /// In addition to creating IRenderable, stores the texture and creates
     /// the vertex  buffer. Takes ownership of the texture and deletes it as
     /// soon as this instance is destroyed, therefore allocate it on the heap.
+    /// Textures acquired from the TextureCache are released instead.
     ///
     /// \param img The heap-allocated QOpenGLTexture to use.
     /// \param renderTarget Target to render texture on.
@@ -177,6 +197,14 @@ public overridden:
     ////////////////////////////////////////////////////////////////////////////
     virtual void render() override;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the id of the underlying texture.
+    ///
+    /// \returns the texture id; 0 if not created.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    virtual uint textureId() const override;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the root model item of this instance.
     ///
@@ -220,6 +248,9 @@ protected overridable:
     // Virtual functions
     ////////////////////////////////////////////////////////////////////////////
     virtual bool initializeData();
+    virtual void modifyAttribs();
+    virtual void drawElements();
+    virtual TextureCache::Options textureOptions() const;
 
     ////////////////////////////////////////////////////////////////////////////
     // Protected functions
@@ -235,13 +266,13 @@ private:
     // Functions
     ////////////////////////////////////////////////////////////////////////////
     bool createBuffers();
-    bool createTexture(const QImage& img);
+    bool createTexture(const QString& path);
+    OpenGLShader* selectProgram();
     void bindObjects();
     void releaseObjects();
     void writeVertices();
+    void writeSourceRectangle();
     void modifyProgram();
-    void modifyAttribs();
-    void drawElements();
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
@@ -251,10 +282,15 @@ private:
     BlendModes         m_blendMode;
     Effect             m_effect;
     QRectF             m_sourceRect;
+    QRectF             m_vertexRect;
+    QPointF            m_uvOffset;
     QOpenGLTexture*    m_texture;
     QOpenGLBuffer*     m_vertexBuffer;
     QOpenGLBuffer*     m_indexBuffer;
+    OpenGLShader*      m_program;
+    OpenGLShader*      m_variantBase;
     bool               m_update;
+    bool               m_variantDirty;
 };
 
 
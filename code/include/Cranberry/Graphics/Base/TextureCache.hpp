@@ -0,0 +1,261 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_BASE_TEXTURECACHE_HPP
+#define CRANBERRY_GRAPHICS_BASE_TEXTURECACHE_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QList>
+#include <QOpenGLTexture>
+#include <QString>
+
+// Forward declarations
+CRANBERRY_FORWARD_Q(QImage)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Shares textures between all objects that load the same image with the
+/// same options. Textures are reference counted; unreferenced textures stay
+/// resident until the memory budget is exceeded. Must only be used from the
+/// thread that renders.
+///
+/// \class TextureCache
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT TextureCache final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies how a texture is sampled. Part of the cache key.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Options
+    {
+        QOpenGLTexture::Filter   filter   = QOpenGLTexture::Linear;
+        QOpenGLTexture::WrapMode wrapMode = QOpenGLTexture::ClampToEdge;
+        bool                     mipmaps  = false;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Counters for the lifetime of the cache.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        quint64 hits;            ///< Requests served by an existing texture
+        quint64 misses;          ///< Requests that created a texture
+        quint64 evictions;       ///< Unreferenced textures destroyed
+        qint64  residentBytes;   ///< Estimated video memory in use
+        int     residentCount;   ///< Textures currently alive
+        int     referencedCount; ///< Textures currently in use
+    };
+
+    CRANBERRY_DECLARE_CTOR(TextureCache)
+    CRANBERRY_DECLARE_DTOR(TextureCache)
+    CRANBERRY_DISABLE_COPY(TextureCache)
+    CRANBERRY_DISABLE_MOVE(TextureCache)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the cache shared by all windows.
+    ///
+    /// \returns the shared cache.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static TextureCache* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the texture of the image at \p path and increases its
+    /// reference count. Paths pointing to the same file share the texture.
+    ///
+    /// \param path Path to the image.
+    /// \param options Sampling options.
+    /// \returns the texture; nullptr if the image could not be loaded.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QOpenGLTexture* acquire(const QString& path, const Options& options = Options());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the texture of \p img and increases its reference count.
+    /// Copies of the same QImage share the texture. Unlike textures loaded
+    /// from a path, these are destroyed as soon as they are not used anymore.
+    ///
+    /// \param img Image to upload.
+    /// \param options Sampling options.
+    /// \returns the texture; nullptr if the image is null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QOpenGLTexture* acquire(const QImage& img, const Options& options = Options());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Hands a texture that was created by upload() over to the cache, as if
+    /// it was loaded from \p path, and increases its reference count. If the
+    /// cache already holds that image, \p texture is deleted and the existing
+    /// one is returned instead.
+    ///
+    /// \param path Path the texture was loaded from.
+    /// \param texture Texture created by upload().
+    /// \param options Options passed to upload().
+    /// \returns the shared texture.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QOpenGLTexture* adopt(
+            const QString& path,
+            QOpenGLTexture* texture,
+            const Options& options = Options()
+            );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates a texture the same way the cache does, without registering it.
+    /// May be called on any thread whose current context shares resources
+    /// with the render context. Does not report errors.
+    ///
+    /// \param img Image to upload.
+    /// \param options Sampling options.
+    /// \returns the texture; nullptr if it could not be created.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static QOpenGLTexture* upload(const QImage& img, const Options& options = Options());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Decreases the reference count of \p texture.
+    ///
+    /// \param texture Texture retrieved by acquire().
+    /// \returns false if \p texture is not managed by this cache.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool release(QOpenGLTexture* texture);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether \p texture is shared through this cache. Shared
+    /// textures must not be modified, e.g. by changing their wrap mode;
+    /// acquire them with other options instead.
+    ///
+    /// \param texture Texture to look up.
+    /// \returns true if managed by this cache.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool contains(QOpenGLTexture* texture) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the memory budget, in bytes.
+    ///
+    /// \returns the budget.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    qint64 budget() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the memory budget. Whenever the resident textures exceed it,
+    /// the least recently used unreferenced textures are destroyed. Textures
+    /// that are in use are never destroyed.
+    ///
+    /// \param bytes New budget, in bytes.
+    /// \default 256 MiB
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setBudget(qint64 bytes);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the current statistics.
+    ///
+    /// \returns the statistics.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    Statistics statistics() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys all unreferenced textures. Requires the context the textures
+    /// were created in to be current.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        QString         key;        ///< Path or image key plus options
+        QOpenGLTexture* texture;    ///< Shared texture
+        qint64          bytes;      ///< Estimated size in video memory
+        int             refs;       ///< Amount of users
+        bool            persistent; ///< Can be reloaded, thus kept resident
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    QOpenGLTexture* lookup(const QString& key);
+    QOpenGLTexture* insert(const QString& key, QOpenGLTexture* texture, const Options& options, bool persistent);
+    void evict(Entry* entry);
+    void enforceBudget();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QHash<QString, Entry*>         m_entries;  ///< Entries by key
+    QHash<QOpenGLTexture*, Entry*> m_textures; ///< Entries by texture
+    QList<Entry*>                  m_unused;   ///< Unreferenced, oldest first
+    Statistics                     m_stats;    ///< Counters
+    qint64                         m_budget;   ///< Memory budget, in bytes
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TextureCache
+/// \ingroup Graphics
+///
+/// TextureBase, TextureAtlas, MapTileset and Tilemap load their images
+/// through this cache, thus 500 sprites showing "enemy.png" share a single
+/// texture. Textures passed to TextureBase::create() may also be acquired
+/// from the cache; they are released instead of deleted on destruction.
+///
+/// \code
+/// TextureCache* cache = TextureCache::instance();
+/// cache->setBudget(128 * 1024 * 1024);
+///
+/// TextureCache::Statistics s = cache->statistics();
+/// qDebug() << s.hits << "hits," << s.misses << "misses,"
+///          << s.residentBytes / 1024 << "KiB resident";
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -93,6 +93,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isFading() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object may be updated in parallel with other
+    /// objects.
+    ///
+    /// \returns true if thread-safe.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isThreadSafe() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the X-position of the object.
     ///
@@ -472,6 +481,18 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setOpacity(float opacity);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether this object may be updated in parallel with other
+    /// objects by engine containers. Only enable this if the update touches
+    /// neither shared state nor OpenGL and no slot is connected to the signals
+    /// it emits.
+    ///
+    /// \param threadSafe True to allow parallel updates.
+    /// \default false
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setThreadSafe(bool threadSafe);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the position of the object.
     ///
@@ -743,6 +764,7 @@ private:
     bool                 m_isScalingX;
     bool                 m_isScalingY;
     bool                 m_isFading;
+    bool                 m_isThreadSafe;
     float                m_speedMoveX;
     float                m_speedMoveY;
     float                m_speedRotateX;
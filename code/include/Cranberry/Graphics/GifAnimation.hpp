@@ -48,6 +48,19 @@ public:
     CRANBERRY_DISABLE_COPY(GifAnimation)
     CRANBERRY_DISABLE_MOVE(GifAnimation)
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the animation without blocking the game loop. The file is
+    /// decoded on a worker thread and the frames are uploaded over the next
+    /// calls to update(). AnimationBaseEmitter::readyAnimation() is emitted
+    /// once the animation can be rendered.
+    ///
+    /// \param path Path to a *.gif file.
+    /// \param renderTarget Target to render animation on.
+    /// \returns true if loading was started.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool createAsync(const QString& path, Window* renderTarget = nullptr);
+
 
 public overridden:
 
@@ -81,6 +94,14 @@ public overridden:
 /// gif.render();
 /// \endcode
 ///
+/// Big files should be loaded asynchronously, to not freeze the game:
+///
+/// \code
+/// QObject::connect(gif.signals(), &AnimationBaseEmitter::readyAnimation,
+///                  [&] { gif.beginAnimation(AnimateForever); });
+/// gif.createAsync(":/anims/big.gif", this);
+/// \endcode
+///
 ////////////////////////////////////////////////////////////////////////////////
 
 
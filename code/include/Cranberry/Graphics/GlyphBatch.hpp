@@ -0,0 +1,224 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_GLYPHBATCH_HPP
+#define CRANBERRY_GRAPHICS_GLYPHBATCH_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
+
+// Qt headers
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(GlyphText)
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Draws any amount of GlyphText labels from the shared glyph atlas, using
+/// one draw call per atlas page.
+///
+/// \class GlyphBatch
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT GlyphBatch : public RenderBase
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(GlyphBatch)
+    CRANBERRY_DECLARE_DTOR(GlyphBatch)
+    CRANBERRY_DISABLE_COPY(GlyphBatch)
+    CRANBERRY_DISABLE_MOVE(GlyphBatch)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the width of the outline, in pixels of a glyph drawn at
+    /// GlyphAtlas::baseSize(). The outline scales along with the font size.
+    ///
+    /// \returns the outline width.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float outlineWidth() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the blur factor, in pixels of a glyph drawn at the base size.
+    ///
+    /// \returns the blur factor.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float blurFactor() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves all texts drawn by this batch.
+    ///
+    /// \returns the texts.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QVector<GlyphText*>& texts() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the width of the outline of all texts. Limited to
+    /// GlyphAtlas::spread(). Zero disables the outline.
+    ///
+    /// \param width New outline width.
+    /// \default 0
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setOutlineWidth(float width);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies how far the edges of all texts are smoothed. Zero gives
+    /// sharp, anti-aliased edges.
+    ///
+    /// \param factor New blur factor.
+    /// \default 0
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setBlurFactor(float factor);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds the given text to this batch. Does not take ownership.
+    ///
+    /// \param text Text to draw.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void addText(GlyphText* text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the given text from this batch.
+    ///
+    /// \param text Text to remove.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void removeText(GlyphText* text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes all texts from this batch.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+public overridden:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the buffers of this batch.
+    ///
+    /// \param renderTarget Target to render on.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(Window* renderTarget = nullptr) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys the buffers of this batch.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates this batch and the transformations of all texts.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update(const GameTime& time) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Renders all texts.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void render() override;
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    bool writeVertices();
+    void modifyProgram();
+    void modifyAttribs();
+    void drawPages();
+    void releaseObjects();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<GlyphText*>            m_texts;        ///< Texts to draw
+    QVector<priv::GlyphVertices>   m_pages;        ///< Quads per atlas page
+    priv::GlyphVertices            m_vertices;     ///< Quads of all pages
+    QVector<int>                   m_pageOffsets;  ///< First quad per page
+    QOpenGLBuffer*                 m_vertexBuffer; ///< Holds all quads
+    QOpenGLBuffer*                 m_indexBuffer;  ///< Holds quad indices
+    int                            m_indexQuads;   ///< Quads in index buffer
+    float                          m_outlineWidth; ///< Outline width
+    float                          m_blurFactor;   ///< Blur factor
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class GlyphBatch
+/// \ingroup Graphics
+///
+/// All labels of a HUD should be added to one batch. Every frame, the batch
+/// collects the glyph quads of its texts into one vertex buffer and draws
+/// them with the cb.glsl.sdftext shader. Outline and blur are computed from
+/// the distance field in the shader, thus changing them costs nothing.
+///
+/// \code
+/// m_hud = new GlyphBatch;
+/// m_hud->create(this);
+/// m_hud->setOutlineWidth(2.0f);
+/// m_hud->addText(m_score);
+/// m_hud->addText(m_health);
+///
+/// // in update
+/// m_score->setText(QString("Score: %0").arg(m_points));
+/// m_hud->update(time);
+///
+/// // in render
+/// m_hud->render();
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
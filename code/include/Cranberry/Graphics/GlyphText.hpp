@@ -0,0 +1,197 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_GLYPHTEXT_HPP
+#define CRANBERRY_GRAPHICS_GLYPHTEXT_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/TransformBase.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
+#include <Cranberry/System/GameTime.hpp>
+
+// Qt headers
+#include <QColor>
+#include <QFont>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Defines a label that is drawn by a GlyphBatch. Holds no OpenGL resources;
+/// its glyphs are taken from the shared GlyphAtlas.
+///
+/// \class GlyphText
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT GlyphText : public TransformBase
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(GlyphText)
+    CRANBERRY_DEFAULT_DTOR(GlyphText)
+    CRANBERRY_DISABLE_COPY(GlyphText)
+    CRANBERRY_DISABLE_MOVE(GlyphText)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the text.
+    ///
+    /// \returns the text.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QString& text() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the font.
+    ///
+    /// \returns the font.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QFont& font() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the fill color.
+    ///
+    /// \returns the fill color.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QColor& color() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the outline color.
+    ///
+    /// \returns the outline color.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QColor& outlineColor() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the text. Line breaks start a new line.
+    ///
+    /// \param text New text.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setText(const QString& text);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the font. Any size is drawn from the same atlas glyphs.
+    ///
+    /// \param font New font.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setFont(const QFont& font);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the fill color.
+    ///
+    /// \param color New fill color.
+    /// \default Qt::white
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setColor(const QColor& color);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the outline color. The outline width is specified by the
+    /// batch that draws this text.
+    ///
+    /// \param color New outline color.
+    /// \default Qt::black
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setOutlineColor(const QColor& color);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates the transformations of this text. Called by the batch.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update(const GameTime& time);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends the transformed glyph quads of this text to \p pages, one
+    /// vertex list per atlas page. Lays out the text first if it changed.
+    ///
+    /// \param pages Vertex lists to append to.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void appendQuads(QVector<priv::GlyphVertices>& pages);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct LayoutGlyph
+    {
+        QRectF rect; ///< Quad in local coordinates
+        QRectF uv;   ///< Texture coordinates
+        int    page; ///< Atlas page
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void layout();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<LayoutGlyph> m_glyphs;       ///< Laid out glyphs
+    QString              m_text;         ///< Text to draw
+    QFont                m_font;         ///< Font to draw with
+    QColor               m_color;        ///< Fill color
+    QColor               m_outlineColor; ///< Outline color
+    bool                 m_layoutUpdate; ///< Text or font changed
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class GlyphText
+/// \ingroup Graphics
+///
+/// Unlike Text, a GlyphText does not render into its own framebuffer. Any
+/// amount of labels can be added to one GlyphBatch, which draws them all at
+/// once. Changing the text only lays out the glyphs again.
+///
+/// \code
+/// m_score = new GlyphText;
+/// m_score->setFont(QFont("Arial", 24));
+/// m_score->setText("Score: 0");
+/// m_score->setPosition(16, 16);
+/// m_hud->addText(m_score);
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -0,0 +1,343 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_PARTICLESYSTEM_HPP
+#define CRANBERRY_GRAPHICS_PARTICLESYSTEM_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/TextureBase.hpp>
+#include <Cranberry/System/Random.hpp>
+
+// Qt headers
+#include <QGradientStops>
+#include <QPointF>
+#include <QSizeF>
+#include <QVector>
+
+// Standard headers
+#include <vector>
+
+// Forward declarations
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
+CRANBERRY_FORWARD_Q(QOpenGLExtraFunctions)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Simulates up to a fixed budget of particles, all sharing one texture, and
+/// draws all of them with a single instanced draw call.
+///
+/// \class ParticleSystem
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT ParticleSystem : public TextureBase
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Describes how and which particles are emitted. Angles are in degrees,
+    /// positions are relative to the particle system.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Emitter
+    {
+        Emitter();
+
+        QPointF          position;     ///< Center of the spawn area
+        QSizeF           area;         ///< Size of the spawn area
+        float            rate;         ///< Particles per second
+        int              burst;        ///< Particles emitted by burst()
+        float            minLife;      ///< Minimum lifetime in seconds
+        float            maxLife;      ///< Maximum lifetime in seconds
+        float            minSpeed;     ///< Minimum speed in pixels per second
+        float            maxSpeed;     ///< Maximum speed in pixels per second
+        float            direction;    ///< Direction of the emission
+        float            spread;       ///< Deviation from the direction
+        float            minSpin;      ///< Minimum degrees per second
+        float            maxSpin;      ///< Maximum degrees per second
+        QPointF          acceleration; ///< Gravity, wind, etc.
+        QGradientStops   colors;       ///< Color over the normalized age
+        QVector<QPointF> sizes;        ///< Scale (y) over the normalized age (x)
+    };
+
+    CRANBERRY_DECLARE_CTOR(ParticleSystem)
+    CRANBERRY_DECLARE_DTOR(ParticleSystem)
+    CRANBERRY_DISABLE_COPY(ParticleSystem)
+    CRANBERRY_DISABLE_MOVE(ParticleSystem)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of particles alive at once.
+    ///
+    /// \returns the particle budget.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int capacity() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of particles that are currently alive.
+    ///
+    /// \returns the particle count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int count() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of emitters.
+    ///
+    /// \returns the emitter count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int emitterCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the emitter at \p index.
+    ///
+    /// \param index Index of the emitter.
+    /// \returns the emitter.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const Emitter& emitter(int index) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the emitters continuously emit particles.
+    ///
+    /// \returns true if emitting.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isEmitting() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the particles are added onto the scene rather than
+    /// blended over it.
+    ///
+    /// \returns true if additive.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isAdditive() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the maximum amount of particles alive at once. All memory is
+    /// allocated up front; emissions that exceed the budget are dropped.
+    ///
+    /// \param capacity Particle budget.
+    /// \default 10000
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setCapacity(int capacity);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the emitters continuously emit particles. Bursts are
+    /// emitted regardless.
+    ///
+    /// \param emitting True to emit particles at their rates.
+    /// \default true
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setEmitting(bool emitting);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the particles are added onto the scene, which suits
+    /// fire, sparks and magic. This is independent of the blend mode, which
+    /// combines the texture with the particle color.
+    ///
+    /// \param additive True to add the particles onto the scene.
+    /// \default false
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setAdditive(bool additive);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds an emitter. Its color and size curves are sampled once, so the
+    /// cost of a particle does not depend on the amount of curve points.
+    ///
+    /// \param emitter Emitter to add.
+    /// \returns the index of the emitter.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int addEmitter(const Emitter& emitter);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Replaces the emitter at \p index. Particles that are already alive
+    /// take on the new curves.
+    ///
+    /// \param index Index of the emitter.
+    /// \param emitter New emitter.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setEmitter(int index, const Emitter& emitter);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes all emitters and kills all particles.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clearEmitters();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Emits Emitter::burst particles from the emitter at \p index at once.
+    ///
+    /// \param index Index of the emitter.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void burst(int index);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Emits \p count particles from the emitter at \p index at once.
+    ///
+    /// \param index Index of the emitter.
+    /// \param count Amount of particles.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void burst(int index, int count);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Kills all particles.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+public overridden:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys the instance buffer and the texture.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Emits new particles, advances all living particles by the delta time
+    /// and kills those that exceeded their lifetime. Large systems are
+    /// simulated on the JobSystem.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update(const GameTime& time) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Renders all living particles with one instanced draw call.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void render() override;
+
+
+protected overridden:
+
+    bool initializeData() override;
+    void modifyAttribs() override;
+    void drawElements() override;
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Particles
+    {
+        std::vector<float> x, y;   ///< Position
+        std::vector<float> vx, vy; ///< Velocity
+        std::vector<float> ax, ay; ///< Acceleration
+        std::vector<float> angle;  ///< Rotation in radians
+        std::vector<float> spin;   ///< Radians per second
+        std::vector<float> age;    ///< Seconds since emission
+        std::vector<float> rcp;    ///< Reciprocal of the lifetime
+        std::vector<int>   curve;  ///< Offset of the emitter curves
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void sampleCurves(int index);
+    void spawn(int index, int count);
+    void kill();
+    void simulate(int begin, int end, float dt);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    Particles              m_particles;      ///< Simulation data, one array each
+    std::vector<float>     m_instances;      ///< Per-instance data for the GPU
+    std::vector<float>     m_colorCurves;    ///< Sampled colors of all emitters
+    std::vector<float>     m_sizeCurves;     ///< Sampled sizes of all emitters
+    std::vector<float>     m_random;         ///< Random numbers for spawning
+    QVector<Emitter>       m_emitters;       ///< All emitters
+    QVector<float>         m_pending;        ///< Fractional particles per emitter
+    QOpenGLBuffer*         m_instanceBuffer; ///< Streams the instance data
+    QOpenGLExtraFunctions* egl;              ///< Instanced drawing
+    Random                 m_rng;            ///< Randomizes new particles
+    int                    m_capacity;       ///< Particle budget
+    int                    m_count;          ///< Living particles
+    int                    m_drawCount;      ///< Particles in m_instances
+    bool                   m_emitting;       ///< Emitting at the rates?
+    bool                   m_additive;       ///< Additive blending?
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class ParticleSystem
+/// \ingroup Graphics
+///
+/// The particles are stored as one array per attribute, so that the update
+/// loops run over contiguous floats and can be vectorized by the compiler.
+/// The color and size curves are sampled into small tables when an emitter is
+/// added. The texture is drawn with the color of the particle according to
+/// the blend mode, which defaults to BlendMultiply; the alpha of the color
+/// always fades the particle.
+///
+/// \code
+/// ParticleSystem::Emitter sparks;
+/// sparks.rate = 2000.0f;
+/// sparks.direction = -90.0f;
+/// sparks.spread = 30.0f;
+/// sparks.acceleration = QPointF(0, 400);
+/// sparks.colors = { { 0.0, Qt::yellow }, { 1.0, QColor(255, 0, 0, 0) } };
+/// sparks.sizes = { { 0.0, 1.0 }, { 1.0, 0.2 } };
+///
+/// m_sparks = new ParticleSystem;
+/// m_sparks->create(":/img/spark.png", this);
+/// m_sparks->setCapacity(50000);
+/// m_sparks->setAdditive(true);
+/// m_sparks->addEmitter(sparks);
+/// m_sparks->setPosition(400, 300);
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
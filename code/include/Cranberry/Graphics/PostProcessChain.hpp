@@ -0,0 +1,310 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_POSTPROCESSCHAIN_HPP
+#define CRANBERRY_GRAPHICS_POSTPROCESSCHAIN_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/Enumerations.hpp>
+#include <Cranberry/Graphics/Base/RenderBase.hpp>
+
+// Qt headers
+#include <QColor>
+#include <QList>
+#include <QSize>
+#include <QVector>
+
+// Standard headers
+#include <functional>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(OpenGLShader)
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
+CRANBERRY_FORWARD_Q(QOpenGLFramebufferObject)
+CRANBERRY_FORWARD_Q(QOpenGLTimeMonitor)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Renders multiple objects once and runs an ordered list of shader passes
+/// over the result, using two ping-pong textures per pass resolution.
+///
+/// \class PostProcessChain
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT PostProcessChain final : public RenderBase
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the custom uniforms of a pass. Called every frame, after the
+    /// program has been bound.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    using PassSetup = std::function<void(OpenGLShader*)>;
+
+    CRANBERRY_DECLARE_CTOR(PostProcessChain)
+    CRANBERRY_DECLARE_DTOR(PostProcessChain)
+    CRANBERRY_DISABLE_COPY(PostProcessChain)
+    CRANBERRY_DISABLE_MOVE(PostProcessChain)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the background color of the scene.
+    ///
+    /// \returns the background color.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QColor& backgroundColor() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of passes.
+    ///
+    /// \returns the pass count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int passCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the GPU time of the passes can be measured. Timer
+    /// queries are not available on OpenGL ES.
+    ///
+    /// \returns true if passTime() reports measurements.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isTimingSupported() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the GPU time that the pass \p index took, in milliseconds.
+    /// The measurement lags a few frames behind, in order not to stall.
+    ///
+    /// \param index Index of the pass.
+    /// \returns the GPU time; -1 if not measured (yet).
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float passTime(int index) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the GPU time of all passes, in milliseconds.
+    ///
+    /// \returns the total GPU time; -1 if not measured (yet).
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float totalTime() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the background color of the scene. Setting this to QColor()
+    /// results in the clear color of the render target.
+    ///
+    /// \param color Background color.
+    /// \default Qt::transparent
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setBackgroundColor(const QColor& color);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds a new renderable object and puts it at the end of the list.
+    ///
+    /// \param object Object to add to the scene.
+    /// \returns false if that object already exists.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool addObject(RenderBase* object);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes the given object from the scene.
+    ///
+    /// \param object Object to remove.
+    /// \returns false if that object does not exist.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool removeObject(RenderBase* object);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends a pass. The program samples the output of the previous pass
+    /// from u_tex and the unprocessed scene from u_scene. u_winSize holds the
+    /// size of the texture in u_tex. The last pass is drawn onto the render
+    /// target, regardless of its resolution.
+    ///
+    /// \param program Program of the pass. Not owned by the chain.
+    /// \param resolution Size of the texture the pass renders into.
+    /// \param setup Specifies custom uniforms, if any.
+    /// \returns the index of the pass.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int addPass(
+        OpenGLShader* program,
+        PassResolution resolution = ResolutionFull,
+        const PassSetup& setup = PassSetup()
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends a separable gaussian blur; one horizontal and one vertical
+    /// pass. Blurring at a lower resolution widens the blur for free.
+    ///
+    /// \param radius Distance between the samples, in texels.
+    /// \param resolution Resolution of both passes.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void addBlur(float radius = 1.0f, PassResolution resolution = ResolutionHalf);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends a bloom: extracts the bright parts of the previous pass,
+    /// blurs them at half resolution and adds them to the scene.
+    ///
+    /// \param threshold Brightness at which pixels start to glow.
+    /// \param intensity Strength of the glow.
+    /// \param radius Blur radius, in texels of the half resolution.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void addBloom(float threshold = 0.8f, float intensity = 1.0f, float radius = 1.5f);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes all passes. The scene is then drawn unprocessed.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clearPasses();
+
+
+public overridden:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object is null.
+    ///
+    /// \returns true if this chain is null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the vertex buffer and the scene targets.
+    ///
+    /// \param renderTarget Target to render on.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(Window* renderTarget = nullptr) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys all targets and buffers.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates all objects in the scene.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update(const GameTime& time) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Renders all objects and runs all passes.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void render() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the revision of this chain, which includes the revisions of
+    /// all of its objects.
+    ///
+    /// \returns the revision.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 revision() const override;
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Pass
+    {
+        OpenGLShader*  program;    ///< Program to run
+        PassSetup      setup;      ///< Specifies custom uniforms
+        PassResolution resolution; ///< Size of the output
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    bool createTargets();
+    void destroyTargets();
+    void destroyMonitor();
+    QOpenGLFramebufferObject* target(PassResolution res, QOpenGLFramebufferObject* input);
+    void renderScene();
+    void runPasses();
+    auto drawPass(const Pass&, QOpenGLFramebufferObject*, bool) -> QOpenGLFramebufferObject*;
+    bool beginTiming();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QList<RenderBase*>        m_objects;       ///< Objects of the scene
+    QVector<Pass>             m_passes;        ///< Passes, in order
+    QVector<float>            m_passTimes;     ///< Last GPU times per pass
+    QOpenGLFramebufferObject* m_msScene;       ///< Multisampled scene
+    QOpenGLFramebufferObject* m_scene;         ///< Resolved scene
+    QOpenGLFramebufferObject* m_targets[3][2]; ///< Ping-pong per resolution
+    QOpenGLBuffer*            m_vertexBuffer;  ///< Holds both quads
+    QOpenGLTimeMonitor*       m_monitor;       ///< Measures the passes
+    QColor                    m_backColor;     ///< Scene background
+    QSize                     m_size;          ///< Size of the targets
+    bool                      m_timing;        ///< Measurement in flight?
+    bool                      m_noTiming;      ///< Timer queries missing?
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class PostProcessChain
+/// \ingroup Graphics
+///
+/// Unlike nested SpriteBatch objects, a chain only renders its scene into
+/// one multisampled target. Every pass then reads the output of the previous
+/// one, so any amount of effects costs two textures per resolution.
+///
+/// \code
+/// m_chain = new PostProcessChain;
+/// m_chain->create(this);
+/// m_chain->addObject(m_tilemap);
+/// m_chain->addObject(m_player);
+/// m_chain->addBloom(0.7f, 1.2f);
+/// m_chain->addPass(OpenGLDefaultShaders::get("cb.glsl.film"));
+///
+/// // in render
+/// m_chain->render();
+/// qDebug() << "bloom extract:" << m_chain->passTime(0) << "ms";
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
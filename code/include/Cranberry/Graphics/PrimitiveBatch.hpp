@@ -0,0 +1,268 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GRAPHICS_PRIMITIVEBATCH_HPP
+#define CRANBERRY_GRAPHICS_PRIMITIVEBATCH_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
+
+// Qt headers
+#include <QColor>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Draws lines, rectangles and circles in immediate mode. All primitives are
+/// appended to one vertex stream and drawn with a single draw call when the
+/// batch is flushed.
+///
+/// \class PrimitiveBatch
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_GRAPHICS_EXPORT PrimitiveBatch : public RenderBase
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(PrimitiveBatch)
+    CRANBERRY_DECLARE_DTOR(PrimitiveBatch)
+    CRANBERRY_DISABLE_COPY(PrimitiveBatch)
+    CRANBERRY_DISABLE_MOVE(PrimitiveBatch)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether primitives are anti-aliased.
+    ///
+    /// \returns true if smooth.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of vertices that wait for the next flush.
+    ///
+    /// \returns the pending vertex count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int pendingVertices() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of draw calls issued since the last frame.
+    ///
+    /// \returns the draw call count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int drawCalls() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether primitives are anti-aliased. Flushes all pending
+    /// primitives if the state changes.
+    ///
+    /// \param smooth True to smoothen primitives.
+    /// \default true
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Draws a line from \p p1 to \p p2.
+    ///
+    /// \param p1 Start point.
+    /// \param p2 End point.
+    /// \param color Line color.
+    /// \param width Line width in pixels.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void line(
+        const QPointF& p1,
+        const QPointF& p2,
+        const QColor& color,
+        float width = 1.0f
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Draws a rectangle. An outline is drawn inside the rectangle.
+    ///
+    /// \param rc Rectangle to draw.
+    /// \param color Fill or outline color.
+    /// \param filled True to fill the rectangle.
+    /// \param width Outline width in pixels; ignored if filled.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void rect(
+        const QRectF& rc,
+        const QColor& color,
+        bool filled = true,
+        float width = 1.0f
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Draws a circle. An outline is drawn inside the circle.
+    ///
+    /// \param center Center of the circle.
+    /// \param radius Radius of the circle.
+    /// \param color Fill or outline color.
+    /// \param filled True to fill the circle.
+    /// \param width Outline width in pixels; ignored if filled.
+    /// \param segments Amount of segments; zero picks one by the radius.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void circle(
+        const QPointF& center,
+        float radius,
+        const QColor& color,
+        bool filled = true,
+        float width = 1.0f,
+        int segments = 0
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Draws connected lines through all \p points, with mitered joints.
+    ///
+    /// \param points Points to connect; at least two.
+    /// \param color Line color.
+    /// \param width Line width in pixels.
+    /// \param closed True to connect the last point with the first one.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void polyline(
+        const QVector<QPointF>& points,
+        const QColor& color,
+        float width = 1.0f,
+        bool closed = false
+        );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Draws all pending primitives with one draw call. Call this before
+    /// rendering other objects that should appear on top of them.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void flush();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Discards all pending primitives.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+public overridden:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether this object is null.
+    ///
+    /// \returns true if null.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isNull() const override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates the vertex buffer of this batch.
+    ///
+    /// \param renderTarget Target to render on.
+    /// \returns true if created successfully.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool create(Window* renderTarget = nullptr) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys the vertex buffer of this batch.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates the transformations of this batch and resets the draw call
+    /// counter.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update(const GameTime& time) override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Equivalent to flush().
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void render() override;
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void appendTriangle(const QPointF& a, const QPointF& b, const QPointF& c);
+    void appendQuad(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d);
+    void modifyProgram();
+    void modifyAttribs();
+    void releaseObjects();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    priv::VarVertices m_vertices;     ///< Pending triangles
+    QOpenGLBuffer*    m_vertexBuffer; ///< Streams the triangles
+    QColor            m_color;        ///< Color of the primitive being added
+    int               m_drawCalls;    ///< Draw calls since the last update
+    bool              m_smooth;       ///< Anti-aliasing enabled?
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class PrimitiveBatch
+/// \ingroup Graphics
+///
+/// Every window owns a batch, retrieved by Window::draw(), which is flushed
+/// after Window::onRender(). Primitives do not need to be created or
+/// destroyed; they only live for the frame they were drawn in. Lines and
+/// outlines are extruded to triangles, so any line width is supported.
+///
+/// \code
+/// void MyWindow::onRender()
+/// {
+///     m_sprite->render();
+///
+///     draw()->rect(m_selection, Qt::green, false, 2.0f);
+///     draw()->circle(m_cursor, 4.0f, Qt::red);
+///     draw()->polyline(m_path, Qt::yellow, 3.0f);
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -218,6 +218,7 @@ private:
     TreeModelItem*  m_rootModelItem;
     MovementMap     m_movements;
     SpriteMovement* m_currentMove;
+    quint64         m_animRevision;
     bool            m_isRunning;
     bool            m_isBlocking;
 };
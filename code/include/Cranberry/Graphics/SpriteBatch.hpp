@@ -27,11 +27,14 @@
 // Cranberry headers
 #include <Cranberry/Graphics/Base/Enumerations.hpp>
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/Graphics/Base/RenderTargetPool.hpp>
 #include <Cranberry/OpenGL/OpenGLVertex.hpp>
 #include <Cranberry/System/GameTime.hpp>
 
 // Qt headers
 #include <QList>
+#include <QMatrix4x4>
+#include <QVector>
 
 // Forward declarations
 CRANBERRY_FORWARD_C(Window)
@@ -85,6 +88,30 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     Effect effect() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the sample count of the target the objects are rendered to.
+    ///
+    /// \returns the sample count; zero if not multisampled.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int samples() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the target has a depth/stencil buffer.
+    ///
+    /// \returns true if it has one.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool hasDepthStencil() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the rendered objects are kept between frames.
+    ///
+    /// \returns true if retained.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isRetained() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the background color of this batch. Setting this to
     /// QColor() [isValid() returns false] will result in the BG color
@@ -112,6 +139,48 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setEffect(Effect effect);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the sample count of the target the objects are rendered to.
+    /// Zero renders the objects directly into a texture, which saves the
+    /// memory of the multisampled buffers and the resolve blit.
+    ///
+    /// \param samples Sample count; clamped to what the driver supports.
+    /// \default 4
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSamples(int samples);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the target has a depth/stencil buffer. Only needed
+    /// if one of the objects relies on depth or stencil tests.
+    ///
+    /// \param depthStencil True to attach a depth/stencil buffer.
+    /// \default true
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setDepthStencil(bool depthStencil);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether the rendered objects are kept between frames. A
+    /// retained batch only renders its objects again if one of them was
+    /// added, removed, transformed or reports a new revision; otherwise it
+    /// only draws the image of the last time. Only enable this if all objects
+    /// report their changes, or call invalidate() whenever they do not.
+    ///
+    /// \param retained True to keep the image between frames.
+    /// \default false
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setRetained(bool retained);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Forces the objects to be rendered again the next frame. Necessary for
+    /// objects that change without reporting it through RenderBase::revision,
+    /// e.g. custom objects or shaders animated over time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void invalidate();
+
     ////////////////////////////////////////////////////////////////////////////
     /// Creates a new sprite batch based on an existing fbo. Takes ownership
     /// of the Qt framebuffer object, you must not free it yourself.
@@ -199,6 +268,15 @@ public overridden:
     ////////////////////////////////////////////////////////////////////////////
     void render() override;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the revision of this batch, which includes the revisions of
+    /// all of its objects.
+    ///
+    /// \returns the revision.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 revision() const override;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the root model item for this instance. Use this method only if
     /// the debug overlay is about to be shown.
@@ -228,21 +306,34 @@ public overridden:
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    typedef priv::RenderTargetPool::Target Target;
+
+    struct Snapshot
+    {
+        RenderBase*   object;   ///< Object rendered
+        quint64       revision; ///< Revision rendered
+        QMatrix4x4    matrix;   ///< Transformation rendered
+        OpenGLShader* program;  ///< Program rendered with
+        float         opacity;  ///< Opacity rendered with
+    };
+
     ////////////////////////////////////////////////////////////////////////////
     // Functions
     ////////////////////////////////////////////////////////////////////////////
     bool createInternal(Window*);
-    bool createData();
-    bool createFboRbo();
     bool createBuffers();
-    void recreateFboRbo();
     void updateVertices();
     bool writeData();
     bool writeBuffers();
-    bool writeFramebuffer();
-    bool writeTexture();
-    bool writeRenderbuffer();
-    void destroyFboRbo();
+    bool hasChanged();
+    bool acquireTarget();
+    bool resolveBatch();
+    bool resolveFbo();
+    void blit(uint source, Target* target);
+    void releaseTargets();
     void destroyBuffers();
     void setupBatch();
     void setupFrame();
@@ -261,14 +352,16 @@ private:
     QList<RenderBase*>        m_objects;
     QRectF                    m_geometry;
     QColor                    m_backColor;
-    uint                      m_frameBuffer;
-    uint                      m_msFrameBuffer;
-    uint                      m_renderBuffer;
+    Target*                   m_target;
+    Target*                   m_cache;
+    QVector<Snapshot>         m_snapshots;
     uint                      m_vertexArray;
     uint                      m_vertexBuffer;
     uint                      m_indexBuffer;
-    uint                      m_frameTexture;
-    uint                      m_msFrameTexture;
+    int                       m_samples;
+    bool                      m_depthStencil;
+    bool                      m_retained;
+    bool                      m_dirty;
     bool                      m_isEmbedded;
     bool                      m_takeOwnership;
 };
@@ -281,6 +374,11 @@ private:
 /// The SpriteBatch class should be mainly used to apply post-processing
 /// effects (even transitions) to a large group of objects.
 ///
+/// Batches do not own their framebuffers. They acquire them from a pool for
+/// the duration of render() only, so batches of the same size share memory.
+/// Retained batches keep the resolved image until their objects change,
+/// which suits static content such as HUD frames or decoration layers.
+///
 /// \code
 /// // Applies the sepia effect to multiple objects.
 /// m_batch = new SpriteBatch;
@@ -25,14 +25,16 @@
 
 
 // Cranberry headers
-#include <Cranberry/Graphics/SpriteBatch.hpp>
+#include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/Graphics/Base/TextCache.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
 
 // Qt headers
 #include <QFont>
-#include <QOpenGLPaintDevice>
 #include <QTextOption>
 
 // Forward declarations
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
 CRANBERRY_FORWARD_Q(QPen)
 CRANBERRY_FORWARD_Q(QBrush)
 CRANBERRY_FORWARD_Q(QStaticText)
@@ -44,11 +46,12 @@ CRANBERRY_BEGIN_NAMESPACE
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// This class is capable of rendering text. If you have a static text, calling
-/// create() and not doing anything else is fine. But in case you need dynamic
-/// text that changes very often, invoke setColumnLimit() and setRowLimit().
-/// Cranberry will calculate the optimal texture size from these two parameters,
-/// but is still able to resize the texture in case text happens to be bigger.
+/// This class is capable of rendering text. Rasterized texts are shared by all
+/// Text objects with the same string, font, colors, options and outline, thus
+/// identical labels are rendered into a texture only once. Textures are taken
+/// from size classes and recycled, so changing the text rarely allocates. In
+/// order to restrict the texture size, invoke setColumnLimit() and
+/// setRowLimit().
 ///
 /// \class Text
 /// \author Nicolas Kogler
@@ -283,12 +286,18 @@ private:
     ////////////////////////////////////////////////////////////////////////////
     void updateTexture();
     void updateShader();
-    void resizeTexture(QSizeF);
+    void updateVertices();
     void renderToTexture();
     void prepareConstraint();
     void recalcSize();
+    void releaseEntry();
+    void bindObjects();
+    void releaseObjects();
+    void modifyAttribs();
     auto approximateSize() -> QSizeF;
     auto measureText() -> QSizeF;
+    auto layoutKey() const -> QString;
+    auto rasterKey(const QSize& size) const -> QString;
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
@@ -300,14 +309,15 @@ private:
     QPen*                     m_textPen;
     QBrush*                   m_outlineBrush;
     QTextOption               m_options;
-    QOpenGLPaintDevice*       m_paintDevice;
-    QOpenGLFramebufferObject* m_fbo;
-    SpriteBatch*              m_batch;
+    QString                   m_rasterKey;
+    priv::TextCache::Entry*   m_entry;
+    priv::QuadVertices        m_vertices;
+    QOpenGLBuffer*            m_vertexBuffer;
+    QOpenGLBuffer*            m_indexBuffer;
+    quint64                   m_propertyRevision;
     int                       m_outlineWidth;
     int                       m_columnLimit;
     int                       m_rowLimit;
-    float                     m_lastWidth;
-    float                     m_lastHeight;
     float                     m_blurFactor;
     bool                      m_textUpdate;
 };
@@ -28,8 +28,10 @@
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
 #include <Cranberry/System/Receivers/GuiManagerReceiver.hpp>
 
+// Qt headers
+#include <QElapsedTimer>
+
 // Forward declarations
-CRANBERRY_FORWARD_C(SpriteBatch)
 CRANBERRY_FORWARD_P(WindowPrivate)
 CRANBERRY_FORWARD_Q(QQmlContext)
 CRANBERRY_FORWARD_Q(QQmlComponent)
@@ -38,6 +40,7 @@ CRANBERRY_FORWARD_Q(QQuickItem)
 CRANBERRY_FORWARD_Q(QQuickRenderControl)
 CRANBERRY_FORWARD_Q(QQuickWindow)
 CRANBERRY_FORWARD_Q(QOffscreenSurface)
+CRANBERRY_FORWARD_Q(QOpenGLBuffer)
 CRANBERRY_FORWARD_Q(QOpenGLContext)
 CRANBERRY_FORWARD_Q(QOpenGLFramebufferObject)
 
@@ -118,6 +121,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     QPointF topLeft() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the maximum amount of times per second the Qml scene is
+    /// rendered.
+    ///
+    /// \returns the update rate; 0 if unlimited.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int updateRate() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the visibility of this Gui. If false is passed, the Gui will
     /// not be focusable from the underlying QOpenGLWindow, i.e. it gets
@@ -154,6 +166,17 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setEffect(Effect effect);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Limits how often per second the Qml scene is rendered, so that heavy
+    /// animations do not hold back the game loop. The last image of the
+    /// scene is drawn in between.
+    ///
+    /// \param rate Updates per second; 0 to render every change.
+    /// \default 0
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setUpdateRate(int rate);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Creates a new GuiManager that manages the given Qml Gui.
     ///
@@ -228,6 +251,9 @@ private:
     void clearFbo();
     void createFbo();
     void resizeFbo();
+    void renderScene();
+    void drawFbo();
+    bool writeVertices();
     void requestUpdate();
 
     ////////////////////////////////////////////////////////////////////////////
@@ -235,7 +261,6 @@ private:
     ////////////////////////////////////////////////////////////////////////////
     GuiManagerReceiver        m_receiver;
     TreeModelItem*            m_rootModelItem;
-    SpriteBatch*              m_batch;
     QOffscreenSurface*        m_offscreenSurface;
     QQuickRenderControl*      m_renderControl;
     QQuickWindow*             m_renderWindow;
@@ -243,6 +268,10 @@ private:
     QQmlComponent*            m_qmlComponent;
     QQuickItem*               m_rootItem;
     QOpenGLFramebufferObject* m_fbo;
+    QOpenGLBuffer*            m_vertexBuffer;
+    QElapsedTimer             m_updateTimer;
+    Effect                    m_effect;
+    int                       m_updateRate;
     bool                      m_requiresUpdate;
     bool                      m_isInitialized;
     bool                      m_isVisible;
@@ -30,6 +30,9 @@
 // Qt headers
 #include <QHash>
 
+// Standard headers
+#include <bitset>
+
 
 CRANBERRY_BEGIN_NAMESPACE
 
@@ -46,7 +49,7 @@ class CRANBERRY_INPUT_EXPORT KeyboardState final
 {
 public:
 
-    CRANBERRY_DEFAULT_CTOR(KeyboardState)
+    CRANBERRY_DECLARE_CTOR(KeyboardState)
     CRANBERRY_DEFAULT_DTOR(KeyboardState)
     CRANBERRY_DEFAULT_COPY(KeyboardState)
     CRANBERRY_DEFAULT_MOVE(KeyboardState)
@@ -67,6 +70,23 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isKeyUp(int key) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given key was pressed during the current frame.
+    /// Also true if it was released again within the same frame.
+    ///
+    /// \returns true if the key went down this frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isKeyPressed(int key) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given key was released during the current frame.
+    ///
+    /// \returns true if the key went up this frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isKeyReleased(int key) const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Determines whether the given modifier is pressed.
     ///
@@ -101,13 +121,34 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setModifiers(int mods);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Starts a new frame. Forgets which keys were pressed or released, but
+    /// keeps which keys are down.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void advanceFrame();
+
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    typedef std::bitset<1024> KeyBits;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    static int slot(int key);
+    bool testKey(const KeyBits& bits, int key, int flag) const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    QHash<int, bool> m_keyStates; ///< true = pressed, false = released
+    KeyBits          m_down;      ///< Keys that are pressed
+    KeyBits          m_pressed;   ///< Keys that went down this frame
+    KeyBits          m_released;  ///< Keys that went up this frame
+    QHash<int, int>  m_otherKeys; ///< Keys without a slot, as flags
     int              m_modifiers; ///< One or more modifiers combined
 };
 
@@ -116,9 +157,11 @@ private:
 /// \class KeyboardState
 /// \ingroup Input
 ///
-/// The keyboard's key states will be stored in a hash map since Qt
-/// unfortunately has very high key values. Use one of the four convenient
-/// functions to determine whether a key or modifier is pressed.
+/// Latin and special keys are stored in bitsets, indexed by the low bits of
+/// their Qt key code. The rare keys beyond that, e.g. of non-latin layouts,
+/// fall back to a hash map. isKeyPressed() and isKeyReleased() detect the
+/// edges since the last frame; a key that is tapped within one frame is
+/// reported by both.
 ///
 /// \code
 /// void onKeyPressed(const KeyboardState& keyboard)
@@ -28,7 +28,7 @@
 #include <Cranberry/Config.hpp>
 
 // Qt headers
-#include <QHash>
+#include <QtGlobal>
 
 
 CRANBERRY_BEGIN_NAMESPACE
@@ -46,7 +46,7 @@ class CRANBERRY_INPUT_EXPORT MouseState final
 {
 public:
 
-    CRANBERRY_DEFAULT_CTOR(MouseState)
+    CRANBERRY_DECLARE_CTOR(MouseState)
     CRANBERRY_DEFAULT_DTOR(MouseState)
     CRANBERRY_DEFAULT_COPY(MouseState)
     CRANBERRY_DEFAULT_MOVE(MouseState)
@@ -69,6 +69,26 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isButtonUp(int button) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given button was pressed during the current
+    /// frame. Also true if it was released again within the same frame.
+    ///
+    /// \param button Qt::MouseButton to check for.
+    /// \returns true if the button went down this frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isButtonPressed(int button) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the given button was released during the current
+    /// frame.
+    ///
+    /// \param button Qt::MouseButton to check for.
+    /// \returns true if the button went up this frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isButtonReleased(int button) const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the state of \p button.
     ///
@@ -78,13 +98,22 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setButtonState(int button, bool state);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Starts a new frame. Forgets which buttons were pressed or released, but
+    /// keeps which buttons are down.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void advanceFrame();
+
 
 private:
 
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    QHash<int, bool> m_buttonStates; ///< true = pressed, false = released
+    quint32 m_down;     ///< Buttons that are pressed
+    quint32 m_pressed;  ///< Buttons that went down this frame
+    quint32 m_released; ///< Buttons that went up this frame
 };
 
 
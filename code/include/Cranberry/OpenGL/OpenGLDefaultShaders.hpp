@@ -75,7 +75,12 @@ public:
 
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the program called \p name. Returns a null pointer if unable
-    /// to find the shader.
+    /// to find the shader or if it failed to link, in which case an error is
+    /// raised once. Default programs are compiled on the first call,
+    /// which therefore requires the OpenGL context to be current on the
+    /// calling thread; e.g. within Window::onInit() or Window::onRender().
+    /// Without a current context, an error is raised and a null pointer is
+    /// returned; the program is compiled by a later call.
     ///
     /// \param name Key of the program to retrieve.
     /// \returns the associated shader program.
@@ -83,16 +88,38 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     static OpenGLShader* get(const QString& name);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the variant of the default program \p program that has
+    /// \p modes and \p effect compiled in, instead of evaluating them for
+    /// every fragment. Variants are compiled on first use and thus require a
+    /// current OpenGL context, like get(). Returns \p program itself if it
+    /// has no variants, e.g. for custom programs, or if there is no context.
+    ///
+    /// \param program Default program, as retrieved by get().
+    /// \param modes Blend modes to compile in.
+    /// \param effect Effect to compile in.
+    /// \returns the specialized program.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static OpenGLShader* getVariant(
+            OpenGLShader* program,
+            BlendModes modes,
+            Effect effect
+            );
+
 
 private:
 
     ////////////////////////////////////////////////////////////////////////////
     // Functions
     ////////////////////////////////////////////////////////////////////////////
-    static OpenGLShader* cranberryGetShader(const char*);
+    static OpenGLShader* cranberryGetShader(const char*, const char*, const QStringList& = QStringList());
+    static OpenGLShader* cranberryCompileShader(const QString&);
+    static void cranberryDeferShader(const QString&, const char*, bool = false, bool = false);
+    static void cranberryDeferShader(const QString&, const char*, const char*, const char*, bool = false, bool = false);
+    static void cranberryInitShader(const QString&, QOpenGLShaderProgram*);
     static void cranberryLoadDefaultShaders();
     static void cranberryFreeDefaultShaders();
-    static void cranberryInitDefaultShaders();
     static void cranberryUpdateDefaultShaders();
 
     friend class priv::WindowPrivate;
@@ -101,6 +128,8 @@ private:
 
 typedef QHash<QString, OpenGLShader*> ShaderMap;
 typedef QVector<OpenGLShader*> ShaderUpdateList;
+typedef QHash<int, OpenGLShader*> VariantMap;
+typedef QHash<OpenGLShader*, VariantMap> VariantCache;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,7 +139,12 @@ typedef QVector<OpenGLShader*> ShaderUpdateList;
 /// A static class that holds default shaders for shapes and sprites. They can
 /// then be accessed anywhere, anytime. The OpenGLDefaultShaders::get() function
 /// is furthermore thread-safe, meaning you can initialize graphics objects from
-/// multiple threads.
+/// multiple threads, as long as the programs they use have been compiled.
+///
+/// Programs are only compiled when first requested, so that a game does not
+/// pay for effects it never uses. Qt keeps the linked binaries in its shader
+/// disk cache (one per GPU and driver), which turns later compilations into
+/// a simple load. Set QT_DISABLE_SHADER_DISK_CACHE to bypass it.
 ///
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -29,6 +29,7 @@
 // Qt headers
 #include <QRectF>
 #include <QString>
+#include <QStringList>
 
 // Forward declarations
 CRANBERRY_FORWARD_Q(QMatrix4x4)
@@ -70,7 +71,8 @@ public:
 
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves a pointer to the vertex shader. If no vertex shader has
-    /// been specified before, a nullptr is returned.
+    /// been specified before or the program was restored from the shader
+    /// disk cache, a nullptr is returned.
     ///
     /// \returns the vertex shader, if any.
     ///
@@ -78,8 +80,9 @@ public:
     QOpenGLShader* vertexShader();
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Retrieves a pointer to the fragment shader. If no vertex shader has
-    /// been specified before, a nullptr is returned.
+    /// Retrieves a pointer to the fragment shader. If no fragment shader has
+    /// been specified before or the program was restored from the shader
+    /// disk cache, a nullptr is returned.
     ///
     /// \returns the fragment shader, if any.
     ///
@@ -94,6 +97,24 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool isLinked() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the preprocessor definitions of this program.
+    ///
+    /// \returns the list of definitions.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const QStringList& defines() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies preprocessor definitions that are inserted right after the
+    /// #version directive of both shaders. Each entry has the form "NAME" or
+    /// "NAME VALUE". Must be called before the shaders are specified.
+    ///
+    /// \param defines List of definitions.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setDefines(const QStringList& defines);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the code of the vertex shader. If you want to load the
     /// source code from a file, use setVertexShaderFromFile().
@@ -216,6 +237,25 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setSourceRect(const QRectF& rect);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the vertex shader declares the optional uniform
+    /// u_uvOffset, which is added to the texture coordinates of all vertices.
+    ///
+    /// \returns true if u_uvOffset is available.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool hasUvOffset() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the texture coordinate offset for uniform u_uvOffset. Does
+    /// nothing if the shader does not declare it. Will call bind()
+    /// automatically.
+    ///
+    /// \param offset Offset in texture coordinates.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setUvOffset(const QPointF& offset);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Gets the layout location of the uniform called \p name.
     ///
@@ -369,6 +409,9 @@ private:
     QOpenGLShader*        m_fragment;  ///< The fragment shader
     QString               m_vertName;  ///< Vertex shader name
     QString               m_fragName;  ///< Fragment shader name
+    QString               m_vertCode;  ///< Vertex source, until linked
+    QString               m_fragCode;  ///< Fragment source, until linked
+    QStringList           m_defines;   ///< Inserted after #version
     uint*                 m_refCount;  ///< Counts the "copies" of this instance
     bool                  m_isBound;   ///< Is currently bound?
     int                   m_locTex;    ///< Uniform location of u_tex
@@ -378,6 +421,7 @@ private:
     int                   m_locEffect; ///< Uniform location of u_effect
     int                   m_locSize;   ///< Uniform location of u_winSize
     int                   m_locRect;   ///< Uniform location of u_sourceRect
+    int                   m_locOffset; ///< Uniform location of u_uvOffset
 };
 
 
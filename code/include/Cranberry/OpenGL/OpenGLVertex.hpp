@@ -294,6 +294,87 @@ private:
     float m_fields[4];
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// Defines a single vertex having a XY position, UV texture coordinate, a RGBA
+/// fill color and a RGBA outline color. Used for glyphs of distance field text.
+///
+/// \class GlyphVertex
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class GlyphVertex
+{
+public:
+
+    GlyphVertex();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the position of the vertex.
+    ///
+    /// \param x X-position.
+    /// \param y Y-position.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void xy(float x, float y);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the texture coordinates of the vertex.
+    ///
+    /// \param u U-coordinate.
+    /// \param v V-coordinate.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void uv(float u, float v);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the fill color of the vertex.
+    ///
+    /// \param color QColor object representing the RGBA quadruple.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void rgba(const QColor& color);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the outline color of the vertex.
+    ///
+    /// \param color QColor object representing the RGBA quadruple.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void outline(const QColor& color);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the raw floating-point data.
+    ///
+    /// \returns a pointer to the raw data.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const float* data() const;
+
+    // Attribute offsets and sizes
+    static constexpr uint  xyAttrib()      { return 0; }
+    static constexpr uint  uvAttrib()      { return 1; }
+    static constexpr uint  rgbaAttrib()    { return 2; }
+    static constexpr uint  outlineAttrib() { return 3; }
+    static constexpr uint  xyLength()      { return 2; }
+    static constexpr uint  uvLength()      { return 2; }
+    static constexpr uint  rgbaLength()    { return 4; }
+    static constexpr uint  outlineLength() { return 4; }
+    static constexpr uint  size()          { return sizeof(float) * 12; }
+    static constexpr void* xyOffset()      { return (void*) (nullptr); }
+    static constexpr void* uvOffset()      { return (void*) (sizeof(float) * 2); }
+    static constexpr void* rgbaOffset()    { return (void*) (sizeof(float) * 4); }
+    static constexpr void* outlineOffset() { return (void*) (sizeof(float) * 8); }
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    float m_fields[12];
+};
+
 
 ////////////////////////////////////////////////////////////////////////////
 // Types
@@ -304,6 +385,7 @@ using QuadVertices = std::array<TextureVertex, 4>;
 using VarVertices = std::vector<Vertex>;
 using MapVertices = std::vector<MapVertex>;
 using IdVertices = std::vector<qint32>;
+using GlyphVertices = std::vector<GlyphVertex>;
 
 ////////////////////////////////////////////////////////////////////////////
 // Macroes
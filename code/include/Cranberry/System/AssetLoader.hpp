@@ -0,0 +1,285 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_SYSTEM_ASSETLOADER_HPP
+#define CRANBERRY_SYSTEM_ASSETLOADER_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
+#include <Cranberry/System/Emitters/AssetLoaderEmitter.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QJsonDocument>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtXml/QDomDocument>
+
+// Standard headers
+#include <functional>
+
+// Forward declarations
+CRANBERRY_FORWARD_P(AssetWorker)
+CRANBERRY_FORWARD_Q(QOpenGLTexture)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Loads assets on worker threads while the game keeps rendering. Each worker
+/// owns an offscreen surface and a context that shares resources with all
+/// windows, thus textures are uploaded off the render thread as well.
+///
+/// \class AssetLoader
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT AssetLoader final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the kind of an asset.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    enum AssetType
+    {
+        AssetTexture, ///< Image, uploaded to a texture
+        AssetJson,    ///< JSON document, e.g. a sprite or animation
+        AssetXml      ///< XML document, e.g. a TMX map
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// A loaded asset, handed to the callback on the render thread.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct Asset
+    {
+        int             id;      ///< Identifier returned by the load function
+        AssetType       type;    ///< Kind of the asset
+        QString         path;    ///< Path the asset was loaded from
+        bool            success; ///< False if the asset could not be loaded
+        QOpenGLTexture* texture; ///< Texture; release it via TextureCache
+        QJsonDocument   json;    ///< Parsed JSON document
+        QDomDocument    xml;     ///< Parsed XML document
+    };
+
+    using Callback = std::function<void(const Asset&)>;
+
+    CRANBERRY_DECLARE_CTOR(AssetLoader)
+    CRANBERRY_DECLARE_DTOR(AssetLoader)
+    CRANBERRY_DISABLE_COPY(AssetLoader)
+    CRANBERRY_DISABLE_MOVE(AssetLoader)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the loader shared by all windows.
+    ///
+    /// \returns the shared loader.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static AssetLoader* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the signals of the loader.
+    ///
+    /// \returns the signals.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    AssetLoaderEmitter* signals();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of worker threads.
+    ///
+    /// \returns the worker count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int workerCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the amount of worker threads. Only has an effect before the
+    /// first asset is requested.
+    ///
+    /// \param count New worker count.
+    /// \default Half of the logical cores, at least one.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setWorkerCount(int count);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Decodes the image at \p path and uploads it to a texture, which is then
+    /// handed to the TextureCache. Must be called on the render thread.
+    ///
+    /// \param path Path to the image.
+    /// \param callback Called on the render thread once the texture is ready.
+    /// \param options Sampling options of the texture.
+    /// \returns the identifier of the asset.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int loadTexture(
+            const QString& path,
+            const Callback& callback = Callback(),
+            const TextureCache::Options& options = TextureCache::Options()
+            );
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Reads and parses the JSON document at \p path.
+    ///
+    /// \param path Path to the document.
+    /// \param callback Called on the render thread once parsed.
+    /// \returns the identifier of the asset.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int loadJson(const QString& path, const Callback& callback = Callback());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Reads and parses the XML document at \p path.
+    ///
+    /// \param path Path to the document.
+    /// \param callback Called on the render thread once parsed.
+    /// \returns the identifier of the asset.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int loadXml(const QString& path, const Callback& callback = Callback());
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the progress of a single asset, from 0 to 1. The asset is
+    /// complete once its callback was called.
+    ///
+    /// \param id Identifier returned by a load function.
+    /// \returns the progress of the asset.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    qreal progress(int id) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the progress of all assets requested since the loader was
+    /// idle the last time, from 0 to 1.
+    ///
+    /// \returns the aggregate progress.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    qreal progress() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether any asset is still being loaded.
+    ///
+    /// \returns true if loading.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isLoading() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Hands all assets that finished loading to their callbacks. Textures
+    /// are only handed over once the GPU finished uploading them. Called by
+    /// the main window every frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void update();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Stops all workers. Pending assets are discarded.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void stop();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Destroys the worker contexts. Textures created by the workers must
+    /// have been destroyed before.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void destroy();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Job
+    {
+        Asset                 asset;    ///< Asset being loaded
+        Callback              callback; ///< Called once loaded
+        TextureCache::Options options;  ///< Texture options
+        void*                 fence;    ///< GLsync; signaled once uploaded
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    int enqueue(AssetType type, const QString& path, const Callback& callback, Job job);
+    bool takeJob(Job& job);
+    void finishJob(const Job& job);
+    void setProgress(int id, qreal progress);
+    void deliver(Job& job);
+    void start();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    AssetLoaderEmitter          m_emitter;     ///< Signals
+    QVector<priv::AssetWorker*> m_workers;     ///< Worker threads
+    QQueue<Job>                 m_queue;       ///< Jobs not yet started
+    QList<Job>                  m_finished;    ///< Jobs not yet delivered
+    QHash<int, qreal>           m_progress;    ///< Progress of pending assets
+    mutable QMutex              m_mutex;       ///< Guards all of the above
+    QWaitCondition              m_wake;        ///< Wakes the workers
+    int                         m_workerCount; ///< Workers to start
+    int                         m_nextId;      ///< Next asset identifier
+    int                         m_requested;   ///< Assets since being idle
+    bool                        m_quit;        ///< Workers shall stop
+    bool                        m_started;     ///< Workers were started
+
+    friend class priv::AssetWorker;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class AssetLoader
+/// \ingroup System
+///
+/// Loading screens request all assets of the next scene and poll the
+/// aggregate progress, while the game keeps rendering at full frame rate.
+///
+/// \code
+/// AssetLoader* loader = AssetLoader::instance();
+/// loader->loadTexture(":/textures/level2.png", [this] (const AssetLoader::Asset& a)
+/// {
+///     m_background->create(a.texture, this);
+/// });
+///
+/// QObject::connect(loader->signals(), &AssetLoaderEmitter::progressChanged,
+///                  [this] (qreal p) { m_loadingBar->setValue(p); });
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -53,10 +53,14 @@ public:
 
 
     inline void emitFinishedAnimation() { Q_EMIT finishedAnimation(); }
+    inline void emitReadyAnimation() { Q_EMIT readyAnimation(); }
+    inline void emitFailedAnimation() { Q_EMIT failedAnimation(); }
 
 Q_SIGNALS:
 
     void finishedAnimation();
+    void readyAnimation();
+    void failedAnimation();
 
 
 private:
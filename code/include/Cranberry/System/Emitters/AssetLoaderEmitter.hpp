@@ -0,0 +1,76 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_SYSTEM_EMITTERS_ASSETLOADEREMITTER_HPP
+#define CRANBERRY_SYSTEM_EMITTERS_ASSETLOADEREMITTER_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QObject>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Emits signals for the AssetLoader.
+///
+/// \class AssetLoaderEmitter
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT AssetLoaderEmitter : public QObject
+{
+public:
+
+    CRANBERRY_DEFAULT_CTOR(AssetLoaderEmitter)
+    CRANBERRY_DEFAULT_DTOR(AssetLoaderEmitter)
+    CRANBERRY_DISABLE_COPY(AssetLoaderEmitter)
+    CRANBERRY_DISABLE_MOVE(AssetLoaderEmitter)
+
+
+    inline void emitLoadedAsset(int id, bool success) { Q_EMIT loadedAsset(id, success); }
+    inline void emitProgressChanged(qreal progress) { Q_EMIT progressChanged(progress); }
+    inline void emitFinishedLoading() { Q_EMIT finishedLoading(); }
+
+
+Q_SIGNALS:
+
+    void loadedAsset(int id, bool success);
+    void progressChanged(qreal progress);
+    void finishedLoading();
+
+
+private:
+
+    Q_OBJECT
+};
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
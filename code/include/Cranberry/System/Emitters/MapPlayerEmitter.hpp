@@ -30,6 +30,7 @@
 #include <Cranberry/System/Emitters/RenderBaseEmitter.hpp>
 
 // Qt headers
+#include <QMetaMethod>
 #include <QObject>
 
 
@@ -60,6 +61,34 @@ public:
     inline void emitStartedLeaveTile(const TileEvent& e) { Q_EMIT startedLeaveTile(e); }
     inline void emitStartedLeaveObject(const ObjectEvent& e) { Q_EMIT startedLeaveObject(e); }
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether any of the started or finished move signals has a
+    /// receiver. The player does not raise these events otherwise.
+    ///
+    /// eturns true if there is at least one receiver.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool hasMoveReceivers() const
+    {
+        return isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::startedMoveTile)) ||
+               isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::finishedMoveTile)) ||
+               isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::startedMoveObject)) ||
+               isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::finishedMoveObject));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether any of the started leave signals has a receiver.
+    /// The player does not raise these events otherwise.
+    ///
+    /// eturns true if there is at least one receiver.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    inline bool hasLeaveReceivers() const
+    {
+        return isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::startedLeaveTile)) ||
+               isSignalConnected(QMetaMethod::fromSignal(&MapPlayerEmitter::startedLeaveObject));
+    }
+
 Q_SIGNALS:
 
     void startedMoveTile(const TileEvent& e);
@@ -0,0 +1,301 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_SYSTEM_JOBSYSTEM_HPP
+#define CRANBERRY_SYSTEM_JOBSYSTEM_HPP
+
+
+// Cranberry headers
+#include <Cranberry/System/GameTime.hpp>
+
+// Qt headers
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+// Standard headers
+#include <functional>
+
+// Forward declarations
+CRANBERRY_FORWARD_P(JobQueue)
+CRANBERRY_FORWARD_P(JobWorker)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds jobs and the order in which they must run. Jobs without a path
+/// between them may run in parallel.
+///
+/// \class TaskGraph
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT TaskGraph final
+{
+public:
+
+    CRANBERRY_DEFAULT_CTOR(TaskGraph)
+    CRANBERRY_DEFAULT_DTOR(TaskGraph)
+    CRANBERRY_DEFAULT_COPY(TaskGraph)
+    CRANBERRY_DEFAULT_MOVE(TaskGraph)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of tasks.
+    ///
+    /// \returns the task count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int count() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds a task.
+    ///
+    /// \param job Job of the task.
+    /// \returns the index of the task.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int add(const std::function<void()>& job);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies that the task \p after must not start before the task
+    /// \p before has finished.
+    ///
+    /// \param before Index of the task that runs first.
+    /// \param after Index of the task that depends on it.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void precede(int before, int after);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Removes all tasks.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Task
+    {
+        std::function<void()> job;          ///< Work of the task
+        QVector<int>           successors;   ///< Tasks waiting for this one
+        int                    dependencies; ///< Tasks this one waits for
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<Task> m_tasks;
+
+    friend class JobSystem;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Runs jobs on a pool of worker threads. Every worker owns a queue and
+/// steals from the others once its own queue runs dry. Threads that wait for
+/// jobs execute jobs themselves in the meantime.
+///
+/// \class JobSystem
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT JobSystem final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(JobSystem)
+    CRANBERRY_DECLARE_DTOR(JobSystem)
+    CRANBERRY_DISABLE_COPY(JobSystem)
+    CRANBERRY_DISABLE_MOVE(JobSystem)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the job system shared by all windows.
+    ///
+    /// \returns the shared job system.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static JobSystem* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of worker threads.
+    ///
+    /// \returns the worker count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int workerCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the amount of worker threads. Only has an effect before the
+    /// first job is run. Zero runs all jobs on the calling thread.
+    ///
+    /// \param count New worker count.
+    /// \default One less than the logical cores.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setWorkerCount(int count);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Calls \p body for every index in [0, count) and returns once all calls
+    /// finished. The indices are split into chunks of \p grain indices.
+    ///
+    /// \param count Amount of indices.
+    /// \param body Called with every index; must be thread-safe.
+    /// \param grain Indices per job; zero picks one by the worker count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void parallelFor(int count, const std::function<void(int)>& body, int grain = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Runs all tasks of \p graph in the specified order and returns once all
+    /// of them finished.
+    ///
+    /// \param graph Tasks to run.
+    /// \returns false if the graph contains a cycle; nothing is run then.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool run(const TaskGraph& graph);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates all \p objects. Objects marked thread-safe are updated in
+    /// parallel first, the remaining ones afterwards, in order, on the
+    /// calling thread.
+    ///
+    /// \param objects Objects providing isThreadSafe() and update().
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename Container>
+    void updateObjects(const Container& objects, const GameTime& time);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Stops all workers. Must not be called while jobs are running.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void stop();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Job
+    {
+        std::function<void()> work;    ///< Work to do
+        QAtomicInt*           pending; ///< Decreased once done
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void start();
+    void push(const QVector<Job>& jobs);
+    bool takeJob(int queue, Job* job);
+    void execute(const Job& job);
+    void wait(QAtomicInt* pending);
+    int currentQueue() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<priv::JobWorker*> m_workers;     ///< Worker threads
+    QVector<priv::JobQueue*>  m_queues;      ///< One per worker, one shared
+    QAtomicInt                m_queued;      ///< Jobs in all queues
+    QMutex                    m_mutex;       ///< Guards sleeping and starting
+    QWaitCondition            m_wake;        ///< Wakes idle workers
+    int                       m_workerCount; ///< Workers to start
+    bool                      m_quit;        ///< Workers shall stop
+    bool                      m_started;     ///< Workers were started
+
+    friend class priv::JobQueue;
+    friend class priv::JobWorker;
+};
+
+
+template<typename Container>
+void JobSystem::updateObjects(const Container& objects, const GameTime& time)
+{
+    int safe = 0;
+    for (const auto* object : objects)
+    {
+        if (object->isThreadSafe()) safe++;
+    }
+
+    // A single object is not worth waking up the workers.
+    const bool parallel = safe > 1;
+    if (parallel)
+    {
+        parallelFor(objects.size(), [&objects, &time] (int i)
+        {
+            auto* object = objects.at(i);
+            if (object->isThreadSafe()) object->update(time);
+        });
+    }
+
+    for (auto* object : objects)
+    {
+        if (!parallel || !object->isThreadSafe()) object->update(time);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class JobSystem
+/// \ingroup System
+///
+/// Engine containers, e.g. SpriteBatch and Map, update their children through
+/// updateObjects(). Objects are only updated in parallel once marked with
+/// TransformBase::setThreadSafe(), i.e. when their update neither touches
+/// shared state nor OpenGL. Rendering always stays on the render thread.
+///
+/// \code
+/// JobSystem* jobs = JobSystem::instance();
+/// jobs->parallelFor(m_particles.size(), [this, &time] (int i)
+/// {
+///     m_particles[i].advance(time.deltaTime());
+/// });
+///
+/// TaskGraph graph;
+/// int physics = graph.add([this] { stepPhysics(); });
+/// int ai = graph.add([this] { thinkAi(); });
+/// int resolve = graph.add([this] { resolveCollisions(); });
+/// graph.precede(physics, resolve);
+/// graph.precede(ai, resolve);
+/// jobs->run(graph);
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
@@ -30,6 +30,9 @@
 // Qt headers
 #include <QVariant>
 
+// Forward declarations
+CRANBERRY_FORWARD_P(TreeModelPrivate)
+
 
 CRANBERRY_BEGIN_NAMESPACE
 
@@ -149,7 +152,8 @@ public:
     QVariant value() const;
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies the member variable.
+    /// Specifies the member variable. Views are only notified if the value
+    /// actually differs.
     ///
     /// \param m Variant representing the member variable.
     ///
@@ -157,7 +161,8 @@ public:
     void setMember(const QVariant& m);
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies the member variable value.
+    /// Specifies the member variable value. Views are only notified if the
+    /// value actually differs, so this may be called every frame.
     ///
     /// \param v Variant representing the member variable value.
     ///
@@ -174,6 +179,10 @@ private:
     QVariant              m_member;
     QVariant              m_value;
     TreeModelItem*        m_parent;
+    bool                  m_changed;
+    bool                  m_structureChanged;
+
+    friend class priv::TreeModelPrivate;
 };
 
 
@@ -32,6 +32,7 @@
 #include <QHash>
 #include <QModelIndex>
 #include <QVariant>
+#include <QVector>
 
 // Forward declarations
 CRANBERRY_FORWARD_C(TreeModel)
@@ -67,6 +68,11 @@ public:
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void collectChanges(TreeModelItem*, const QModelIndex&, QVector<QModelIndex>*, bool*);
+
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
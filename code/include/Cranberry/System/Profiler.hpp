@@ -0,0 +1,265 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_SYSTEM_PROFILER_HPP
+#define CRANBERRY_SYSTEM_PROFILER_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_P(ProfileBuffer)
+CRANBERRY_FORWARD_P(ProfileScope)
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Collects the CPU time of scopes marked with cranProfile() on all threads
+/// and exports them in the Chrome trace format.
+///
+/// \class Profiler
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT Profiler final
+{
+public:
+
+    CRANBERRY_DISABLE_COPY(Profiler)
+    CRANBERRY_DISABLE_MOVE(Profiler)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the one and only profiler.
+    ///
+    /// \returns the profiler.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static Profiler* instance();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether the scopes were compiled in. Build cranberry with
+    /// CONFIG+=cranberry_profile to define CRANBERRY_PROFILE.
+    ///
+    /// \returns true if the profiler records anything.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    static bool isCompiledIn();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the time a frame may take before it counts as a spike.
+    ///
+    /// \returns the frame budget in milliseconds.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    double frameBudget() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of frames dumped on a spike.
+    ///
+    /// \returns the frame count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int spikeFrames() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the directory spikes are dumped into.
+    ///
+    /// \returns the directory.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QString spikeDirectory() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the time a frame may take before it counts as a spike. The
+    /// last spikeFrames() frames are then dumped into spikeDirectory(). Since
+    /// dumping takes time itself, the following frames are not checked.
+    ///
+    /// \param ms Frame budget in milliseconds; zero disables the detection.
+    /// \default 33.3 (two frames at 60 fps)
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setFrameBudget(double ms);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the amount of frames dumped on a spike, including the spike.
+    /// Frames whose scopes were overwritten already are dumped partially.
+    ///
+    /// \param frames Frame count.
+    /// \default 120
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSpikeFrames(int frames);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies the directory spikes are dumped into.
+    ///
+    /// \param dir Existing directory.
+    /// \default QDir::tempPath()
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setSpikeDirectory(const QString& dir);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Writes all scopes still held by the per-thread buffers into \p path.
+    /// The file can be opened in chrome://tracing or Perfetto.
+    ///
+    /// \param path Path of the JSON file.
+    /// \returns false if the file could not be written.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool exportTrace(const QString& path);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Marks the start of a new frame and checks the previous one against the
+    /// frame budget. The main window calls this through cranProfileFrame().
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void beginFrame();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    Profiler();
+    ~Profiler();
+
+    qint64 now() const;
+    void record(const char* name, qint64 begin, qint64 end);
+    void dumpSpike(double ms);
+    bool writeTrace(const QString& path, qint64 from);
+    priv::ProfileBuffer* createBuffer();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<priv::ProfileBuffer*> m_buffers;     ///< One per thread
+    QVector<qint64>               m_frames;      ///< Recent frame starts
+    QElapsedTimer                 m_clock;       ///< Time base of all scopes
+    QString                       m_spikeDir;    ///< Where spikes are dumped
+    mutable QMutex                m_mutex;       ///< Guards all but the clock
+    double                        m_budget;      ///< Frame budget in ms
+    qint64                        m_frameCount;  ///< Frames since start
+    int                           m_spikeFrames; ///< Frames per dump
+    int                           m_cooldown;    ///< Frames until next check
+
+    friend class priv::ProfileScope;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class Profiler
+/// \ingroup System
+///
+/// Every thread writes its scopes into its own ring buffer, without locks.
+/// Only the most recent scopes of each thread are kept, so the profiler can
+/// stay enabled for a whole session. Scopes may nest.
+///
+/// \code
+/// void MyGame::onUpdate(const GameTime& time)
+/// {
+///     cranProfile("MyGame::onUpdate");
+///     m_world->step(time);
+/// }
+///
+/// Profiler::instance()->setFrameBudget(20.0);
+/// Profiler::instance()->exportTrace("session.json");
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Records the time between its construction and destruction. Use the
+/// cranProfile() macro rather than this class.
+///
+/// \class ProfileScope
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class ProfileScope final
+{
+public:
+
+    CRANBERRY_DISABLE_COPY(ProfileScope)
+    CRANBERRY_DISABLE_MOVE(ProfileScope)
+
+    ProfileScope(const char* name)
+        : m_name(name)
+        , m_begin(Profiler::instance()->now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        Profiler* p = Profiler::instance();
+        p->record(m_name, m_begin, p->now());
+    }
+
+
+private:
+
+    const char* m_name;
+    qint64      m_begin;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Measures the enclosing scope under the given name, which must be a string
+/// literal. Without CRANBERRY_PROFILE, these macroes compile to nothing.
+///
+/// \def cranProfile cranProfileFrame
+///
+////////////////////////////////////////////////////////////////////////////////
+#ifdef CRANBERRY_PROFILE
+    #define CRANBERRY_PROFILE_JOIN(x, y) x##y
+    #define CRANBERRY_PROFILE_VAR(x) CRANBERRY_PROFILE_JOIN(cranProfileScope, x)
+    #define cranProfile(name) CRANBERRY_NAMESPACE::priv::ProfileScope CRANBERRY_PROFILE_VAR(__LINE__)(name)
+    #define cranProfileFrame() CRANBERRY_NAMESPACE::Profiler::instance()->beginFrame()
+#else
+    #define cranProfile(name)
+    #define cranProfileFrame()
+#endif
+
+
+#endif
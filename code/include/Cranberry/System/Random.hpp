@@ -25,10 +25,11 @@
 
 
 // Cranberry headers
-#include <Cranberry/Config.hpp>
+#include <Cranberry/System/RandomEngines.hpp>
 
 // Qt headers
 #include <QString>
+#include <QVector>
 
 // Standard headers
 #include <random>
@@ -51,7 +52,7 @@ class CRANBERRY_SYSTEM_EXPORT Random final
 public:
 
     typedef std::discrete_distribution<> Distribution;
-    typedef std::mt19937 MersenneTwister;
+    typedef Xoshiro256 Engine;
 
     CRANBERRY_DECLARE_CTOR(Random)
     CRANBERRY_DEFAULT_DTOR(Random)
@@ -59,8 +60,9 @@ public:
     CRANBERRY_DEFAULT_MOVE(Random)
 
     ////////////////////////////////////////////////////////////////////////////
-    /// Specifies a new seed for the random. By default, this is the time at
-    /// which the Random object is constructed.
+    /// Specifies a new seed for the random. By default, this is taken from
+    /// std::random_device when the Random object is constructed. The same
+    /// seed always yields the same sequence.
     ///
     /// \param seed Something unique.
     ///
@@ -168,14 +170,41 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     const QByteArray nextBlob(int size) const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Fills \p data with random floating-point numbers in the range set by
+    /// Random::setMinMax(). Much faster than calling nextDouble() in a loop.
+    ///
+    /// \param data Array to fill.
+    /// \param count Amount of numbers.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void fill(float* data, int count) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Fills \p data with random integer numbers in the range set by
+    /// Random::setMinMax(). Much faster than calling nextNumber() in a loop.
+    ///
+    /// \param data Array to fill.
+    /// \param count Amount of numbers.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void fill(int* data, int count) const;
+
 
 private:
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    quint32 nextBounded(quint32 range, quint32 bits) const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Members
     ////////////////////////////////////////////////////////////////////////////
-    mutable MersenneTwister m_engine;       ///< Engine that generates numbers
-    mutable Distribution    m_dist;         ///< Discrete distribution vector
+    mutable Engine          m_engine;       ///< Engine that generates numbers
+    mutable Xoshiro256x4    m_bulk;         ///< Engine of the fill functions
+    QVector<float>          m_aliasProb;    ///< Alias method: keep probability
+    QVector<int>            m_alias;        ///< Alias method: alternatives
     mutable QString         m_charset;      ///< Random string character set
     double                  m_fmin, m_fmax; ///< Min/max values for doubles
     int                     m_imin, m_imax; ///< Min/max values for integers
@@ -187,7 +216,10 @@ private:
 /// \ingroup System
 ///
 /// With this class, you can easily generate reliable random numbers,
-/// booleans and strings. Usage is illustrated in the example below:
+/// booleans and strings. Integers are drawn without modulo bias and discrete
+/// numbers in constant time by the alias method. A Random object must not be
+/// shared between threads; parallel jobs should use Philox4x32 streams.
+/// Usage is illustrated in the example below:
 ///
 /// \code
 /// Random random;
@@ -201,6 +233,10 @@ private:
 /// auto r4 = random.nextDiscrete();
 /// auto r5 = random.nextString(10);
 /// auto r6 = random.nextBlob(10);
+///
+/// QVector<float> angles(4096);
+/// random.setMinMax(0.0, 2.0 * M_PI);
+/// random.fill(angles.data(), angles.size());
 /// \endcode
 ///
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,354 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_SYSTEM_RANDOMENGINES_HPP
+#define CRANBERRY_SYSTEM_RANDOMENGINES_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+
+CRANBERRY_BEGIN_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// xoshiro256++ by Blackman and Vigna. Fast general-purpose engine with 256
+/// bits of state. Meets the requirements of UniformRandomBitGenerator, thus
+/// it can be used with all standard distributions.
+///
+/// \class Xoshiro256
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT Xoshiro256 final
+{
+public:
+
+    typedef quint64 result_type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs the engine and seeds it.
+    ///
+    /// \param seed Any value; expanded to the full state.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    explicit Xoshiro256(quint64 seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Resets the state from \p seed.
+    ///
+    /// \param seed Any value; expanded to the full state.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void seed(quint64 seed);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Advances the engine by 2^128 steps. Copies that were jumped a
+    /// different amount of times yield non-overlapping streams.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void jump();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Generates the next 64 random bits.
+    ///
+    /// \returns the random bits.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    result_type operator()();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 m_s[4]; ///< State
+
+    friend class Xoshiro256x4;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Four independent xoshiro256++ streams, advanced in lockstep. The state is
+/// laid out per word, so that the compiler turns each step into a few SIMD
+/// instructions. Used for bulk generation.
+///
+/// \class Xoshiro256x4
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT Xoshiro256x4 final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs the streams and seeds them.
+    ///
+    /// \param seed Any value; the streams are spaced 2^128 steps apart.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    explicit Xoshiro256x4(quint64 seed = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Resets the state of all streams from \p seed.
+    ///
+    /// \param seed Any value; the streams are spaced 2^128 steps apart.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void seed(quint64 seed);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Generates the next 64 random bits of every stream.
+    ///
+    /// \param out Receives four values.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void next(quint64* out);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 m_s[4][4]; ///< State; word, then stream
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// PCG32 (XSH-RR) by O'Neill. Small state, 32-bit output and up to 2^63
+/// distinct streams per seed.
+///
+/// \class Pcg32
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT Pcg32 final
+{
+public:
+
+    typedef quint32 result_type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs the engine and seeds it.
+    ///
+    /// \param seed Starting point within the stream.
+    /// \param stream Selects one of 2^63 streams.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    explicit Pcg32(quint64 seed = 0, quint64 stream = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Resets the state.
+    ///
+    /// \param seed Starting point within the stream.
+    /// \param stream Selects one of 2^63 streams.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void seed(quint64 seed, quint64 stream = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Generates the next 32 random bits.
+    ///
+    /// \returns the random bits.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    result_type operator()();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 m_state;     ///< Current state
+    quint64 m_increment; ///< Odd; selects the stream
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Philox4x32-10 by Salmon et al. A counter-based engine: the n-th value of a
+/// stream is a pure function of the key, the stream and n. Every job of a
+/// parallel loop can thus draw from its own stream and the results do not
+/// depend on the order in which the jobs ran.
+///
+/// \class Philox4x32
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class CRANBERRY_SYSTEM_EXPORT Philox4x32 final
+{
+public:
+
+    typedef quint32 result_type;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Constructs the engine.
+    ///
+    /// \param key Shared by all streams, e.g. the seed of the level.
+    /// \param stream Identifies the stream, e.g. the index of a job.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    explicit Philox4x32(quint64 key = 0, quint64 stream = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Selects the key and the stream and restarts at its first value.
+    ///
+    /// \param key Shared by all streams.
+    /// \param stream Identifies the stream.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void seed(quint64 key, quint64 stream = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Jumps to the value at \p position of the current stream, in constant
+    /// time.
+    ///
+    /// \param position Index of the next value.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void seek(quint64 position);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Generates the next 32 random bits.
+    ///
+    /// \returns the random bits.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    result_type operator()();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    void generate();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    quint32 m_key[2];     ///< Key of the rounds
+    quint64 m_stream;     ///< Upper half of the counter
+    quint64 m_block;      ///< Lower half of the counter
+    quint32 m_output[4];  ///< Values of the current block
+    int     m_index;      ///< Next value within the block
+};
+
+
+inline quint64 Xoshiro256::operator()()
+{
+    const quint64 sum = m_s[0] + m_s[3];
+    const quint64 result = ((sum << 23) | (sum >> 41)) + m_s[0];
+    const quint64 t = m_s[1] << 17;
+
+    m_s[2] ^= m_s[0];
+    m_s[3] ^= m_s[1];
+    m_s[1] ^= m_s[2];
+    m_s[0] ^= m_s[3];
+    m_s[2] ^= t;
+    m_s[3] = (m_s[3] << 45) | (m_s[3] >> 19);
+
+    return result;
+}
+
+
+inline void Xoshiro256x4::next(quint64* out)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        const quint64 sum = m_s[0][i] + m_s[3][i];
+        out[i] = ((sum << 23) | (sum >> 41)) + m_s[0][i];
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        const quint64 t = m_s[1][i] << 17;
+
+        m_s[2][i] ^= m_s[0][i];
+        m_s[3][i] ^= m_s[1][i];
+        m_s[1][i] ^= m_s[2][i];
+        m_s[0][i] ^= m_s[3][i];
+        m_s[2][i] ^= t;
+        m_s[3][i] = (m_s[3][i] << 45) | (m_s[3][i] >> 19);
+    }
+}
+
+
+inline quint32 Pcg32::operator()()
+{
+    const quint64 old = m_state;
+    m_state = old * 6364136223846793005ULL + m_increment;
+
+    const quint32 xorShifted = quint32(((old >> 18) ^ old) >> 27);
+    const quint32 rot = quint32(old >> 59);
+
+    return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+}
+
+
+inline quint32 Philox4x32::operator()()
+{
+    if (m_index == 4)
+    {
+        generate();
+    }
+
+    return m_output[m_index++];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class Philox4x32
+/// \ingroup System
+///
+/// \code
+/// JobSystem::instance()->parallelFor(m_particles.size(), [this] (int i)
+/// {
+///     // Same result regardless of the worker that runs index i.
+///     Philox4x32 rng(m_seed, i);
+///     m_particles[i].angle = rng() * (2.0 * M_PI / 4294967296.0);
+/// });
+/// \endcode
+///
+////////////////////////////////////////////////////////////////////////////////
+
+
+CRANBERRY_END_NAMESPACE
+
+
+#endif
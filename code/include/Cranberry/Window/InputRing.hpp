@@ -0,0 +1,124 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_WINDOW_INPUTRING_HPP
+#define CRANBERRY_WINDOW_INPUTRING_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QAtomicInt>
+#include <QPoint>
+#include <QString>
+#include <QVector>
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds one input event, stamped with the time it was received.
+///
+////////////////////////////////////////////////////////////////////////////////
+struct InputEvent
+{
+    enum Type
+    {
+        KeyPress,
+        KeyRelease,
+        ButtonPress,
+        ButtonRelease
+    };
+
+    qint64  time;       ///< Nanoseconds since the window was created
+    Type    type;       ///< Kind of event
+    int     code;       ///< Qt::Key or Qt::MouseButton
+    int     modifiers;  ///< Qt::KeyboardModifiers
+    bool    autoRepeat; ///< Repeated key?
+    QPoint  pos;        ///< Cursor position of button events
+    QString text;       ///< Text of key press events
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Passes input events from the thread that receives them to the thread that
+/// updates the game, without locking. There must be only one of each.
+///
+/// \class InputRing
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class InputRing final
+{
+public:
+
+    CRANBERRY_DECLARE_CTOR(InputRing)
+    CRANBERRY_DISABLE_COPY(InputRing)
+    CRANBERRY_DISABLE_MOVE(InputRing)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of events that were dropped because the ring was
+    /// full.
+    ///
+    /// \returns the dropped event count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int dropped() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends an event. Only called by the producing thread.
+    ///
+    /// \param event Event to append.
+    /// \returns false if the ring is full.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool push(const InputEvent& event);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Takes the oldest event. Only called by the consuming thread.
+    ///
+    /// \param event Receives the event.
+    /// \returns false if the ring is empty.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool pop(InputEvent* event);
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<InputEvent> m_events;  ///< Fixed amount of slots
+    QAtomicInt          m_head;    ///< Next slot to write
+    QAtomicInt          m_tail;    ///< Next slot to read
+    QAtomicInt          m_dropped; ///< Events lost to a full ring
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+#endif
@@ -0,0 +1,105 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_WINDOW_RENDERCOMMANDLIST_HPP
+#define CRANBERRY_WINDOW_RENDERCOMMANDLIST_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QVector>
+
+// Standard headers
+#include <functional>
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// List of render commands. The commands of one frame are recorded during its
+/// update and rendering and executed once onRender() has finished. Recording
+/// may happen on the update thread, which never runs while execute() is
+/// called.
+///
+/// \class RenderCommandList
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class RenderCommandList final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// A command that issues OpenGL calls. Runs after the update of the frame
+    /// it was recorded in.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    using Command = std::function<void()>;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of commands recorded for the current frame.
+    ///
+    /// \returns the recorded command count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int recordedCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends a command to the frame being recorded.
+    ///
+    /// \param command Command to append.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void record(const Command& command);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Runs all recorded commands in recording order and starts recording
+    /// the next frame. Must be called on the thread that owns the OpenGL
+    /// context.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void execute();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Discards all recorded commands.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<Command> m_commands; ///< Commands of the current frame
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+#endif
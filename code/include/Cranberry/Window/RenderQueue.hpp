@@ -0,0 +1,122 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_WINDOW_RENDERQUEUE_HPP
+#define CRANBERRY_WINDOW_RENDERQUEUE_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Config.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QVector>
+
+// Forward declarations
+CRANBERRY_FORWARD_C(RenderBase)
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Collects the objects of one frame together with a 64-bit sort key and
+/// renders them in key order, i.e. by layer and depth, then in the order they
+/// were enqueued. Opaque objects of the same layer and depth are rendered
+/// grouped by shader and texture instead. Only pointers to the live objects are
+/// kept; they are rendered by execute() after the update of the frame has
+/// finished.
+///
+/// \class RenderQueue
+/// \author Nicolas Kogler
+/// \date October 18, 2026
+///
+////////////////////////////////////////////////////////////////////////////////
+class RenderQueue final
+{
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the amount of objects enqueued for the current frame.
+    ///
+    /// \returns the enqueued object count.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int recordedCount() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Computes the sort key of \p object and appends it to the current
+    /// frame.
+    ///
+    /// \param object Object to render.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void push(RenderBase* object);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Sorts the objects of the current frame, renders them and starts the
+    /// next frame. Must be called on the thread that owns the OpenGL context,
+    /// after the update of the frame has finished.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void execute();
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Discards all enqueued objects.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void clear();
+
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Types
+    ////////////////////////////////////////////////////////////////////////////
+    struct Packet
+    {
+        quint64     key;    ///< Layer, depth, then state or sequence
+        RenderBase* object; ///< Object to render
+    };
+
+    typedef QHash<quintptr, quint64> IdMap;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Functions
+    ////////////////////////////////////////////////////////////////////////////
+    quint64 denseId(IdMap& ids, quintptr value);
+    void sort();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Members
+    ////////////////////////////////////////////////////////////////////////////
+    QVector<Packet> m_packets;  ///< Objects of the current frame
+    QVector<Packet> m_scratch;  ///< Radix sort buffer
+    IdMap           m_shaders;  ///< Dense ids of the shaders
+    IdMap           m_textures; ///< Dense ids of the textures
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+#endif
@@ -38,12 +38,16 @@
 // Qt headers
 #include <QObject>
 
+// Standard headers
+#include <functional>
+
 // Forward declarations
 CRANBERRY_FORWARD_Q(QSurface)
 CRANBERRY_FORWARD_Q(QOpenGLContext)
 CRANBERRY_FORWARD_Q(QOpenGLFunctions)
 CRANBERRY_FORWARD_C(GuiManager)
 CRANBERRY_FORWARD_C(OpenGLShader)
+CRANBERRY_FORWARD_C(PrimitiveBatch)
 CRANBERRY_FORWARD_C(RenderBase)
 CRANBERRY_FORWARD_P(WindowPrivate)
 
@@ -156,6 +160,41 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     uint vao() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the immediate-mode primitive batch of this window. Anything
+    /// drawn with it is flushed after onRender().
+    ///
+    /// \returns the primitive batch.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    PrimitiveBatch* draw() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the keyboard state of the current frame. Unlike the state
+    /// passed to onKeyDown(), it can be queried at any time during onUpdate().
+    ///
+    /// \returns the keyboard state.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const KeyboardState& keyboard() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the mouse state of the current frame.
+    ///
+    /// \returns the mouse state.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    const MouseState& mouse() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Retrieves the time between the oldest input event of the last presented
+    /// frame and the swap of that frame, in milliseconds.
+    ///
+    /// \returns the input latency; -1 if not measured (yet).
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    float inputLatency() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Restores all OpenGL settings.
     ///
@@ -183,6 +222,25 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void hideDebugOverlay();
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Records a render command for the current frame. Commands run in the
+    /// order they were submitted, right after onRender(), on the thread that
+    /// owns the OpenGL context.
+    ///
+    /// \param command Command that renders, e.g. a lambda.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void submit(const std::function<void()>& command);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Adds \p object to the render queue of this window. Equivalent to
+    /// RenderBase::enqueue().
+    ///
+    /// \param object Object to render after onRender().
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void enqueue(RenderBase* object);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specify the settings for this window. Call this before you call start().
     ///
@@ -222,7 +280,20 @@ protected overridable:
     virtual void onInit() { }
     virtual void onExit() { }
     virtual void onCrash() { }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates the game logic of one frame. If WindowSettings::isThreaded()
+    /// is set, this runs on a separate thread rather than the one that owns
+    /// the window: the OpenGL context is not current there, QObjects created
+    /// within live on that thread and timers or queued connections of the
+    /// window's thread do not fire during the update. Rendering waits for
+    /// the update of its frame in either case.
+    ///
+    /// \param time Contains the delta time.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
     virtual void onUpdate(const GameTime&) { }
+
     virtual void onRender() { }
     virtual void onMouseMoved(const MouseMoveEvent&) { }
     virtual void onMouseButtonDown(const MouseState&) { }
@@ -33,9 +33,14 @@
 #include <Cranberry/Input/GamepadReleaseEvent.hpp>
 #include <Cranberry/Input/GamepadState.hpp>
 #include <Cranberry/System/GameTime.hpp>
+#include <Cranberry/Window/InputRing.hpp>
+#include <Cranberry/Window/RenderCommandList.hpp>
+#include <Cranberry/Window/RenderQueue.hpp>
 #include <Cranberry/Window/WindowSettings.hpp>
 
 // Qt headers
+#include <QAtomicInt>
+#include <QElapsedTimer>
 #include <QOpenGLWindow>
 
 // Forward declarations
@@ -44,9 +49,11 @@ CRANBERRY_FORWARD_Q(QOpenGLFunctions)
 CRANBERRY_FORWARD_C(Game)
 CRANBERRY_FORWARD_C(GuiManager)
 CRANBERRY_FORWARD_C(OpenGLShader)
+CRANBERRY_FORWARD_C(PrimitiveBatch)
 CRANBERRY_FORWARD_C(RenderBase)
 CRANBERRY_FORWARD_C(TreeModel)
 CRANBERRY_FORWARD_C(Window)
+CRANBERRY_FORWARD_P(UpdateThread)
 CRANBERRY_ALIAS(QList<cran::GuiManager*>, GuiWindows)
 
 
@@ -111,6 +118,15 @@ private:
     void renderDebugOverlay();
     void parseSettings();
     void destroyGL();
+    void pollInput();
+    void updateFrame();
+    void swapFrame();
+    void renderFrame();
+    void measureLatency();
+    void measureStartup();
+    void startUpdateThread();
+    void stopUpdateThread();
+    void finishUpdate();
     if_debug(void calculateFramerate())
 
     ////////////////////////////////////////////////////////////////////////////
@@ -120,11 +136,23 @@ private:
     cran::Window*     m_window;
     cran::RenderBase* m_dbgOverlay;
     GuiManager*       m_guiOverlay;
+    PrimitiveBatch*   m_draw;
     TreeModel*        m_debugModel;
     GuiWindows        m_guiWindows;
     GuiManager*       m_activeGui;
+    UpdateThread*     m_updateThread;
+    RenderCommandList m_commands;
+    RenderQueue       m_queue;
+    InputRing         m_input;
+    QElapsedTimer     m_inputClock;
+    QAtomicInt        m_inputLatency;
+    qint64            m_inputSampled;
+    qint64            m_inputShown;
+    qint64            m_initStarted;
+    qint64            m_firstFrame;
     WindowSettings    m_settings;
     GameTime          m_time;
+    double            m_fpsTime;
     KeyboardState     m_keyState;
     GamepadState      m_padState;
     MouseState        m_mouseState;
@@ -132,14 +160,15 @@ private:
     qint32            m_keyCount;
     qint32            m_padCount;
     qint32            m_btnCount;
+    qint32            m_fpsFrames;
     uint              m_vao;
-    uint              m_dbgFrames;
     bool              m_isMainWindow;
     bool              m_fakeFocusOut;
 
     friend class cran::Game;
     friend class cran::GuiManager;
     friend class cran::Window;
+    friend class UpdateThread;
 };
 
 
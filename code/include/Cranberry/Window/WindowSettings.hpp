@@ -90,6 +90,15 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     bool useVerticalSync() const;
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines whether Window::onUpdate() runs on its own thread. By
+    /// default, this value is \em false.
+    ///
+    /// \return true if updating on a separate thread.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isThreaded() const;
+
     ////////////////////////////////////////////////////////////////////////////
     /// Retrieves the title of the window. By default, this value is random.
     ///
@@ -158,6 +167,20 @@ public:
     ////////////////////////////////////////////////////////////////////////////
     void setVerticalSync(bool value);
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// Specifies whether Window::onUpdate() runs on its own thread. Only the
+    /// buffer swap of the previous frame and the event processing overlap
+    /// with the update; rendering always waits for the update of its frame,
+    /// so that Window::onRender() sees a consistent state. This pays off if
+    /// the swap blocks, e.g. with vertical sync. Neither onUpdate() nor
+    /// anything it calls may use OpenGL then, and QObjects used within must
+    /// cope with being accessed from another thread; see Window::onUpdate().
+    ///
+    /// \param value True to update on a separate thread.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    void setThreaded(bool value);
+
     ////////////////////////////////////////////////////////////////////////////
     /// Specifies the window's title.
     ///
@@ -211,6 +234,7 @@ private:
     bool    m_isFullscreen;     ///< Running fullscreen?
     bool    m_isDoubleBuffered; ///< Double-buffering window?
     bool    m_useVerticalSync;  ///< Use vertical synchronisation?
+    bool    m_isThreaded;       ///< Update on a separate thread?
     QString m_title;            ///< Window title
     QSize   m_size;             ///< Window size
     QPoint  m_pos;              ///< Window position
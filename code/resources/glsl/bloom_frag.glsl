@@ -0,0 +1,47 @@
+﻿#version %0
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Input variables
+in vec2 o_uv;
+
+// Output variables
+out vec4 o_pixel;
+
+// Cranberry uniform variables
+uniform sampler2D u_tex;   // blurred highlights
+uniform sampler2D u_scene; // unprocessed scene
+uniform float u_opac;
+
+// Bloom uniform variables
+uniform float u_intensity; // strength of the glow
+
+
+void main()
+{
+    vec4 scene = texture(u_scene, o_uv);
+    vec3 glow = texture(u_tex, o_uv).rgb * u_intensity;
+
+    // The glow also spreads onto transparent parts of the scene.
+    float alpha = clamp(scene.a + max(glow.r, max(glow.g, glow.b)), 0.0, 1.0);
+    o_pixel = vec4(scene.rgb + glow, alpha * u_opac);
+}
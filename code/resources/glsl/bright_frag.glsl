@@ -0,0 +1,46 @@
+﻿#version %0
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Input variables
+in vec2 o_uv;
+
+// Output variables
+out vec4 o_pixel;
+
+// Cranberry uniform variables
+uniform sampler2D u_tex;
+uniform float u_opac;
+
+// Bright uniform variables
+uniform float u_threshold; // brightness at which pixels start to glow
+
+
+void main()
+{
+    vec4 color = texture(u_tex, o_uv);
+    float bright = max(color.r, max(color.g, color.b));
+
+    // Keeps only the part of the pixel that is brighter than the threshold.
+    float factor = max(bright - u_threshold, 0.0) / max(bright, 0.0001);
+    o_pixel = vec4(color.rgb * factor, color.a * u_opac);
+}
@@ -0,0 +1,54 @@
+﻿#version %0
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Input variables
+in vec2 o_uv;
+
+// Output variables
+out vec4 o_pixel;
+
+// Cranberry uniform variables
+uniform sampler2D u_tex;
+uniform float u_opac;
+uniform vec2 u_winSize; // size of the source texture
+
+// Gauss uniform variables
+uniform vec2 u_direction; // (1, 0) for horizontal, (0, 1) for vertical
+uniform float u_radius;   // distance between the taps, in texels
+
+
+void main()
+{
+    // Nine taps in five fetches: two neighbouring taps are merged into one
+    // fetch between them, which the linear filter weights accordingly.
+    vec2 step = u_direction * u_radius / u_winSize;
+    vec4 final = texture(u_tex, o_uv) * 0.2270270270;
+
+    final += texture(u_tex, o_uv + step * 1.3846153846) * 0.3162162162;
+    final += texture(u_tex, o_uv - step * 1.3846153846) * 0.3162162162;
+    final += texture(u_tex, o_uv + step * 3.2307692308) * 0.0702702703;
+    final += texture(u_tex, o_uv - step * 3.2307692308) * 0.0702702703;
+
+    // Finally applies opacity and sets it as shader output.
+    o_pixel = vec4(final.rgb, final.a * u_opac);
+}
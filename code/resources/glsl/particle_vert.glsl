@@ -0,0 +1,55 @@
+﻿#version %0
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Input variables
+layout(location = 0) in vec3 i_xyz;
+layout(location = 1) in vec2 i_uv;
+layout(location = 2) in vec4 i_rgba;
+layout(location = 3) in vec4 i_inst;
+layout(location = 4) in vec4 i_color;
+
+// Output variables
+out vec2 o_uv;
+out vec4 o_rgba;
+
+// Uniform variables
+uniform mat4 u_mvp;
+uniform vec4 u_sourceRect;
+uniform vec2 u_uvOffset;
+
+
+void main()
+{
+    // i_inst holds the position, scale and rotation of the particle. The
+    // quad is scaled and rotated about its center.
+    vec2 pos = (i_xyz.xy - u_sourceRect.zw * 0.5) * i_inst.z;
+    float c = cos(i_inst.w);
+    float s = sin(i_inst.w);
+
+    pos = vec2(pos.x * c - pos.y * s, pos.x * s + pos.y * c) + i_inst.xy;
+
+    o_uv = i_uv + u_uvOffset;
+    o_rgba = i_rgba * i_color;
+    gl_Position = u_mvp * vec4(pos, 0.0, 1.0);
+}
@@ -31,10 +31,11 @@ out vec2 o_uv;
 
 // Uniform variables
 uniform mat4 u_mvp;
+uniform vec2 u_uvOffset;
 
 
 void main()
 {
-    o_uv = i_uv;
+    o_uv = i_uv + u_uvOffset;
     gl_Position = u_mvp * vec4(i_xyz, 1.0);
 }
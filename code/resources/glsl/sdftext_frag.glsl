@@ -0,0 +1,59 @@
+﻿#version %0
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Input variables
+in vec2 o_uv;
+in vec4 o_rgba;
+in vec4 o_outline;
+
+// Output variables
+out vec4 o_pixel;
+
+// Cranberry uniform variables
+uniform sampler2D u_tex;
+uniform float u_opac;
+uniform float u_outlineWidth;
+uniform float u_blurFactor;
+uniform float u_distanceScale;
+
+
+void main()
+{
+    // The distance field stores 0.5 on the glyph outline; one pixel at the
+    // base size equals u_distanceScale.
+    float dist = texture(u_tex, o_uv).r;
+    float soft = max(fwidth(dist) * 0.75, 0.0001) + u_blurFactor * u_distanceScale;
+    float edge = 0.5 - u_outlineWidth * u_distanceScale;
+
+    float fill = smoothstep(0.5 - soft, 0.5 + soft, dist);
+    float outer = smoothstep(edge - soft, edge + soft, dist);
+    float ring = max(outer - fill, 0.0);
+
+    // Composes fill and outline with premultiplied alpha, then converts back
+    // since the window blends with straight alpha.
+    float alpha = o_rgba.a * fill + o_outline.a * ring;
+    vec3 color = o_rgba.rgb * o_rgba.a * fill + o_outline.rgb * o_outline.a * ring;
+
+    o_pixel = vec4(color / max(alpha, 0.0001), alpha * u_opac);
+}
@@ -35,8 +35,8 @@ uniform int u_mode;
 uniform int u_effect;
 
 // Functions
-vec4 applyBlending(vec4);
-vec4 applyEffects(vec4);
+vec4 applyBlending(vec4, int);
+vec4 applyEffects(vec4, int);
 vec4 applyMultiply(vec4, vec4);
 vec4 applyScreen(vec4, vec4);
 vec4 applyOverlay(vec4, vec4);
@@ -57,34 +57,51 @@ void main()
     vec4 vecOpac = vec4(1.0, 1.0, 1.0, u_opac);
     vec4 vecPixel = texture(u_tex, o_uv);
 
-    vecPixel = applyBlending(vecPixel);
-    vecPixel = applyEffects(vecPixel);
+    // Variants have the blend mode and effect compiled in, so that the
+    // common case is nothing more than a texture fetch.
+#if defined(CB_VARIANT)
+#if CB_BLEND_MODE != 0
+    vecPixel = applyBlending(vecPixel, CB_BLEND_MODE);
+#endif
+#if CB_EFFECT != 0
+    vecPixel = applyEffects(vecPixel, CB_EFFECT);
+#endif
+#else
+    vecPixel = applyBlending(vecPixel, u_mode);
+    vecPixel = applyEffects(vecPixel, u_effect);
+#endif
+
+    // The blend modes keep the alpha of the texture; particles fade out by
+    // the alpha of their color.
+#if defined(CB_PARTICLE)
+    vecOpac.a *= o_rgba.a;
+#endif
 
     o_pixel = vecPixel * vecOpac;
 }
 
 
-vec4 applyBlending(vec4 p)
+vec4 applyBlending(vec4 p, int mode)
 {
-    if ((u_mode & 0x0001) != 0) return applyMultiply(p, o_rgba);
-    if ((u_mode & 0x0002) != 0) return applyScreen(p, o_rgba);
-    if ((u_mode & 0x0004) != 0) return applyOverlay(p, o_rgba);
-    if ((u_mode & 0x0008) != 0) return applyDivide(p, o_rgba);
-    if ((u_mode & 0x0010) != 0) return applyAdd(p, o_rgba);
-    if ((u_mode & 0x0020) != 0) return applySubtract(p, o_rgba);
-    if ((u_mode & 0x0040) != 0) return applyDiff(p, o_rgba);
-    if ((u_mode & 0x0080) != 0) return applyDarken(p, o_rgba);
-    if ((u_mode & 0x0100) != 0) return applyLighten(p, o_rgba);
+    if ((mode & 0x0001) != 0) return applyMultiply(p, o_rgba);
+    if ((mode & 0x0002) != 0) return applyScreen(p, o_rgba);
+    if ((mode & 0x0004) != 0) return applyOverlay(p, o_rgba);
+    if ((mode & 0x0008) != 0) return applyDivide(p, o_rgba);
+    if ((mode & 0x0010) != 0) return applyAdd(p, o_rgba);
+    if ((mode & 0x0020) != 0) return applySubtract(p, o_rgba);
+    if ((mode & 0x0040) != 0) return applyDiff(p, o_rgba);
+    if ((mode & 0x0080) != 0) return applyDarken(p, o_rgba);
+    if ((mode & 0x0100) != 0) return applyLighten(p, o_rgba);
     return p;
 }
 
 
-vec4 applyEffects(vec4 p)
+vec4 applyEffects(vec4 p, int effect)
 {
-    if (u_effect == 1) return applyGrayscale(p);
-    if (u_effect == 2) return applySepia(p);
-    if (u_effect == 3) return applyInvert(p);
-    if (u_effect == 4) return applySilhouette(p);
+    if (effect == 1) return applyGrayscale(p);
+    if (effect == 2) return applySepia(p);
+    if (effect == 3) return applyInvert(p);
+    if (effect == 4) return applySilhouette(p);
     return p;
 }
 
@@ -32,11 +32,12 @@ out vec4 o_rgba;
 
 // Uniform variables
 uniform mat4 u_mvp;
+uniform vec2 u_uvOffset;
 
 
 void main()
 {
-    o_uv = i_uv;
+    o_uv = i_uv + u_uvOffset;
     o_rgba = i_rgba;
     gl_Position = u_mvp * vec4(i_xyz, 1.0);
 }
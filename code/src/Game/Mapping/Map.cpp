@@ -21,9 +21,12 @@
 
 // Cranberry headers
 #include <Cranberry/Game/Mapping/Map.hpp>
+#include <Cranberry/Game/Mapping/MapNavigationGrid.hpp>
 #include <Cranberry/Game/Mapping/MapObjectLayer.hpp>
 #include <Cranberry/Game/Mapping/MapTileLayer.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 // Qt headers
 #include <QFile>
@@ -36,6 +39,9 @@ CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Could not open map file \"%2\".")
 CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Could not parse tileset.")
 CRANBERRY_CONST_VAR(QString, e_03, "%0 [%1] - Could not parse layer.")
 
+// Globals
+CRANBERRY_GLOBAL_VAR(QVector<cran::MapObject*>, g_noObjects)
+
 
 CRANBERRY_USING_NAMESPACE
 
@@ -174,26 +180,37 @@ MapLayer* Map::layerByName(const QString& name) const
 
 MapObject* Map::objectByName(const QString& name) const
 {
-    for (MapLayer* layer : m_layers)
+    return m_objectsByName.value(name, nullptr);
+}
+
+
+const QVector<MapObject*>& Map::objectsByType(const QString& type) const
+{
+    auto it = m_objectsByType.find(type);
+    if (it == m_objectsByType.end())
     {
-        if (layer->layerType() == LayerTypeObject)
-        {
-            const MapObjectLayer* ol = static_cast<MapObjectLayer*>(layer);
-            for (MapObject* o : ol->objects())
-            {
-                if (o->name() == name)
-                {
-                    return o;
-                }
-            }
-        }
+        return g_noObjects;
     }
+    else
+    {
+        return it.value();
+    }
+}
 
-    return nullptr;
+
+MapCollisionGrid& Map::collisionGrid()
+{
+    return m_collisionGrid;
 }
 
 
-const QMap<QString, QVariant>& Map::properties() const
+const MapCollisionGrid& Map::collisionGrid() const
+{
+    return m_collisionGrid;
+}
+
+
+const MapProperties& Map::properties() const
 {
     return m_properties;
 }
@@ -231,7 +248,10 @@ bool Map::create(const QString& mapPath, Window* rt)
 
     setSize(m_width * m_tileWidth, m_height * m_tileHeight);
 
-    return loadTilesets(&mapNode) && loadLayers(&mapNode) && loadProperties(&mapNode);
+    return loadTilesets(&mapNode) &&
+           loadLayers(&mapNode) &&
+           loadProperties(&mapNode) &&
+           m_collisionGrid.create(this);
 }
 
 
@@ -249,8 +269,19 @@ void Map::destroy()
 
     delete m_player;
 
+    // The navigation grids keep their bits, but can no longer be updated.
+    for (MapNavigationGrid* grid : m_navigationGrids)
+    {
+        grid->m_map = nullptr;
+        grid->m_layer = nullptr;
+    }
+
+    m_player = nullptr;
     m_layers.clear();
     m_tilesets.clear();
+    m_objectsByName.clear();
+    m_objectsByType.clear();
+    m_navigationGrids.clear();
 
     RenderBase::destroy();
 }
@@ -260,17 +291,22 @@ void Map::update(const GameTime& time)
 {
     updateTransform(time);
 
-    for (MapLayer* layer : m_layers)
-    {
-        layer->update(time);
-    }
+    JobSystem::instance()->updateObjects(m_layers, time);
 
     m_player->update(time);
+
+    // The player moves within the map; its position is no revision.
+    if (m_player->isMoving())
+    {
+        markDirty();
+    }
 }
 
 
 void Map::render()
 {
+    cranProfile("Map::render");
+
     for (MapLayer* layer : m_layers)
     {
         if (layer->isVisible())
@@ -283,6 +319,23 @@ void Map::render()
 }
 
 
+quint64 Map::revision() const
+{
+    quint64 revision = RenderBase::revision();
+    for (MapLayer* layer : m_layers)
+    {
+        revision += layer->revision();
+    }
+
+    if (m_player != nullptr && m_player->renderObject() != nullptr)
+    {
+        revision += m_player->renderObject()->revision();
+    }
+
+    return revision;
+}
+
+
 bool Map::loadTilesets(QDomElement* elem)
 {
     QDomNodeList listTileset = elem->elementsByTagName("tileset");
@@ -327,6 +380,7 @@ bool Map::loadLayers(QDomElement* elem)
             }
 
             m_layers.append(layer);
+            indexObjects(layer);
         }
     }
 
@@ -341,3 +395,72 @@ bool Map::loadProperties(QDomElement* elem)
 
     return true;
 }
+
+
+void Map::indexObjects(const MapObjectLayer* layer)
+{
+    for (MapObject* obj : layer->objects())
+    {
+        if (!obj->name().isEmpty() && !m_objectsByName.contains(obj->name()))
+        {
+            m_objectsByName.insert(obj->name(), obj);
+        }
+
+        if (!obj->type().isEmpty())
+        {
+            m_objectsByType[obj->type()].append(obj);
+        }
+    }
+}
+
+
+void Map::reindexName(const QString& name)
+{
+    // The object layers are already up to date; the lowest one wins.
+    m_objectsByName.remove(name);
+    for (MapLayer* layer : m_layers)
+    {
+        if (layer->layerType() == LayerTypeObject)
+        {
+            MapObject* obj = static_cast<MapObjectLayer*>(layer)->objectByName(name);
+            if (obj != nullptr)
+            {
+                m_objectsByName.insert(name, obj);
+                break;
+            }
+        }
+    }
+}
+
+
+void Map::reindexType(const QString& type)
+{
+    QVector<MapObject*> objects;
+    for (MapLayer* layer : m_layers)
+    {
+        if (layer->layerType() == LayerTypeObject)
+        {
+            objects += static_cast<MapObjectLayer*>(layer)->objectsByType(type);
+        }
+    }
+
+    if (objects.isEmpty())
+    {
+        m_objectsByType.remove(type);
+    }
+    else
+    {
+        m_objectsByType.insert(type, objects);
+    }
+}
+
+
+void Map::updateGrids(int x, int y)
+{
+    m_collisionGrid.updateTile(x, y);
+
+    for (MapNavigationGrid* grid : m_navigationGrids)
+    {
+        grid->updateTile(x, y);
+    }
+}
@@ -0,0 +1,95 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapBitGrid.hpp>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapBitGrid::MapBitGrid()
+    : m_width(0)
+    , m_height(0)
+    , m_stride(0)
+{
+}
+
+
+bool MapBitGrid::isNull() const
+{
+    return m_width == 0 || m_height == 0;
+}
+
+
+int MapBitGrid::width() const
+{
+    return m_width;
+}
+
+
+int MapBitGrid::height() const
+{
+    return m_height;
+}
+
+
+bool MapBitGrid::setBit(int x, int y, bool value)
+{
+    if (uint(x) >= uint(m_width) || uint(y) >= uint(m_height))
+    {
+        return false;
+    }
+
+    quint64& word = m_words[y * m_stride + (x >> 6)];
+    const quint64 bit = quint64(1) << (x & 63);
+    const quint64 old = word;
+
+    if (value)
+    {
+        word |= bit;
+    }
+    else
+    {
+        word &= ~bit;
+    }
+
+    return word != old;
+}
+
+
+void MapBitGrid::allocate(int width, int height, bool value)
+{
+    m_width = width;
+    m_height = height;
+    m_stride = (width + 63) / 64;
+    m_words.fill(value ? ~quint64(0) : 0, m_stride * height);
+
+    // Clears the padding bits so that they never read as set.
+    if (value && (width & 63))
+    {
+        const quint64 mask = (quint64(1) << (width & 63)) - 1;
+        for (int y = 0; y < height; y++)
+        {
+            m_words[y * m_stride + m_stride - 1] &= mask;
+        }
+    }
+}
@@ -0,0 +1,314 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/Map.hpp>
+#include <Cranberry/Game/Mapping/MapCollisionGrid.hpp>
+#include <Cranberry/Game/Mapping/MapObjectLayer.hpp>
+#include <Cranberry/Game/Mapping/MapTileLayer.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Qt headers
+#include <QRect>
+
+// Standard headers
+#include <cmath>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "Collision grid: Map is null.")
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapCollisionGrid::MapCollisionGrid()
+    : m_map(nullptr)
+    , m_solidKey(-1)
+    , m_freeLink(-1)
+{
+}
+
+
+bool MapCollisionGrid::isNull() const
+{
+    return m_solid.isNull();
+}
+
+
+int MapCollisionGrid::width() const
+{
+    return m_solid.width();
+}
+
+
+int MapCollisionGrid::height() const
+{
+    return m_solid.height();
+}
+
+
+int MapCollisionGrid::objectsAt(int x, int y, QVector<ObjectEntry>& entries) const
+{
+    entries.clear();
+    if (uint(x) >= uint(width()) || uint(y) >= uint(height()))
+    {
+        return 0;
+    }
+
+    for (int i = m_firstLink.at(y * width() + x); i != -1; i = m_links.at(i).next)
+    {
+        entries.append(m_links.at(i).entry);
+    }
+
+    return entries.size();
+}
+
+
+void MapCollisionGrid::setSolid(int x, int y, bool solid)
+{
+    m_solid.setBit(x, y, solid);
+}
+
+
+bool MapCollisionGrid::create(const Map* map, const QString& solidProperty)
+{
+    if (map == nullptr || map->mapWidth() <= 0 || map->mapHeight() <= 0)
+    {
+        return cranError(e_01);
+    }
+
+    m_map = map;
+    m_solidKey = solidProperty.isEmpty() ? -1 : MapPropertyKeys::find(solidProperty);
+    m_solid.allocate(map->mapWidth(), map->mapHeight(), false);
+
+    // Resolves the property once per tileset tile rather than once per map
+    // tile, so that evaluating a tile never touches the property tables.
+    m_solidTiles.clear();
+    for (MapTileset* tileset : map->tilesets())
+    {
+        QVector<bool> solid(tileset->tileCount(), false);
+        for (int i = 0; i < tileset->tileCount(); i++)
+        {
+            solid[i] = tileset->tileProperties(i).toBool(m_solidKey);
+        }
+
+        m_solidTiles.append(solid);
+    }
+
+    // Links every object to all tiles it covers, in layer order.
+    m_firstLink.fill(-1, width() * height());
+    m_links.clear();
+    m_freeLink = -1;
+    m_objectSlots.clear();
+
+    for (MapLayer* layer : map->layers())
+    {
+        if (layer->layerType() != LayerTypeObject) continue;
+
+        const MapObjectLayer* ol = static_cast<MapObjectLayer*>(layer);
+        for (MapObject* o : ol->objects())
+        {
+            ObjectSlot slot;
+            slot.layer = ol;
+            slot.tiles = coveredTiles(o);
+            slot.solid = o->properties().toBool(m_solidKey);
+
+            linkObject(o, slot);
+            m_objectSlots.insert(o, slot);
+        }
+    }
+
+    for (int y = 0; y < height(); y++)
+    {
+        for (int x = 0; x < width(); x++)
+        {
+            evaluateTile(x, y);
+        }
+    }
+
+    return true;
+}
+
+
+void MapCollisionGrid::updateTile(int x, int y)
+{
+    if (m_map != nullptr && uint(x) < uint(width()) && uint(y) < uint(height()))
+    {
+        evaluateTile(x, y);
+    }
+}
+
+
+void MapCollisionGrid::updateObject(MapObject* object)
+{
+    auto it = m_objectSlots.find(object);
+    if (it == m_objectSlots.end())
+    {
+        return;
+    }
+
+    const QRect oldTiles = it->tiles;
+    const bool oldSolid = it->solid;
+
+    it->tiles = coveredTiles(object);
+    it->solid = object->properties().toBool(m_solidKey);
+
+    if (it->tiles == oldTiles && it->solid == oldSolid)
+    {
+        return;
+    }
+
+    unlinkObject(object, oldTiles);
+    linkObject(object, *it);
+
+    // Re-evaluates the tiles the object left and the ones it entered.
+    for (const QRect& r : { oldTiles, it->tiles })
+    {
+        for (int y = r.top(); y <= r.bottom(); y++)
+        {
+            for (int x = r.left(); x <= r.right(); x++)
+            {
+                evaluateTile(x, y);
+            }
+        }
+    }
+}
+
+
+QRect MapCollisionGrid::coveredTiles(const MapObject* o) const
+{
+    if (o->isNull())
+    {
+        return QRect();
+    }
+
+    const int tw = m_map->tileWidth();
+    const int th = m_map->tileHeight();
+    const int x0 = static_cast<int>(std::floor(o->x() / tw));
+    const int y0 = static_cast<int>(std::floor(o->y() / th));
+    const int x1 = (o->width() > 0)
+            ? static_cast<int>(std::floor((o->x() + o->width() - 1) / tw))
+            : x0;
+    const int y1 = (o->height() > 0)
+            ? static_cast<int>(std::floor((o->y() + o->height() - 1) / th))
+            : y0;
+
+    return QRect(QPoint(x0, y0), QPoint(x1, y1)).intersected(QRect(0, 0, width(), height()));
+}
+
+
+void MapCollisionGrid::linkObject(MapObject* object, const ObjectSlot& slot)
+{
+    const QRect& r = slot.tiles;
+    for (int y = r.top(); y <= r.bottom(); y++)
+    {
+        for (int x = r.left(); x <= r.right(); x++)
+        {
+            // Reuses the links of removed objects before growing the pool.
+            int link = m_freeLink;
+            if (link != -1)
+            {
+                m_freeLink = m_links.at(link).next;
+            }
+            else
+            {
+                link = m_links.size();
+                m_links.append(Link());
+            }
+
+            Link& l = m_links[link];
+            l.entry.object = object;
+            l.entry.layer = slot.layer;
+            l.solid = slot.solid;
+            l.next = -1;
+
+            // Appends the link, so that objects keep their layer order.
+            int* tail = &m_firstLink[y * width() + x];
+            while (*tail != -1)
+            {
+                tail = &m_links[*tail].next;
+            }
+
+            *tail = link;
+        }
+    }
+}
+
+
+void MapCollisionGrid::unlinkObject(const MapObject* object, const QRect& tiles)
+{
+    for (int y = tiles.top(); y <= tiles.bottom(); y++)
+    {
+        for (int x = tiles.left(); x <= tiles.right(); x++)
+        {
+            int* prev = &m_firstLink[y * width() + x];
+            while (*prev != -1)
+            {
+                const int link = *prev;
+                if (m_links.at(link).entry.object != object)
+                {
+                    prev = &m_links[link].next;
+                    continue;
+                }
+
+                *prev = m_links.at(link).next;
+                m_links[link].next = m_freeLink;
+                m_freeLink = link;
+                break;
+            }
+        }
+    }
+}
+
+
+void MapCollisionGrid::evaluateTile(int x, int y)
+{
+    const int index = y * width() + x;
+    bool solid = false;
+
+    for (MapLayer* layer : m_map->layers())
+    {
+        if (layer->layerType() != LayerTypeTile)
+        {
+            continue;
+        }
+
+        const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
+        if (index >= tl->tiles().size())
+        {
+            continue;
+        }
+
+        const MapTile& tile = tl->tiles().at(index);
+        if (!tile.isNull() && tile.tilesetId() < m_solidTiles.size())
+        {
+            const QVector<bool>& flags = m_solidTiles.at(tile.tilesetId());
+            solid |= tile.tileId() < flags.size() && flags.at(tile.tileId());
+        }
+    }
+
+    for (int i = m_firstLink.at(index); i != -1 && !solid; i = m_links.at(i).next)
+    {
+        solid = m_links.at(i).solid;
+    }
+
+    m_solid.setBit(x, y, solid);
+}
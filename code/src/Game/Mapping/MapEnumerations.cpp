@@ -21,11 +21,45 @@
 
 // Cranberry headers
 #include <Cranberry/Game/Mapping/Enumerations.hpp>
+#include <Cranberry/Game/Mapping/MapProperties.hpp>
 
 // Qt headers
 #include <QtXml/QDomElement>
 
 
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////
+    /// Parses the properties of a TMX element and hands the name, type and
+    /// string value of each one to \p store.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename Fn>
+    void forEachTmxProperty(QDomElement* element, Fn store)
+    {
+        if (element->isNull())
+        {
+            return;
+        }
+
+        auto elemList = element->elementsByTagName("property");
+        for (int i = 0; i < elemList.size(); i++)
+        {
+            QDomElement elem = elemList.at(i).toElement();
+            QString value = elem.attribute("value");
+
+            if (value.isEmpty())
+            {
+                // TMX appearantly saves multi-line strings inside the element.
+                value = elem.nodeValue();
+            }
+
+            store(elem.attribute("name"), cran::getPropertyTypeFromString(elem.attribute("type")), value);
+        }
+    }
+}
+
+
 QColor cran::getColorFromString(QString str)
 {
     if (str.isEmpty()) return QColor();
@@ -99,26 +133,26 @@ QVariant cran::getPropertyValue(PropertyType type, const QString& value)
 
 void cran::getTmxProperties(QDomElement* element, QMap<QString, QVariant>& props)
 {
-    if (!element->isNull())
+    forEachTmxProperty(element, [&] (const QString& name, PropertyType type, const QString& value)
     {
-        auto elemList = element->elementsByTagName("property");
-        for (int i = 0; i < elemList.size(); i++)
-        {
-            QDomElement elem = elemList.at(i).toElement();
-            QString name = elem.attribute("name");
-            QString type = elem.attribute("type");
-            QString value = elem.attribute("value");
-            PropertyType t = getPropertyTypeFromString(type);
+        props.insert(name, getPropertyValue(type, value));
+    });
+}
 
-            if (value.isEmpty())
-            {
-                // TMX appearantly saves multi-line strings inside the element.
-                props.insert(name, getPropertyValue(t, elem.nodeValue()));
-            }
-            else
-            {
-                props.insert(name, getPropertyValue(t, value));
-            }
-        }
-    }
+
+void cran::getTmxProperties(QDomElement* element, MapProperties& props)
+{
+    forEachTmxProperty(element, [&] (const QString& name, PropertyType type, const QString& value)
+    {
+        props.setValue(MapPropertyKeys::intern(name), type, value);
+    });
+}
+
+
+void cran::getTmxProperties(QDomElement* element, MapPropertyTable& table, int row)
+{
+    forEachTmxProperty(element, [&] (const QString& name, PropertyType type, const QString& value)
+    {
+        table.setValue(row, MapPropertyKeys::intern(name), type, value);
+    });
 }
@@ -0,0 +1,97 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapFlowField.hpp>
+
+// Standard headers
+#include <array>
+
+// Constants
+CRANBERRY_CONST_ARR(int, 8, c_dirX, 1, 1, 0, -1, -1, -1, 0, 1)
+CRANBERRY_CONST_ARR(int, 8, c_dirY, 0, 1, 1, 1, 0, -1, -1, -1)
+CRANBERRY_CONST_VAR(quint8, c_none, 0xFF)
+CRANBERRY_CONST_VAR(quint32, c_unreachable, 0xFFFFFFFF)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapFlowField::MapFlowField()
+    : m_goal(-1, -1)
+    , m_width(0)
+    , m_height(0)
+    , m_gridVersion(0)
+{
+}
+
+
+bool MapFlowField::isNull() const
+{
+    return m_width == 0 || m_height == 0;
+}
+
+
+const QPoint& MapFlowField::goal() const
+{
+    return m_goal;
+}
+
+
+uint MapFlowField::gridVersion() const
+{
+    return m_gridVersion;
+}
+
+
+bool MapFlowField::isReachable(int x, int y) const
+{
+    return distance(x, y) != -1;
+}
+
+
+QPoint MapFlowField::direction(int x, int y) const
+{
+    if (uint(x) >= uint(m_width) || uint(y) >= uint(m_height))
+    {
+        return QPoint();
+    }
+
+    const quint8 dir = m_directions.at(y * m_width + x);
+    if (dir == c_none)
+    {
+        return QPoint();
+    }
+
+    return QPoint(c_dirX[dir], c_dirY[dir]);
+}
+
+
+int MapFlowField::distance(int x, int y) const
+{
+    if (uint(x) >= uint(m_width) || uint(y) >= uint(m_height))
+    {
+        return -1;
+    }
+
+    const quint32 cost = m_costs.at(y * m_width + x);
+    return (cost == c_unreachable) ? -1 : static_cast<int>(cost);
+}
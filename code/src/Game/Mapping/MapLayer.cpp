@@ -31,6 +31,7 @@ MapLayer::MapLayer(Map* parent)
     : m_parent(parent)
     , m_opacity(1.0f)
     , m_isVisible(true)
+    , m_isThreadSafe(false)
     , m_offsetX(0)
     , m_offsetY(0)
 {
@@ -61,6 +62,12 @@ bool MapLayer::isVisible() const
 }
 
 
+bool MapLayer::isThreadSafe() const
+{
+    return m_isThreadSafe;
+}
+
+
 int MapLayer::layerId() const
 {
     return m_layerId;
@@ -97,6 +104,12 @@ void MapLayer::setVisibility(bool visible)
 }
 
 
+void MapLayer::setThreadSafe(bool threadSafe)
+{
+    m_isThreadSafe = threadSafe;
+}
+
+
 void MapLayer::setLayerId(int id)
 {
     m_layerId = id;
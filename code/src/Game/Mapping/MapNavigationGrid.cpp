@@ -0,0 +1,343 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/Map.hpp>
+#include <Cranberry/Game/Mapping/MapNavigationGrid.hpp>
+#include <Cranberry/Game/Mapping/MapTileLayer.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "Navigation grid: Invalid size %0x%1.")
+CRANBERRY_CONST_VAR(QString, e_02, "Navigation grid: Map is null.")
+CRANBERRY_CONST_VAR(QString, e_03, "Navigation grid: Layer does not match map size.")
+CRANBERRY_CONST_VAR(int, c_maxChanges, 4096)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapNavigationGrid::MapNavigationGrid()
+    : m_map(nullptr)
+    , m_layer(nullptr)
+    , m_changesFrom(0)
+    , m_version(0)
+{
+}
+
+
+MapNavigationGrid::MapNavigationGrid(const MapNavigationGrid& other)
+    : m_map(nullptr)
+    , m_layer(other.m_layer)
+    , m_solidTiles(other.m_solidTiles)
+    , m_walkable(other.m_walkable)
+    , m_changes(other.m_changes)
+    , m_changesFrom(other.m_changesFrom)
+    , m_version(other.m_version)
+{
+    attach(other.m_map);
+}
+
+
+MapNavigationGrid::~MapNavigationGrid()
+{
+    attach(nullptr);
+}
+
+
+MapNavigationGrid& MapNavigationGrid::operator =(const MapNavigationGrid& other)
+{
+    if (this != &other)
+    {
+        attach(other.m_map);
+
+        m_layer = other.m_layer;
+        m_solidTiles = other.m_solidTiles;
+        m_walkable = other.m_walkable;
+        m_changes = other.m_changes;
+        m_changesFrom = other.m_changesFrom;
+        m_version = other.m_version;
+    }
+
+    return *this;
+}
+
+
+bool MapNavigationGrid::isNull() const
+{
+    return m_walkable.isNull();
+}
+
+
+int MapNavigationGrid::width() const
+{
+    return m_walkable.width();
+}
+
+
+int MapNavigationGrid::height() const
+{
+    return m_walkable.height();
+}
+
+
+uint MapNavigationGrid::version() const
+{
+    return m_version;
+}
+
+
+bool MapNavigationGrid::changesSince(uint version, QVector<QPoint>& tiles) const
+{
+    tiles.clear();
+    if (version < m_changesFrom)
+    {
+        return false;
+    }
+
+    for (const Change& change : m_changes)
+    {
+        if (change.version > version)
+        {
+            tiles.append(change.tile);
+        }
+    }
+
+    return true;
+}
+
+
+void MapNavigationGrid::setWalkable(int x, int y, bool walkable)
+{
+    if (writeTile(x, y, walkable))
+    {
+        m_version++;
+    }
+}
+
+
+bool MapNavigationGrid::create(int width, int height)
+{
+    attach(nullptr);
+    m_layer = nullptr;
+    m_solidTiles.clear();
+
+    return allocate(width, height);
+}
+
+
+bool MapNavigationGrid::create(const Map* map, const QString& property)
+{
+    if (map == nullptr || map->isNull())
+    {
+        return cranError(e_02);
+    }
+
+    // Resolves the property once per tileset tile rather than once per map
+    // tile, so that evaluating a tile never touches the property maps.
+    MapPropertyKey key = MapPropertyKeys::find(property);
+    m_solidTiles.clear();
+    for (MapTileset* tileset : map->tilesets())
+    {
+        QVector<bool> solid(tileset->tileCount(), false);
+        for (int i = 0; i < tileset->tileCount(); i++)
+        {
+            solid[i] = tileset->tileProperties(i).toBool(key);
+        }
+
+        m_solidTiles.append(solid);
+    }
+
+    m_layer = nullptr;
+
+    return createInternal(map);
+}
+
+
+bool MapNavigationGrid::create(const Map* map, const MapTileLayer* layer)
+{
+    if (map == nullptr || map->isNull())
+    {
+        return cranError(e_02);
+    }
+
+    if (layer == nullptr || layer->tiles().size() < map->mapWidth() * map->mapHeight())
+    {
+        return cranError(e_03);
+    }
+
+    m_solidTiles.clear();
+    m_layer = layer;
+
+    return createInternal(map);
+}
+
+
+void MapNavigationGrid::updateTile(int x, int y)
+{
+    if (m_map != nullptr &&
+        uint(x) < uint(width()) &&
+        uint(y) < uint(height()) &&
+        writeTile(x, y, !evaluateTile(x, y)))
+    {
+        m_version++;
+    }
+}
+
+
+void MapNavigationGrid::updateRegion(const QRect& region)
+{
+    if (m_map == nullptr)
+    {
+        return;
+    }
+
+    bool changed = false;
+    QRect r = region.intersected(QRect(0, 0, width(), height()));
+
+    for (int y = r.top(); y <= r.bottom(); y++)
+    {
+        for (int x = r.left(); x <= r.right(); x++)
+        {
+            changed |= writeTile(x, y, !evaluateTile(x, y));
+        }
+    }
+
+    if (changed)
+    {
+        m_version++;
+    }
+}
+
+
+bool MapNavigationGrid::createInternal(const Map* map)
+{
+    if (!allocate(map->mapWidth(), map->mapHeight()))
+    {
+        return false;
+    }
+
+    attach(map);
+
+    for (int y = 0; y < height(); y++)
+    {
+        for (int x = 0; x < width(); x++)
+        {
+            if (evaluateTile(x, y))
+            {
+                m_walkable.setBit(x, y, false);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool MapNavigationGrid::allocate(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return cranError(e_01.arg(width).arg(height));
+    }
+
+    m_walkable.allocate(width, height, true);
+    m_changes.clear();
+    m_changesFrom = ++m_version;
+
+    return true;
+}
+
+
+bool MapNavigationGrid::evaluateTile(int x, int y) const
+{
+    const int index = y * width() + x;
+
+    if (m_layer != nullptr)
+    {
+        return !m_layer->tiles().at(index).isNull();
+    }
+
+    for (MapLayer* layer : m_map->layers())
+    {
+        if (layer->layerType() != LayerTypeTile)
+        {
+            continue;
+        }
+
+        const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
+        if (index >= tl->tiles().size())
+        {
+            continue;
+        }
+
+        const MapTile& tile = tl->tiles().at(index);
+        if (!tile.isNull())
+        {
+            const QVector<bool>& solid = m_solidTiles.at(tile.tilesetId());
+            if (tile.tileId() < solid.size() && solid.at(tile.tileId()))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+
+bool MapNavigationGrid::writeTile(int x, int y, bool walkable)
+{
+    if (!m_walkable.setBit(x, y, walkable))
+    {
+        return false;
+    }
+
+    // Forgets the older half of the changes once the log is full; versions
+    // before the remaining changes are no longer known.
+    if (m_changes.size() >= c_maxChanges)
+    {
+        const int half = c_maxChanges / 2;
+        m_changesFrom = m_changes.at(half - 1).version;
+        m_changes.remove(0, half);
+    }
+
+    m_changes.append({ m_version + 1, QPoint(x, y) });
+
+    return true;
+}
+
+
+void MapNavigationGrid::attach(const Map* map)
+{
+    if (m_map != nullptr)
+    {
+        m_map->m_navigationGrids.removeOne(this);
+    }
+
+    m_map = map;
+
+    if (m_map != nullptr)
+    {
+        m_map->m_navigationGrids.append(this);
+    }
+}
@@ -21,7 +21,9 @@
 
 // Cranberry headers
 #include <Cranberry/Game/Mapping/MapObject.hpp>
+#include <Cranberry/Game/Mapping/MapObjectLayer.hpp>
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 
 CRANBERRY_USING_NAMESPACE
@@ -29,6 +31,7 @@ CRANBERRY_USING_NAMESPACE
 
 MapObject::MapObject()
     : m_id(-1)
+    , m_layer(nullptr)
     , m_renderObject(nullptr)
     , m_takeOwnership(false)
 {
@@ -68,10 +71,15 @@ const QString& MapObject::type() const
 }
 
 
-const QVariant& MapObject::propertyValue(const QString& property) const
+QVariant MapObject::propertyValue(const QString& property) const
 {
-    auto it = m_properties.find(property);
-    return it.value();
+    return m_properties.value(property);
+}
+
+
+QVariant MapObject::propertyValue(MapPropertyKey key) const
+{
+    return m_properties.value(key);
 }
 
 
@@ -81,7 +89,13 @@ RenderBase* MapObject::renderObject() const
 }
 
 
-QMap<QString, QVariant>& MapObject::properties()
+MapProperties& MapObject::properties()
+{
+    return m_properties;
+}
+
+
+const MapProperties& MapObject::properties() const
 {
     return m_properties;
 }
@@ -95,13 +109,37 @@ void MapObject::setId(int id)
 
 void MapObject::setName(const QString &name)
 {
+    if (name == m_name) return;
+
+    const QString previous = m_name;
     m_name = name;
+
+    if (m_layer != nullptr)
+    {
+        m_layer->reindexName(previous);
+        m_layer->reindexName(name);
+    }
 }
 
 
 void MapObject::setType(const QString &type)
 {
+    if (type == m_type) return;
+
+    const QString previous = m_type;
     m_type = type;
+
+    if (m_layer != nullptr)
+    {
+        m_layer->reindexType(previous);
+        m_layer->reindexType(type);
+    }
+}
+
+
+void MapObject::setProperties(const MapProperties& props)
+{
+    m_properties = props;
 }
 
 
@@ -123,6 +161,8 @@ void MapObject::update(const GameTime& time)
 
 void MapObject::render()
 {
+    cranProfile("MapObject::render");
+
     if (m_renderObject != nullptr)
     {
         copyTransform(this, m_renderObject, true);
@@ -23,6 +23,8 @@
 #include <Cranberry/Game/Mapping/Map.hpp>
 #include <Cranberry/Game/Mapping/MapObjectLayer.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 // Qt headers
 #include <QDomElement>
@@ -35,6 +37,9 @@ CRANBERRY_CONST_VAR(QString, e_04, "TMX (object): Y attribute is missing.")
 CRANBERRY_CONST_VAR(QString, e_05, "TMX (object): Width attribute is missing.")
 CRANBERRY_CONST_VAR(QString, e_06, "TMX (object): Height attribute is missing.")
 
+// Globals
+CRANBERRY_GLOBAL_VAR(QVector<cran::MapObject*>, g_noObjects)
+
 
 CRANBERRY_USING_NAMESPACE
 
@@ -56,15 +61,21 @@ MapObjectLayer::~MapObjectLayer()
 
 MapObject* MapObjectLayer::objectByName(const QString& name) const
 {
-    for (MapObject* obj : m_objects)
+    return m_objectsByName.value(name, nullptr);
+}
+
+
+const QVector<MapObject*>& MapObjectLayer::objectsByType(const QString& type) const
+{
+    auto it = m_objectsByType.find(type);
+    if (it == m_objectsByType.end())
     {
-        if (obj->name() == name)
-        {
-            return obj;
-        }
+        return g_noObjects;
+    }
+    else
+    {
+        return it.value();
     }
-
-    return nullptr;
 }
 
 
@@ -108,8 +119,12 @@ bool MapObjectLayer::parse(QDomElement* xmlElement, int layerId)
         setOffsetY(xmlElement->attribute("offsety").toInt());
     }
 
-    // Parses the object data.
+    // Parses the object data. All objects of this layer store their
+    // properties in one table, one row per object.
     QDomNodeList listObject = xmlElement->elementsByTagName("object");
+    m_properties = QExplicitlySharedDataPointer<MapPropertyTable>(new MapPropertyTable);
+    m_properties->addRows(listObject.size());
+
     for (int i = 0; i < listObject.size(); i++)
     {
         MapObject* obj = new MapObject;
@@ -179,8 +194,28 @@ bool MapObjectLayer::parse(QDomElement* xmlElement, int layerId)
             obj->setType(elem.attribute("type"));
         }
 
-        getTmxProperties(&props, obj->properties());
+        // Writes into the shared table; the properties of the object would
+        // copy their row on every write.
+        getTmxProperties(&props, *m_properties, i);
+        obj->setProperties(MapProperties(m_properties, i));
+
+        // The first object with a given name wins, like the former linear scan.
+        if (!obj->name().isEmpty() && !m_objectsByName.contains(obj->name()))
+        {
+            m_objectsByName.insert(obj->name(), obj);
+        }
+
+        if (!obj->type().isEmpty())
+        {
+            m_objectsByType[obj->type()].append(obj);
+        }
+
+        // Keeps the collision grid of the map in sync with the object.
+        auto relink = [this, obj] { map()->collisionGrid().updateObject(obj); };
+        QObject::connect(obj->signals(), &TransformBaseEmitter::positionChanged, relink);
+        QObject::connect(obj->signals(), &TransformBaseEmitter::sizeChanged, relink);
 
+        obj->m_layer = this;
         m_objects.append(obj);
     }
 
@@ -188,23 +223,111 @@ bool MapObjectLayer::parse(QDomElement* xmlElement, int layerId)
 }
 
 
+void MapObjectLayer::reindexName(const QString& name)
+{
+    if (name.isEmpty())
+    {
+        return;
+    }
+
+    // The first object with the name wins, as when loading.
+    m_objectsByName.remove(name);
+    for (MapObject* obj : m_objects)
+    {
+        if (obj->name() == name)
+        {
+            m_objectsByName.insert(name, obj);
+            break;
+        }
+    }
+
+    if (map() != nullptr)
+    {
+        map()->reindexName(name);
+    }
+}
+
+
+void MapObjectLayer::reindexType(const QString& type)
+{
+    if (type.isEmpty())
+    {
+        return;
+    }
+
+    // Rebuilds the list, so that it stays in file order.
+    QVector<MapObject*> objects;
+    for (MapObject* obj : m_objects)
+    {
+        if (obj->type() == type)
+        {
+            objects.append(obj);
+        }
+    }
+
+    if (objects.isEmpty())
+    {
+        m_objectsByType.remove(type);
+    }
+    else
+    {
+        m_objectsByType.insert(type, objects);
+    }
+
+    if (map() != nullptr)
+    {
+        map()->reindexType(type);
+    }
+}
+
+
 LayerType MapObjectLayer::layerType() const
 {
     return LayerTypeObject;
 }
 
 
+quint64 MapObjectLayer::revision() const
+{
+    quint64 revision = 0;
+    for (MapObject* obj : m_objects)
+    {
+        if (obj->renderObject() != nullptr)
+        {
+            revision += obj->renderObject()->revision();
+        }
+    }
+
+    return revision;
+}
+
+
 void MapObjectLayer::update(const GameTime& time)
 {
+    // Animated moves do not emit positionChanged(); relinks the objects that
+    // moved during this update, including the ones that just arrived.
+    QVector<MapObject*> moving;
     for (MapObject* obj : m_objects)
     {
-        obj->update(time);
+        if (obj->isMoving())
+        {
+            moving.append(obj);
+        }
+    }
+
+    JobSystem::instance()->updateObjects(m_objects, time);
+
+    for (MapObject* obj : moving)
+    {
+        map()->collisionGrid().updateObject(obj);
     }
 }
 
 
 void MapObjectLayer::render()
 {
+    cranProfile("MapObjectLayer::render");
+
     for (MapObject* obj : m_objects)
     {
         obj->setX(obj->x() + offsetX() + map()->x());
@@ -0,0 +1,601 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapPathfinder.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <array>
+#include <functional>
+
+// Constants
+CRANBERRY_CONST_ARR(int, 8, c_dirX, 1, 1, 0, -1, -1, -1, 0, 1)
+CRANBERRY_CONST_ARR(int, 8, c_dirY, 0, 1, 1, 1, 0, -1, -1, -1)
+CRANBERRY_CONST_VAR(quint8, c_none, 0xFF)
+CRANBERRY_CONST_VAR(quint32, c_unreachable, 0xFFFFFFFF)
+CRANBERRY_CONST_VAR(quint32, c_straightCost, 10)
+CRANBERRY_CONST_VAR(quint32, c_diagonalCost, 14)
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    inline int sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    inline quint32 octile(int dx, int dy)
+    {
+        const quint32 ax = static_cast<quint32>(qAbs(dx));
+        const quint32 ay = static_cast<quint32>(qAbs(dy));
+        const quint32 mn = qMin(ax, ay);
+        return c_diagonalCost * mn + c_straightCost * (qMax(ax, ay) - mn);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// A changed tile only alters a flow field if the field reaches it or one
+    /// of its neighbours; a tile that becomes walkable elsewhere stays cut off.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool isAffected(const MapFlowField& field, const QVector<QPoint>& tiles)
+    {
+        for (const QPoint& tile : tiles)
+        {
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (field.isReachable(tile.x() + dx, tile.y() + dy))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+}
+
+
+MapPathfinder::MapPathfinder(const MapNavigationGrid* grid)
+    : m_grid(grid)
+    , m_search(0)
+    , m_cacheVersion(0)
+    , m_cacheSize(8)
+    , m_diagonal(true)
+{
+}
+
+
+const MapNavigationGrid* MapPathfinder::grid() const
+{
+    return m_grid;
+}
+
+
+bool MapPathfinder::allowsDiagonalMovement() const
+{
+    return m_diagonal;
+}
+
+
+int MapPathfinder::flowFieldCacheSize() const
+{
+    return m_cacheSize;
+}
+
+
+void MapPathfinder::setGrid(const MapNavigationGrid* grid)
+{
+    m_grid = grid;
+    clearCache();
+}
+
+
+void MapPathfinder::setDiagonalMovement(bool allow)
+{
+    if (m_diagonal != allow)
+    {
+        m_diagonal = allow;
+        clearCache();
+    }
+}
+
+
+void MapPathfinder::setFlowFieldCacheSize(int size)
+{
+    m_cacheSize = qMax(1, size);
+
+    while (m_fieldOrder.size() > m_cacheSize)
+    {
+        m_fields.remove(m_fieldOrder.takeFirst());
+    }
+}
+
+
+bool MapPathfinder::findPath(const QPoint& start, const QPoint& goal, QVector<QPoint>& path)
+{
+    path.clear();
+
+    if (!prepareSearch() ||
+        !m_grid->isWalkable(start.x(), start.y()) ||
+        !m_grid->isWalkable(goal.x(), goal.y()))
+    {
+        return false;
+    }
+
+    if (start == goal)
+    {
+        return true;
+    }
+
+    const int width = m_grid->width();
+    const int goalIndex = goal.y() * width + goal.x();
+
+    pushOpen(start.y() * width + start.x(), -1, 0, heuristic(start.x(), start.y(), goal));
+
+    int current;
+    while ((current = popOpen()) != -1)
+    {
+        if (current == goalIndex)
+        {
+            reconstructPath(current, path);
+            return true;
+        }
+
+        if (m_diagonal)
+        {
+            expandJumpPoints(current, goal);
+        }
+        else
+        {
+            expandNeighbours(current, goal);
+        }
+    }
+
+    return false;
+}
+
+
+MapFlowField MapPathfinder::flowField(const QPoint& goal)
+{
+    validateCache();
+
+    if (m_grid == nullptr || !m_grid->isWalkable(goal.x(), goal.y()))
+    {
+        return MapFlowField();
+    }
+
+    const int key = goal.y() * m_grid->width() + goal.x();
+    auto it = m_fields.find(key);
+    if (it != m_fields.end())
+    {
+        // Marks the flow field as most recently used.
+        m_fieldOrder.removeOne(key);
+        m_fieldOrder.append(key);
+        return it.value();
+    }
+
+    while (m_fieldOrder.size() >= m_cacheSize)
+    {
+        m_fields.remove(m_fieldOrder.takeFirst());
+    }
+
+    MapFlowField& field = m_fields[key];
+    buildFlowField(field, goal);
+    m_fieldOrder.append(key);
+
+    return field;
+}
+
+
+void MapPathfinder::clearCache()
+{
+    m_fields.clear();
+    m_fieldOrder.clear();
+    m_cacheVersion = (m_grid != nullptr) ? m_grid->version() : 0;
+}
+
+
+bool MapPathfinder::prepareSearch()
+{
+    if (m_grid == nullptr || m_grid->isNull())
+    {
+        return false;
+    }
+
+    // Buffers are only reallocated if the grid size changes. Stamps allow us
+    // to skip clearing them before every search.
+    const int size = m_grid->width() * m_grid->height();
+    if (m_costs.size() != size)
+    {
+        m_costs.resize(size);
+        m_parents.resize(size);
+        m_openStamp.fill(0, size);
+        m_closedStamp.fill(0, size);
+        m_search = 0;
+    }
+
+    if (++m_search == 0)
+    {
+        m_openStamp.fill(0);
+        m_closedStamp.fill(0);
+        m_search = 1;
+    }
+
+    m_open.clear();
+
+    return true;
+}
+
+
+void MapPathfinder::pushOpen(int index, int parent, quint32 g, quint32 h)
+{
+    if (m_closedStamp.at(index) == m_search)
+    {
+        return;
+    }
+
+    if (m_openStamp.at(index) == m_search && m_costs.at(index) <= g)
+    {
+        return;
+    }
+
+    m_openStamp[index] = m_search;
+    m_costs[index] = g;
+    m_parents[index] = parent;
+
+    // Outdated entries remain in the heap and are skipped by popOpen().
+    m_open.push_back({ g + h, index });
+    std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+}
+
+
+int MapPathfinder::popOpen()
+{
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+        const int index = m_open.back().index;
+        m_open.pop_back();
+
+        if (m_closedStamp.at(index) != m_search)
+        {
+            m_closedStamp[index] = m_search;
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+
+void MapPathfinder::expandJumpPoints(int index, const QPoint& goal)
+{
+    const MapNavigationGrid& grid = *m_grid;
+    const int width = grid.width();
+    const int x = index % width;
+    const int y = index / width;
+    const int parent = m_parents.at(index);
+
+    int dirs[8][2];
+    int count = 0;
+
+    auto add = [&dirs, &count] (int dx, int dy) -> void
+    {
+        dirs[count][0] = dx;
+        dirs[count][1] = dy;
+        count++;
+    };
+
+    if (parent == -1)
+    {
+        // The start tile has no direction yet; consider all neighbours.
+        for (int d = 0; d < 8; d++)
+        {
+            if (canStep(x, y, c_dirX[d], c_dirY[d]))
+            {
+                add(c_dirX[d], c_dirY[d]);
+            }
+        }
+    }
+    else
+    {
+        // Prunes all neighbours that can be reached optimally without
+        // passing through this tile.
+        const int dx = sign(x - parent % width);
+        const int dy = sign(y - parent / width);
+
+        if (dx != 0 && dy != 0)
+        {
+            const bool vertical = grid.isWalkable(x, y + dy);
+            const bool horizontal = grid.isWalkable(x + dx, y);
+
+            if (vertical) add(0, dy);
+            if (horizontal) add(dx, 0);
+            if (vertical && horizontal) add(dx, dy);
+        }
+        else if (dx != 0)
+        {
+            const bool next = grid.isWalkable(x + dx, y);
+            const bool below = grid.isWalkable(x, y + 1);
+            const bool above = grid.isWalkable(x, y - 1);
+
+            if (next) add(dx, 0);
+            if (next && below) add(dx, 1);
+            if (next && above) add(dx, -1);
+            if (below) add(0, 1);
+            if (above) add(0, -1);
+        }
+        else
+        {
+            const bool next = grid.isWalkable(x, y + dy);
+            const bool right = grid.isWalkable(x + 1, y);
+            const bool left = grid.isWalkable(x - 1, y);
+
+            if (next) add(0, dy);
+            if (next && right) add(1, dy);
+            if (next && left) add(-1, dy);
+            if (right) add(1, 0);
+            if (left) add(-1, 0);
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const int jp = jump(x + dirs[i][0], y + dirs[i][1], dirs[i][0], dirs[i][1], goal);
+        if (jp != -1)
+        {
+            relax(index, jp % width, jp / width, goal);
+        }
+    }
+}
+
+
+void MapPathfinder::expandNeighbours(int index, const QPoint& goal)
+{
+    const int width = m_grid->width();
+    const int x = index % width;
+    const int y = index / width;
+
+    // Only the orthogonal directions have even indices.
+    for (int d = 0; d < 8; d += 2)
+    {
+        if (m_grid->isWalkable(x + c_dirX[d], y + c_dirY[d]))
+        {
+            relax(index, x + c_dirX[d], y + c_dirY[d], goal);
+        }
+    }
+}
+
+
+void MapPathfinder::relax(int from, int x, int y, const QPoint& goal)
+{
+    const int width = m_grid->width();
+    const int fx = from % width;
+    const int fy = from / width;
+    const quint32 g = m_costs.at(from) + octile(x - fx, y - fy);
+
+    pushOpen(y * width + x, from, g, heuristic(x, y, goal));
+}
+
+
+int MapPathfinder::jump(int x, int y, int dx, int dy, const QPoint& goal) const
+{
+    const MapNavigationGrid& grid = *m_grid;
+
+    // Straight jumps are iterative; diagonal jumps only ever recurse into
+    // straight jumps, hence the recursion depth never exceeds one.
+    for (;;)
+    {
+        if (!grid.isWalkable(x, y))
+        {
+            return -1;
+        }
+
+        if (x == goal.x() && y == goal.y())
+        {
+            return y * grid.width() + x;
+        }
+
+        if (dx != 0 && dy != 0)
+        {
+            if (jump(x + dx, y, dx, 0, goal) != -1 ||
+                jump(x, y + dy, 0, dy, goal) != -1)
+            {
+                return y * grid.width() + x;
+            }
+        }
+        else if (dx != 0)
+        {
+            if ((grid.isWalkable(x, y - 1) && !grid.isWalkable(x - dx, y - 1)) ||
+                (grid.isWalkable(x, y + 1) && !grid.isWalkable(x - dx, y + 1)))
+            {
+                return y * grid.width() + x;
+            }
+        }
+        else
+        {
+            if ((grid.isWalkable(x - 1, y) && !grid.isWalkable(x - 1, y - dy)) ||
+                (grid.isWalkable(x + 1, y) && !grid.isWalkable(x + 1, y - dy)))
+            {
+                return y * grid.width() + x;
+            }
+        }
+
+        if (!canStep(x, y, dx, dy))
+        {
+            return -1;
+        }
+
+        x += dx;
+        y += dy;
+    }
+}
+
+
+bool MapPathfinder::canStep(int x, int y, int dx, int dy) const
+{
+    if (!m_grid->isWalkable(x + dx, y + dy))
+    {
+        return false;
+    }
+
+    // Diagonal steps must not cut corners.
+    return dx == 0 || dy == 0 ||
+          (m_grid->isWalkable(x + dx, y) && m_grid->isWalkable(x, y + dy));
+}
+
+
+quint32 MapPathfinder::heuristic(int x, int y, const QPoint& goal) const
+{
+    if (m_diagonal)
+    {
+        return octile(goal.x() - x, goal.y() - y);
+    }
+
+    return c_straightCost * static_cast<quint32>(qAbs(goal.x() - x) + qAbs(goal.y() - y));
+}
+
+
+void MapPathfinder::reconstructPath(int goalIndex, QVector<QPoint>& path) const
+{
+    const int width = m_grid->width();
+    QVector<QPoint> jumpPoints;
+
+    for (int i = goalIndex; i != -1; i = m_parents.at(i))
+    {
+        jumpPoints.append(QPoint(i % width, i / width));
+    }
+
+    // Jump points are connected by straight or diagonal lines; fills in the
+    // tiles in between so that each step moves by exactly one tile.
+    for (int i = jumpPoints.size() - 1; i > 0; i--)
+    {
+        QPoint current = jumpPoints.at(i);
+        const QPoint& next = jumpPoints.at(i - 1);
+
+        while (current != next)
+        {
+            current += QPoint(sign(next.x() - current.x()), sign(next.y() - current.y()));
+            path.append(current);
+        }
+    }
+}
+
+
+void MapPathfinder::buildFlowField(MapFlowField& field, const QPoint& goal)
+{
+    const int width = m_grid->width();
+    const int height = m_grid->height();
+    const int step = m_diagonal ? 1 : 2;
+    const int goalIndex = goal.y() * width + goal.x();
+
+    field.m_width = width;
+    field.m_height = height;
+    field.m_goal = goal;
+    field.m_gridVersion = m_grid->version();
+    field.m_costs.fill(c_unreachable, width * height);
+    field.m_directions.fill(c_none, width * height);
+    field.m_costs[goalIndex] = 0;
+
+    // Dijkstra from the goal outwards; every tile points to the neighbour it
+    // was reached from.
+    m_open.clear();
+    m_open.push_back({ 0, goalIndex });
+
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+        const OpenNode node = m_open.back();
+        m_open.pop_back();
+
+        if (node.cost > field.m_costs.at(node.index))
+        {
+            continue;
+        }
+
+        const int x = node.index % width;
+        const int y = node.index / width;
+
+        for (int d = 0; d < 8; d += step)
+        {
+            if (!canStep(x, y, c_dirX[d], c_dirY[d]))
+            {
+                continue;
+            }
+
+            const int next = (y + c_dirY[d]) * width + (x + c_dirX[d]);
+            const quint32 cost = node.cost + ((d & 1) ? c_diagonalCost : c_straightCost);
+
+            if (cost < field.m_costs.at(next))
+            {
+                field.m_costs[next] = cost;
+                field.m_directions[next] = static_cast<quint8>((d + 4) & 7);
+                m_open.push_back({ cost, next });
+                std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+            }
+        }
+    }
+}
+
+
+void MapPathfinder::validateCache()
+{
+    if (m_grid == nullptr)
+    {
+        clearCache();
+        return;
+    }
+
+    if (m_grid->version() == m_cacheVersion)
+    {
+        return;
+    }
+
+    QVector<QPoint> changes;
+    if (!m_grid->changesSince(m_cacheVersion, changes))
+    {
+        clearCache();
+        return;
+    }
+
+    // Discards only the flow fields the changed tiles may have altered.
+    for (auto it = m_fields.begin(); it != m_fields.end();)
+    {
+        if (isAffected(it.value(), changes))
+        {
+            m_fieldOrder.removeOne(it.key());
+            it = m_fields.erase(it);
+        }
+        else
+        {
+            it->m_gridVersion = m_grid->version();
+            ++it;
+        }
+    }
+
+    m_cacheVersion = m_grid->version();
+}
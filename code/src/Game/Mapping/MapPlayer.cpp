@@ -25,6 +25,7 @@
 #include <Cranberry/Game/Mapping/MapPlayer.hpp>
 #include <Cranberry/Game/Mapping/MapTileLayer.hpp>
 #include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 
 CRANBERRY_USING_NAMESPACE
@@ -137,6 +138,8 @@ void MapPlayer::update(const GameTime& time)
 
 void MapPlayer::render()
 {
+    cranProfile("MapPlayer::render");
+
     if (m_renderObject != nullptr)
     {
         setSize(m_parent->tileWidth(), m_parent->tileHeight());
@@ -175,63 +178,17 @@ bool MapPlayer::exceedsMapSize(int x, int y)
 
 bool MapPlayer::movePlayerByTiles(int x, int y)
 {
-    if (exceedsMapSize(tileX() + x, tileY() + y))
+    const int oldTileX = tileX();
+    const int oldTileY = tileY();
+
+    if (exceedsMapSize(oldTileX + x, oldTileY + y))
     {
         return false;
     }
 
-    for (MapLayer* layer : m_parent->layers())
+    if (!stepTile(oldTileX, oldTileY, oldTileX + x, oldTileY + y, false))
     {
-        if (layer->layerType() == LayerTypeTile)
-        {
-            const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
-            const MapTile& told = tl->tiles().at(getTileIndex(tileX(), tileY()));
-            const MapTile& tnew = tl->tiles().at(getTileIndex(tileX() + x, tileY() + y));
-
-            if (!tnew.isNull())
-            {
-                TileEvent event(tnew, tl, m_parent->tilesets()[tnew.tilesetId()]);
-                m_emitter.emitStartedMoveTile(event);
-
-                if (!event.isAccepted())
-                {
-                    // We e.g. hit something solid, abort.
-                    return false;
-                }
-            }
-
-            if (!told.isNull())
-            {
-                m_emitter.emitStartedLeaveTile(TileEvent(
-                        told,
-                        tl,
-                        m_parent->tilesets()[told.tilesetId()]
-                        ));
-            }
-        }
-        else
-        {
-            const MapObjectLayer* ol = static_cast<MapObjectLayer*>(layer);
-            for (MapObject* o : ol->objects())
-            {
-                const QRect r1(o->x(), o->y(), o->width(), o->height());
-                const QRect r2(tileX() + x, tileY() + y, m_parent->tileWidth(), m_parent->tileHeight());
-
-                if (r1.intersects(r2) && !o->isNull())
-                {
-                    ObjectEvent event(o, ol);
-                    m_emitter.emitStartedMoveObject(event);
-
-                    if (!event.isAccepted())
-                    {
-                        // We e.g. hit something solid, abort.
-                        return false;
-                    }
-                }
-
-                m_emitter.emitStartedLeaveObject(ObjectEvent(o, ol));
-            }
-        }
+        return false;
     }
 
     moveBy(x * m_parent->tileWidth(), y * m_parent->tileHeight());
@@ -256,80 +213,165 @@ bool MapPlayer::movePlayerByPixels(int dx, int dy)
 
     if (oldTileX != newTileX || oldTileY != newTileY)
     {
-        // Current tile changed, send event to all layers.
-        for (MapLayer* layer : m_parent->layers())
+        // Current tile changed, raise the events in an instant.
+        if (!stepTile(oldTileX, oldTileY, newTileX, newTileY, true))
+        {
+            return false;
+        }
+    }
+
+    // Moves the player in an instant.
+    setPosition(pX + dx, pY + dy);
+    return true;
+}
+
+
+bool MapPlayer::stepTile(int oldX, int oldY, int newX, int newY, bool instant)
+{
+    const MapCollisionGrid& grid = m_parent->collisionGrid();
+
+    // Tiles marked as solid are rejected before the handlers are asked. The
+    // grid only marks tiles if it was created with a solid property or the
+    // tiles were set explicitly.
+    if (grid.isSolid(newX, newY))
+    {
+        return false;
+    }
+
+    if (m_emitter.hasMoveReceivers() && !emitStartedMove(newX, newY, instant))
+    {
+        return false;
+    }
+
+    if (m_emitter.hasLeaveReceivers())
+    {
+        emitStartedLeave(oldX, oldY, newX, newY);
+    }
+
+    return true;
+}
+
+
+bool MapPlayer::emitStartedMove(int x, int y, bool instant)
+{
+    const MapCollisionGrid& grid = m_parent->collisionGrid();
+    const int index = getTileIndex(x, y);
+
+    for (MapLayer* layer : m_parent->layers())
+    {
+        if (layer->layerType() != LayerTypeTile)
         {
-            if (layer->layerType() == LayerTypeTile)
+            continue;
+        }
+
+        const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
+        const MapTile& tile = tl->tiles().at(index);
+
+        if (!tile.isNull())
+        {
+            TileEvent event(tile, tl, m_parent->tilesets()[tile.tilesetId()]);
+            m_emitter.emitStartedMoveTile(event);
+
+            if (!event.isAccepted())
             {
-                const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
-                const MapTile& told = tl->tiles().at(getTileIndex(oldTileX, oldTileY));
-                const MapTile& tnew = tl->tiles().at(getTileIndex(newTileX, newTileY));
-
-                if (!tnew.isNull())
-                {
-                    TileEvent event(tnew, tl, m_parent->tilesets()[tnew.tilesetId()]);
-                    m_emitter.emitStartedMoveTile(event);
-
-                    if (!event.isAccepted())
-                    {
-                        // We e.g. hit something solid, abort.
-                        return false;
-                    }
-
-                    m_emitter.emitFinishedMoveTile(event);
-                }
-
-                if (!told.isNull())
-                {
-                    m_emitter.emitStartedLeaveTile(TileEvent(
-                            told,
-                            tl,
-                            m_parent->tilesets()[told.tilesetId()]
-                            ));
-                }
+                // We e.g. hit something solid, abort.
+                return false;
             }
-            else
+
+            if (instant)
             {
-                const MapObjectLayer* ol = static_cast<MapObjectLayer*>(layer);
-                for (MapObject* o : ol->objects())
-                {
-                    const QRect r1(o->x(), o->y(), o->width(), o->height());
-                    const QRect r2(pX + dx, pY + dy, m_parent->tileWidth(), m_parent->tileHeight());
-
-                    if (r1.intersects(r2) && !o->isNull())
-                    {
-                        ObjectEvent event(o, ol);
-                        m_emitter.emitStartedMoveObject(event);
-
-                        if (!event.isAccepted())
-                        {
-                            // We e.g. hit something solid, abort.
-                            return false;
-                        }
-
-                        m_emitter.emitFinishedMoveObject(event);
-                    }
-
-                    m_emitter.emitStartedLeaveObject(ObjectEvent(o, ol));
-                }
+                m_emitter.emitFinishedMoveTile(event);
             }
         }
     }
 
-    // Moves the player in an instant.
-    setPosition(pX + dx, pY + dy);
+    QVector<MapCollisionGrid::ObjectEntry> objects;
+    for (int i = 0, count = grid.objectsAt(x, y, objects); i < count; i++)
+    {
+        ObjectEvent event(objects[i].object, objects[i].layer);
+        m_emitter.emitStartedMoveObject(event);
+
+        if (!event.isAccepted())
+        {
+            // We e.g. hit something solid, abort.
+            return false;
+        }
+
+        if (instant)
+        {
+            m_emitter.emitFinishedMoveObject(event);
+        }
+    }
+
     return true;
 }
 
 
+void MapPlayer::emitStartedLeave(int oldX, int oldY, int newX, int newY)
+{
+    const MapCollisionGrid& grid = m_parent->collisionGrid();
+    const int index = getTileIndex(oldX, oldY);
+
+    for (MapLayer* layer : m_parent->layers())
+    {
+        if (layer->layerType() != LayerTypeTile)
+        {
+            continue;
+        }
+
+        const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
+        const MapTile& tile = tl->tiles().at(index);
+
+        if (!tile.isNull())
+        {
+            m_emitter.emitStartedLeaveTile(TileEvent(
+                    tile,
+                    tl,
+                    m_parent->tilesets()[tile.tilesetId()]
+                    ));
+        }
+    }
+
+    // Only objects that do not cover the new tile as well are left.
+    QVector<MapCollisionGrid::ObjectEntry> oldObjects, newObjects;
+    const int oldCount = grid.objectsAt(oldX, oldY, oldObjects);
+    const int newCount = grid.objectsAt(newX, newY, newObjects);
+
+    for (int i = 0; i < oldCount; i++)
+    {
+        bool left = true;
+        for (int j = 0; j < newCount && left; j++)
+        {
+            left = newObjects[j].object != oldObjects[i].object;
+        }
+
+        if (left)
+        {
+            m_emitter.emitStartedLeaveObject(ObjectEvent(
+                    oldObjects[i].object,
+                    oldObjects[i].layer
+                    ));
+        }
+    }
+}
+
+
 void MapPlayer::moveFinished()
 {
+    if (!m_emitter.hasMoveReceivers())
+    {
+        return;
+    }
+
+    const MapCollisionGrid& grid = m_parent->collisionGrid();
+
+    const int index = getTileIndex(tileX(), tileY());
     for (MapLayer* layer : m_parent->layers())
     {
         if (layer->layerType() == LayerTypeTile)
         {
             const MapTileLayer* tl = static_cast<MapTileLayer*>(layer);
-            const MapTile& tile = tl->tiles().at(getTileIndex(tileX(), tileY()));
+            const MapTile& tile = tl->tiles().at(index);
 
             if (!tile.isNull())
             {
@@ -340,19 +382,11 @@ void MapPlayer::moveFinished()
                       ));
             }
         }
-        else
-        {
-            const MapObjectLayer* ol = static_cast<MapObjectLayer*>(layer);
-            for (MapObject* o : ol->objects())
-            {
-                const QRect r1(o->x(), o->y(), o->width(), o->height());
-                const QRect r2((int) x(), (int) y(), m_parent->tileWidth(), m_parent->tileHeight());
+    }
 
-                if (r1.intersects(r2))
-                {
-                    m_emitter.emitFinishedMoveObject(ObjectEvent(o, ol));
-                }
-            }
-        }
+    QVector<MapCollisionGrid::ObjectEntry> objects;
+    for (int i = 0, count = grid.objectsAt(tileX(), tileY(), objects); i < count; i++)
+    {
+        m_emitter.emitFinishedMoveObject(ObjectEvent(objects[i].object, objects[i].layer));
     }
 }
@@ -0,0 +1,196 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapProperties.hpp>
+
+// Globals
+CRANBERRY_GLOBAL_VAR(QString, g_empty)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapProperties::MapProperties()
+    : m_row(0)
+{
+}
+
+
+MapProperties::MapProperties(const QExplicitlySharedDataPointer<MapPropertyTable>& table, int row)
+    : m_table(table)
+    , m_row(row)
+{
+}
+
+
+bool MapProperties::isValid() const
+{
+    return m_table && !m_table->isEmpty(m_row);
+}
+
+
+bool MapProperties::contains(MapPropertyKey key) const
+{
+    return m_table && m_table->contains(m_row, key);
+}
+
+
+bool MapProperties::contains(const QString& name) const
+{
+    return contains(MapPropertyKeys::find(name));
+}
+
+
+QVector<MapPropertyKey> MapProperties::keys() const
+{
+    QVector<MapPropertyKey> keys;
+    if (m_table)
+    {
+        for (MapPropertyKey key : m_table->keys())
+        {
+            if (m_table->contains(m_row, key))
+            {
+                keys.append(key);
+            }
+        }
+    }
+
+    return keys;
+}
+
+
+QVariant MapProperties::value(MapPropertyKey key) const
+{
+    return !m_table ? QVariant() : m_table->value(m_row, key);
+}
+
+
+QVariant MapProperties::value(const QString& name) const
+{
+    return value(MapPropertyKeys::find(name));
+}
+
+
+bool MapProperties::toBool(MapPropertyKey key, bool def) const
+{
+    return !m_table ? def : m_table->toBool(m_row, key, def);
+}
+
+
+int MapProperties::toInt(MapPropertyKey key, int def) const
+{
+    return !m_table ? def : m_table->toInt(m_row, key, def);
+}
+
+
+float MapProperties::toFloat(MapPropertyKey key, float def) const
+{
+    return !m_table ? def : m_table->toFloat(m_row, key, def);
+}
+
+
+QColor MapProperties::toColor(MapPropertyKey key, const QColor& def) const
+{
+    return !m_table ? def : m_table->toColor(m_row, key, def);
+}
+
+
+const QString& MapProperties::toString(MapPropertyKey key) const
+{
+    return !m_table ? g_empty : m_table->toString(m_row, key);
+}
+
+
+QMap<QString, QVariant> MapProperties::toMap() const
+{
+    QMap<QString, QVariant> map;
+    for (MapPropertyKey key : keys())
+    {
+        map.insert(MapPropertyKeys::name(key), value(key));
+    }
+
+    return map;
+}
+
+
+void MapProperties::setValue(MapPropertyKey key, const QVariant& value)
+{
+    detach();
+    m_table->setValue(m_row, key, value);
+}
+
+
+void MapProperties::setValue(const QString& name, const QVariant& value)
+{
+    setValue(MapPropertyKeys::intern(name), value);
+}
+
+
+void MapProperties::setValue(MapPropertyKey key, PropertyType type, const QString& value)
+{
+    detach();
+    m_table->setValue(m_row, key, type, value);
+}
+
+
+void MapProperties::addProperty(const QString& name, const QVariant& value)
+{
+    setValue(name, value);
+}
+
+
+void MapProperties::removeProperty(const QString& name)
+{
+    const MapPropertyKey key = MapPropertyKeys::find(name);
+    if (contains(key))
+    {
+        detach();
+        m_table->remove(m_row, key);
+    }
+}
+
+
+void MapProperties::detach()
+{
+    if (!m_table)
+    {
+        m_table = QExplicitlySharedDataPointer<MapPropertyTable>(new MapPropertyTable);
+        m_row = m_table->addRows(1);
+    }
+    else if (m_table->ref.load() > 1)
+    {
+        // Copies only the own row; the rest of the table belongs to others.
+        QExplicitlySharedDataPointer<MapPropertyTable> table(new MapPropertyTable);
+        const int row = table->addRows(1);
+
+        for (MapPropertyKey key : m_table->keys())
+        {
+            if (m_table->contains(m_row, key))
+            {
+                table->setValue(row, key, m_table->value(m_row, key));
+            }
+        }
+
+        m_table = table;
+        m_row = row;
+    }
+}
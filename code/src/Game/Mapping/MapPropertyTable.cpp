@@ -0,0 +1,453 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapPropertyTable.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Qt headers
+#include <QAtomicPointer>
+#include <QHash>
+#include <QMutex>
+
+// Standard headers
+#include <algorithm>
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////
+    /// All interned names at one point in time. Never modified once
+    /// published; interning a new name publishes an extended copy.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    struct KeyTable
+    {
+        QHash<QString, int> keys;  ///< Key by name
+        QVector<QString>    names; ///< Name by key
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Determines the property type that stores \p value without loss.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    cran::PropertyType variantType(const QVariant& value)
+    {
+        switch (static_cast<int>(value.type()))
+        {
+            case QMetaType::Bool:      return cran::PropertyTypeBoolean;
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong: return cran::PropertyTypeInteger;
+            case QMetaType::Float:
+            case QMetaType::Double:    return cran::PropertyTypeFloat;
+            case QMetaType::QColor:    return cran::PropertyTypeColor;
+            default:                   return cran::PropertyTypeString;
+        }
+    }
+}
+
+
+// Globals
+CRANBERRY_GLOBAL_VAR(QAtomicPointer<const KeyTable>, g_keys)
+CRANBERRY_GLOBAL_VAR(QVector<const KeyTable*>, g_retired)
+CRANBERRY_GLOBAL_VAR(QMutex, g_mutex)
+CRANBERRY_GLOBAL_VAR(QString, g_empty)
+CRANBERRY_CONST_VAR(QString, w_01, "MapPropertyTable: Property %0 did not keep its type.")
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+MapPropertyKey MapPropertyKeys::intern(const QString& name)
+{
+    MapPropertyKey key = find(name);
+    if (key >= 0)
+    {
+        return key;
+    }
+
+    // Writers are serialized; another thread may have interned the name in
+    // the meantime.
+    QMutexLocker lock(&g_mutex);
+
+    const KeyTable* current = g_keys.loadAcquire();
+    if (current != nullptr && current->keys.contains(name))
+    {
+        return current->keys.value(name);
+    }
+
+    KeyTable* table = (current != nullptr) ? new KeyTable(*current) : new KeyTable;
+    key = table->names.size();
+    table->names.append(name);
+    table->keys.insert(name, key);
+
+    // Readers may still hold the previous table; it is kept alive, which is
+    // cheap since only a few hundred names are interned per game.
+    if (current != nullptr)
+    {
+        g_retired.append(current);
+    }
+
+    g_keys.storeRelease(table);
+
+    return key;
+}
+
+
+MapPropertyKey MapPropertyKeys::find(const QString& name)
+{
+    const KeyTable* table = g_keys.loadAcquire();
+    return (table != nullptr) ? table->keys.value(name, -1) : -1;
+}
+
+
+QString MapPropertyKeys::name(MapPropertyKey key)
+{
+    const KeyTable* table = g_keys.loadAcquire();
+    if (table == nullptr || key < 0 || key >= table->names.size())
+    {
+        return QString();
+    }
+
+    return table->names.at(key);
+}
+
+
+MapPropertyTable::MapPropertyTable()
+    : m_rows(0)
+{
+}
+
+
+int MapPropertyTable::rowCount() const
+{
+    return m_rows;
+}
+
+
+int MapPropertyTable::addRows(int count)
+{
+    const int first = m_rows;
+    m_rows += qMax(0, count);
+
+    for (Column& c : m_columns)
+    {
+        resizeColumn(c);
+    }
+
+    return first;
+}
+
+
+const QVector<MapPropertyKey>& MapPropertyTable::keys() const
+{
+    return m_keys;
+}
+
+
+bool MapPropertyTable::contains(int row, MapPropertyKey key) const
+{
+    const Column* c = column(key);
+    return c != nullptr && row >= 0 && row < m_rows && c->present.testBit(row);
+}
+
+
+bool MapPropertyTable::isEmpty(int row) const
+{
+    for (const Column& c : m_columns)
+    {
+        if (row >= 0 && row < m_rows && c.present.testBit(row))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+PropertyType MapPropertyTable::type(MapPropertyKey key) const
+{
+    const Column* c = column(key);
+    return (c != nullptr && !c->mixed) ? c->type : PropertyTypeInvalid;
+}
+
+
+bool MapPropertyTable::toBool(int row, MapPropertyKey key, bool def) const
+{
+    if (!contains(row, key)) return def;
+
+    const Column* c = column(key);
+    switch (rowType(*c, row))
+    {
+        case PropertyTypeBoolean:
+        case PropertyTypeInteger: return c->ints.at(row) != 0;
+        case PropertyTypeFloat:   return c->floats.at(row) != 0.0f;
+        default:                  return def;
+    }
+}
+
+
+int MapPropertyTable::toInt(int row, MapPropertyKey key, int def) const
+{
+    if (!contains(row, key)) return def;
+
+    const Column* c = column(key);
+    switch (rowType(*c, row))
+    {
+        case PropertyTypeBoolean:
+        case PropertyTypeInteger: return c->ints.at(row);
+        case PropertyTypeFloat:   return static_cast<int>(c->floats.at(row));
+        default:                  return def;
+    }
+}
+
+
+float MapPropertyTable::toFloat(int row, MapPropertyKey key, float def) const
+{
+    if (!contains(row, key)) return def;
+
+    const Column* c = column(key);
+    switch (rowType(*c, row))
+    {
+        case PropertyTypeBoolean:
+        case PropertyTypeInteger: return static_cast<float>(c->ints.at(row));
+        case PropertyTypeFloat:   return c->floats.at(row);
+        default:                  return def;
+    }
+}
+
+
+QColor MapPropertyTable::toColor(int row, MapPropertyKey key, const QColor& def) const
+{
+    if (!contains(row, key) || rowType(*column(key), row) != PropertyTypeColor)
+    {
+        return def;
+    }
+
+    return QColor::fromRgba(static_cast<QRgb>(column(key)->ints.at(row)));
+}
+
+
+const QString& MapPropertyTable::toString(int row, MapPropertyKey key) const
+{
+    if (!contains(row, key)) return g_empty;
+
+    const PropertyType type = rowType(*column(key), row);
+    if (type != PropertyTypeString && type != PropertyTypeFile)
+    {
+        return g_empty;
+    }
+
+    return column(key)->strings.at(row);
+}
+
+
+QVariant MapPropertyTable::value(int row, MapPropertyKey key) const
+{
+    if (!contains(row, key)) return QVariant();
+
+    const Column* c = column(key);
+    switch (rowType(*c, row))
+    {
+        case PropertyTypeBoolean: return c->ints.at(row) != 0;
+        case PropertyTypeInteger: return c->ints.at(row);
+        case PropertyTypeFloat:   return c->floats.at(row);
+        case PropertyTypeColor:   return QColor::fromRgba(static_cast<QRgb>(c->ints.at(row)));
+        case PropertyTypeFile:
+        case PropertyTypeString:  return c->strings.at(row);
+        default:                  return QVariant();
+    }
+}
+
+
+void MapPropertyTable::setValue(int row, MapPropertyKey key, const QVariant& value)
+{
+    if (row < 0 || row >= m_rows || key < 0 || !value.isValid())
+    {
+        return;
+    }
+
+    const PropertyType type = variantType(value);
+    Column& c = columnForWrite(key, type);
+
+    switch (type)
+    {
+        case PropertyTypeBoolean: c.ints[row] = value.toBool() ? 1 : 0; break;
+        case PropertyTypeInteger: c.ints[row] = value.toInt(); break;
+        case PropertyTypeFloat:   c.floats[row] = value.toFloat(); break;
+        case PropertyTypeColor:   c.ints[row] = static_cast<qint32>(value.value<QColor>().rgba()); break;
+        default:                  c.strings[row] = value.toString(); break;
+    }
+
+    storeValue(c, row, type);
+    if_debug(checkType(row, key, type))
+}
+
+
+void MapPropertyTable::setValue(int row, MapPropertyKey key, PropertyType type, const QString& value)
+{
+    if (row < 0 || row >= m_rows || key < 0 || type == PropertyTypeInvalid)
+    {
+        return;
+    }
+
+    Column& c = columnForWrite(key, type);
+    switch (type)
+    {
+        case PropertyTypeBoolean: c.ints[row] = (value == "true" || value == "1") ? 1 : 0; break;
+        case PropertyTypeInteger: c.ints[row] = value.toInt(); break;
+        case PropertyTypeFloat:   c.floats[row] = value.toFloat(); break;
+        case PropertyTypeColor:   c.ints[row] = static_cast<qint32>(getColorFromString(value).rgba()); break;
+        default:                  c.strings[row] = value; break;
+    }
+
+    storeValue(c, row, type);
+    if_debug(checkType(row, key, type))
+}
+
+
+void MapPropertyTable::remove(int row, MapPropertyKey key)
+{
+    if (!contains(row, key))
+    {
+        return;
+    }
+
+    Column& c = m_columns[m_columnOf.at(key)];
+    c.present.clearBit(row);
+
+    if (!c.strings.isEmpty())
+    {
+        c.strings[row].clear();
+    }
+}
+
+
+const MapPropertyTable::Column* MapPropertyTable::column(MapPropertyKey key) const
+{
+    if (key < 0 || key >= m_columnOf.size() || m_columnOf.at(key) == -1)
+    {
+        return nullptr;
+    }
+
+    return &m_columns.at(m_columnOf.at(key));
+}
+
+
+MapPropertyTable::Column& MapPropertyTable::columnForWrite(MapPropertyKey key, PropertyType type)
+{
+    if (key >= m_columnOf.size())
+    {
+        const int oldSize = m_columnOf.size();
+        m_columnOf.resize(key + 1);
+        std::fill(m_columnOf.begin() + oldSize, m_columnOf.end(), -1);
+    }
+
+    if (m_columnOf.at(key) == -1)
+    {
+        Column c;
+        c.type = type;
+        c.mixed = false;
+        resizeColumn(c);
+
+        m_columnOf[key] = m_columns.size();
+        m_columns.append(c);
+        m_keys.append(key);
+    }
+
+    Column& c = m_columns[m_columnOf.at(key)];
+    if (c.type != type && !c.mixed)
+    {
+        // E.g. a string "warp" on one object and an integer one on another.
+        // Converting either would lose it; every row keeps its type instead.
+        c.mixed = true;
+        c.types.fill(static_cast<qint8>(c.type), m_rows);
+        resizeColumn(c);
+    }
+
+    return c;
+}
+
+
+void MapPropertyTable::resizeColumn(Column& c)
+{
+    c.present.resize(m_rows);
+
+    if (c.mixed)
+    {
+        c.types.resize(m_rows);
+        c.ints.resize(m_rows);
+        c.floats.resize(m_rows);
+        c.strings.resize(m_rows);
+        return;
+    }
+
+    switch (c.type)
+    {
+        case PropertyTypeBoolean:
+        case PropertyTypeInteger:
+        case PropertyTypeColor:   c.ints.resize(m_rows); break;
+        case PropertyTypeFloat:   c.floats.resize(m_rows); break;
+        default:                  c.strings.resize(m_rows); break;
+    }
+}
+
+
+void MapPropertyTable::storeValue(Column& c, int row, PropertyType type)
+{
+    c.present.setBit(row);
+
+    if (c.mixed)
+    {
+        c.types[row] = static_cast<qint8>(type);
+
+        // Releases a string the row held before.
+        if (type != PropertyTypeString && type != PropertyTypeFile)
+        {
+            c.strings[row].clear();
+        }
+    }
+}
+
+
+PropertyType MapPropertyTable::rowType(const Column& c, int row)
+{
+    return c.mixed ? static_cast<PropertyType>(c.types.at(row)) : c.type;
+}
+
+
+if_debug
+(
+void MapPropertyTable::checkType(int row, MapPropertyKey key, PropertyType type) const
+{
+    // The value must read back with the type it was stored with.
+    const PropertyType stored = variantType(value(row, key));
+    const bool isText = (type == PropertyTypeString || type == PropertyTypeFile);
+
+    if (stored != type && !(isText && stored == PropertyTypeString))
+    {
+        cranWarning(w_01.arg(MapPropertyKeys::name(key)));
+    }
+}
+)
@@ -24,6 +24,7 @@
 #include <Cranberry/Game/Mapping/MapTileLayer.hpp>
 #include <Cranberry/Game/Mapping/MapTileset.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 // Qt headers
 #include <QDomElement>
@@ -78,6 +79,26 @@ Tilemap* MapTileLayer::renderObject() const
 }
 
 
+bool MapTileLayer::setTile(int x, int y, const MapTile& tile)
+{
+    const int index = y * map()->mapWidth() + x;
+    if (tile.isNull() || x < 0 || x >= map()->mapWidth() || index < 0 || index >= m_tiles.size())
+    {
+        return false;
+    }
+
+    if (!m_tileMap->replaceTile(x, y, tile.tileId(), tile.tilesetId()))
+    {
+        return cranError(e_04);
+    }
+
+    m_tiles[index] = tile;
+    map()->updateGrids(x, y);
+
+    return true;
+}
+
+
 bool MapTileLayer::parse(
     QDomElement* xmlElement,
     const QVector<MapTileset*>& tilesets,
@@ -261,6 +282,12 @@ LayerType MapTileLayer::layerType() const
 }
 
 
+quint64 MapTileLayer::revision() const
+{
+    return m_tileMap->revision();
+}
+
+
 void MapTileLayer::update(const GameTime& time)
 {
     m_tileMap->update(time);
@@ -269,6 +296,8 @@ void MapTileLayer::update(const GameTime& time)
 
 void MapTileLayer::render()
 {
+    cranProfile("MapTileLayer::render");
+
     // Convert position to integer due to rendering artifacts.
     m_tileMap->setX((int) offsetX() + map()->x());
     m_tileMap->setY((int) offsetY() + map()->y());
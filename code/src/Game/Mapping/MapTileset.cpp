@@ -22,6 +22,7 @@
 // Cranberry headers
 #include <Cranberry/Game/Mapping/Enumerations.hpp>
 #include <Cranberry/Game/Mapping/MapTileset.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
 #include <Cranberry/System/Debug.hpp>
 
 // Qt headers
@@ -57,7 +58,7 @@ MapTileset::MapTileset()
 
 MapTileset::~MapTileset()
 {
-    delete m_texture;
+    TextureCache::instance()->release(m_texture);
 }
 
 
@@ -115,7 +116,7 @@ int MapTileset::tileCount() const
 }
 
 
-const QMap<QString, QVariant>& MapTileset::properties() const
+const MapProperties& MapTileset::properties() const
 {
     return m_properties;
 }
@@ -123,14 +124,13 @@ const QMap<QString, QVariant>& MapTileset::properties() const
 
 const MapTileProperties& MapTileset::tileProperties(int tileId) const
 {
-    auto it = m_tileProps.find(tileId);
-    if (it == m_tileProps.end())
+    if (tileId < 0 || tileId >= m_tileProps.size())
     {
         return g_default;
     }
     else
     {
-        return it.value();
+        return m_tileProps.at(tileId);
     }
 }
 
@@ -175,17 +175,29 @@ bool MapTileset::parse(QDomElement* xmlElement)
     QDomElement xmlProps = xmlElement->elementsByTagName("properties").at(0).toElement();
     getTmxProperties(&xmlProps, m_properties);
 
+    // All tiles share one property table, one row per tile.
+    m_tileTable = QExplicitlySharedDataPointer<MapPropertyTable>(new MapPropertyTable);
+    m_tileTable->addRows(m_tileCount);
+    m_tileProps.clear();
+    m_tileProps.reserve(m_tileCount);
+    for (int i = 0; i < m_tileCount; i++)
+    {
+        m_tileProps.append(MapTileProperties(m_tileTable, i));
+    }
+
     // Parses the tile elements. TODO: tile animations.
     auto tileElems = xmlElement->elementsByTagName("tile");
     for (int i = 0; i < tileElems.size(); i++)
     {
-        MapTileProperties mtp;
         QDomElement elem = tileElems.at(i).toElement();
-        QString id = elem.attribute("id");
-        QDomElement props = elem.elementsByTagName("properties").at(0).toElement();
+        int id = elem.attribute("id").toInt();
+        if (id < 0 || id >= m_tileCount)
+        {
+            continue;
+        }
 
-        getTmxProperties(&props, mtp.properties());
-        m_tileProps.insert(id.toInt(), mtp);
+        QDomElement props = elem.elementsByTagName("properties").at(0).toElement();
+        getTmxProperties(&props, *m_tileTable, id);
     }
 
     // Parses the image element.
@@ -201,15 +213,15 @@ bool MapTileset::parse(QDomElement* xmlElement)
         return cranError(e_05);
     }
 
-    QImage img(strSource);
-    if (img.isNull())
+    // Maps of the same world usually share their tilesets.
+    TextureCache::Options options;
+    options.filter = QOpenGLTexture::Nearest;
+
+    m_texture = TextureCache::instance()->acquire(strSource, options);
+    if (m_texture == nullptr)
     {
         return cranError(e_06);
     }
 
-    m_texture = new QOpenGLTexture(img, QOpenGLTexture::DontGenerateMipMaps);
-    m_texture->setMinMagFilters(QOpenGLTexture::Nearest, QOpenGLTexture::Nearest);
-    m_texture->setWrapMode(QOpenGLTexture::ClampToEdge);
-
     return true;
 }
@@ -21,12 +21,16 @@
 
 // Cranberry headers
 #include <Cranberry/Graphics/Background.hpp>
+#include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
 #include <QOpenGLTexture>
 
+// Constants
+CRANBERRY_CONST_VAR(QString, w_01, "%0 [%1] - Shared texture does not repeat; acquire it with wrap mode Repeat.")
+
 
 CRANBERRY_USING_NAMESPACE
 
@@ -256,6 +260,15 @@ bool Background::initializeData()
 }
 
 
+TextureCache::Options Background::textureOptions() const
+{
+    TextureCache::Options options;
+    options.wrapMode = QOpenGLTexture::Repeat;
+
+    return options;
+}
+
+
 TreeModelItem* Background::rootModelItem()
 {
     return m_rootModelItem;
@@ -314,8 +327,21 @@ void Background::updateProperties()
 
 void Background::prepareTexture()
 {
-    texture()->bind();
-    texture()->setWrapMode(QOpenGLTexture::Repeat);
+    // Textures of the cache are shared with other objects and keep their
+    // sampling state; only textures owned by this background are changed.
+    if (texture()->wrapMode(QOpenGLTexture::DirectionS) != QOpenGLTexture::Repeat)
+    {
+        if (TextureCache::instance()->contains(texture()))
+        {
+            cranWarning(ERRARG(w_01));
+        }
+        else
+        {
+            texture()->bind();
+            texture()->setWrapMode(QOpenGLTexture::Repeat);
+        }
+    }
+
     updateUVs();
 }
 
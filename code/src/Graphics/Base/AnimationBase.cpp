@@ -24,14 +24,98 @@
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
+// Qt headers
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QThreadPool>
+
 // Constants
 CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Cannot render invalid object.")
 CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - The given render target is invalid.")
+CRANBERRY_CONST_VAR(QString, e_03, "%0 [%1] - Frames could not be decoded.")
+CRANBERRY_CONST_VAR(QString, e_04, "%0 [%1] - Frame is larger than the maximum texture size.")
 CRANBERRY_CONST_VAR(qint32, c_maxSize, 4096)
+CRANBERRY_CONST_VAR(qint64, c_uploadBudget, 2)
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// State of an asynchronous load, shared by the animation and the worker.
+///
+////////////////////////////////////////////////////////////////////////////////
+class AnimationLoad
+{
+public:
+
+    QVector<QImage> frames;      ///< Decoded frames, in RGBA8888
+    QVector<qreal>  durations;   ///< Frame durations, in milliseconds
+    QAtomicInt      state;       ///< 0 = decoding, 1 = decoded, -1 = failed
+    QAtomicInt      cancelled;   ///< Set if the animation was destroyed
+    TextureAtlas*   atlas;       ///< Atlas the next frame is inserted into
+    QSize           largestSize; ///< Largest frame uploaded so far
+    int             uploaded;    ///< Amount of frames uploaded so far
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Decodes the frames and converts them to the texture format.
+///
+////////////////////////////////////////////////////////////////////////////////
+class AnimationDecodeTask : public QRunnable
+{
+public:
+
+    AnimationDecodeTask(
+            const QSharedPointer<AnimationLoad>& load,
+            const std::function<bool(QVector<QImage>&, QVector<qreal>&)>& decoder
+            )
+        : m_load(load)
+        , m_decoder(decoder)
+    {
+    }
+
+    void run() override
+    {
+        if (m_load->cancelled.loadAcquire() != 0)
+        {
+            return;
+        }
 
+        bool success = m_decoder(m_load->frames, m_load->durations) &&
+                      !m_load->frames.isEmpty() &&
+                       m_load->frames.size() == m_load->durations.size();
 
+        // Converts on this thread; TextureAtlas uploads RGBA8888 as is.
+        for (QImage& img : m_load->frames)
+        {
+            if (!success || m_load->cancelled.loadAcquire() != 0)
+            {
+                break;
+            }
+
+            if (img.format() != QImage::Format_RGBA8888)
+            {
+                img = img.convertToFormat(QImage::Format_RGBA8888);
+            }
+        }
+
+        m_load->state.storeRelease(success ? 1 : -1);
+    }
+
+private:
+
+    QSharedPointer<AnimationLoad> m_load;
+    std::function<bool(QVector<QImage>&, QVector<qreal>&)> m_decoder;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
 CRANBERRY_USING_NAMESPACE
 
 
@@ -68,6 +152,12 @@ bool AnimationBase::isAnimating() const
 }
 
 
+bool AnimationBase::isLoading() const
+{
+    return !m_load.isNull();
+}
+
+
 int AnimationBase::frameCount() const
 {
     return m_frames.size();
@@ -109,6 +199,7 @@ void AnimationBase::setIdleFrame(uint atlas, const QRectF& frame)
     m_idleFrame.setRectangle(frame);
     m_idleFrame.setDuration(0.0);
     m_idleFrame.setFrameId(-1);
+    markDirty();
 }
 
 
@@ -130,6 +221,8 @@ void AnimationBase::setBlendColor(
     {
         atlas->texture()->setBlendColor(tl, tr, br, bl);
     }
+
+    markDirty();
 }
 
 
@@ -139,6 +232,8 @@ void AnimationBase::setBlendMode(BlendModes modes)
     {
         atlas->texture()->setBlendMode(modes);
     }
+
+    markDirty();
 }
 
 
@@ -148,6 +243,8 @@ void AnimationBase::setEffect(Effect effect)
     {
         atlas->texture()->setEffect(effect);
     }
+
+    markDirty();
 }
 
 
@@ -159,16 +256,7 @@ AnimationBaseEmitter* AnimationBase::signals()
 
 void AnimationBase::destroy()
 {
-    for (TextureAtlas* atlas : m_atlases)
-    {
-        delete atlas;
-    }
-
-    m_frames.clear();
-    m_atlases.clear();
-    m_currentFrame = nullptr;
-    m_isAnimating = false;
-
+    releaseFrames();
     RenderBase::destroy();
 }
 
@@ -177,6 +265,16 @@ void AnimationBase::update(const GameTime& time)
 {
     updateTransform(time);
 
+    // The frames are uploaded while rendering; keeps retained containers
+    // rendering this animation until it is ready.
+    if (isLoading())
+    {
+        markDirty();
+        return;
+    }
+
+    const AnimationFrame* previousFrame = m_currentFrame;
+
     // Updates the animation.
     if (m_isAnimating && Q_LIKELY(!isNull()))
     {
@@ -202,6 +300,11 @@ void AnimationBase::update(const GameTime& time)
         }
     }
 
+    if (m_currentFrame != previousFrame)
+    {
+        markDirty();
+    }
+
     // Copies all transformations.
     TextureBase* texture = getCurrentTexture();
     {
@@ -214,6 +317,16 @@ void AnimationBase::update(const GameTime& time)
 
 void AnimationBase::render()
 {
+    cranProfile("AnimationBase::render");
+
+    // Uploads the next frames on the thread that owns the context; update()
+    // may run on another one.
+    if (isLoading())
+    {
+        continueLoading();
+        return;
+    }
+
     if (!prepareRendering()) return;
 
     // Renders the current texture.
@@ -227,47 +340,65 @@ bool AnimationBase::createInternal(
           Window* rt
     )
 {
+    releaseFrames();
     if (!RenderBase::create(rt)) return false;
 
     qint32 maxSize = qMin(c_maxSize, TextureBase::maxSize());
-    TextureAtlas* currentAtlas = new TextureAtlas(maxSize, renderTarget());
+    QVector<int> remaining;
     QSize largestSize;
 
-    AnimationFrame currentFrame;
-    qint32 frameCount = frames.size();
-
-    // Finds a nice place in the atlas, for every frame.
-    for (int i = 0; i < frameCount; i++)
+    for (int i = 0; i < frames.size(); i++)
     {
         const QImage& img = frames.at(i);
-        const qreal& dura = durations.at(i);
-        if (!currentAtlas->canInsert())
-        {
-            // Atlas is full; create new one.
-            m_atlases.append(currentAtlas);
-            currentAtlas = new TextureAtlas(maxSize, renderTarget());
-        }
 
-        currentAtlas->insert(img);
-        currentFrame.setAtlasId(m_atlases.size());
-        currentFrame.setDuration(dura / 1000.0);
-        currentFrame.setRectangle(currentAtlas->lastRectangle());
-        currentFrame.setFrameId(i);
+        AnimationFrame frame;
+        frame.setDuration(durations.at(i) / 1000.0);
+        frame.setFrameId(i);
 
-        m_frames.push_back(currentFrame);
+        m_frames.push_back(frame);
+        remaining.push_back(i);
 
         // Finds the largest image.
         largestSize.rwidth() = qMax(img.width(), largestSize.width());
         largestSize.rheight() = qMax(img.height(), largestSize.height());
     }
 
-    // Adds the last atlas to the list.
-    m_atlases.append(currentAtlas);
-    m_currentFrame = &m_frames.first();
+    // Packs all frames that still fit into one atlas at once, then continues
+    // with the remaining frames in a new atlas.
+    while (!remaining.isEmpty())
+    {
+        QVector<QImage> images;
+        QVector<QRect> rects;
+        QVector<int> next;
 
-    setSize(largestSize.width(), largestSize.height());
-    setOrigin(width() / 2, height() / 2);
-    setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.texture"));
+        for (int i : remaining) images.append(frames.at(i));
+
+        TextureAtlas* atlas = new TextureAtlas(maxSize, renderTarget());
+        if (atlas->insert(images, rects) == 0)
+        {
+            delete atlas;
+            return cranError(ERRARG(e_04));
+        }
+
+        for (int i = 0; i < remaining.size(); i++)
+        {
+            AnimationFrame& frame = m_frames[remaining.at(i)];
+            if (rects.at(i).isNull())
+            {
+                next.append(remaining.at(i));
+            }
+            else
+            {
+                frame.setAtlasId(m_atlases.size());
+                frame.setRectangle(rects.at(i));
+            }
+        }
+
+        m_atlases.append(atlas);
+        remaining = next;
+    }
+
+    finishCreation(largestSize);
 
     return true;
 }
@@ -279,6 +410,7 @@ bool AnimationBase::createInternal(
           Window* rt
     )
 {
+    releaseFrames();
     if (!RenderBase::create(rt)) return false;
 
     QSize largestSize;
@@ -295,13 +427,151 @@ bool AnimationBase::createInternal(
 
     // Simply copies the frames since everything is prepared.
     m_frames = frames;
+    finishCreation(largestSize);
+
+    return true;
+}
+
+
+bool AnimationBase::createInternalAsync(const FrameDecoder& decoder, Window* rt)
+{
+    // The frames of a previous creation would otherwise be appended to.
+    releaseFrames();
+
+    if (!RenderBase::create(rt)) return false;
+
+    m_load.reset(new priv::AnimationLoad);
+    m_load->atlas = nullptr;
+    m_load->uploaded = 0;
+
+    QThreadPool::globalInstance()->start(new priv::AnimationDecodeTask(m_load, decoder));
+
+    return true;
+}
+
+
+bool AnimationBase::insertFrame(TextureAtlas*& atlas, const QImage& img, qreal duration)
+{
+    if (!atlas->canInsert(img.size()))
+    {
+        // Atlas is full; create new one.
+        m_atlases.append(atlas);
+        atlas = new TextureAtlas(qMin(c_maxSize, TextureBase::maxSize()), renderTarget());
+    }
+
+    if (!atlas->insert(img))
+    {
+        return cranError(ERRARG(e_04));
+    }
+
+    AnimationFrame frame;
+    frame.setAtlasId(m_atlases.size());
+    frame.setDuration(duration / 1000.0);
+    frame.setRectangle(atlas->lastRectangle());
+    frame.setFrameId(m_frames.size());
+
+    m_frames.push_back(frame);
+
+    return true;
+}
+
+
+void AnimationBase::finishCreation(const QSize& largestSize)
+{
     m_currentFrame = &m_frames.first();
 
     setSize(largestSize.width(), largestSize.height());
     setOrigin(width() / 2, height() / 2);
     setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.texture"));
+}
 
-    return true;
+
+void AnimationBase::continueLoading()
+{
+    const int state = m_load->state.loadAcquire();
+    if (state == 0)
+    {
+        return;
+    }
+    else if (state < 0)
+    {
+        cranError(ERRARG(e_03));
+        cancelLoading();
+        m_emitter.emitFailedAnimation();
+        return;
+    }
+
+    makeCurrent();
+
+    if (m_load->atlas == nullptr)
+    {
+        qint32 maxSize = qMin(c_maxSize, TextureBase::maxSize());
+        m_load->atlas = new TextureAtlas(maxSize, renderTarget());
+    }
+
+    // Uploads frames until the time budget of this frame is used up, but at
+    // least one, so that loading always progresses.
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<QImage>& frames = m_load->frames;
+    do
+    {
+        const int i = m_load->uploaded++;
+        const QImage& img = frames.at(i);
+        if (!insertFrame(m_load->atlas, img, m_load->durations.at(i)))
+        {
+            cancelLoading();
+            m_emitter.emitFailedAnimation();
+            return;
+        }
+
+        m_load->largestSize.rwidth() = qMax(img.width(), m_load->largestSize.width());
+        m_load->largestSize.rheight() = qMax(img.height(), m_load->largestSize.height());
+
+        // The pixels now reside in the texture.
+        frames[i] = QImage();
+    }
+    while (m_load->uploaded < frames.size() && timer.elapsed() < c_uploadBudget);
+
+    if (m_load->uploaded == frames.size())
+    {
+        m_atlases.append(m_load->atlas);
+        finishCreation(m_load->largestSize);
+        m_load.reset();
+        markDirty();
+        m_emitter.emitReadyAnimation();
+    }
+}
+
+
+void AnimationBase::cancelLoading()
+{
+    if (m_load.isNull())
+    {
+        return;
+    }
+
+    // The worker keeps its own reference and stops as soon as possible.
+    m_load->cancelled.storeRelease(1);
+    delete m_load->atlas;
+    m_load.reset();
+}
+
+
+void AnimationBase::releaseFrames()
+{
+    cancelLoading();
+
+    for (TextureAtlas* atlas : m_atlases)
+    {
+        delete atlas;
+    }
+
+    m_frames.clear();
+    m_atlases.clear();
+    m_currentFrame = nullptr;
+    m_isAnimating = false;
 }
 
 
@@ -0,0 +1,364 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/GlyphAtlas.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Qt headers
+#include <QImage>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLTexture>
+#include <QPainter>
+#include <QPainterPath>
+
+// Standard headers
+#include <cmath>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "GlyphAtlas: Glyph %0 is larger than a page.")
+CRANBERRY_CONST_VAR(QString, e_02, "GlyphAtlas: Page texture could not be created.")
+CRANBERRY_CONST_VAR(int, c_gap, 1)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+GlyphAtlas::GlyphAtlas()
+{
+}
+
+
+GlyphAtlas::~GlyphAtlas()
+{
+    if (QOpenGLContext::currentContext() != nullptr)
+    {
+        destroy();
+    }
+}
+
+
+GlyphAtlas* GlyphAtlas::instance()
+{
+    static GlyphAtlas atlas;
+    return &atlas;
+}
+
+
+int GlyphAtlas::fontId(const QFont& font)
+{
+    QFont base(font);
+    base.setPixelSize(baseSize());
+
+    QMutexLocker lock(&m_mutex);
+
+    const QString key = base.key();
+    auto it = m_fontIds.find(key);
+    if (it != m_fontIds.end())
+    {
+        return it.value();
+    }
+
+    const int id = m_fonts.size();
+    m_fonts.append(QRawFont::fromFont(base));
+    m_fontIds.insert(key, id);
+
+    return id;
+}
+
+
+QRawFont GlyphAtlas::rawFont(int id) const
+{
+    QMutexLocker lock(&m_mutex);
+    return (id >= 0 && id < m_fonts.size()) ? m_fonts.at(id) : QRawFont();
+}
+
+
+GlyphAtlas::Glyph GlyphAtlas::glyph(int id, quint32 index)
+{
+    QMutexLocker lock(&m_mutex);
+
+    const quint64 key = (quint64(id) << 32) | index;
+    auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end())
+    {
+        return it.value();
+    }
+
+    Glyph g = createGlyph(id, index);
+    m_glyphs.insert(key, g);
+
+    return g;
+}
+
+
+int GlyphAtlas::pageCount() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_pages.size();
+}
+
+
+bool GlyphAtlas::bindPage(int page)
+{
+    QMutexLocker lock(&m_mutex);
+    if (page < 0 || page >= m_pages.size())
+    {
+        return false;
+    }
+
+    Page& p = m_pages[page];
+    if (p.texture == nullptr)
+    {
+        p.texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+        p.texture->setFormat(QOpenGLTexture::R8_UNorm);
+        p.texture->setSize(pageSize(), pageSize());
+        p.texture->allocateStorage();
+
+        if (!p.texture->isStorageAllocated())
+        {
+            delete p.texture;
+            p.texture = nullptr;
+            return cranError(e_02);
+        }
+
+        p.texture->setMinificationFilter(QOpenGLTexture::Linear);
+        p.texture->setMagnificationFilter(QOpenGLTexture::Linear);
+        p.texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+        p.dirtyTop = 0;
+        p.dirtyBottom = qMax(p.dirtyBottom, p.shelfY + p.shelfHeight);
+    }
+
+    glDebug(p.texture->bind());
+
+    // Only the rows touched since the last upload are transferred; as they
+    // span the whole page width, they are contiguous in memory.
+    if (p.dirtyTop < p.dirtyBottom)
+    {
+        QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+        glDebug(gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        glDebug(gl->glTexSubImage2D(
+                    GL_TEXTURE_2D,
+                    0,
+                    0,
+                    p.dirtyTop,
+                    pageSize(),
+                    p.dirtyBottom - p.dirtyTop,
+                    GL_RED,
+                    GL_UNSIGNED_BYTE,
+                    p.pixels.constData() + p.dirtyTop * pageSize()
+                    ));
+        glDebug(gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+        p.dirtyTop = pageSize();
+        p.dirtyBottom = 0;
+    }
+
+    return true;
+}
+
+
+void GlyphAtlas::releasePage(int page)
+{
+    QMutexLocker lock(&m_mutex);
+    if (page >= 0 && page < m_pages.size() && m_pages.at(page).texture != nullptr)
+    {
+        glDebug(m_pages.at(page).texture->release());
+    }
+}
+
+
+void GlyphAtlas::destroy()
+{
+    QMutexLocker lock(&m_mutex);
+    for (Page& p : m_pages)
+    {
+        delete p.texture;
+    }
+
+    m_pages.clear();
+    m_glyphs.clear();
+    m_fonts.clear();
+    m_fontIds.clear();
+}
+
+
+GlyphAtlas::Glyph GlyphAtlas::createGlyph(int id, quint32 index)
+{
+    Glyph g;
+    g.page = -1;
+
+    if (id < 0 || id >= m_fonts.size())
+    {
+        return g;
+    }
+
+    // Blank glyphs (e.g. spaces) only advance the pen.
+    const QPainterPath path = m_fonts.at(id).pathForGlyph(index);
+    const QRect box = path.boundingRect().toAlignedRect();
+    if (box.isEmpty())
+    {
+        return g;
+    }
+
+    // The distance field extends beyond the outline by the spread on all
+    // sides, so that outlines and blur are not cut off.
+    const int pad = spread() + 1;
+    const int w = box.width() + pad * 2;
+    const int h = box.height() + pad * 2;
+
+    QImage coverage(w, h, QImage::Format_ARGB32_Premultiplied);
+    coverage.fill(Qt::transparent);
+    {
+        QPainter painter(&coverage);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(pad - box.x(), pad - box.y());
+        painter.fillPath(path, Qt::white);
+    }
+
+    int page;
+    const QRect rc = allocate(w, h, page);
+    if (rc.isNull())
+    {
+        cranError(e_01.arg(index));
+        return g;
+    }
+
+    writeDistanceField(coverage, rc, m_pages[page]);
+
+    const qreal ps = pageSize();
+    g.bounds = QRectF(box.x() - pad, box.y() - pad, w, h);
+    g.uv = QRectF(rc.x() / ps, rc.y() / ps, w / ps, h / ps);
+    g.page = page;
+
+    return g;
+}
+
+
+QRect GlyphAtlas::allocate(int width, int height, int& page)
+{
+    if (width + c_gap > pageSize() || height + c_gap > pageSize())
+    {
+        return QRect();
+    }
+
+    // Shelf packing: glyphs of one font have similar heights, thus the rows
+    // waste little space and placing a glyph is O(1).
+    if (!m_pages.isEmpty())
+    {
+        Page& p = m_pages.last();
+        if (p.shelfX + width + c_gap > pageSize())
+        {
+            p.shelfX = 0;
+            p.shelfY += p.shelfHeight;
+            p.shelfHeight = 0;
+        }
+
+        if (p.shelfY + height + c_gap <= pageSize())
+        {
+            QRect rc(p.shelfX, p.shelfY, width, height);
+            p.shelfX += width + c_gap;
+            p.shelfHeight = qMax(p.shelfHeight, height + c_gap);
+            page = m_pages.size() - 1;
+            return rc;
+        }
+    }
+
+    Page p;
+    p.pixels.fill(0, pageSize() * pageSize());
+    p.texture = nullptr;
+    p.shelfX = width + c_gap;
+    p.shelfY = 0;
+    p.shelfHeight = height + c_gap;
+    p.dirtyTop = pageSize();
+    p.dirtyBottom = 0;
+
+    m_pages.append(p);
+    page = m_pages.size() - 1;
+
+    return QRect(0, 0, width, height);
+}
+
+
+void GlyphAtlas::writeDistanceField(const QImage& coverage, const QRect& rc, Page& page)
+{
+    const int w = coverage.width();
+    const int h = coverage.height();
+    const int s = spread();
+
+    // Coverage of every pixel, 0 to 255.
+    QVector<quint8> alpha(w * h);
+    for (int y = 0; y < h; y++)
+    {
+        const QRgb* line = reinterpret_cast<const QRgb*>(coverage.constScanLine(y));
+        for (int x = 0; x < w; x++)
+        {
+            alpha[y * w + x] = static_cast<quint8>(qAlpha(line[x]));
+        }
+    }
+
+    for (int y = 0; y < h; y++)
+    {
+        quint8* dst = page.pixels.data() + (rc.y() + y) * pageSize() + rc.x();
+        for (int x = 0; x < w; x++)
+        {
+            const quint8 a = alpha.at(y * w + x);
+            float dist;
+
+            if (a > 0 && a < 255)
+            {
+                // Anti-aliased pixels lie on the outline; their coverage is a
+                // better estimate of the sub-pixel distance than a search.
+                dist = a / 255.0f - 0.5f;
+            }
+            else
+            {
+                // Searches the nearest pixel on the other side of the outline
+                // within the spread.
+                const bool inside = (a == 255);
+                int best = (s + 1) * (s + 1);
+
+                for (int v = qMax(0, y - s); v <= qMin(h - 1, y + s); v++)
+                {
+                    for (int u = qMax(0, x - s); u <= qMin(w - 1, x + s); u++)
+                    {
+                        if ((alpha.at(v * w + u) >= 128) != inside)
+                        {
+                            best = qMin(best, (u - x) * (u - x) + (v - y) * (v - y));
+                        }
+                    }
+                }
+
+                dist = std::sqrt(static_cast<float>(best)) - 0.5f;
+                dist = inside ? dist : -dist;
+            }
+
+            // Stores 0.5 on the outline and 0 resp. 1 at the spread.
+            const float value = qBound(0.0f, 0.5f + dist / (2.0f * s), 1.0f);
+            dst[x] = static_cast<quint8>(value * 255.0f + 0.5f);
+        }
+    }
+
+    page.dirtyTop = qMin(page.dirtyTop, rc.top());
+    page.dirtyBottom = qMax(page.dirtyBottom, rc.bottom() + 1);
+}
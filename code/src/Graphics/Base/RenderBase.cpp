@@ -48,6 +48,10 @@ RenderBase::RenderBase()
     , m_customProgram(nullptr)
     , m_name("{no_name}")
     , m_osRenderer(0)
+    , m_layer(0)
+    , m_depth(0.0f)
+    , m_opaque(false)
+    , m_revision(0)
 {
 }
 
@@ -82,6 +86,12 @@ const QString& RenderBase::name() const
 }
 
 
+quint64 RenderBase::revision() const
+{
+    return m_revision;
+}
+
+
 void RenderBase::setShaderProgram(OpenGLShader* program)
 {
     m_customProgram = program;
@@ -94,6 +104,12 @@ void RenderBase::setDefaultShaderProgram(OpenGLShader* program)
 }
 
 
+void RenderBase::markDirty()
+{
+    m_revision++;
+}
+
+
 uint RenderBase::offscreenRenderer() const
 {
     return m_osRenderer;
@@ -137,6 +153,57 @@ bool RenderBase::prepareRendering()
 }
 
 
+int RenderBase::layer() const
+{
+    return m_layer;
+}
+
+
+float RenderBase::depth() const
+{
+    return m_depth;
+}
+
+
+bool RenderBase::isOpaque() const
+{
+    return m_opaque;
+}
+
+
+void RenderBase::setLayer(int layer)
+{
+    m_layer = qBound(-128, layer, 127);
+}
+
+
+void RenderBase::setDepth(float depth)
+{
+    m_depth = qBound(0.0f, depth, 1.0f);
+}
+
+
+void RenderBase::setOpaque(bool opaque)
+{
+    m_opaque = opaque;
+}
+
+
+void RenderBase::enqueue()
+{
+    if (Q_LIKELY(m_renderTarget != nullptr))
+    {
+        m_renderTarget->enqueue(this);
+    }
+}
+
+
+uint RenderBase::textureId() const
+{
+    return 0;
+}
+
+
 bool RenderBase::isNull() const
 {
     return m_renderTarget == nullptr;
@@ -0,0 +1,290 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/RenderTargetPool.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Qt headers
+#include <QHash>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QVector>
+
+// Types
+typedef cran::priv::RenderTargetPool::Target Target;
+typedef QHash<quint64, QVector<Target*>> TargetPool;
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "RenderTargetPool: Framebuffer of size %0x%1 with %2 samples could not be created.")
+CRANBERRY_CONST_VAR(int, c_maxIdleFrames, 120)
+
+// Globals
+CRANBERRY_GLOBAL_VAR(TargetPool, g_pool)
+CRANBERRY_GLOBAL_VAR(qint64, g_memory)
+CRANBERRY_GLOBAL_VAR(int, g_maxSamples)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    quint64 poolKey(const QSize& size, int samples, bool depthStencil)
+    {
+        return (quint64(size.width()) << 40)  |
+               (quint64(size.height()) << 16) |
+               (quint64(samples) << 1)        |
+               (quint64(depthStencil));
+    }
+}
+
+
+Target* priv::RenderTargetPool::acquire(
+        const QSize& size,
+        int samples,
+        bool depthStencil
+        )
+{
+    // Drivers reject sample counts they do not support. Clamps them before
+    // the lookup, so that released targets end up in the same bucket.
+    if (samples > 0)
+    {
+        if (g_maxSamples == 0)
+        {
+            QOpenGLExtraFunctions* gl = QOpenGLContext::currentContext()->extraFunctions();
+            glDebug(gl->glGetIntegerv(GL_MAX_SAMPLES, &g_maxSamples));
+            g_maxSamples = qMax(1, g_maxSamples);
+        }
+
+        samples = qMin(samples, g_maxSamples);
+    }
+
+    QVector<Target*>& pool = g_pool[poolKey(size, samples, depthStencil)];
+    if (!pool.isEmpty())
+    {
+        return pool.takeLast();
+    }
+
+    return create(size, samples, depthStencil);
+}
+
+
+void priv::RenderTargetPool::release(Target* target)
+{
+    if (target == nullptr)
+    {
+        return;
+    }
+
+    target->idleFrames = 0;
+    g_pool[poolKey(target->size, target->samples, target->depthStencil)].append(target);
+}
+
+
+void priv::RenderTargetPool::collect()
+{
+    for (auto it = g_pool.begin(); it != g_pool.end(); )
+    {
+        QVector<Target*>& pool = it.value();
+        for (int i = pool.size() - 1; i >= 0; i--)
+        {
+            if (++pool[i]->idleFrames > c_maxIdleFrames)
+            {
+                destroy(pool.takeAt(i));
+            }
+        }
+
+        it = pool.isEmpty() ? g_pool.erase(it) : it + 1;
+    }
+}
+
+
+qint64 priv::RenderTargetPool::memoryUsage()
+{
+    return g_memory;
+}
+
+
+void priv::RenderTargetPool::clear()
+{
+    for (const auto& pool : g_pool)
+    {
+        for (Target* target : pool)
+        {
+            destroy(target);
+        }
+    }
+
+    g_pool.clear();
+    g_maxSamples = 0;
+}
+
+
+Target* priv::RenderTargetPool::create(
+        const QSize& size,
+        int samples,
+        bool depthStencil
+        )
+{
+    QOpenGLExtraFunctions* gl = QOpenGLContext::currentContext()->extraFunctions();
+
+    Target* target = new Target;
+    target->frameBuffer = 0;
+    target->colorBuffer = 0;
+    target->depthBuffer = 0;
+    target->size = size;
+    target->samples = samples;
+    target->depthStencil = depthStencil;
+    target->idleFrames = 0;
+
+    glDebug(gl->glGenFramebuffers(1, &target->frameBuffer));
+    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, target->frameBuffer));
+
+    // The color of multisampled targets is never sampled, only resolved;
+    // a renderbuffer suffices and is available on OpenGL ES as well.
+    if (samples > 0)
+    {
+        glDebug(gl->glGenRenderbuffers(1, &target->colorBuffer));
+        glDebug(gl->glBindRenderbuffer(GL_RENDERBUFFER, target->colorBuffer));
+        glDebug(gl->glRenderbufferStorageMultisample(
+                    GL_RENDERBUFFER,
+                    samples,
+                    GL_RGBA8,
+                    size.width(),
+                    size.height()
+                    ));
+
+        glDebug(gl->glFramebufferRenderbuffer(
+                    GL_FRAMEBUFFER,
+                    GL_COLOR_ATTACHMENT0,
+                    GL_RENDERBUFFER,
+                    target->colorBuffer
+                    ));
+    }
+    else
+    {
+        glDebug(gl->glGenTextures(1, &target->colorBuffer));
+        glDebug(gl->glBindTexture(GL_TEXTURE_2D, target->colorBuffer));
+        glDebug(gl->glTexImage2D(
+                    GL_TEXTURE_2D,
+                    GL_ZERO,
+                    GL_RGBA8,
+                    size.width(),
+                    size.height(),
+                    GL_ZERO,
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    NULL
+                    ));
+
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        glDebug(gl->glBindTexture(GL_TEXTURE_2D, GL_ZERO));
+
+        glDebug(gl->glFramebufferTexture2D(
+                    GL_FRAMEBUFFER,
+                    GL_COLOR_ATTACHMENT0,
+                    GL_TEXTURE_2D,
+                    target->colorBuffer,
+                    GL_ZERO
+                    ));
+    }
+
+    if (depthStencil)
+    {
+        glDebug(gl->glGenRenderbuffers(1, &target->depthBuffer));
+        glDebug(gl->glBindRenderbuffer(GL_RENDERBUFFER, target->depthBuffer));
+        glDebug(gl->glRenderbufferStorageMultisample(
+                    GL_RENDERBUFFER,
+                    samples,
+                    GL_DEPTH24_STENCIL8,
+                    size.width(),
+                    size.height()
+                    ));
+
+        glDebug(gl->glFramebufferRenderbuffer(
+                    GL_FRAMEBUFFER,
+                    GL_DEPTH_STENCIL_ATTACHMENT,
+                    GL_RENDERBUFFER,
+                    target->depthBuffer
+                    ));
+    }
+
+    uint status;
+    glDebug(status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    glDebug(gl->glBindRenderbuffer(GL_RENDERBUFFER, GL_ZERO));
+    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, GL_ZERO));
+
+    g_memory += bytes(target);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        destroy(target);
+        cranError(e_01.arg(size.width()).arg(size.height()).arg(samples));
+        return nullptr;
+    }
+
+    return target;
+}
+
+
+void priv::RenderTargetPool::destroy(Target* target)
+{
+    QOpenGLExtraFunctions* gl = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (target->frameBuffer != 0)
+    {
+        glDebug(gl->glDeleteFramebuffers(1, &target->frameBuffer));
+    }
+
+    if (target->colorBuffer != 0)
+    {
+        if (target->samples > 0)
+        {
+            glDebug(gl->glDeleteRenderbuffers(1, &target->colorBuffer));
+        }
+        else
+        {
+            glDebug(gl->glDeleteTextures(1, &target->colorBuffer));
+        }
+    }
+
+    if (target->depthBuffer != 0)
+    {
+        glDebug(gl->glDeleteRenderbuffers(1, &target->depthBuffer));
+    }
+
+    g_memory -= bytes(target);
+    delete target;
+}
+
+
+qint64 priv::RenderTargetPool::bytes(const Target* target)
+{
+    const qint64 pixels = qint64(target->size.width()) * target->size.height();
+    const qint64 samples = qMax(1, target->samples);
+
+    // Both the color and the depth/stencil format take four bytes per sample.
+    return pixels * samples * (target->depthStencil ? 8 : 4);
+}
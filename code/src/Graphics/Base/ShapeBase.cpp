@@ -26,6 +26,7 @@
 #include <Cranberry/OpenGL/OpenGLShader.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
@@ -86,18 +87,21 @@ bool ShapeBase::isSmooth() const
 void ShapeBase::setShapeFilled(bool filled)
 {
     m_filled = filled;
+    markDirty();
 }
 
 
 void ShapeBase::setSmooth(bool smooth)
 {
     m_smooth = smooth;
+    markDirty();
 }
 
 
 void ShapeBase::setLineWidth(int width)
 {
     m_lineWidth = qMax(width, 1);
+    markDirty();
 }
 
 
@@ -107,6 +111,7 @@ void ShapeBase::setColor(const QColor& color)
     m_colorBuffer.append(color);
     m_colorUpdate = true;
     m_update = true;
+    markDirty();
 }
 
 
@@ -121,6 +126,7 @@ void ShapeBase::setColor(const QVector<QColor>& colors)
     m_colorBuffer = colors;
     m_colorUpdate = true;
     m_update = true;
+    markDirty();
 }
 
 
@@ -153,6 +159,8 @@ void ShapeBase::update(const GameTime& time)
 
 void ShapeBase::render()
 {
+    cranProfile("ShapeBase::render");
+
     if (!prepareRendering())
     {
         return;
@@ -297,6 +305,7 @@ bool ShapeBase::createInternal(const QVector<QPointF>& points, Window* rt)
     m_vertexBuffer->release();
     m_points = points;
     m_update = true;
+    markDirty();
 
     setOrigin(findCenter(points));
     setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.shape"));
@@ -0,0 +1,182 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/TextCache.hpp>
+#include <Cranberry/System/Debug.hpp>
+
+// Qt headers
+#include <QCache>
+#include <QHash>
+#include <QOpenGLFramebufferObject>
+#include <QVector>
+
+// Types
+typedef QCache<QString, QSizeF> SizeCache;
+typedef QHash<QString, cran::priv::TextCache::Entry*> EntryMap;
+typedef QHash<quint64, QVector<QOpenGLFramebufferObject*>> FboPool;
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "TextCache: Framebuffer of size %0x%1 could not be created.")
+CRANBERRY_CONST_VAR(int, c_maxSizes, 4096)
+CRANBERRY_CONST_VAR(int, c_maxPooled, 8)
+CRANBERRY_CONST_VAR(int, c_minClass, 32)
+
+// Globals
+CRANBERRY_GLOBAL_VAR(SizeCache, g_sizes)
+CRANBERRY_GLOBAL_VAR(EntryMap, g_entries)
+CRANBERRY_GLOBAL_VAR(FboPool, g_pool)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+bool priv::TextCache::findSize(const QString& key, QSizeF* size)
+{
+    const QSizeF* cached = g_sizes.object(key);
+    if (cached == nullptr)
+    {
+        return false;
+    }
+
+    *size = *cached;
+    return true;
+}
+
+
+void priv::TextCache::insertSize(const QString& key, const QSizeF& size)
+{
+    if (g_sizes.maxCost() != c_maxSizes)
+    {
+        g_sizes.setMaxCost(c_maxSizes);
+    }
+
+    g_sizes.insert(key, new QSizeF(size));
+}
+
+
+priv::TextCache::Entry* priv::TextCache::acquire(
+        const QString& key,
+        const QSize& size,
+        bool* created
+        )
+{
+    *created = false;
+
+    Entry* entry = g_entries.value(key, nullptr);
+    if (entry != nullptr)
+    {
+        entry->refs++;
+        return entry;
+    }
+
+    // Reuses a framebuffer of the same size class, if one is available.
+    const QSize cls = sizeClass(size);
+    const quint64 poolKey = (quint64(cls.width()) << 32) | quint64(cls.height());
+    QOpenGLFramebufferObject* fbo = nullptr;
+
+    QVector<QOpenGLFramebufferObject*>& pool = g_pool[poolKey];
+    if (!pool.isEmpty())
+    {
+        fbo = pool.takeLast();
+    }
+    else
+    {
+        fbo = new QOpenGLFramebufferObject(cls, QOpenGLFramebufferObject::CombinedDepthStencil);
+        if (!fbo->isValid())
+        {
+            delete fbo;
+            cranError(e_01.arg(cls.width()).arg(cls.height()));
+            return nullptr;
+        }
+    }
+
+    entry = new Entry;
+    entry->key = key;
+    entry->fbo = fbo;
+    entry->size = size;
+    entry->refs = 1;
+
+    g_entries.insert(key, entry);
+    *created = true;
+
+    return entry;
+}
+
+
+void priv::TextCache::release(const QString& key)
+{
+    Entry* entry = g_entries.value(key, nullptr);
+    if (entry == nullptr || --entry->refs > 0)
+    {
+        return;
+    }
+
+    const QSize cls = entry->fbo->size();
+    const quint64 poolKey = (quint64(cls.width()) << 32) | quint64(cls.height());
+
+    QVector<QOpenGLFramebufferObject*>& pool = g_pool[poolKey];
+    if (pool.size() < c_maxPooled)
+    {
+        pool.append(entry->fbo);
+    }
+    else
+    {
+        delete entry->fbo;
+    }
+
+    g_entries.remove(key);
+    delete entry;
+}
+
+
+void priv::TextCache::clear()
+{
+    for (Entry* entry : g_entries)
+    {
+        delete entry->fbo;
+        delete entry;
+    }
+
+    for (const auto& pool : g_pool)
+    {
+        qDeleteAll(pool);
+    }
+
+    g_entries.clear();
+    g_pool.clear();
+    g_sizes.clear();
+}
+
+
+QSize priv::TextCache::sizeClass(const QSize& size)
+{
+    // Rounds both dimensions up to the next power of two, so that a text that
+    // grows by a few characters most likely stays in its class.
+    auto roundUp = [] (int v)
+    {
+        int c = c_minClass;
+        while (c < v) c <<= 1;
+        return c;
+    };
+
+    return QSize(roundUp(size.width()), roundUp(size.height()));
+}
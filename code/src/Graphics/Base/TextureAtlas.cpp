@@ -21,23 +21,33 @@
 
 // Cranberry headers
 #include <Cranberry/Graphics/Base/TextureAtlas.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
 #include <QOpenGLTexture>
 #include <QOpenGLFunctions>
 
+// Standard headers
+#include <algorithm>
+#include <numeric>
+
 
 CRANBERRY_USING_NAMESPACE
 
 
-TextureAtlas::TextureAtlas(int size, Window* renderTarget)
-    : m_size(size)
+TextureAtlas::TextureAtlas(int size, Window* renderTarget, PackingMethod method)
+    : m_method(method)
+    , m_size(size)
     , m_usedSpace(0)
     , m_occupancy(0.0)
     , m_texture(new TextureBase)
+    , m_pixelBuffer(nullptr)
+    , m_usePixelBuffer(false)
 {
     if (renderTarget == nullptr)
     {
@@ -74,15 +84,24 @@ TextureAtlas::TextureAtlas(int size, Window* renderTarget)
     m_texId = tex->textureId();
     gl = renderTarget->functions();
 
+    // Pixel unpack buffers are not available in OpenGL ES 2.0.
+    QOpenGLContext* ctx = renderTarget->context();
+    m_usePixelBuffer = !ctx->isOpenGLES() || ctx->format().majorVersion() >= 3;
+
     m_free.push_back(QRect(0, 0, size, size));
+    m_skyline.push_back({ 0, 0, size });
 }
 
 
 TextureAtlas::TextureAtlas(const QImage& img, Window* renderTarget)
-    : m_size(img.size().width())
+    : m_bounds(img.rect())
+    , m_method(PackMaxRects)
+    , m_size(img.size().width())
     , m_usedSpace(0)
     , m_occupancy(1.0)
     , m_texture(new TextureBase)
+    , m_pixelBuffer(nullptr)
+    , m_usePixelBuffer(false)
 {
     if (renderTarget == nullptr)
     {
@@ -98,13 +117,20 @@ TextureAtlas::TextureAtlas(const QImage& img, Window* renderTarget)
         renderTarget->makeCurrent();
     }
 
-    m_texture->create(new QOpenGLTexture(img), renderTarget);
+    // Sprites create one atlas per movement out of the same sheet; they all
+    // share a single texture.
+    TextureCache::Options options;
+    options.wrapMode = QOpenGLTexture::Repeat;
+    options.mipmaps = true;
+
+    m_texture->create(TextureCache::instance()->acquire(img, options), renderTarget);
 }
 
 
 TextureAtlas::~TextureAtlas()
 {
     m_texture->destroy();
+    delete m_pixelBuffer;
 }
 
 
@@ -115,27 +141,73 @@ bool TextureAtlas::insert(const QImage& img)
     auto fit = find(img.width(), img.height(), index);
     if (fit.isNull()) return false;
 
-    // Performs a clean-up.
-    split(m_free.at(index), fit);
-    m_free.erase(m_free.begin() + index);
-    merge();
-
     // Places the rectangle inside the texture.
-    m_used.push_back(fit);
-    m_usedSpace += (fit.width() * fit.height());
-    m_occupancy = (m_usedSpace / (m_size * m_size));
+    place(fit, index);
     drawIntoTexture(img, fit);
 
     return true;
 }
 
 
+int TextureAtlas::insert(const QVector<QImage>& images, QVector<QRect>& rects)
+{
+    QVector<int> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // Sorts by the longer side, then by area, both descending.
+    std::stable_sort(order.begin(), order.end(), [&images] (int a, int b)
+    {
+        const QSize sa = images.at(a).size();
+        const QSize sb = images.at(b).size();
+        const int la = qMax(sa.width(), sa.height());
+        const int lb = qMax(sb.width(), sb.height());
+
+        if (la != lb) return la > lb;
+        return sa.width() * sa.height() > sb.width() * sb.height();
+    });
+
+    rects.fill(QRect(), images.size());
+
+    int inserted = 0;
+    for (int i : order)
+    {
+        if (insert(images.at(i)))
+        {
+            rects[i] = m_used.last();
+            inserted++;
+        }
+    }
+
+    return inserted;
+}
+
+
 bool TextureAtlas::canInsert() const
 {
     return m_occupancy < 0.9;
 }
 
 
+bool TextureAtlas::canInsert(const QSize& size) const
+{
+    int index;
+    return !find(size.width(), size.height(), index).isNull();
+}
+
+
+qreal TextureAtlas::occupancy() const
+{
+    return m_occupancy;
+}
+
+
+qreal TextureAtlas::efficiency() const
+{
+    const qint64 area = qint64(m_bounds.width()) * m_bounds.height();
+    return (area == 0) ? 0.0 : qreal(m_usedSpace) / area;
+}
+
+
 const QRect& TextureAtlas::lastRectangle() const
 {
     return m_used.last();
@@ -154,78 +226,238 @@ TextureBase* TextureAtlas::texture() const
 }
 
 
-int TextureAtlas::score(int width, int height, const QRect& free)
+QRect TextureAtlas::find(int width, int height, int& index) const
 {
-    return free.width() * free.height() - width * height;
+    if (width <= 0 || height <= 0 || width > m_size || height > m_size)
+    {
+        return QRect();
+    }
+
+    return (m_method == PackSkyline)
+            ? findSkyline(width, height, index)
+            : findMaxRects(width, height, index);
 }
 
 
-QRect TextureAtlas::find(int width, int height, int& index)
+QRect TextureAtlas::findMaxRects(int width, int height, int& index) const
 {
-    QRect bestNode(0, 0, width, height);
-    int bestScore = std::numeric_limits<int>::max(), n = 0;
-    bool success = false;
+    QRect bestNode;
+    int bestShort = std::numeric_limits<int>::max();
+    int bestLong = std::numeric_limits<int>::max();
 
-    // Finds the best fit.
-    for (auto it = m_free.begin(); it < m_free.end(); ++it, ++n)
+    // Picks the free rectangle that leaves the shortest side, and on a tie,
+    // the shortest long side.
+    for (int i = 0; i < m_free.size(); i++)
     {
-        // Does fit perfectly in a free rectangle?
-        if (width == it->width() && height == it->height())
+        const QRect& free = m_free.at(i);
+        if (width > free.width() || height > free.height())
+        {
+            continue;
+        }
+
+        int leftH = free.width() - width;
+        int leftV = free.height() - height;
+        int shortSide = qMin(leftH, leftV);
+        int longSide = qMax(leftH, leftV);
+
+        if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong))
         {
-            bestNode.moveLeft(it->x());
-            bestNode.moveTop(it->y());
-            bestScore = std::numeric_limits<int>::min();
+            bestNode = QRect(free.x(), free.y(), width, height);
+            bestShort = shortSide;
+            bestLong = longSide;
+            index = i;
 
-            index = n;
-            success = true;
-            break;
+            // Does fit perfectly in a free rectangle?
+            if (shortSide == 0 && longSide == 0) break;
         }
+    }
+
+    return bestNode;
+}
+
+
+QRect TextureAtlas::findSkyline(int width, int height, int& index) const
+{
+    QRect bestNode;
+    int bestBottom = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
 
-        // Does it fit anyhow in the free rectangle?
-        else if (width <= it->width() && height <= it->height())
+    // Picks the position with the lowest bottom edge, and on a tie, the one
+    // on the narrowest segment.
+    for (int i = 0; i < m_skyline.size(); i++)
+    {
+        int y;
+        if (!fitsSkyline(i, width, height, y))
         {
-            auto s = score(width, height, *it);
-            if (s < bestScore)
-            {
-                bestNode.moveLeft(it->x());
-                bestNode.moveTop(it->y());
-                bestScore = s;
+            continue;
+        }
 
-                index = n;
-                success = true;
-            }
+        const SkylineNode& node = m_skyline.at(i);
+        if (y + height < bestBottom || (y + height == bestBottom && node.width < bestWidth))
+        {
+            bestNode = QRect(node.x, y, width, height);
+            bestBottom = y + height;
+            bestWidth = node.width;
+            index = i;
         }
     }
 
-    return (success) ? bestNode : QRect();
+    return bestNode;
 }
 
 
-void TextureAtlas::split(const QRect& free, const QRect& used)
+bool TextureAtlas::fitsSkyline(int index, int width, int height, int& y) const
 {
-    // Compute leftover area.
-    int w = free.width() - used.width();
-    int h = free.height() - used.height();
-    bool hsplit = used.width() * h <= used.height() * w;
+    int x = m_skyline.at(index).x;
+    if (x + width > m_size)
+    {
+        return false;
+    }
+
+    // The rectangle rests on the highest segment below it.
+    int widthLeft = width;
+    y = m_skyline.at(index).y;
 
-    // Splits a free rectangle into two new rects.
-    QRect bottom(free.x(), free.y() + used.height(), 0, free.height() - used.height());
-    QRect right(free.x() + used.width(), free.y(), free.width() - used.width(), 0);
+    while (widthLeft > 0)
+    {
+        const SkylineNode& node = m_skyline.at(index++);
+        y = qMax(y, node.y);
+
+        if (y + height > m_size)
+        {
+            return false;
+        }
+
+        widthLeft -= node.width;
+    }
+
+    return true;
+}
 
-    if (hsplit)
+
+void TextureAtlas::place(const QRect& rc, int index)
+{
+    if (m_method == PackSkyline)
     {
-        bottom.setWidth(free.width());
-        right.setHeight(used.height());
+        placeSkyline(rc, index);
     }
     else
     {
-        bottom.setWidth(used.width());
-        right.setHeight(free.height());
+        placeMaxRects(rc);
+    }
+
+    m_used.push_back(rc);
+    m_bounds = m_bounds.united(rc);
+    m_usedSpace += (rc.width() * rc.height());
+    m_occupancy = (qreal(m_usedSpace) / (qreal(m_size) * m_size));
+}
+
+
+void TextureAtlas::placeMaxRects(const QRect& rc)
+{
+    const int oldCount = m_free.size();
+
+    // Splits every free rectangle that overlaps the used one into the (up to
+    // four) maximal rectangles around it.
+    for (int i = 0; i < oldCount; i++)
+    {
+        const QRect free = m_free.at(i);
+        if (!free.intersects(rc))
+        {
+            continue;
+        }
+
+        if (rc.left() > free.left())
+        {
+            m_free.push_back(QRect(free.left(), free.top(), rc.left() - free.left(), free.height()));
+        }
+        if (rc.right() < free.right())
+        {
+            m_free.push_back(QRect(rc.right() + 1, free.top(), free.right() - rc.right(), free.height()));
+        }
+        if (rc.top() > free.top())
+        {
+            m_free.push_back(QRect(free.left(), free.top(), free.width(), rc.top() - free.top()));
+        }
+        if (rc.bottom() < free.bottom())
+        {
+            m_free.push_back(QRect(free.left(), rc.bottom() + 1, free.width(), free.bottom() - rc.bottom()));
+        }
+
+        // Marks the split rectangle for removal.
+        m_free[i] = QRect();
+    }
+
+    // Removes the split rectangles while keeping track of the first new one.
+    int firstNew = oldCount;
+    for (int i = oldCount - 1; i >= 0; i--)
+    {
+        if (m_free.at(i).isNull())
+        {
+            m_free.removeAt(i);
+            firstNew--;
+        }
+    }
+
+    prune(firstNew);
+}
+
+
+void TextureAtlas::prune(int firstNew)
+{
+    // The old free rectangles are maximal among each other, and none of them
+    // can be contained in one of the new rectangles, which are parts of the
+    // split ones. Therefore, only new rectangles need to be tested.
+    for (int i = firstNew; i < m_free.size(); i++)
+    {
+        for (int j = 0; j < m_free.size(); j++)
+        {
+            if (i != j && m_free.at(j).contains(m_free.at(i)))
+            {
+                m_free.removeAt(i--);
+                break;
+            }
+        }
+    }
+}
+
+
+void TextureAtlas::placeSkyline(const QRect& rc, int index)
+{
+    m_skyline.insert(index, { rc.x(), rc.y() + rc.height(), rc.width() });
+
+    // Shrinks or removes the segments now covered by the new one.
+    for (int i = index + 1; i < m_skyline.size(); i++)
+    {
+        SkylineNode& prev = m_skyline[i - 1];
+        SkylineNode& node = m_skyline[i];
+        int overlap = prev.x + prev.width - node.x;
+
+        if (overlap <= 0)
+        {
+            break;
+        }
+
+        node.x += overlap;
+        node.width -= overlap;
+
+        if (node.width > 0)
+        {
+            break;
+        }
+
+        m_skyline.removeAt(i--);
     }
 
-    // Adds both rectangles, if valid, to the free ones.
-    if (bottom.width() > 0 && bottom.height() > 0) m_free.push_back(bottom);
-    if (right.width() > 0 && right.height() > 0) m_free.push_back(right);
+    // Merges neighbouring segments at the same height.
+    for (int i = 0; i < m_skyline.size() - 1; i++)
+    {
+        if (m_skyline.at(i).y == m_skyline.at(i + 1).y)
+        {
+            m_skyline[i].width += m_skyline.at(i + 1).width;
+            m_skyline.removeAt(i-- + 1);
+        }
+    }
 }
 
 
@@ -237,7 +469,38 @@ void TextureAtlas::drawIntoTexture(QImage img, const QRect& src)
         img = img.convertToFormat(QImage::Format_RGBA8888);
     }
 
-    // Writes the new data into the texture.
+    const void* pixels = img.constBits();
+    if (m_usePixelBuffer && m_pixelBuffer == nullptr)
+    {
+        m_pixelBuffer = new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
+        m_pixelBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+        m_usePixelBuffer = m_pixelBuffer->create();
+    }
+
+    // Stages the pixels in the pixel buffer. Re-allocating the storage orphans
+    // the one of the previous frame, which might still be transferred.
+    if (m_usePixelBuffer)
+    {
+        const int bytes = img.bytesPerLine() * img.height();
+
+        glDebug(m_pixelBuffer->bind());
+        glDebug(m_pixelBuffer->allocate(bytes));
+
+        void* dest = m_pixelBuffer->map(QOpenGLBuffer::WriteOnly);
+        if (dest != nullptr)
+        {
+            memcpy(dest, img.constBits(), bytes);
+            m_pixelBuffer->unmap();
+            pixels = nullptr;
+        }
+        else
+        {
+            m_pixelBuffer->release();
+        }
+    }
+
+    // Writes the new data into the texture. Reads from offset zero of the
+    // pixel buffer if the pixels were staged.
     glDebug(gl->glBindTexture(GL_TEXTURE_2D, m_texId));
     glDebug(gl->glTexSubImage2D(
                 GL_TEXTURE_2D, GL_ZERO,
@@ -246,48 +509,12 @@ void TextureAtlas::drawIntoTexture(QImage img, const QRect& src)
                 src.width(),
                 src.height(),
                 GL_RGBA, GL_UNSIGNED_BYTE,
-                img.constBits()
+                pixels
                 ));
     glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
-}
 
-
-void TextureAtlas::merge()
-{
-    for (int i = 0; i < m_free.size(); i++)
+    if (pixels == nullptr)
     {
-        QRect& ifree = m_free[i];
-        for (int j = i + 1; j < m_free.size(); j++)
-        {
-            QRect& jfree = m_free[j];
-            if (ifree.width() == jfree.width() && ifree.x() == jfree.x())
-            {
-                if (ifree.y() == jfree.y() + jfree.height())
-                {
-                    ifree.setTop(ifree.top() - jfree.height());
-                    ifree.setHeight(ifree.height() + jfree.height());
-                    m_free.erase(m_free.begin() + j--);
-                }
-                else if (ifree.y() + ifree.height() == jfree.y())
-                {
-                    ifree.setHeight(ifree.height() + jfree.height());
-                    m_free.erase(m_free.begin() + j--);
-                }
-            }
-            else if (ifree.height() == jfree.height() && ifree.y() == jfree.y())
-            {
-                if (ifree.x() == jfree.x() + jfree.width())
-                {
-                    ifree.setLeft(ifree.left() - jfree.width());
-                    ifree.setWidth(ifree.width() + jfree.width());
-                    m_free.erase(m_free.begin() + j--);
-                }
-                else if (ifree.x() + ifree.width() == jfree.x())
-                {
-                    ifree.setWidth(ifree.width() + jfree.width());
-                    m_free.erase(m_free.begin() + j--);
-                }
-            }
-        }
+        glDebug(m_pixelBuffer->release());
     }
 }
@@ -21,11 +21,13 @@
 
 // Cranberry headers
 #include <Cranberry/Graphics/Base/TextureBase.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/OpenGL/OpenGLShader.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
@@ -52,7 +54,10 @@ TextureBase::TextureBase()
     , m_texture(nullptr)
     , m_vertexBuffer(nullptr)
     , m_indexBuffer(nullptr)
+    , m_program(nullptr)
+    , m_variantBase(nullptr)
     , m_update(false)
+    , m_variantDirty(true)
 {
 }
 
@@ -69,6 +74,18 @@ QOpenGLTexture* TextureBase::texture() const
 }
 
 
+BlendModes TextureBase::blendMode() const
+{
+    return m_blendMode;
+}
+
+
+Effect TextureBase::effect() const
+{
+    return m_effect;
+}
+
+
 void TextureBase::setSourceRectangle(const QRectF& rc)
 {
     setSourceRectangle(rc.x(), rc.y(), rc.width(), rc.height());
@@ -77,27 +94,26 @@ void TextureBase::setSourceRectangle(const QRectF& rc)
 
 void TextureBase::setSourceRectangle(qreal x, qreal y, qreal w, qreal h)
 {
-    float texW = width();
-    float texH = height();
-    float dstW = w;
-    float dstH = h;
-    float uvcX = x / texW;
-    float uvcY = y / texH;
-    float uvcW = uvcX + (dstW / texW);
-    float uvcH = uvcY + (dstH / texH);
-
-    m_vertices.at(0).xyz(0.f,  0.f,  0.f);
-    m_vertices.at(1).xyz(dstW, 0.f,  0.f);
-    m_vertices.at(2).xyz(dstW, dstH, 0.f);
-    m_vertices.at(3).xyz(0.f,  dstH, 0.f);
+    const QRectF rc(x, y, w, h);
+    if (rc == m_sourceRect && !m_vertexRect.isNull())
+    {
+        return;
+    }
 
-    m_vertices.at(0).uv(uvcX, uvcY);
-    m_vertices.at(1).uv(uvcW, uvcY);
-    m_vertices.at(2).uv(uvcW, uvcH);
-    m_vertices.at(3).uv(uvcX, uvcH);
+    m_sourceRect = rc;
+    markDirty();
 
-    m_sourceRect = QRectF(x, y, w, h);
-    m_update = true;
+    // A region of the same size only moves the texture coordinates, which
+    // the vertex shader offsets; the vertex buffer stays untouched.
+    if (rc.size() == m_vertexRect.size())
+    {
+        m_uvOffset.setX((x - m_vertexRect.x()) / width());
+        m_uvOffset.setY((y - m_vertexRect.y()) / height());
+    }
+    else
+    {
+        writeSourceRectangle();
+    }
 }
 
 
@@ -120,25 +136,38 @@ void TextureBase::setBlendColor(
     m_vertices.at(3).rgba(bl);
 
     m_update = true;
+    markDirty();
 }
 
 
 void TextureBase::setBlendMode(BlendModes modes)
 {
-    m_blendMode = modes;
+    if (modes != m_blendMode)
+    {
+        m_blendMode = modes;
+        m_variantDirty = true;
+        markDirty();
+    }
 }
 
 
 void TextureBase::setEffect(Effect effect)
 {
-    m_effect = effect;
+    if (effect != m_effect)
+    {
+        m_effect = effect;
+        m_variantDirty = true;
+        markDirty();
+    }
 }
 
 
 bool TextureBase::initializeData()
 {
     setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.texture"));
+    m_variantDirty = true;
     setSize(m_texture->width(), m_texture->height());
+    m_vertexRect = QRectF();
     setSourceRectangle(0.0f, 0.0f, width(), height());
     setOrigin(width() / 2.0f, height() / 2.0f);
     setBlendColor(QColor(Qt::white));
@@ -147,6 +176,12 @@ bool TextureBase::initializeData()
 }
 
 
+uint TextureBase::textureId() const
+{
+    return (m_texture != nullptr) ? m_texture->textureId() : 0;
+}
+
+
 bool TextureBase::isNull() const
 {
     return RenderBase::isNull()        ||
@@ -169,7 +204,7 @@ bool TextureBase::create(const QString& img, Window* renderTarget)
     {
         return false;
     }
-    else if (!createTexture(QImage(img)))
+    else if (!createTexture(img))
     {
         return false;
     }
@@ -199,11 +234,17 @@ void TextureBase::destroy()
 {
     delete m_vertexBuffer;
     delete m_indexBuffer;
-    delete m_texture;
+
+    if (!TextureCache::instance()->release(m_texture))
+    {
+        delete m_texture;
+    }
 
     m_vertexBuffer = nullptr;
     m_indexBuffer = nullptr;
     m_texture = nullptr;
+    m_program = nullptr;
+    m_variantBase = nullptr;
 
     RenderBase::destroy();
 }
@@ -217,11 +258,15 @@ void TextureBase::update(const GameTime& time)
 
 void TextureBase::render()
 {
+    cranProfile("TextureBase::render");
+
     if (!prepareRendering())
     {
         return;
     }
 
+    m_program = selectProgram();
+
     bindObjects();
     writeVertices();
     modifyProgram();
@@ -246,6 +291,7 @@ QOpenGLBuffer* TextureBase::buffer() const
 void TextureBase::requestUpdate()
 {
     m_update = true;
+    markDirty();
 }
 
 
@@ -339,22 +385,35 @@ bool TextureBase::createBuffers()
 }
 
 
-bool TextureBase::createTexture(const QImage& img)
+bool TextureBase::createTexture(const QString& path)
 {
-    m_texture = new QOpenGLTexture(img);
-    if (!m_texture->isCreated() || img.isNull())
+    // Textures with other options than the default ones are cached apart.
+    m_texture = TextureCache::instance()->acquire(path, textureOptions());
+    if (m_texture == nullptr)
     {
         return cranError(ERRARG(e_03));
     }
 
-    m_texture->setMinificationFilter(QOpenGLTexture::Linear);
-    m_texture->setMagnificationFilter(QOpenGLTexture::Linear);
-    m_texture->setWrapMode(QOpenGLTexture::ClampToEdge);
-
     return true;
 }
 
 
+OpenGLShader* TextureBase::selectProgram()
+{
+    // Default programs are swapped for the variant that matches the blend
+    // mode and effect; custom programs are returned unchanged.
+    OpenGLShader* program = shaderProgram();
+    if (program != m_variantBase || m_variantDirty)
+    {
+        m_variantBase = program;
+        m_program = OpenGLDefaultShaders::getVariant(program, m_blendMode, m_effect);
+        m_variantDirty = false;
+    }
+
+    return m_program;
+}
+
+
 void TextureBase::bindObjects()
 {
     // Binds the texture to unit 0.
@@ -364,7 +423,7 @@ void TextureBase::bindObjects()
 
     glDebug(m_vertexBuffer->bind());
     glDebug(m_indexBuffer->bind());
-    glDebug(shaderProgram()->bind());
+    glDebug(m_program->bind());
 }
 
 
@@ -373,12 +432,18 @@ void TextureBase::releaseObjects()
     glDebug(m_texture->release());
     glDebug(m_vertexBuffer->release());
     glDebug(m_indexBuffer->release());
-    glDebug(shaderProgram()->release());
+    glDebug(m_program->release());
 }
 
 
 void TextureBase::writeVertices()
 {
+    // Custom shaders without u_uvOffset need the region in the vertices.
+    if (m_sourceRect != m_vertexRect && !m_program->hasUvOffset())
+    {
+        writeSourceRectangle();
+    }
+
     // Only update data if update occured.
     if (m_update)
     {
@@ -393,9 +458,36 @@ void TextureBase::writeVertices()
 }
 
 
+void TextureBase::writeSourceRectangle()
+{
+    float texW = width();
+    float texH = height();
+    float dstW = m_sourceRect.width();
+    float dstH = m_sourceRect.height();
+    float uvcX = m_sourceRect.x() / texW;
+    float uvcY = m_sourceRect.y() / texH;
+    float uvcW = uvcX + (dstW / texW);
+    float uvcH = uvcY + (dstH / texH);
+
+    m_vertices.at(0).xyz(0.f,  0.f,  0.f);
+    m_vertices.at(1).xyz(dstW, 0.f,  0.f);
+    m_vertices.at(2).xyz(dstW, dstH, 0.f);
+    m_vertices.at(3).xyz(0.f,  dstH, 0.f);
+
+    m_vertices.at(0).uv(uvcX, uvcY);
+    m_vertices.at(1).uv(uvcW, uvcY);
+    m_vertices.at(2).uv(uvcW, uvcH);
+    m_vertices.at(3).uv(uvcX, uvcH);
+
+    m_vertexRect = m_sourceRect;
+    m_uvOffset = QPointF();
+    m_update = true;
+}
+
+
 void TextureBase::modifyProgram()
 {
-    OpenGLShader* program = shaderProgram();
+    OpenGLShader* program = m_program;
 
     glDebug(program->setSampler(GL_TEXTURE0));
     glDebug(program->setMvpMatrix(matrix(this)));
@@ -404,6 +496,7 @@ void TextureBase::modifyProgram()
     glDebug(program->setEffect(m_effect));
     glDebug(program->setWindowSize(renderTarget()->size()));
     glDebug(program->setSourceRect(m_sourceRect));
+    glDebug(program->setUvOffset(m_uvOffset));
 }
 
 
@@ -452,3 +545,10 @@ void TextureBase::drawElements()
                 priv::TextureVertex::xyzOffset()
                 ));
 }
+
+
+TextureCache::Options TextureBase::textureOptions() const
+{
+    // Linear filtering, clamped to edge; the shared default options.
+    return TextureCache::Options();
+}
@@ -0,0 +1,327 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
+
+// Qt headers
+#include <QFileInfo>
+#include <QImage>
+#include <QOpenGLContext>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "TextureCache: Image %0 could not be loaded.")
+CRANBERRY_CONST_VAR(QString, e_02, "TextureCache: Texture could not be created.")
+CRANBERRY_CONST_VAR(qint64, c_defaultBudget, 256 * 1024 * 1024)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////
+    /// Appends the options to a path or image key.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QString optionsKey(const QString& base, const TextureCache::Options& options)
+    {
+        return QString("%0|%1|%2|%3")
+                .arg(base)
+                .arg(static_cast<int>(options.filter))
+                .arg(static_cast<int>(options.wrapMode))
+                .arg(options.mipmaps ? 1 : 0);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Different spellings of the same file share one key.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QString pathKey(const QString& path, const TextureCache::Options& options)
+    {
+        QFileInfo info(path);
+        QString canonical = info.canonicalFilePath();
+        if (canonical.isEmpty())
+        {
+            canonical = info.absoluteFilePath();
+        }
+
+        return optionsKey(canonical, options);
+    }
+}
+
+
+TextureCache::TextureCache()
+    : m_stats({ 0, 0, 0, 0, 0, 0 })
+    , m_budget(c_defaultBudget)
+{
+}
+
+
+TextureCache::~TextureCache()
+{
+    if (QOpenGLContext::currentContext() != nullptr)
+    {
+        clear();
+    }
+}
+
+
+TextureCache* TextureCache::instance()
+{
+    static TextureCache cache;
+    return &cache;
+}
+
+
+QOpenGLTexture* TextureCache::acquire(const QString& path, const Options& options)
+{
+    const QString key = pathKey(path, options);
+    if (QOpenGLTexture* texture = lookup(key))
+    {
+        return texture;
+    }
+
+    cranProfile("TextureCache::load");
+
+    QImage img(path);
+    if (img.isNull())
+    {
+        cranError(e_01.arg(path));
+        return nullptr;
+    }
+
+    return insert(key, upload(img, options), options, true);
+}
+
+
+QOpenGLTexture* TextureCache::acquire(const QImage& img, const Options& options)
+{
+    if (img.isNull())
+    {
+        return nullptr;
+    }
+
+    const QString key = optionsKey(QString("image:%0").arg(img.cacheKey()), options);
+    if (QOpenGLTexture* texture = lookup(key))
+    {
+        return texture;
+    }
+
+    return insert(key, upload(img, options), options, false);
+}
+
+
+QOpenGLTexture* TextureCache::adopt(
+        const QString& path,
+        QOpenGLTexture* texture,
+        const Options& options
+        )
+{
+    const QString key = pathKey(path, options);
+    if (QOpenGLTexture* existing = lookup(key))
+    {
+        delete texture;
+        return existing;
+    }
+
+    return insert(key, texture, options, true);
+}
+
+
+QOpenGLTexture* TextureCache::upload(const QImage& img, const Options& options)
+{
+    cranProfile("TextureCache::upload");
+
+    QOpenGLTexture* texture = new QOpenGLTexture(
+            img,
+            options.mipmaps ? QOpenGLTexture::GenerateMipMaps
+                            : QOpenGLTexture::DontGenerateMipMaps
+            );
+
+    if (!texture->isCreated())
+    {
+        delete texture;
+        return nullptr;
+    }
+
+    QOpenGLTexture::Filter minFilter = options.filter;
+    if (options.mipmaps)
+    {
+        minFilter = (options.filter == QOpenGLTexture::Nearest)
+                ? QOpenGLTexture::NearestMipMapNearest
+                : QOpenGLTexture::LinearMipMapLinear;
+    }
+
+    texture->setMinMagFilters(minFilter, options.filter);
+    texture->setWrapMode(options.wrapMode);
+
+    return texture;
+}
+
+
+bool TextureCache::release(QOpenGLTexture* texture)
+{
+    Entry* entry = m_textures.value(texture, nullptr);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    if (--entry->refs > 0)
+    {
+        return true;
+    }
+
+    m_stats.referencedCount--;
+
+    // Images can not be loaded again once their data is gone.
+    if (!entry->persistent)
+    {
+        evict(entry);
+    }
+    else
+    {
+        m_unused.append(entry);
+        enforceBudget();
+    }
+
+    return true;
+}
+
+
+bool TextureCache::contains(QOpenGLTexture* texture) const
+{
+    return m_textures.contains(texture);
+}
+
+
+qint64 TextureCache::budget() const
+{
+    return m_budget;
+}
+
+
+void TextureCache::setBudget(qint64 bytes)
+{
+    m_budget = bytes;
+    enforceBudget();
+}
+
+
+TextureCache::Statistics TextureCache::statistics() const
+{
+    return m_stats;
+}
+
+
+void TextureCache::clear()
+{
+    while (!m_unused.isEmpty())
+    {
+        evict(m_unused.first());
+    }
+}
+
+
+QOpenGLTexture* TextureCache::lookup(const QString& key)
+{
+    Entry* entry = m_entries.value(key, nullptr);
+    if (entry == nullptr)
+    {
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    if (entry->refs++ == 0)
+    {
+        m_unused.removeOne(entry);
+        m_stats.referencedCount++;
+    }
+
+    m_stats.hits++;
+    return entry->texture;
+}
+
+
+QOpenGLTexture* TextureCache::insert(
+        const QString& key,
+        QOpenGLTexture* texture,
+        const Options& options,
+        bool persistent
+        )
+{
+    if (texture == nullptr)
+    {
+        cranError(e_02);
+        return nullptr;
+    }
+
+    // Mipmaps add another third of the base level.
+    qint64 bytes = qint64(texture->width()) * texture->height() * 4;
+    if (options.mipmaps)
+    {
+        bytes += bytes / 3;
+    }
+
+    Entry* entry = new Entry;
+    entry->key = key;
+    entry->texture = texture;
+    entry->bytes = bytes;
+    entry->refs = 1;
+    entry->persistent = persistent;
+
+    m_entries.insert(key, entry);
+    m_textures.insert(texture, entry);
+    m_stats.residentBytes += bytes;
+    m_stats.residentCount++;
+    m_stats.referencedCount++;
+
+    enforceBudget();
+
+    return texture;
+}
+
+
+void TextureCache::evict(Entry* entry)
+{
+    m_unused.removeOne(entry);
+    m_entries.remove(entry->key);
+    m_textures.remove(entry->texture);
+
+    m_stats.residentBytes -= entry->bytes;
+    m_stats.residentCount--;
+    m_stats.evictions++;
+
+    delete entry->texture;
+    delete entry;
+}
+
+
+void TextureCache::enforceBudget()
+{
+    while (m_stats.residentBytes > m_budget && !m_unused.isEmpty())
+    {
+        evict(m_unused.first());
+    }
+}
@@ -58,6 +58,7 @@ TransformBase::TransformBase()
     , m_isScalingX(false)
     , m_isScalingY(false)
     , m_isFading(false)
+    , m_isThreadSafe(false)
     , m_speedMoveX(50.f)
     , m_speedMoveY(50.f)
     , m_speedRotateX(50.f)
@@ -120,6 +121,12 @@ bool TransformBase::isFading() const
 }
 
 
+bool TransformBase::isThreadSafe() const
+{
+    return m_isThreadSafe;
+}
+
+
 float TransformBase::x() const
 {
     return m_x;
@@ -434,6 +441,12 @@ void TransformBase::setOpacity(float opacity)
 }
 
 
+void TransformBase::setThreadSafe(bool threadSafe)
+{
+    m_isThreadSafe = threadSafe;
+}
+
+
 void TransformBase::setPosition(float x, float y)
 {
     m_x = x;
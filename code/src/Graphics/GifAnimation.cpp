@@ -35,6 +35,36 @@ CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Frame %2 could not be read.")
 CRANBERRY_USING_NAMESPACE
 
 
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////
+    /// Reads all frames and their durations.
+    ///
+    /// \returns the index of the frame that could not be read; -1 on success.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int readFrames(const QString& path, QVector<QImage>& frames, QVector<qreal>& durations)
+    {
+        QImageReader reader(path);
+        QImage outputImage;
+        qint32 imgCount = reader.imageCount();
+
+        for (qint32 i = 0; i < imgCount; i++)
+        {
+            if (!reader.read(&outputImage))
+            {
+                return i;
+            }
+
+            frames.append(outputImage);
+            durations.append(reader.nextImageDelay());
+        }
+
+        return -1;
+    }
+}
+
+
 bool GifAnimation::create(const QString& path, Window* renderTarget)
 {
     QVector<QImage> frames;
@@ -48,20 +78,26 @@ bool GifAnimation::create(const QString& path, Window* renderTarget)
     }
 
     // Reads each image and their durations.
-    QImageReader reader(path);
-    QImage outputImage;
-    qint32 imgCount = reader.imageCount();
-
-    for (qint32 i = 0; i < imgCount; i++)
+    qint32 failed = readFrames(path, frames, durations);
+    if (failed != -1)
     {
-        if (!reader.read(&outputImage))
-        {
-            return cranError(ERRARG_1(e_02, QString::number(i)));
-        }
-
-        frames.append(outputImage);
-        durations.append(reader.nextImageDelay());
+        return cranError(ERRARG_1(e_02, QString::number(failed)));
     }
 
     return createInternal(frames, durations, renderTarget);
 }
+
+
+bool GifAnimation::createAsync(const QString& path, Window* renderTarget)
+{
+    QFileInfo info(path);
+    if (!info.exists())
+    {
+        return cranError(ERRARG_1(e_01, path));
+    }
+
+    return createInternalAsync([path] (QVector<QImage>& frames, QVector<qreal>& durations)
+    {
+        return readFrames(path, frames, durations) == -1;
+    }, renderTarget);
+}
@@ -0,0 +1,355 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/GlyphAtlas.hpp>
+#include <Cranberry/Graphics/GlyphBatch.hpp>
+#include <Cranberry/Graphics/GlyphText.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/OpenGL/OpenGLShader.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/Window.hpp>
+
+// Qt headers
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Vertex buffer creation failed.")
+CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Index buffer creation failed.")
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+GlyphBatch::GlyphBatch()
+    : RenderBase()
+    , m_vertexBuffer(nullptr)
+    , m_indexBuffer(nullptr)
+    , m_indexQuads(0)
+    , m_outlineWidth(0.0f)
+    , m_blurFactor(0.0f)
+{
+}
+
+
+GlyphBatch::~GlyphBatch()
+{
+    destroy();
+}
+
+
+float GlyphBatch::outlineWidth() const
+{
+    return m_outlineWidth;
+}
+
+
+float GlyphBatch::blurFactor() const
+{
+    return m_blurFactor;
+}
+
+
+const QVector<GlyphText*>& GlyphBatch::texts() const
+{
+    return m_texts;
+}
+
+
+void GlyphBatch::setOutlineWidth(float width)
+{
+    m_outlineWidth = qBound(0.0f, width, float(GlyphAtlas::spread()));
+}
+
+
+void GlyphBatch::setBlurFactor(float factor)
+{
+    m_blurFactor = qBound(0.0f, factor, float(GlyphAtlas::spread()));
+}
+
+
+void GlyphBatch::addText(GlyphText* text)
+{
+    if (text != nullptr && !m_texts.contains(text))
+    {
+        m_texts.append(text);
+    }
+}
+
+
+void GlyphBatch::removeText(GlyphText* text)
+{
+    m_texts.removeOne(text);
+}
+
+
+void GlyphBatch::clear()
+{
+    m_texts.clear();
+}
+
+
+bool GlyphBatch::isNull() const
+{
+    return RenderBase::isNull()        ||
+           m_vertexBuffer == nullptr   ||
+           m_indexBuffer == nullptr    ||
+          !m_vertexBuffer->isCreated() ||
+          !m_indexBuffer->isCreated();
+}
+
+
+bool GlyphBatch::create(Window* renderTarget)
+{
+    if (!RenderBase::create(renderTarget))
+    {
+        return false;
+    }
+
+    m_vertexBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    if (!m_vertexBuffer->create())
+    {
+        return cranError(ERRARG(e_01));
+    }
+
+    m_indexBuffer = new QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
+    if (!m_indexBuffer->create())
+    {
+        return cranError(ERRARG(e_02));
+    }
+
+    m_vertexBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_indexBuffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_indexQuads = 0;
+
+    setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.sdftext"));
+
+    return true;
+}
+
+
+void GlyphBatch::destroy()
+{
+    delete m_vertexBuffer;
+    delete m_indexBuffer;
+
+    m_vertexBuffer = nullptr;
+    m_indexBuffer = nullptr;
+    m_indexQuads = 0;
+
+    RenderBase::destroy();
+}
+
+
+void GlyphBatch::update(const GameTime& time)
+{
+    updateTransform(time);
+
+    JobSystem::instance()->updateObjects(m_texts, time);
+
+    // Texts are laid out while rendering and carry no revision of their own;
+    // containers must therefore redraw this batch every frame.
+    markDirty();
+}
+
+
+void GlyphBatch::render()
+{
+    cranProfile("GlyphBatch::render");
+
+    if (!prepareRendering())
+    {
+        return;
+    }
+
+    if (!writeVertices())
+    {
+        return;
+    }
+
+    modifyProgram();
+    modifyAttribs();
+    drawPages();
+    releaseObjects();
+}
+
+
+bool GlyphBatch::writeVertices()
+{
+    // Collects the quads of all texts, grouped by atlas page, and copies the
+    // groups one after another into a single buffer.
+    for (priv::GlyphVertices& page : m_pages)
+    {
+        page.clear();
+    }
+
+    for (GlyphText* text : m_texts)
+    {
+        text->appendQuads(m_pages);
+    }
+
+    m_vertices.clear();
+    m_pageOffsets.resize(m_pages.size() + 1);
+    for (int i = 0; i < m_pages.size(); i++)
+    {
+        m_pageOffsets[i] = static_cast<int>(m_vertices.size() / 4);
+        m_vertices.insert(m_vertices.end(), m_pages.at(i).begin(), m_pages.at(i).end());
+    }
+
+    const int quads = static_cast<int>(m_vertices.size() / 4);
+    m_pageOffsets[m_pages.size()] = quads;
+    if (quads == 0)
+    {
+        return false;
+    }
+
+    // Indices are the same for every frame; they only grow.
+    glDebug(m_indexBuffer->bind());
+    if (quads > m_indexQuads)
+    {
+        m_indexQuads = qMax(quads, m_indexQuads * 2);
+
+        QVector<uint> indices(m_indexQuads * 6);
+        for (int i = 0; i < m_indexQuads; i++)
+        {
+            indices[i * 6 + 0] = i * 4 + 0;
+            indices[i * 6 + 1] = i * 4 + 1;
+            indices[i * 6 + 2] = i * 4 + 2;
+            indices[i * 6 + 3] = i * 4 + 2;
+            indices[i * 6 + 4] = i * 4 + 3;
+            indices[i * 6 + 5] = i * 4 + 0;
+        }
+
+        glDebug(m_indexBuffer->allocate(indices.constData(), indices.size() * sizeof(uint)));
+    }
+
+    // Re-allocating orphans the storage of the last frame, so the driver
+    // does not need to wait for the GPU to finish reading it.
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_vertexBuffer->allocate(
+                m_vertices.data(),
+                static_cast<int>(m_vertices.size() * priv::GlyphVertex::size())
+                ));
+
+    return true;
+}
+
+
+void GlyphBatch::modifyProgram()
+{
+    OpenGLShader* program = shaderProgram();
+
+    glDebug(program->bind());
+    glDebug(program->setSampler(GL_TEXTURE0));
+    glDebug(program->setMvpMatrix(matrix(this)));
+    glDebug(program->setOpacity(opacity()));
+    glDebug(program->program()->setUniformValue("u_outlineWidth", m_outlineWidth));
+    glDebug(program->program()->setUniformValue("u_blurFactor", m_blurFactor));
+    glDebug(program->program()->setUniformValue(
+                "u_distanceScale", 1.0f / (2.0f * GlyphAtlas::spread())));
+}
+
+
+void GlyphBatch::modifyAttribs()
+{
+    glDebug(gl->glEnableVertexAttribArray(priv::GlyphVertex::xyAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::GlyphVertex::uvAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::GlyphVertex::rgbaAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::GlyphVertex::outlineAttrib()));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::GlyphVertex::xyAttrib(),
+                priv::GlyphVertex::xyLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::GlyphVertex::size(),
+                priv::GlyphVertex::xyOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::GlyphVertex::uvAttrib(),
+                priv::GlyphVertex::uvLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::GlyphVertex::size(),
+                priv::GlyphVertex::uvOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::GlyphVertex::rgbaAttrib(),
+                priv::GlyphVertex::rgbaLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::GlyphVertex::size(),
+                priv::GlyphVertex::rgbaOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::GlyphVertex::outlineAttrib(),
+                priv::GlyphVertex::outlineLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::GlyphVertex::size(),
+                priv::GlyphVertex::outlineOffset()
+                ));
+}
+
+
+void GlyphBatch::drawPages()
+{
+    GlyphAtlas* atlas = GlyphAtlas::instance();
+    glDebug(gl->glActiveTexture(GL_TEXTURE0));
+
+    // One draw call per atlas page; usually all glyphs fit in one page.
+    for (int i = 0; i < m_pages.size(); i++)
+    {
+        const int first = m_pageOffsets.at(i);
+        const int count = m_pageOffsets.at(i + 1) - first;
+        if (count == 0 || !atlas->bindPage(i))
+        {
+            continue;
+        }
+
+        glDebug(gl->glDrawElements(
+                    GL_TRIANGLES,
+                    count * 6,
+                    GL_UNSIGNED_INT,
+                    reinterpret_cast<void*>(first * 6 * sizeof(uint))
+                    ));
+
+        atlas->releasePage(i);
+    }
+}
+
+
+void GlyphBatch::releaseObjects()
+{
+    // The outline attribute is not used by any other shader.
+    glDebug(gl->glDisableVertexAttribArray(priv::GlyphVertex::outlineAttrib()));
+    glDebug(m_vertexBuffer->release());
+    glDebug(m_indexBuffer->release());
+    glDebug(shaderProgram()->release());
+}
@@ -0,0 +1,215 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/GlyphAtlas.hpp>
+#include <Cranberry/Graphics/GlyphText.hpp>
+
+// Qt headers
+#include <QFontInfo>
+#include <QMatrix4x4>
+#include <QStringList>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+GlyphText::GlyphText()
+    : TransformBase()
+    , m_color(Qt::white)
+    , m_outlineColor(Qt::black)
+    , m_layoutUpdate(false)
+{
+}
+
+
+const QString& GlyphText::text() const
+{
+    return m_text;
+}
+
+
+const QFont& GlyphText::font() const
+{
+    return m_font;
+}
+
+
+const QColor& GlyphText::color() const
+{
+    return m_color;
+}
+
+
+const QColor& GlyphText::outlineColor() const
+{
+    return m_outlineColor;
+}
+
+
+void GlyphText::setText(const QString& text)
+{
+    if (m_text != text)
+    {
+        m_text = text;
+        m_layoutUpdate = true;
+    }
+}
+
+
+void GlyphText::setFont(const QFont& font)
+{
+    if (m_font != font)
+    {
+        m_font = font;
+        m_layoutUpdate = true;
+    }
+}
+
+
+void GlyphText::setColor(const QColor& color)
+{
+    m_color = color;
+}
+
+
+void GlyphText::setOutlineColor(const QColor& color)
+{
+    m_outlineColor = color;
+}
+
+
+void GlyphText::update(const GameTime& time)
+{
+    updateTransform(time);
+}
+
+
+void GlyphText::appendQuads(QVector<priv::GlyphVertices>& pages)
+{
+    if (m_layoutUpdate)
+    {
+        layout();
+        m_layoutUpdate = false;
+    }
+
+    if (m_glyphs.isEmpty() || opacity() <= 0.0f)
+    {
+        return;
+    }
+
+    // Same transformation as TransformBase::matrix(), minus the projection
+    // which is applied by the batch.
+    QMatrix4x4 model, rot, orig, norig;
+    rot.rotate(angleX(), 1.f, 0.f, 0.f);
+    rot.rotate(angleY(), 0.f, 1.f, 0.f);
+    rot.rotate(angleZ(), 0.f, 0.f, 1.f);
+    orig.translate(origin().x(), origin().y());
+    norig.translate(-origin().x(), -origin().y());
+    model.translate(x(), y());
+    model = model * orig * rot * norig * orig;
+    model.scale(scaleX(), scaleY());
+    model = model * norig;
+
+    QColor fill(m_color);
+    QColor outline(m_outlineColor);
+    fill.setAlphaF(fill.alphaF() * opacity());
+    outline.setAlphaF(outline.alphaF() * opacity());
+
+    priv::GlyphVertex v;
+    v.rgba(fill);
+    v.outline(outline);
+
+    for (const LayoutGlyph& g : m_glyphs)
+    {
+        if (g.page >= pages.size())
+        {
+            pages.resize(g.page + 1);
+        }
+
+        priv::GlyphVertices& dst = pages[g.page];
+        const QPointF tl = model.map(g.rect.topLeft());
+        const QPointF tr = model.map(g.rect.topRight());
+        const QPointF br = model.map(g.rect.bottomRight());
+        const QPointF bl = model.map(g.rect.bottomLeft());
+
+        v.xy(tl.x(), tl.y()); v.uv(g.uv.left(), g.uv.top());     dst.push_back(v);
+        v.xy(tr.x(), tr.y()); v.uv(g.uv.right(), g.uv.top());    dst.push_back(v);
+        v.xy(br.x(), br.y()); v.uv(g.uv.right(), g.uv.bottom()); dst.push_back(v);
+        v.xy(bl.x(), bl.y()); v.uv(g.uv.left(), g.uv.bottom());  dst.push_back(v);
+    }
+}
+
+
+void GlyphText::layout()
+{
+    GlyphAtlas* atlas = GlyphAtlas::instance();
+    const int id = atlas->fontId(m_font);
+    const QRawFont raw = atlas->rawFont(id);
+
+    m_glyphs.clear();
+    if (!raw.isValid())
+    {
+        setSize(0, 0);
+        return;
+    }
+
+    // Glyphs and advances are stored at the base size and scaled down (or
+    // up) to the pixel size of the font.
+    const qreal scale = QFontInfo(m_font).pixelSize() / qreal(GlyphAtlas::baseSize());
+    const qreal ascent = raw.ascent() * scale;
+    const qreal lineHeight = (raw.ascent() + raw.descent() + raw.leading()) * scale;
+    const QStringList lines = m_text.split('\n');
+
+    qreal width = 0;
+    qreal baseline = ascent;
+
+    for (const QString& line : lines)
+    {
+        const QVector<quint32> indexes = raw.glyphIndexesForString(line);
+        const QVector<QPointF> advances = raw.advancesForGlyphIndexes(
+                    indexes, QRawFont::KernedAdvances);
+
+        qreal pen = 0;
+        for (int i = 0; i < indexes.size(); i++)
+        {
+            const GlyphAtlas::Glyph g = atlas->glyph(id, indexes.at(i));
+            if (g.page != -1)
+            {
+                LayoutGlyph lg;
+                lg.rect = QRectF(pen + g.bounds.x() * scale,
+                                 baseline + g.bounds.y() * scale,
+                                 g.bounds.width() * scale,
+                                 g.bounds.height() * scale);
+                lg.uv = g.uv;
+                lg.page = g.page;
+                m_glyphs.append(lg);
+            }
+
+            pen += advances.at(i).x() * scale;
+        }
+
+        width = qMax(width, pen);
+        baseline += lineHeight;
+    }
+
+    setSize(width, lineHeight * lines.size());
+}
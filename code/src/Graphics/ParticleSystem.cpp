@@ -0,0 +1,552 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/ParticleSystem.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/GameTime.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/Window.hpp>
+
+// Qt headers
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QtMath>
+
+// Standard headers
+#include <algorithm>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Instance buffer creation failed.")
+CRANBERRY_CONST_VAR(int, c_defaultCapacity, 10000)
+CRANBERRY_CONST_VAR(int, c_curveSize, 64)
+CRANBERRY_CONST_VAR(int, c_stride, 8)
+CRANBERRY_CONST_VAR(int, c_randoms, 6)
+CRANBERRY_CONST_VAR(int, c_chunkSize, 8192)
+CRANBERRY_CONST_VAR(uint, c_instAttrib, 3)
+CRANBERRY_CONST_VAR(uint, c_colorAttrib, 4)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+ParticleSystem::Emitter::Emitter()
+    : rate(100.0f)
+    , burst(100)
+    , minLife(1.0f)
+    , maxLife(1.0f)
+    , minSpeed(50.0f)
+    , maxSpeed(100.0f)
+    , direction(0.0f)
+    , spread(180.0f)
+    , minSpin(0.0f)
+    , maxSpin(0.0f)
+{
+}
+
+
+ParticleSystem::ParticleSystem()
+    : TextureBase()
+    , m_instanceBuffer(nullptr)
+    , egl(nullptr)
+    , m_capacity(0)
+    , m_count(0)
+    , m_drawCount(0)
+    , m_emitting(true)
+    , m_additive(false)
+{
+    setCapacity(c_defaultCapacity);
+    setBlendMode(BlendMultiply);
+}
+
+
+ParticleSystem::~ParticleSystem()
+{
+    destroy();
+}
+
+
+int ParticleSystem::capacity() const
+{
+    return m_capacity;
+}
+
+
+int ParticleSystem::count() const
+{
+    return m_count;
+}
+
+
+int ParticleSystem::emitterCount() const
+{
+    return m_emitters.size();
+}
+
+
+const ParticleSystem::Emitter& ParticleSystem::emitter(int index) const
+{
+    return m_emitters.at(index);
+}
+
+
+bool ParticleSystem::isEmitting() const
+{
+    return m_emitting;
+}
+
+
+bool ParticleSystem::isAdditive() const
+{
+    return m_additive;
+}
+
+
+void ParticleSystem::setCapacity(int capacity)
+{
+    m_capacity = qMax(0, capacity);
+    m_count = qMin(m_count, m_capacity);
+    m_drawCount = qMin(m_drawCount, m_capacity);
+
+    const size_t size = static_cast<size_t>(m_capacity);
+    m_particles.x.resize(size);
+    m_particles.y.resize(size);
+    m_particles.vx.resize(size);
+    m_particles.vy.resize(size);
+    m_particles.ax.resize(size);
+    m_particles.ay.resize(size);
+    m_particles.angle.resize(size);
+    m_particles.spin.resize(size);
+    m_particles.age.resize(size);
+    m_particles.rcp.resize(size);
+    m_particles.curve.resize(size);
+    m_instances.resize(size * c_stride);
+}
+
+
+void ParticleSystem::setEmitting(bool emitting)
+{
+    m_emitting = emitting;
+}
+
+
+void ParticleSystem::setAdditive(bool additive)
+{
+    if (additive != m_additive)
+    {
+        m_additive = additive;
+        markDirty();
+    }
+}
+
+
+int ParticleSystem::addEmitter(const Emitter& emitter)
+{
+    m_emitters.append(emitter);
+    m_pending.append(0.0f);
+    sampleCurves(m_emitters.size() - 1);
+
+    return m_emitters.size() - 1;
+}
+
+
+void ParticleSystem::setEmitter(int index, const Emitter& emitter)
+{
+    m_emitters[index] = emitter;
+    sampleCurves(index);
+}
+
+
+void ParticleSystem::clearEmitters()
+{
+    m_emitters.clear();
+    m_pending.clear();
+    m_colorCurves.clear();
+    m_sizeCurves.clear();
+
+    clear();
+}
+
+
+void ParticleSystem::burst(int index)
+{
+    spawn(index, m_emitters.at(index).burst);
+}
+
+
+void ParticleSystem::burst(int index, int count)
+{
+    spawn(index, count);
+}
+
+
+void ParticleSystem::clear()
+{
+    m_count = 0;
+}
+
+
+bool ParticleSystem::isNull() const
+{
+    return TextureBase::isNull()       ||
+           m_instanceBuffer == nullptr ||
+          !m_instanceBuffer->isCreated();
+}
+
+
+void ParticleSystem::destroy()
+{
+    delete m_instanceBuffer;
+
+    m_instanceBuffer = nullptr;
+    egl = nullptr;
+    m_count = 0;
+    m_drawCount = 0;
+
+    TextureBase::destroy();
+}
+
+
+void ParticleSystem::update(const GameTime& time)
+{
+    updateTransform(time);
+
+    const float dt = static_cast<float>(time.deltaTime());
+
+    kill();
+
+    if (m_emitting)
+    {
+        for (int i = 0; i < m_emitters.size(); i++)
+        {
+            m_pending[i] += m_emitters.at(i).rate * dt;
+
+            const int count = static_cast<int>(m_pending.at(i));
+            m_pending[i] -= count;
+            spawn(i, count);
+        }
+    }
+
+    // Small systems are not worth the synchronization.
+    if (m_count > c_chunkSize)
+    {
+        const int chunks = (m_count + c_chunkSize - 1) / c_chunkSize;
+        JobSystem::instance()->parallelFor(chunks, [this, dt] (int chunk)
+        {
+            const int begin = chunk * c_chunkSize;
+            simulate(begin, qMin(begin + c_chunkSize, m_count), dt);
+        }, 1);
+    }
+    else
+    {
+        simulate(0, m_count, dt);
+    }
+
+    if (m_count > 0 || m_drawCount > 0)
+    {
+        markDirty();
+    }
+
+    m_drawCount = m_count;
+}
+
+
+void ParticleSystem::render()
+{
+    cranProfile("ParticleSystem::render");
+
+    if (m_drawCount > 0)
+    {
+        TextureBase::render();
+    }
+}
+
+
+bool ParticleSystem::initializeData()
+{
+    if (!TextureBase::initializeData())
+    {
+        return false;
+    }
+
+    m_instanceBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    if (!m_instanceBuffer->create())
+    {
+        return cranError(ERRARG(e_01));
+    }
+
+    m_instanceBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+    egl = renderTarget()->context()->extraFunctions();
+
+    // Particles are positioned relative to the system; rotating or scaling
+    // the system happens about its position.
+    setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.particle"));
+    setOrigin(0.0f, 0.0f);
+
+    return true;
+}
+
+
+void ParticleSystem::modifyAttribs()
+{
+    TextureBase::modifyAttribs();
+
+    const int stride = c_stride * sizeof(float);
+
+    // Re-allocating orphans the storage of the previous frame, so the driver
+    // does not need to wait for the GPU to finish reading it.
+    glDebug(m_instanceBuffer->bind());
+    glDebug(m_instanceBuffer->allocate(m_instances.data(), m_drawCount * stride));
+
+    glDebug(gl->glEnableVertexAttribArray(c_instAttrib));
+    glDebug(gl->glEnableVertexAttribArray(c_colorAttrib));
+
+    glDebug(gl->glVertexAttribPointer(
+                c_instAttrib,
+                4,
+                GL_FLOAT,
+                GL_FALSE,
+                stride,
+                nullptr
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                c_colorAttrib,
+                4,
+                GL_FLOAT,
+                GL_FALSE,
+                stride,
+                reinterpret_cast<const void*>(4 * sizeof(float))
+                ));
+
+    glDebug(egl->glVertexAttribDivisor(c_instAttrib, 1));
+    glDebug(egl->glVertexAttribDivisor(c_colorAttrib, 1));
+    glDebug(m_instanceBuffer->release());
+}
+
+
+void ParticleSystem::drawElements()
+{
+    if (m_additive)
+    {
+        glDebug(gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE));
+    }
+
+    glDebug(egl->glDrawElementsInstanced(
+                GL_TRIANGLES,
+                QUADS_TO_TRIANGLES(4),
+                GL_UNSIGNED_INT,
+                nullptr,
+                m_drawCount
+                ));
+
+    if (m_additive)
+    {
+        glDebug(gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    }
+
+    // The vertex array of the window is shared by all objects.
+    glDebug(egl->glVertexAttribDivisor(c_instAttrib, 0));
+    glDebug(egl->glVertexAttribDivisor(c_colorAttrib, 0));
+    glDebug(gl->glDisableVertexAttribArray(c_instAttrib));
+    glDebug(gl->glDisableVertexAttribArray(c_colorAttrib));
+}
+
+
+void ParticleSystem::sampleCurves(int index)
+{
+    const Emitter& e = m_emitters.at(index);
+    const size_t offset = static_cast<size_t>(index) * c_curveSize;
+
+    m_colorCurves.resize(std::max(m_colorCurves.size(), (offset + c_curveSize) * 4));
+    m_sizeCurves.resize(std::max(m_sizeCurves.size(), offset + c_curveSize));
+
+    QGradientStops colors = e.colors;
+    QVector<QPointF> sizes = e.sizes;
+
+    if (colors.isEmpty()) colors.append({ 0.0, QColor(Qt::white) });
+    if (sizes.isEmpty()) sizes.append({ 0.0, 1.0 });
+
+    std::sort(colors.begin(), colors.end(), [] (const QGradientStop& a, const QGradientStop& b)
+    {
+        return a.first < b.first;
+    });
+
+    std::sort(sizes.begin(), sizes.end(), [] (const QPointF& a, const QPointF& b)
+    {
+        return a.x() < b.x();
+    });
+
+    // Samples both curves with linear interpolation; the first and last
+    // points extend to the start and end of the lifetime.
+    int c = 0;
+    int s = 0;
+    for (int i = 0; i < c_curveSize; i++)
+    {
+        const qreal t = qreal(i) / (c_curveSize - 1);
+        while (c < colors.size() - 1 && colors.at(c + 1).first <= t) c++;
+        while (s < sizes.size() - 1 && sizes.at(s + 1).x() <= t) s++;
+
+        QColor c0 = colors.at(c).second;
+        QColor c1 = colors.at(qMin(c + 1, colors.size() - 1)).second;
+        qreal cw = colors.at(qMin(c + 1, colors.size() - 1)).first - colors.at(c).first;
+        qreal ct = (cw > 0.0) ? qBound(0.0, (t - colors.at(c).first) / cw, 1.0) : 0.0;
+
+        qreal s0 = sizes.at(s).y();
+        qreal s1 = sizes.at(qMin(s + 1, sizes.size() - 1)).y();
+        qreal sw = sizes.at(qMin(s + 1, sizes.size() - 1)).x() - sizes.at(s).x();
+        qreal st = (sw > 0.0) ? qBound(0.0, (t - sizes.at(s).x()) / sw, 1.0) : 0.0;
+
+        float* color = &m_colorCurves[(offset + i) * 4];
+        color[0] = static_cast<float>(c0.redF() + (c1.redF() - c0.redF()) * ct);
+        color[1] = static_cast<float>(c0.greenF() + (c1.greenF() - c0.greenF()) * ct);
+        color[2] = static_cast<float>(c0.blueF() + (c1.blueF() - c0.blueF()) * ct);
+        color[3] = static_cast<float>(c0.alphaF() + (c1.alphaF() - c0.alphaF()) * ct);
+
+        m_sizeCurves[offset + i] = static_cast<float>(s0 + (s1 - s0) * st);
+    }
+}
+
+
+void ParticleSystem::spawn(int index, int count)
+{
+    count = qMin(count, m_capacity - m_count);
+    if (count <= 0)
+    {
+        return;
+    }
+
+    const Emitter& e = m_emitters.at(index);
+    const float life = e.maxLife - e.minLife;
+    const float speed = e.maxSpeed - e.minSpeed;
+    const float spin = e.maxSpin - e.minSpin;
+    const float areaW = static_cast<float>(e.area.width());
+    const float areaH = static_cast<float>(e.area.height());
+    const float posX = static_cast<float>(e.position.x());
+    const float posY = static_cast<float>(e.position.y());
+    const float accX = static_cast<float>(e.acceleration.x());
+    const float accY = static_cast<float>(e.acceleration.y());
+
+    // Draws all random numbers at once, which is much faster than one by one.
+    m_random.resize(static_cast<size_t>(count) * c_randoms);
+    m_rng.fill(m_random.data(), count * c_randoms);
+
+    Particles& p = m_particles;
+    const float* r = m_random.data();
+    for (int i = m_count; i < m_count + count; i++, r += c_randoms)
+    {
+        const float angle = qDegreesToRadians(e.direction + e.spread * (r[2] * 2.0f - 1.0f));
+        const float v = e.minSpeed + speed * r[1];
+
+        p.x[i] = posX + areaW * (r[3] - 0.5f);
+        p.y[i] = posY + areaH * (r[4] - 0.5f);
+        p.vx[i] = qCos(angle) * v;
+        p.vy[i] = qSin(angle) * v;
+        p.ax[i] = accX;
+        p.ay[i] = accY;
+        p.angle[i] = 0.0f;
+        p.spin[i] = qDegreesToRadians(e.minSpin + spin * r[5]);
+        p.age[i] = 0.0f;
+        p.rcp[i] = 1.0f / qMax(e.minLife + life * r[0], 0.001f);
+        p.curve[i] = index * c_curveSize;
+    }
+
+    m_count += count;
+}
+
+
+void ParticleSystem::kill()
+{
+    // Moves the last living particle into the slot of the dead one, so the
+    // arrays stay dense; the order of particles does not matter.
+    Particles& p = m_particles;
+    for (int i = 0; i < m_count;)
+    {
+        if (p.age[i] * p.rcp[i] < 1.0f)
+        {
+            i++;
+            continue;
+        }
+
+        const int last = --m_count;
+        p.x[i] = p.x[last];
+        p.y[i] = p.y[last];
+        p.vx[i] = p.vx[last];
+        p.vy[i] = p.vy[last];
+        p.ax[i] = p.ax[last];
+        p.ay[i] = p.ay[last];
+        p.angle[i] = p.angle[last];
+        p.spin[i] = p.spin[last];
+        p.age[i] = p.age[last];
+        p.rcp[i] = p.rcp[last];
+        p.curve[i] = p.curve[last];
+    }
+}
+
+
+void ParticleSystem::simulate(int begin, int end, float dt)
+{
+    float* x = m_particles.x.data();
+    float* y = m_particles.y.data();
+    float* vx = m_particles.vx.data();
+    float* vy = m_particles.vy.data();
+    float* angle = m_particles.angle.data();
+    float* age = m_particles.age.data();
+    const float* ax = m_particles.ax.data();
+    const float* ay = m_particles.ay.data();
+    const float* spin = m_particles.spin.data();
+    const float* rcp = m_particles.rcp.data();
+    const int* curve = m_particles.curve.data();
+
+    // Plain loops over separate arrays; the compiler vectorizes these.
+    for (int i = begin; i < end; i++)
+    {
+        vx[i] += ax[i] * dt;
+        vy[i] += ay[i] * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        angle[i] += spin[i] * dt;
+        age[i] += dt;
+    }
+
+    // Interleaves the data the GPU needs: x, y, scale, angle and rgba.
+    float* out = m_instances.data() + static_cast<size_t>(begin) * c_stride;
+    for (int i = begin; i < end; i++, out += c_stride)
+    {
+        const float t = qMin(age[i] * rcp[i], 1.0f);
+        const int k = curve[i] + static_cast<int>(t * (c_curveSize - 1));
+        const float* color = &m_colorCurves[static_cast<size_t>(k) * 4];
+
+        out[0] = x[i];
+        out[1] = y[i];
+        out[2] = m_sizeCurves[k];
+        out[3] = angle[i];
+        out[4] = color[0];
+        out[5] = color[1];
+        out[6] = color[2];
+        out[7] = color[3];
+    }
+}
@@ -0,0 +1,612 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/PostProcessChain.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/OpenGL/OpenGLShader.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/Window.hpp>
+
+// Qt headers
+#include <QMatrix4x4>
+#include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLTimeMonitor>
+#include <QVector2D>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Vertex buffer creation failed.")
+CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Framebuffer of size %2x%3 could not be created.")
+CRANBERRY_CONST_VAR(QString, e_03, "%0 [%1] - Pass program is null.")
+CRANBERRY_CONST_VAR(int, c_samples, 4)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////
+    /// Creates a single-sampled target whose texture is filtered linearly, so
+    /// that targets of lower resolution are scaled up smoothly.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    QOpenGLFramebufferObject* createTarget(QOpenGLFunctions* gl, const QSize& size)
+    {
+        auto* fbo = new QOpenGLFramebufferObject(size);
+        if (!fbo->isValid())
+        {
+            delete fbo;
+            return nullptr;
+        }
+
+        glDebug(gl->glBindTexture(GL_TEXTURE_2D, fbo->texture()));
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
+
+        return fbo;
+    }
+
+    int resolutionIndex(PassResolution res)
+    {
+        return (res == ResolutionFull) ? 0 : (res == ResolutionHalf) ? 1 : 2;
+    }
+}
+
+
+PostProcessChain::PostProcessChain()
+    : RenderBase()
+    , m_msScene(nullptr)
+    , m_scene(nullptr)
+    , m_targets()
+    , m_vertexBuffer(nullptr)
+    , m_monitor(nullptr)
+    , m_backColor(Qt::transparent)
+    , m_timing(false)
+    , m_noTiming(false)
+{
+}
+
+
+PostProcessChain::~PostProcessChain()
+{
+    destroy();
+}
+
+
+const QColor& PostProcessChain::backgroundColor() const
+{
+    return m_backColor;
+}
+
+
+int PostProcessChain::passCount() const
+{
+    return m_passes.size();
+}
+
+
+bool PostProcessChain::isTimingSupported() const
+{
+    return !m_noTiming;
+}
+
+
+float PostProcessChain::passTime(int index) const
+{
+    if (index < 0 || index >= m_passTimes.size())
+    {
+        return -1.0f;
+    }
+
+    return m_passTimes.at(index);
+}
+
+
+float PostProcessChain::totalTime() const
+{
+    if (m_passTimes.isEmpty())
+    {
+        return -1.0f;
+    }
+
+    float total = 0.0f;
+    for (float time : m_passTimes)
+    {
+        total += time;
+    }
+
+    return total;
+}
+
+
+void PostProcessChain::setBackgroundColor(const QColor& color)
+{
+    m_backColor = color;
+}
+
+
+bool PostProcessChain::addObject(RenderBase* object)
+{
+    if (m_objects.contains(object)) return false;
+
+    m_objects.append(object);
+    return true;
+}
+
+
+bool PostProcessChain::removeObject(RenderBase* object)
+{
+    return m_objects.removeOne(object);
+}
+
+
+int PostProcessChain::addPass(
+        OpenGLShader* program,
+        PassResolution resolution,
+        const PassSetup& setup
+        )
+{
+    if (program == nullptr)
+    {
+        cranError(ERRARG(e_03));
+        return -1;
+    }
+
+    m_passes.append({ program, setup, resolution });
+    m_passTimes.clear();
+
+    return m_passes.size() - 1;
+}
+
+
+void PostProcessChain::addBlur(float radius, PassResolution resolution)
+{
+    OpenGLShader* gauss = OpenGLDefaultShaders::get("cb.glsl.gauss");
+    int locDir = gauss->uniformLocation("u_direction");
+    int locRad = gauss->uniformLocation("u_radius");
+
+    addPass(gauss, resolution, [=] (OpenGLShader* program)
+    {
+        program->setUniformValue(locDir, 1.0f, 0.0f);
+        program->setUniformValue(locRad, radius);
+    });
+
+    addPass(gauss, resolution, [=] (OpenGLShader* program)
+    {
+        program->setUniformValue(locDir, 0.0f, 1.0f);
+        program->setUniformValue(locRad, radius);
+    });
+}
+
+
+void PostProcessChain::addBloom(float threshold, float intensity, float radius)
+{
+    OpenGLShader* bright = OpenGLDefaultShaders::get("cb.glsl.bright");
+    OpenGLShader* bloom = OpenGLDefaultShaders::get("cb.glsl.bloom");
+    int locThreshold = bright->uniformLocation("u_threshold");
+    int locIntensity = bloom->uniformLocation("u_intensity");
+
+    addPass(bright, ResolutionHalf, [=] (OpenGLShader* program)
+    {
+        program->setUniformValue(locThreshold, threshold);
+    });
+
+    addBlur(radius, ResolutionHalf);
+    addPass(bloom, ResolutionFull, [=] (OpenGLShader* program)
+    {
+        program->setUniformValue(locIntensity, intensity);
+    });
+}
+
+
+void PostProcessChain::clearPasses()
+{
+    m_passes.clear();
+    m_passTimes.clear();
+}
+
+
+bool PostProcessChain::isNull() const
+{
+    return RenderBase::isNull()      ||
+           m_vertexBuffer == nullptr ||
+           m_msScene == nullptr      ||
+           m_scene == nullptr;
+}
+
+
+bool PostProcessChain::create(Window* rt)
+{
+    if (!RenderBase::create(rt))
+    {
+        return false;
+    }
+
+    m_vertexBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    if (!m_vertexBuffer->create())
+    {
+        return cranError(ERRARG(e_01));
+    }
+
+    setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.texture"));
+
+    return createTargets();
+}
+
+
+void PostProcessChain::destroy()
+{
+    destroyTargets();
+    destroyMonitor();
+
+    delete m_vertexBuffer;
+    m_vertexBuffer = nullptr;
+
+    RenderBase::destroy();
+}
+
+
+void PostProcessChain::update(const GameTime& time)
+{
+    updateTransform(time);
+
+    JobSystem::instance()->updateObjects(m_objects, time);
+}
+
+
+void PostProcessChain::render()
+{
+    cranProfile("PostProcessChain::render");
+
+    if (!prepareRendering()) return;
+
+    // Follows the size of the render target.
+    if (renderTarget()->size() != m_size && !createTargets())
+    {
+        return;
+    }
+
+    renderScene();
+    runPasses();
+}
+
+
+quint64 PostProcessChain::revision() const
+{
+    quint64 revision = RenderBase::revision();
+    for (RenderBase* obj : m_objects)
+    {
+        revision += obj->revision();
+    }
+
+    return revision;
+}
+
+
+bool PostProcessChain::createTargets()
+{
+    destroyTargets();
+
+    m_size = renderTarget()->size();
+    setSize(m_size.width(), m_size.height());
+    setOrigin(width() / 2, height() / 2);
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    format.setSamples(c_samples);
+
+    m_msScene = new QOpenGLFramebufferObject(m_size, format);
+    m_scene = createTarget(gl, m_size);
+    if (!m_msScene->isValid() || m_scene == nullptr)
+    {
+        const QSize size = m_size;
+        destroyTargets();
+        return cranError(ERRARG_2(e_02, QString::number(size.width()), QString::number(size.height())));
+    }
+
+    // Two quads: one spanning the whole target in normalized device
+    // coordinates, one spanning this object in pixels. Textures of
+    // framebuffers are upside down, hence the flipped texture coordinates.
+    const float w = m_size.width();
+    const float h = m_size.height();
+    priv::TexVertices<8> vertices;
+
+    vertices.at(0).xyz(-1.f, -1.f, 0.f); vertices.at(0).uv(0.f, 0.f);
+    vertices.at(1).xyz(+1.f, -1.f, 0.f); vertices.at(1).uv(1.f, 0.f);
+    vertices.at(2).xyz(+1.f, +1.f, 0.f); vertices.at(2).uv(1.f, 1.f);
+    vertices.at(3).xyz(-1.f, +1.f, 0.f); vertices.at(3).uv(0.f, 1.f);
+    vertices.at(4).xyz(0.f,  0.f,  0.f); vertices.at(4).uv(0.f, 1.f);
+    vertices.at(5).xyz(w,    0.f,  0.f); vertices.at(5).uv(1.f, 1.f);
+    vertices.at(6).xyz(w,    h,    0.f); vertices.at(6).uv(1.f, 0.f);
+    vertices.at(7).xyz(0.f,  h,    0.f); vertices.at(7).uv(0.f, 0.f);
+
+    for (priv::TextureVertex& v : vertices)
+    {
+        v.rgba(1.f, 1.f, 1.f, 1.f);
+    }
+
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_vertexBuffer->allocate(vertices.data(), priv::TextureVertex::size() * 8));
+    glDebug(m_vertexBuffer->release());
+
+    return true;
+}
+
+
+void PostProcessChain::destroyTargets()
+{
+    delete m_msScene;
+    delete m_scene;
+
+    m_msScene = nullptr;
+    m_scene = nullptr;
+    m_size = QSize();
+
+    for (auto& pair : m_targets)
+    {
+        delete pair[0];
+        delete pair[1];
+
+        pair[0] = nullptr;
+        pair[1] = nullptr;
+    }
+}
+
+
+void PostProcessChain::destroyMonitor()
+{
+    if (m_monitor != nullptr)
+    {
+        m_monitor->destroy();
+        delete m_monitor;
+    }
+
+    m_monitor = nullptr;
+    m_timing = false;
+}
+
+
+QOpenGLFramebufferObject* PostProcessChain::target(
+        PassResolution res,
+        QOpenGLFramebufferObject* input
+        )
+{
+    // Never renders into the texture that is being read.
+    QOpenGLFramebufferObject** pair = m_targets[resolutionIndex(res)];
+    const int slot = (pair[0] != nullptr && pair[0] == input) ? 1 : 0;
+
+    if (pair[slot] == nullptr)
+    {
+        QSize size(qMax(1, m_size.width() / res), qMax(1, m_size.height() / res));
+        pair[slot] = createTarget(gl, size);
+        if (pair[slot] == nullptr)
+        {
+            cranError(ERRARG_2(e_02, QString::number(size.width()), QString::number(size.height())));
+        }
+    }
+
+    return pair[slot];
+}
+
+
+void PostProcessChain::renderScene()
+{
+    const QColor& cc = renderTarget()->settings().clearColor();
+    const QColor& bg = m_backColor.isValid() ? m_backColor : cc;
+
+    glDebug(m_msScene->bind());
+    glDebug(gl->glClearColor(bg.redF(), bg.greenF(), bg.blueF(), bg.alphaF()));
+    glDebug(gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+    glDebug(gl->glClearColor(cc.redF(), cc.greenF(), cc.blueF(), cc.alphaF()));
+
+    for (RenderBase* obj : m_objects)
+    {
+        obj->setOffscreenRenderer(m_msScene->handle());
+        obj->render();
+        obj->setOffscreenRenderer(0);
+    }
+
+    // Resolves the samples; all passes read the single-sampled scene.
+    glDebug(QOpenGLFramebufferObject::blitFramebuffer(m_scene, m_msScene));
+}
+
+
+void PostProcessChain::runPasses()
+{
+    glDebug(m_vertexBuffer->bind());
+
+    // The unprocessed scene is available to all passes on unit 1.
+    glDebug(gl->glActiveTexture(GL_TEXTURE1));
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, m_scene->texture()));
+    glDebug(gl->glActiveTexture(GL_TEXTURE0));
+
+    if (m_passes.isEmpty())
+    {
+        drawPass({ shaderProgram(), PassSetup(), ResolutionFull }, m_scene, true);
+    }
+    else
+    {
+        const bool timed = beginTiming();
+        if (timed) m_monitor->recordSample();
+
+        QOpenGLFramebufferObject* input = m_scene;
+        for (int i = 0; i < m_passes.size() && input != nullptr; i++)
+        {
+            input = drawPass(m_passes.at(i), input, i == m_passes.size() - 1);
+            if (timed) m_monitor->recordSample();
+        }
+
+        m_timing = timed || m_timing;
+    }
+
+    // Restores the state expected by all other objects.
+    glDebug(gl->glActiveTexture(GL_TEXTURE1));
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
+    glDebug(gl->glActiveTexture(GL_TEXTURE0));
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
+    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
+    glDebug(gl->glViewport(0, 0, renderTarget()->width(), renderTarget()->height()));
+    glDebug(gl->glEnable(GL_BLEND));
+    glDebug(m_vertexBuffer->release());
+}
+
+
+QOpenGLFramebufferObject* PostProcessChain::drawPass(
+        const Pass& pass,
+        QOpenGLFramebufferObject* input,
+        bool last
+        )
+{
+    OpenGLShader* program = pass.program;
+    QOpenGLFramebufferObject* output = nullptr;
+    QMatrix4x4 identity;
+
+    // Intermediate passes replace the target contents; only the last pass
+    // blends onto the render target.
+    if (last)
+    {
+        glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
+        glDebug(gl->glViewport(0, 0, renderTarget()->width(), renderTarget()->height()));
+        glDebug(gl->glEnable(GL_BLEND));
+    }
+    else
+    {
+        if ((output = target(pass.resolution, input)) == nullptr)
+        {
+            return nullptr;
+        }
+
+        glDebug(output->bind());
+        glDebug(gl->glViewport(0, 0, output->width(), output->height()));
+        glDebug(gl->glDisable(GL_BLEND));
+    }
+
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, input->texture()));
+
+    // Programs are shared with other objects; resets all common uniforms.
+    glDebug(program->bind());
+    glDebug(program->setSampler(GL_TEXTURE0));
+    glDebug(program->setMvpMatrix(last ? matrix(this) : &identity));
+    glDebug(program->setOpacity(last ? opacity() : 1.0f));
+    glDebug(program->setEffect(EffectNone));
+    glDebug(program->setBlendMode(BlendNone));
+    glDebug(program->setWindowSize(input->size()));
+    glDebug(program->setUvOffset(QPointF()));
+    glDebug(program->setUniformValue(program->uniformLocation("u_scene"), 1));
+
+    if (pass.setup)
+    {
+        pass.setup(program);
+    }
+
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::xyzAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::uvAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::rgbaAttrib()));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::xyzAttrib(),
+                priv::TextureVertex::xyzLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::xyzOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::uvAttrib(),
+                priv::TextureVertex::uvLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::uvOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::rgbaAttrib(),
+                priv::TextureVertex::rgbaLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::rgbaOffset()
+                ));
+
+    glDebug(gl->glDrawArrays(GL_TRIANGLE_FAN, last ? 4 : 0, 4));
+    glDebug(program->release());
+
+    return output;
+}
+
+
+bool PostProcessChain::beginTiming()
+{
+    if (m_noTiming)
+    {
+        return false;
+    }
+
+    // One sample before the first pass and one after each pass.
+    if (m_monitor != nullptr && m_monitor->sampleCount() != m_passes.size() + 1)
+    {
+        destroyMonitor();
+    }
+
+    if (m_monitor == nullptr)
+    {
+        m_monitor = new QOpenGLTimeMonitor;
+        m_monitor->setSampleCount(m_passes.size() + 1);
+        if (!m_monitor->create())
+        {
+            destroyMonitor();
+            m_noTiming = true;
+            return false;
+        }
+    }
+
+    // Reads the results of an earlier frame once the GPU is done with it;
+    // until then, no new measurement is started.
+    if (m_timing)
+    {
+        if (!m_monitor->isResultAvailable())
+        {
+            return false;
+        }
+
+        const QVector<GLuint64> intervals = m_monitor->waitForIntervals();
+        m_passTimes.resize(intervals.size());
+        for (int i = 0; i < intervals.size(); i++)
+        {
+            m_passTimes[i] = intervals.at(i) / 1000000.0f;
+        }
+
+        m_monitor->reset();
+        m_timing = false;
+    }
+
+    return true;
+}
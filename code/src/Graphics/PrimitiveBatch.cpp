@@ -0,0 +1,434 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/PrimitiveBatch.hpp>
+#include <Cranberry/OpenGL/OpenGLDebug.hpp>
+#include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/OpenGL/OpenGLShader.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/Window.hpp>
+
+// Qt headers
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QtMath>
+#include <QVector2D>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Vertex buffer creation failed.")
+CRANBERRY_CONST_VAR(qreal, c_segmentLength, 6.0)
+CRANBERRY_CONST_VAR(int, c_minSegments, 12)
+CRANBERRY_CONST_VAR(int, c_maxSegments, 128)
+CRANBERRY_CONST_VAR(qreal, c_miterLimit, 4.0)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+PrimitiveBatch::PrimitiveBatch()
+    : RenderBase()
+    , m_vertexBuffer(nullptr)
+    , m_drawCalls(0)
+    , m_smooth(true)
+{
+}
+
+
+PrimitiveBatch::~PrimitiveBatch()
+{
+    destroy();
+}
+
+
+bool PrimitiveBatch::isSmooth() const
+{
+    return m_smooth;
+}
+
+
+int PrimitiveBatch::pendingVertices() const
+{
+    return static_cast<int>(m_vertices.size());
+}
+
+
+int PrimitiveBatch::drawCalls() const
+{
+    return m_drawCalls;
+}
+
+
+void PrimitiveBatch::setSmooth(bool smooth)
+{
+    if (smooth != m_smooth)
+    {
+        flush();
+        m_smooth = smooth;
+    }
+}
+
+
+void PrimitiveBatch::line(
+        const QPointF& p1,
+        const QPointF& p2,
+        const QColor& color,
+        float width
+        )
+{
+    if (p1 == p2)
+    {
+        return;
+    }
+
+    QVector2D dir = QVector2D(p2 - p1).normalized();
+    QPointF norm = QPointF(-dir.y(), dir.x()) * (qMax(width, 1.0f) / 2.0);
+
+    m_color = color;
+    appendQuad(p1 - norm, p1 + norm, p2 + norm, p2 - norm);
+}
+
+
+void PrimitiveBatch::rect(
+        const QRectF& rc,
+        const QColor& color,
+        bool filled,
+        float width
+        )
+{
+    const QRectF outer = rc.normalized();
+    const qreal w = qMax(width, 1.0f);
+
+    m_color = color;
+
+    // An outline that covers the whole rectangle is a filled rectangle.
+    if (filled || w * 2.0 >= qMin(outer.width(), outer.height()))
+    {
+        appendQuad(outer.topLeft(), outer.topRight(), outer.bottomRight(), outer.bottomLeft());
+        return;
+    }
+
+    const QRectF inner = outer.adjusted(w, w, -w, -w);
+    appendQuad(outer.topLeft(), outer.topRight(), inner.topRight(), inner.topLeft());
+    appendQuad(outer.topRight(), outer.bottomRight(), inner.bottomRight(), inner.topRight());
+    appendQuad(outer.bottomRight(), outer.bottomLeft(), inner.bottomLeft(), inner.bottomRight());
+    appendQuad(outer.bottomLeft(), outer.topLeft(), inner.topLeft(), inner.bottomLeft());
+}
+
+
+void PrimitiveBatch::circle(
+        const QPointF& center,
+        float radius,
+        const QColor& color,
+        bool filled,
+        float width,
+        int segments
+        )
+{
+    if (radius <= 0.0f)
+    {
+        return;
+    }
+
+    // Keeps the segments about equally long, regardless of the radius.
+    if (segments <= 0)
+    {
+        segments = qCeil(2.0 * M_PI * radius / c_segmentLength);
+    }
+
+    segments = qBound(c_minSegments, segments, c_maxSegments);
+
+    const qreal inner = filled ? 0.0f : qMax(0.0f, radius - qMax(width, 1.0f));
+    const qreal step = 2.0 * M_PI / segments;
+
+    m_color = color;
+    for (int i = 0; i < segments; i++)
+    {
+        const QPointF d0(qCos(step * i), qSin(step * i));
+        const QPointF d1(qCos(step * (i + 1)), qSin(step * (i + 1)));
+
+        if (inner == 0.0)
+        {
+            appendTriangle(center, center + d0 * radius, center + d1 * radius);
+        }
+        else
+        {
+            appendQuad(center + d0 * inner,
+                       center + d0 * radius,
+                       center + d1 * radius,
+                       center + d1 * inner);
+        }
+    }
+}
+
+
+void PrimitiveBatch::polyline(
+        const QVector<QPointF>& points,
+        const QColor& color,
+        float width,
+        bool closed
+        )
+{
+    // Consecutive equal points have no direction and are skipped.
+    QVector<QPointF> pts;
+    pts.reserve(points.size());
+    for (const QPointF& p : points)
+    {
+        if (pts.isEmpty() || pts.last() != p)
+        {
+            pts.append(p);
+        }
+    }
+
+    if (closed && pts.size() > 2 && pts.first() == pts.last())
+    {
+        pts.removeLast();
+    }
+
+    const int count = pts.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    closed = closed && count > 2;
+
+    // Computes the offset of both line edges at every point. At joints, the
+    // offset lies on the bisector, so that adjacent segments meet exactly.
+    const qreal half = qMax(width, 1.0f) / 2.0;
+    QVector<QPointF> offsets(count);
+
+    auto normal = [&pts] (int from, int to)
+    {
+        QVector2D dir = QVector2D(pts.at(to) - pts.at(from)).normalized();
+        return QVector2D(-dir.y(), dir.x());
+    };
+
+    for (int i = 0; i < count; i++)
+    {
+        const bool hasPrev = closed || i > 0;
+        const bool hasNext = closed || i < count - 1;
+        const int prev = (i + count - 1) % count;
+        const int next = (i + 1) % count;
+
+        if (hasPrev && hasNext)
+        {
+            const QVector2D n0 = normal(prev, i);
+            const QVector2D n1 = normal(i, next);
+            const QVector2D miter = (n0 + n1).normalized();
+            const qreal dot = QVector2D::dotProduct(miter, n1);
+
+            // Sharp angles would produce endless spikes; limits them. If the
+            // line folds back onto itself, there is no bisector at all.
+            if (miter.isNull())
+            {
+                offsets[i] = n1.toPointF() * half;
+            }
+            else
+            {
+                const qreal len = (dot > 1.0 / c_miterLimit) ? half / dot : half * c_miterLimit;
+                offsets[i] = miter.toPointF() * len;
+            }
+        }
+        else
+        {
+            offsets[i] = (hasNext ? normal(i, next) : normal(prev, i)).toPointF() * half;
+        }
+    }
+
+    m_color = color;
+    const int segments = closed ? count : count - 1;
+    for (int i = 0; i < segments; i++)
+    {
+        const int j = (i + 1) % count;
+        appendQuad(pts.at(i) - offsets.at(i),
+                   pts.at(i) + offsets.at(i),
+                   pts.at(j) + offsets.at(j),
+                   pts.at(j) - offsets.at(j));
+    }
+}
+
+
+void PrimitiveBatch::flush()
+{
+    if (m_vertices.empty() || !prepareRendering())
+    {
+        return;
+    }
+
+    // Re-allocating orphans the storage of the previous flush, so the driver
+    // does not need to wait for the GPU to finish reading it.
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_vertexBuffer->allocate(
+                m_vertices.data(),
+                static_cast<int>(m_vertices.size() * priv::Vertex::size())
+                ));
+
+    modifyProgram();
+    modifyAttribs();
+
+    if (!m_smooth)
+    {
+        glDebug(gl->glDisable(GL_MULTISAMPLE));
+    }
+
+    glDebug(gl->glDrawArrays(GL_TRIANGLES, GL_ZERO, static_cast<int>(m_vertices.size())));
+
+    if (!m_smooth)
+    {
+        glDebug(gl->glEnable(GL_MULTISAMPLE));
+    }
+
+    releaseObjects();
+
+    m_vertices.clear();
+    m_drawCalls++;
+}
+
+
+void PrimitiveBatch::clear()
+{
+    m_vertices.clear();
+}
+
+
+bool PrimitiveBatch::isNull() const
+{
+    return RenderBase::isNull()      ||
+           m_vertexBuffer == nullptr ||
+          !m_vertexBuffer->isCreated();
+}
+
+
+bool PrimitiveBatch::create(Window* renderTarget)
+{
+    if (!RenderBase::create(renderTarget))
+    {
+        return false;
+    }
+
+    m_vertexBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    if (!m_vertexBuffer->create())
+    {
+        return cranError(ERRARG(e_01));
+    }
+
+    m_vertexBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+    setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.shape"));
+
+    return true;
+}
+
+
+void PrimitiveBatch::destroy()
+{
+    delete m_vertexBuffer;
+
+    m_vertexBuffer = nullptr;
+    m_vertices.clear();
+
+    RenderBase::destroy();
+}
+
+
+void PrimitiveBatch::update(const GameTime& time)
+{
+    updateTransform(time);
+    m_drawCalls = 0;
+}
+
+
+void PrimitiveBatch::render()
+{
+    cranProfile("PrimitiveBatch::render");
+
+    flush();
+}
+
+
+void PrimitiveBatch::appendTriangle(const QPointF& a, const QPointF& b, const QPointF& c)
+{
+    priv::Vertex v;
+    v.rgba(m_color);
+    markDirty();
+
+    v.xyz(a.x(), a.y());
+    m_vertices.push_back(v);
+    v.xyz(b.x(), b.y());
+    m_vertices.push_back(v);
+    v.xyz(c.x(), c.y());
+    m_vertices.push_back(v);
+}
+
+
+void PrimitiveBatch::appendQuad(
+        const QPointF& a,
+        const QPointF& b,
+        const QPointF& c,
+        const QPointF& d
+        )
+{
+    appendTriangle(a, b, c);
+    appendTriangle(c, d, a);
+}
+
+
+void PrimitiveBatch::modifyProgram()
+{
+    OpenGLShader* program = shaderProgram();
+
+    glDebug(program->bind());
+    glDebug(program->setMvpMatrix(matrix(this)));
+    glDebug(program->setOpacity(opacity()));
+}
+
+
+void PrimitiveBatch::modifyAttribs()
+{
+    glDebug(gl->glEnableVertexAttribArray(priv::Vertex::xyzAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::Vertex::rgbaAttrib()));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::Vertex::xyzAttrib(),
+                priv::Vertex::xyzLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::Vertex::size(),
+                priv::Vertex::xyzOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::Vertex::rgbaAttrib(),
+                priv::Vertex::rgbaLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::Vertex::size(),
+                priv::Vertex::rgbaOffset()
+                ));
+}
+
+
+void PrimitiveBatch::releaseObjects()
+{
+    glDebug(m_vertexBuffer->release());
+    glDebug(shaderProgram()->release());
+}
@@ -25,6 +25,7 @@
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 // Qt headers
 #include <QFile>
@@ -68,6 +69,7 @@ MovementMode getJsonMoveMode(QJsonValue& val)
 Sprite::Sprite()
     : RenderBase()
     , m_currentMove(nullptr)
+    , m_animRevision(0)
     , m_isRunning(false)
     , m_isBlocking(false)
 {
@@ -311,6 +313,7 @@ void Sprite::beginMove(const QString& n)
     m_isRunning = true;
     m_currentMove = m;
     m_currentMove->animation()->copyTransform(this, m_currentMove->animation());
+    markDirty();
 }
 
 
@@ -335,6 +338,7 @@ void Sprite::beginIdle(const QString& n)
     m_currentMove = m;
     m_currentMove->animation()->copyTransform(this, m_currentMove->animation());
     m_isRunning = false;
+    markDirty();
 }
 
 
@@ -381,11 +385,21 @@ void Sprite::update(const GameTime& time)
 
     m_currentMove->animation()->update(time);
     updateTransform(time);
+
+    // Containers only see the sprite; forwards changes of the animation.
+    const quint64 revision = m_currentMove->animation()->revision();
+    if (revision != m_animRevision)
+    {
+        m_animRevision = revision;
+        markDirty();
+    }
 }
 
 
 void Sprite::render()
 {
+    cranProfile("Sprite::render");
+
     if (!RenderBase::prepareRendering())
     {
         return;
@@ -25,7 +25,9 @@
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/OpenGL/OpenGLShader.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
@@ -38,13 +40,10 @@
 CRANBERRY_USING_NAMESPACE
 
 
-CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Frame buffer could not be created.")
-CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Render buffer could not be created.")
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Frame buffer could not be acquired.")
 CRANBERRY_CONST_VAR(QString, e_03, "%0 [%1] - Vertex array could not be created.")
 CRANBERRY_CONST_VAR(QString, e_04, "%0 [%1] - Vertex buffer could not be created.")
 CRANBERRY_CONST_VAR(QString, e_05, "%0 [%1] - Index buffer could not be created.")
-CRANBERRY_CONST_VAR(QString, e_06, "%0 [%1] - Texture could not be created.")
-CRANBERRY_CONST_VAR(QString, e_07, "%0 [%1] - Frame buffer not complete.")
 CRANBERRY_CONST_ARR(uint, 6, c_ibo, 0, 1, 2, 2, 3, 0)
 
 
@@ -54,14 +53,15 @@ SpriteBatch::SpriteBatch()
     , m_fbo(nullptr)
     , m_effect(EffectNone)
     , m_backColor(Qt::transparent)
-    , m_frameBuffer(0)
-    , m_msFrameBuffer(0)
-    , m_renderBuffer(0)
+    , m_target(nullptr)
+    , m_cache(nullptr)
     , m_vertexArray(0)
     , m_vertexBuffer(0)
     , m_indexBuffer(0)
-    , m_frameTexture(0)
-    , m_msFrameTexture(0)
+    , m_samples(4)
+    , m_depthStencil(true)
+    , m_retained(false)
+    , m_dirty(true)
     , m_isEmbedded(false)
     , m_takeOwnership(false)
 {
@@ -96,9 +96,28 @@ Effect SpriteBatch::effect() const
 }
 
 
+int SpriteBatch::samples() const
+{
+    return m_samples;
+}
+
+
+bool SpriteBatch::hasDepthStencil() const
+{
+    return m_depthStencil;
+}
+
+
+bool SpriteBatch::isRetained() const
+{
+    return m_retained;
+}
+
+
 void SpriteBatch::setBackgroundColor(const QColor& color)
 {
     m_backColor = color;
+    m_dirty = true;
 }
 
 
@@ -107,14 +126,52 @@ void SpriteBatch::setGeometry(const QRectF& rc)
     if (rc == m_geometry) return;
 
     m_geometry = rc;
+    m_dirty = true;
     setPosition(rc.x(), rc.y());
-    recreateFboRbo();
+
+    // Targets are acquired by size every frame; only the quad changes.
+    if (!isNull())
+    {
+        updateVertices();
+        writeBuffers();
+    }
 }
 
 
 void SpriteBatch::setEffect(Effect effect)
 {
-    m_effect = effect;
+    if (effect != m_effect)
+    {
+        m_effect = effect;
+        markDirty();
+    }
+}
+
+
+void SpriteBatch::setSamples(int samples)
+{
+    m_samples = qMax(0, samples);
+    m_dirty = true;
+}
+
+
+void SpriteBatch::setDepthStencil(bool depthStencil)
+{
+    m_depthStencil = depthStencil;
+    m_dirty = true;
+}
+
+
+void SpriteBatch::setRetained(bool retained)
+{
+    m_retained = retained;
+    m_dirty = true;
+}
+
+
+void SpriteBatch::invalidate()
+{
+    m_dirty = true;
 }
 
 
@@ -127,7 +184,7 @@ bool SpriteBatch::create(
     m_fbo = fbo;
     m_takeOwnership = takeOwnership;
 
-    return createInternal(rt) && createData() && writeData();
+    return createInternal(rt) && createBuffers() && writeData();
 }
 
 
@@ -136,6 +193,8 @@ bool SpriteBatch::addObject(RenderBase* object)
     if (m_objects.contains(object)) return false;
 
     m_objects.append(object);
+    m_dirty = true;
+
     return true;
 }
 
@@ -146,27 +205,26 @@ bool SpriteBatch::insertObject(int layer, RenderBase* object)
     if (layer < 0 || layer >= m_objects.size()) m_objects.append(object);
     else m_objects.insert(layer, object);
 
+    m_dirty = true;
     return true;
 }
 
 
 bool SpriteBatch::removeObject(RenderBase* object)
 {
-    return m_objects.removeOne(object);
+    if (!m_objects.removeOne(object)) return false;
+
+    m_dirty = true;
+    return true;
 }
 
 
 bool SpriteBatch::isNull() const
 {
     return RenderBase::isNull() ||
-           m_frameBuffer  == 0   ||
-           m_msFrameBuffer == 0  ||
-           m_renderBuffer == 0   ||
            m_vertexArray  == 0   ||
            m_vertexBuffer == 0   ||
-           m_indexBuffer  == 0   ||
-           m_frameTexture == 0   ||
-           m_msFrameTexture == 0;
+           m_indexBuffer  == 0;
 }
 
 
@@ -178,9 +236,19 @@ bool SpriteBatch::create(Window* rt)
 
 void SpriteBatch::destroy()
 {
-    destroyFboRbo();
+    releaseTargets();
     destroyBuffers();
 
+    if (m_takeOwnership)
+    {
+        delete m_fbo;
+    }
+
+    m_fbo = nullptr;
+    m_takeOwnership = false;
+    m_snapshots.clear();
+    m_dirty = true;
+
     RenderBase::destroy();
 }
 
@@ -189,20 +257,38 @@ void SpriteBatch::update(const GameTime& time)
 {
     updateTransform(time);
 
-    for (RenderBase* obj : m_objects)
-    {
-        obj->update(time);
-    }
+    JobSystem::instance()->updateObjects(m_objects, time);
 }
 
 
 void SpriteBatch::render()
 {
+    cranProfile("SpriteBatch::render");
+
     if (!prepareRendering()) return;
-    if (!m_objects.isEmpty())
+
+    // A batch without geometry follows the size of the render target.
+    if (m_geometry.isNull() && m_fbo == nullptr &&
+        QSizeF(renderTarget()->size()) != QSizeF(width(), height()))
+    {
+        updateVertices();
+        writeBuffers();
+    }
+
+    // An existing fbo is drawn every frame; own objects only if changed.
+    if (m_fbo != nullptr)
+    {
+        if (!resolveFbo()) return;
+    }
+    else if (hasChanged())
     {
+        if (!acquireTarget()) return;
+
         setupBatch();
         renderBatch();
+
+        if (!resolveBatch()) return;
+        markDirty();
     }
 
     setupFrame();
@@ -211,6 +297,18 @@ void SpriteBatch::render()
 }
 
 
+quint64 SpriteBatch::revision() const
+{
+    quint64 revision = RenderBase::revision();
+    for (RenderBase* obj : m_objects)
+    {
+        revision += obj->revision();
+    }
+
+    return revision;
+}
+
+
 TreeModelItem* SpriteBatch::rootModelItem()
 {
     return m_rootModelItem;
@@ -235,14 +333,12 @@ void SpriteBatch::createProperties(TreeModel* model)
     TreeModelItem* tmiGeoW = new TreeModelItem("w", cp.width());
     TreeModelItem* tmiGeoH = new TreeModelItem("h", cp.height());
     TreeModelItem* tmiOpGL = new TreeModelItem("OpenGL");
-    TreeModelItem* tmiSFbo = new TreeModelItem("Single-sampled frame buffer", m_frameBuffer);
-    TreeModelItem* tmiMFbo = new TreeModelItem("Multi-sampled frame buffer", m_msFrameBuffer);
-    TreeModelItem* tmiORbo = new TreeModelItem("Render buffer", m_renderBuffer);
+    TreeModelItem* tmiSmpl = new TreeModelItem("Samples", m_samples);
+    TreeModelItem* tmiDpth = new TreeModelItem("Depth/stencil", m_depthStencil);
+    TreeModelItem* tmiRetn = new TreeModelItem("Retained", m_retained);
     TreeModelItem* tmiOVao = new TreeModelItem("Vertex array", m_vertexArray);
     TreeModelItem* tmiOVbo = new TreeModelItem("Vertex buffer", m_vertexBuffer);
     TreeModelItem* tmiOIbo = new TreeModelItem("Index buffer", m_indexBuffer);
-    TreeModelItem* tmiSTex = new TreeModelItem("Single-sampled texture", m_frameTexture);
-    TreeModelItem* tmiMTex = new TreeModelItem("Multi-sampled texture", m_msFrameTexture);
 
     m_rootModelItem = new TreeModelItem("SpriteBatch");
     m_rootModelItem->appendChild(tmiEffe);
@@ -255,14 +351,12 @@ void SpriteBatch::createProperties(TreeModel* model)
     tmiGeom->appendChild(tmiGeoY);
     tmiGeom->appendChild(tmiGeoW);
     tmiGeom->appendChild(tmiGeoH);
-    tmiOpGL->appendChild(tmiSFbo);
-    tmiOpGL->appendChild(tmiMFbo);
-    tmiOpGL->appendChild(tmiORbo);
+    tmiOpGL->appendChild(tmiSmpl);
+    tmiOpGL->appendChild(tmiDpth);
+    tmiOpGL->appendChild(tmiRetn);
     tmiOpGL->appendChild(tmiOVao);
     tmiOpGL->appendChild(tmiOVbo);
     tmiOpGL->appendChild(tmiOIbo);
-    tmiOpGL->appendChild(tmiSTex);
-    tmiOpGL->appendChild(tmiMTex);
 
     Q_FOREACH (RenderBase* rb, m_objects)
     {
@@ -285,14 +379,22 @@ void SpriteBatch::createProperties(TreeModel* model)
 
 void SpriteBatch::updateProperties()
 {
-    // Update child objects if count changed.
-    if (m_rootModelItem->childAt(2)->childCount() != m_objects.size())
+    // Rebuilds the child objects only if the count changed.
+    TreeModelItem* tmiObjs = m_rootModelItem->childAt(2);
+    if (tmiObjs->childCount() != m_objects.size())
     {
-        m_rootModelItem->childAt(2)->removeAllChildren();
+        tmiObjs->removeAllChildren();
 
         Q_FOREACH (RenderBase* rb, m_objects)
         {
-            m_rootModelItem->childAt(2)->appendChild(new TreeModelItem("Name", rb->name()));
+            tmiObjs->appendChild(new TreeModelItem("Name", rb->name()));
+        }
+    }
+    else
+    {
+        for (int i = 0; i < m_objects.size(); i++)
+        {
+            tmiObjs->childAt(i)->setValue(m_objects.at(i)->name());
         }
     }
 
@@ -309,14 +411,12 @@ void SpriteBatch::updateProperties()
     m_rootModelItem->childAt(3)->childAt(1)->setValue(cp.y());
     m_rootModelItem->childAt(3)->childAt(2)->setValue(cp.width());
     m_rootModelItem->childAt(3)->childAt(3)->setValue(cp.height());
-    m_rootModelItem->childAt(4)->childAt(0)->setValue(m_frameBuffer);
-    m_rootModelItem->childAt(4)->childAt(1)->setValue(m_msFrameBuffer);
-    m_rootModelItem->childAt(4)->childAt(2)->setValue(m_renderBuffer);
+    m_rootModelItem->childAt(4)->childAt(0)->setValue(m_samples);
+    m_rootModelItem->childAt(4)->childAt(1)->setValue(m_depthStencil);
+    m_rootModelItem->childAt(4)->childAt(2)->setValue(m_retained);
     m_rootModelItem->childAt(4)->childAt(3)->setValue(m_vertexArray);
     m_rootModelItem->childAt(4)->childAt(4)->setValue(m_vertexBuffer);
     m_rootModelItem->childAt(4)->childAt(5)->setValue(m_indexBuffer);
-    m_rootModelItem->childAt(4)->childAt(6)->setValue(m_frameTexture);
-    m_rootModelItem->childAt(4)->childAt(7)->setValue(m_msFrameTexture);
 
     if (!m_isEmbedded)
     {
@@ -336,56 +436,6 @@ bool SpriteBatch::createInternal(Window* rt)
 }
 
 
-bool SpriteBatch::createData()
-{
-    return createFboRbo() && createBuffers();
-}
-
-
-bool SpriteBatch::createFboRbo()
-{
-    glDebug(gl->glGenFramebuffers(1, &m_frameBuffer));
-    if (m_frameBuffer == 0)
-    {
-        return cranError(ERRARG(e_01));
-    }
-
-    glDebug(gl->glGenTextures(1, &m_frameTexture));
-    if (m_frameTexture == 0)
-    {
-        return cranError(ERRARG(e_06));
-    }
-
-    glDebug(gl->glGenRenderbuffers(1, &m_renderBuffer));
-    if (m_renderBuffer == 0)
-    {
-        return cranError(ERRARG(e_02));
-    }
-
-    if (m_fbo == nullptr)
-    {
-        glDebug(gl->glGenFramebuffers(1, &m_msFrameBuffer));
-        if (m_msFrameBuffer == 0)
-        {
-            return cranError(ERRARG(e_01));
-        }
-
-        glDebug(gl->glGenTextures(1, &m_msFrameTexture));
-        if (m_msFrameTexture == 0)
-        {
-            return cranError(ERRARG(e_06));
-        }
-    }
-    else
-    {
-        m_msFrameBuffer = m_fbo->handle();
-        m_msFrameTexture = m_fbo->texture();
-    }
-
-    return true;
-}
-
-
 bool SpriteBatch::createBuffers()
 {
     glDebug(egl->glGenVertexArrays(1, &m_vertexArray));
@@ -410,17 +460,6 @@ bool SpriteBatch::createBuffers()
 }
 
 
-void SpriteBatch::recreateFboRbo()
-{
-    destroyFboRbo();
-    updateVertices();
-    createFboRbo();
-    writeTexture();
-    writeRenderbuffer();
-    writeFramebuffer();
-}
-
-
 void SpriteBatch::updateVertices()
 {
     // If null, takes the entire screen.
@@ -463,10 +502,7 @@ bool SpriteBatch::writeData()
 {
     updateVertices();
 
-    return writeBuffers() &&
-           writeTexture() &&
-           writeRenderbuffer() &&
-           writeFramebuffer();
+    return writeBuffers();
 }
 
 
@@ -498,154 +534,135 @@ bool SpriteBatch::writeBuffers()
 }
 
 
-bool SpriteBatch::writeFramebuffer()
+bool SpriteBatch::hasChanged()
 {
-    // Assigns the underlying texture.
-    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, m_frameBuffer));
-    glDebug(gl->glFramebufferTexture2D(
-                GL_FRAMEBUFFER,
-                GL_COLOR_ATTACHMENT0,
-                GL_TEXTURE_2D,
-                m_frameTexture,
-                GL_ZERO
-                ));
+    const QSize size(width(), height());
+    bool changed = m_dirty || m_cache == nullptr || m_cache->size != size;
 
-    // Check for frame buffer completeness.
-    uint status;
-    glDebug(status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER));
-    if (status != GL_FRAMEBUFFER_COMPLETE)
-    {
-        return cranError(ERRARG(e_07));
-    }
-
-    // Assigns the underlying multisampled texture and the multisampled rbo.
-    if (m_fbo == nullptr)
-    {
-        glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, m_msFrameBuffer));
-        glDebug(gl->glFramebufferTexture2D(
-                    GL_FRAMEBUFFER,
-                    GL_COLOR_ATTACHMENT0,
-                    GL_TEXTURE_2D_MULTISAMPLE,
-                    m_msFrameTexture,
-                    GL_ZERO));
-        glDebug(gl->glFramebufferRenderbuffer(
-                    GL_FRAMEBUFFER,
-                    GL_DEPTH_STENCIL_ATTACHMENT,
-                    GL_RENDERBUFFER,
-                    m_renderBuffer
-                    ));
+    m_dirty = false;
+    if (!m_retained)
+    {
+        return true;
+    }
 
-        // Check for frame buffer completeness.
-        glDebug(status = gl->glCheckFramebufferStatus(GL_FRAMEBUFFER));
-        if (status != GL_FRAMEBUFFER_COMPLETE)
+    // Compares every object with the state it was last rendered in. All
+    // snapshots are taken, so that they are up to date for the next frame.
+    m_snapshots.resize(m_objects.size());
+    for (int i = 0; i < m_objects.size(); i++)
+    {
+        RenderBase* obj = m_objects.at(i);
+        Snapshot& last = m_snapshots[i];
+
+        if (obj->renderTarget() == nullptr)
         {
-            cranError(ERRARG(e_07));
+            last.object = nullptr;
+            changed = true;
+            continue;
         }
+
+        Snapshot now;
+        now.object = obj;
+        now.revision = obj->revision();
+        now.matrix = *obj->matrix(obj);
+        now.program = obj->shaderProgram();
+        now.opacity = obj->opacity();
+
+        if (now.object   != last.object   ||
+            now.revision != last.revision ||
+            now.program  != last.program  ||
+            now.opacity  != last.opacity  ||
+            now.matrix   != last.matrix)
+        {
+            changed = true;
+        }
+
+        last = now;
     }
 
-    glDebug(egl->glBindFramebuffer(GL_FRAMEBUFFER, GL_ZERO));
-    return status == GL_FRAMEBUFFER_COMPLETE;
+    return changed;
 }
 
 
-
-bool SpriteBatch::writeTexture()
+bool SpriteBatch::acquireTarget()
 {
-    // Allocates a texture, enable smoothing.
-    glDebug(gl->glBindTexture(GL_TEXTURE_2D, m_frameTexture));
-    glDebug(gl->glTexImage2D(
-                GL_TEXTURE_2D,
-                GL_ZERO,
-                GL_RGBA8,
-                width(),
-                height(),
-                GL_ZERO,
-                GL_RGBA,
-                GL_UNSIGNED_BYTE,
-                NULL
-                ));
-
-    glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
-    glDebug(gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    glDebug(gl->glBindTexture(GL_TEXTURE_2D, GL_ZERO));
-
-    // Allocates a multisampled texture.
-    if (m_fbo == nullptr)
-    {
-        glDebug(egl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, m_msFrameTexture));
-        glDebug(egl->glTexStorage2DMultisample(
-                    GL_TEXTURE_2D_MULTISAMPLE,
-                    4,
-                    GL_RGBA,
-                    width(),
-                    height(),
-                    GL_TRUE
-                    ));
+    const QSize size(width(), height());
 
-        glDebug(egl->glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, GL_ZERO));
+    m_target = priv::RenderTargetPool::acquire(size, m_samples, m_depthStencil);
+    if (m_target == nullptr)
+    {
+        return cranError(ERRARG(e_01));
     }
 
     return true;
 }
 
 
-bool SpriteBatch::writeRenderbuffer()
+bool SpriteBatch::resolveBatch()
 {
-    glDebug(egl->glBindRenderbuffer(GL_RENDERBUFFER, m_renderBuffer));
-    glDebug(egl->glRenderbufferStorageMultisample(
-                GL_RENDERBUFFER,
-                4,
-                GL_DEPTH24_STENCIL8,
-                width(),
-                height()
-                ));
-
-    glDebug(egl->glBindRenderbuffer(GL_RENDERBUFFER, GL_ZERO));
-    return true;
-}
-
+    Target* image = m_target;
+    m_target = nullptr;
 
-void SpriteBatch::destroyFboRbo()
-{
-    // If using a fbo allocated by Qt, do not delete it manually.
-    if (m_fbo == nullptr)
+    // The multisampled target is only needed until it is resolved.
+    if (image->samples > 0)
     {
-        if (m_msFrameBuffer != 0)
+        Target* resolved = priv::RenderTargetPool::acquire(image->size, 0, false);
+        if (resolved != nullptr)
         {
-            glDebug(gl->glDeleteFramebuffers(1, &m_msFrameBuffer));
-            m_msFrameBuffer = 0;
+            blit(image->frameBuffer, resolved);
         }
-        if (m_msFrameTexture != 0)
+
+        priv::RenderTargetPool::release(image);
+        if (resolved == nullptr)
         {
-            glDebug(gl->glDeleteTextures(1, &m_msFrameTexture));
-            m_msFrameTexture = 0;
+            return cranError(ERRARG(e_01));
         }
-    }
-    else if (m_takeOwnership)
-    {
-        delete m_fbo;
-        m_fbo = nullptr;
-    }
 
-    if (m_frameBuffer != 0)
-    {
-        glDebug(gl->glDeleteFramebuffers(1, &m_frameBuffer));
-        m_frameBuffer = 0;
+        image = resolved;
     }
 
-    if (m_frameTexture != 0)
+    priv::RenderTargetPool::release(m_cache);
+    m_cache = image;
+
+    return true;
+}
+
+
+bool SpriteBatch::resolveFbo()
+{
+    if (m_fbo->format().samples() == 0)
     {
-        glDebug(gl->glDeleteTextures(1, &m_frameTexture));
-        m_frameTexture = 0;
+        return true;
     }
 
-    if (m_renderBuffer != 0)
+    m_cache = priv::RenderTargetPool::acquire(m_fbo->size(), 0, false);
+    if (m_cache == nullptr)
     {
-        glDebug(gl->glDeleteRenderbuffers(1, &m_renderBuffer));
-        m_renderBuffer = 0;
+        return cranError(ERRARG(e_01));
     }
+
+    blit(m_fbo->handle(), m_cache);
+    return true;
+}
+
+
+void SpriteBatch::blit(uint source, Target* target)
+{
+    const int w = target->size.width();
+    const int h = target->size.height();
+
+    glDebug(egl->glBindFramebuffer(GL_READ_FRAMEBUFFER, source));
+    glDebug(egl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->frameBuffer));
+    glDebug(egl->glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+}
+
+
+void SpriteBatch::releaseTargets()
+{
+    priv::RenderTargetPool::release(m_target);
+    priv::RenderTargetPool::release(m_cache);
+
+    m_target = nullptr;
+    m_cache = nullptr;
 }
 
 
@@ -684,8 +701,8 @@ void SpriteBatch::setupBatch()
                     ));
     }
 
-    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, m_msFrameBuffer));
-    glDebug(gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, m_target->frameBuffer));
+    glDebug(gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
 
     // Revert clear color back to default.
     if (m_backColor.isValid())
@@ -705,7 +722,7 @@ void SpriteBatch::renderBatch()
 {
     for (RenderBase* obj : m_objects)
     {
-        obj->setOffscreenRenderer(m_msFrameBuffer);
+        obj->setOffscreenRenderer(m_target->frameBuffer);
         obj->render();
         obj->setOffscreenRenderer(0);
     }
@@ -714,17 +731,8 @@ void SpriteBatch::renderBatch()
 
 void SpriteBatch::setupFrame()
 {
-    OpenGLShader* program = shaderProgram();
-
-    // Blit MSAA fbo to normal fbo.
-    glDebug(egl->glBindFramebuffer(GL_READ_FRAMEBUFFER, m_msFrameBuffer));
-    glDebug(egl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_frameBuffer));
-    glDebug(egl->glBlitFramebuffer(
-                0, 0, width(), height(),
-                0, 0, width(), height(),
-                GL_COLOR_BUFFER_BIT,
-                GL_NEAREST
-                ));
+    OpenGLShader* program = OpenGLDefaultShaders::getVariant(shaderProgram(), BlendNone, m_effect);
+    const uint texture = (m_cache != nullptr) ? m_cache->colorBuffer : m_fbo->texture();
 
     // Bind default framebuffer.
     glDebug(egl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
@@ -734,7 +742,7 @@ void SpriteBatch::setupFrame()
 
     // Activates unit 0 and binds our target texture to it.
     glDebug(egl->glActiveTexture(GL_TEXTURE0));
-    glDebug(egl->glBindTexture(GL_TEXTURE_2D, m_frameTexture));
+    glDebug(egl->glBindTexture(GL_TEXTURE_2D, texture));
 
     // Modify the states of the program.
     glDebug(program->bind());
@@ -796,5 +804,12 @@ void SpriteBatch::releaseFrame()
     glDebug(egl->glBindTexture(GL_TEXTURE_2D, 0));
     glDebug(egl->glBindVertexArray(renderTarget()->vao()));
     glDebug(egl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
-    shaderProgram()->release();
+    OpenGLDefaultShaders::getVariant(shaderProgram(), BlendNone, m_effect)->release();
+
+    // Unless retained, the next batch of the same size may reuse the image
+    // right away.
+    if (m_fbo != nullptr || !m_retained)
+    {
+        releaseTargets();
+    }
 }
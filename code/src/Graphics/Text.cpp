@@ -25,25 +25,26 @@
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
 #include <QBrush>
 #include <QPainter>
-#include <QOffscreenSurface>
 #include <QPainterPath>
-#include <QOpenGLExtraFunctions>
+#include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
 #include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
+#include <QStringList>
 #include <QTextDocumentFragment>
+#include <QtMath>
 
 // Constants
-CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Cannot render invalid object.")
-CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Texture could not be created.")
+CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Vertex buffer creation failed.")
+CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Index buffer creation failed.")
 CRANBERRY_CONST_VAR(qint32, c_maxSize, 4096)
-
-// Macroes
-#define qsf(x) (QSize(x.width(), x.height()))
+CRANBERRY_CONST_ARR(uint, 6, c_ibo, 0, 1, 2, 2, 3, 0)
 
 
 CRANBERRY_USING_NAMESPACE
@@ -53,13 +54,13 @@ Text::Text()
     : RenderBase()
     , m_textPen(new QPen(Qt::white))
     , m_outlineBrush(new QBrush(Qt::black))
-    , m_fbo(nullptr)
-    , m_batch(nullptr)
+    , m_entry(nullptr)
+    , m_vertexBuffer(nullptr)
+    , m_indexBuffer(nullptr)
+    , m_propertyRevision(0)
     , m_outlineWidth(0)
     , m_columnLimit(-1)
     , m_rowLimit(-1)
-    , m_lastWidth(0)
-    , m_lastHeight(0)
     , m_blurFactor(0.0f)
     , m_textUpdate(true)
 {
@@ -129,6 +130,7 @@ void Text::setText(const QString& str)
 {
     m_text = str;
     m_textUpdate = true;
+    markDirty();
 
     recalcSize();
 }
@@ -137,6 +139,7 @@ void Text::setText(const QString& str)
 void Text::setConstraint(const QRect& constraint)
 {
     m_constraint = constraint;
+    markDirty();
 
     if (!constraint.isNull())
     {
@@ -151,6 +154,7 @@ void Text::setFont(const QFont& font)
 {
     m_font = font;
     m_textUpdate = true;
+    markDirty();
 
     recalcSize();
 }
@@ -160,6 +164,7 @@ void Text::setTextColor(const QColor& color)
 {
     m_textPen->setColor(color);
     m_textUpdate = true;
+    markDirty();
 }
 
 
@@ -167,6 +172,7 @@ void Text::setTextOptions(const QTextOption& option)
 {
     m_options = option;
     m_textUpdate = true;
+    markDirty();
 
     recalcSize();
 }
@@ -176,6 +182,7 @@ void Text::setOutlineColor(const QColor& color)
 {
     m_outlineBrush->setColor(color);
     m_textUpdate = true;
+    markDirty();
 }
 
 
@@ -183,6 +190,7 @@ void Text::setOutlineWidth(int width)
 {
     m_outlineWidth = width;
     m_textUpdate = true;
+    markDirty();
 
     recalcSize();
 }
@@ -200,18 +208,21 @@ void Text::setBlurFactor(float factor)
     }
 
     m_blurFactor = factor;
+    markDirty();
 }
 
 
 void Text::setColumnLimit(int limit)
 {
     m_columnLimit = limit;
+    markDirty();
 }
 
 
 void Text::setRowLimit(int limit)
 {
     m_rowLimit = limit;
+    markDirty();
 }
 
 
@@ -222,17 +233,30 @@ bool Text::create(Window* rt)
         return false;
     }
 
-    m_fbo = new QOpenGLFramebufferObject(qsf(approximateSize()), QOpenGLFramebufferObject::CombinedDepthStencil);
-    m_batch = new SpriteBatch();
+    m_vertexBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+    if (!m_vertexBuffer->create() || !m_vertexBuffer->bind())
+    {
+        return cranError(ERRARG(e_01));
+    }
 
-    if (!m_fbo->isValid() || !m_batch->create(m_fbo, renderTarget()))
+    m_indexBuffer = new QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
+    if (!m_indexBuffer->create() || !m_indexBuffer->bind())
     {
-        return false;
+        return cranError(ERRARG(e_02));
     }
 
-    m_lastWidth = m_fbo->width();
-    m_lastHeight = m_fbo->height();
-    m_paintDevice = new QOpenGLPaintDevice(m_fbo->width(), m_fbo->height());
+    m_vertexBuffer->setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_vertexBuffer->allocate(priv::TextureVertex::size() * 4);
+    m_vertexBuffer->release();
+
+    m_indexBuffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_indexBuffer->allocate(c_ibo.data(), sizeof(uint) * 6);
+    m_indexBuffer->release();
+
+    for (priv::TextureVertex& v : m_vertices)
+    {
+        v.rgba(QColor(Qt::white));
+    }
 
     setDefaultShaderProgram(OpenGLDefaultShaders::get("cb.glsl.text"));
 
@@ -242,9 +266,14 @@ bool Text::create(Window* rt)
 
 void Text::destroy()
 {
-    delete m_fbo;
-    delete m_batch;
-    delete m_paintDevice;
+    releaseEntry();
+
+    delete m_vertexBuffer;
+    delete m_indexBuffer;
+
+    m_vertexBuffer = nullptr;
+    m_indexBuffer = nullptr;
+    m_textUpdate = true;
 
     RenderBase::destroy();
 }
@@ -253,15 +282,13 @@ void Text::destroy()
 void Text::update(const GameTime& time)
 {
     updateTransform(time);
-
-    // Copies all transformations.
-    m_batch->setShaderProgram(shaderProgram());
-    m_batch->copyTransform(this, m_batch);
 }
 
 
 void Text::render()
 {
+    cranProfile("Text::render");
+
     if (!RenderBase::prepareRendering())
     {
         return;
@@ -273,9 +300,23 @@ void Text::render()
         m_textUpdate = false;
     }
 
+    if (m_entry == nullptr)
+    {
+        return;
+    }
+
+    bindObjects();
     updateShader();
+    modifyAttribs();
 
-    m_batch->render();
+    glDebug(gl->glDrawElements(
+                GL_TRIANGLES,
+                QUADS_TO_TRIANGLES(4),
+                GL_UNSIGNED_INT,
+                priv::TextureVertex::xyzOffset()
+                ));
+
+    releaseObjects();
 }
 
 
@@ -316,11 +357,17 @@ void Text::createProperties(TreeModel* model)
 
 void Text::updateProperties()
 {
-    m_rootModelItem->childAt(0)->setValue(htmlToPlain(m_text));
-    m_rootModelItem->childAt(1)->setValue(m_font.toString());
-    m_rootModelItem->childAt(2)->setValue(m_textPen->color());
-    m_rootModelItem->childAt(3)->setValue(m_outlineBrush->color());
-    m_rootModelItem->childAt(4)->setValue(m_outlineWidth);
+    // Converting the text is costly; only done if a setter was called.
+    if (revision() != m_propertyRevision)
+    {
+        m_propertyRevision = revision();
+        m_rootModelItem->childAt(0)->setValue(htmlToPlain(m_text));
+        m_rootModelItem->childAt(1)->setValue(m_font.toString());
+        m_rootModelItem->childAt(2)->setValue(m_textPen->color());
+        m_rootModelItem->childAt(3)->setValue(m_outlineBrush->color());
+        m_rootModelItem->childAt(4)->setValue(m_outlineWidth);
+    }
+
     m_rootModelItem->childAt(5)->setValue(m_textUpdate);
 
     RenderBase::updateProperties();
@@ -329,19 +376,49 @@ void Text::updateProperties()
 
 void Text::updateTexture()
 {
-    auto size = measureText();
-    if (size.width() > m_lastWidth || size.height() > m_lastHeight)
+    // The size is either restricted by the column and row limits or matches
+    // the measured text exactly.
+    QSizeF measured = (m_columnLimit <= 0 || m_rowLimit <= 0)
+            ? measureText()
+            : approximateSize();
+
+    QSize size(qBound(1, qCeil(measured.width()), c_maxSize),
+               qBound(1, qCeil(measured.height()), c_maxSize));
+
+    const QString key = rasterKey(size);
+    if (m_entry != nullptr && key == m_rasterKey)
+    {
+        return;
+    }
+
+    // Releases first, so that the framebuffer of this text can be recycled
+    // right away if no other text shares it.
+    releaseEntry();
+
+    bool created;
+    m_entry = priv::TextCache::acquire(key, size, &created);
+    if (m_entry == nullptr)
     {
-        resizeTexture(size);
+        return;
     }
 
-    renderToTexture();
+    m_rasterKey = key;
+    if (created)
+    {
+        renderToTexture();
+    }
+
+    updateVertices();
 }
 
 
 void Text::updateShader()
 {
-    OpenGLShader* shader = OpenGLDefaultShaders::get("cb.glsl.text");
+    OpenGLShader* shader = shaderProgram();
+
+    glDebug(shader->setSampler(GL_TEXTURE0));
+    glDebug(shader->setMvpMatrix(matrix(this)));
+    glDebug(shader->setOpacity(opacity()));
 
     int uloc = shader->uniformLocation("u_outlineWidth");
     int bloc = shader->uniformLocation("u_blurFactor");
@@ -358,45 +435,48 @@ void Text::updateShader()
 }
 
 
-void Text::resizeTexture(QSizeF base)
+void Text::updateVertices()
 {
-    delete m_fbo;
+    const QSize& size = m_entry->size;
+    const float fw = m_entry->fbo->width();
+    const float fh = m_entry->fbo->height();
+    const float uvW = size.width() / fw;
+    const float uvH = 1.0f - size.height() / fh;
 
-    // Finds a suitable size for the texture.
-    float w, h;
-    if (m_columnLimit <= 0 || m_rowLimit <= 0)
-    {
-        w = base.width();
-        h = base.height();
-    }
-    else
-    {
-        // Restricts the size, no matter what.
-        auto s = approximateSize();
-        w = s.width();
-        h = s.height();
-    }
+    // The text is located in the top-left corner of the framebuffer, which
+    // corresponds to the last rows of the texture.
+    m_vertices.at(0).xyz(0.f,          0.f,           0.f);
+    m_vertices.at(1).xyz(size.width(), 0.f,           0.f);
+    m_vertices.at(2).xyz(size.width(), size.height(), 0.f);
+    m_vertices.at(3).xyz(0.f,          size.height(), 0.f);
 
-    m_fbo = new QOpenGLFramebufferObject(QSize(w, h), QOpenGLFramebufferObject::CombinedDepthStencil);
-    m_batch->destroy();
-    m_batch->create(m_fbo, renderTarget());
+    m_vertices.at(0).uv(0.f, 1.f);
+    m_vertices.at(1).uv(uvW, 1.f);
+    m_vertices.at(2).uv(uvW, uvH);
+    m_vertices.at(3).uv(0.f, uvH);
 
-    m_lastWidth = w;
-    m_lastHeight = h;
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_vertexBuffer->write(
+                GL_ZERO,
+                m_vertices.data(),
+                priv::TextureVertex::size() * 4
+                ));
+    glDebug(m_vertexBuffer->release());
 }
 
 
 void Text::renderToTexture()
 {
+    QOpenGLFramebufferObject* fbo = m_entry->fbo;
+    QOpenGLPaintDevice device(fbo->size());
     QFontMetrics fm(m_font);
     QPoint pt(m_outlineWidth / 2, m_outlineWidth / 2);
 
-    m_fbo->bind();
+    fbo->bind();
 
     // Rendering hints
     QPainter painter;
-    painter.begin(m_paintDevice);
-    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.begin(&device);
     painter.setRenderHints(
             QPainter::HighQualityAntialiasing |
             QPainter::SmoothPixmapTransform   |
@@ -404,6 +484,11 @@ void Text::renderToTexture()
             QPainter::Antialiasing
             );
 
+    // Recycled framebuffers still contain the text they were used for.
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(QRect(QPoint(0, 0), fbo->size()), Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
     // Outline
     if (m_outlineWidth > 0)
     {
@@ -426,12 +511,16 @@ void Text::renderToTexture()
     painter.setPen(*m_textPen);
 
     // Text
-    painter.drawText(QRect(pt, m_fbo->size()), m_text, m_options);
+    painter.drawText(QRect(pt, m_entry->size), m_text, m_options);
     painter.end();
 
     // QPainter changes viewport, blending, smoothing and depth testing,
     // therefore we have to restore states before rendering cranberry objects.
     renderTarget()->restoreOpenGLSettings();
+    if (offscreenRenderer() != 0)
+    {
+        glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
+    }
 }
 
 
@@ -449,11 +538,73 @@ void Text::prepareConstraint()
 
 void Text::recalcSize()
 {
-    QSizeF s = measureText();
-    setSize(s);
+    setSize(measureText());
+}
+
 
-    // Resize the paint device, otherwise text may be rendered out-of-bounds.
-    m_paintDevice->setSize(qsf(s));
+void Text::releaseEntry()
+{
+    if (!m_rasterKey.isEmpty())
+    {
+        priv::TextCache::release(m_rasterKey);
+    }
+
+    m_rasterKey.clear();
+    m_entry = nullptr;
+}
+
+
+void Text::bindObjects()
+{
+    glDebug(gl->glActiveTexture(GL_TEXTURE0));
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, m_entry->fbo->texture()));
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_indexBuffer->bind());
+    glDebug(shaderProgram()->bind());
+}
+
+
+void Text::releaseObjects()
+{
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
+    glDebug(m_vertexBuffer->release());
+    glDebug(m_indexBuffer->release());
+    glDebug(shaderProgram()->release());
+}
+
+
+void Text::modifyAttribs()
+{
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::xyzAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::uvAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::rgbaAttrib()));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::xyzAttrib(),
+                priv::TextureVertex::xyzLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::xyzOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::uvAttrib(),
+                priv::TextureVertex::uvLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::uvOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::rgbaAttrib(),
+                priv::TextureVertex::rgbaLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::rgbaOffset()
+                ));
 }
 
 
@@ -477,6 +628,14 @@ QSizeF Text::measureText()
 {
     prepareConstraint();
 
+    // Identical texts are measured only once.
+    const QString key = layoutKey();
+    QSizeF cached;
+    if (priv::TextCache::findSize(key, &cached))
+    {
+        return cached;
+    }
+
     int flags = m_options.alignment();
     if (m_options.wrapMode() == QTextOption::WordWrap)
     {
@@ -497,5 +656,32 @@ QSizeF Text::measureText()
     if ((sz.width() % 2) != 0) sz.rwidth() += 1;
     if ((sz.height() % 2) != 0) sz.rheight() += 1;
 
+    priv::TextCache::insertSize(key, sz);
     return sz;
 }
+
+
+QString Text::layoutKey() const
+{
+    return QStringList({
+            m_text,
+            m_font.key(),
+            QString::number(static_cast<int>(m_options.alignment())),
+            QString::number(static_cast<int>(m_options.wrapMode())),
+            QString::number(m_outlineWidth),
+            QString::number(m_constraint.width()),
+            QString::number(m_constraint.height())
+            }).join(QChar(0x1F));
+}
+
+
+QString Text::rasterKey(const QSize& size) const
+{
+    return QStringList({
+            layoutKey(),
+            m_textPen->color().name(QColor::HexArgb),
+            m_outlineBrush->color().name(QColor::HexArgb),
+            QString::number(size.width()),
+            QString::number(size.height())
+            }).join(QChar(0x1F));
+}
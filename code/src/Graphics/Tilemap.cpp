@@ -21,10 +21,12 @@
 
 // Cranberry headers
 #include <Cranberry/Graphics/Tilemap.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/OpenGL/OpenGLShader.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
@@ -96,15 +98,19 @@ bool Tilemap::create(
     if (!createInternal(rt)) return false;
 
     // We now have an active context; create texture.
+    TextureCache::Options options;
+    options.wrapMode = QOpenGLTexture::Repeat;
+    options.mipmaps = true;
+
     for (const QString& path : tilesets)
     {
-        QImage img(path);
-        if (img.isNull())
+        QOpenGLTexture* texture = TextureCache::instance()->acquire(path, options);
+        if (texture == nullptr)
         {
             return cranError(ERRARG(e_01));
         }
 
-        m_textures.append(new QOpenGLTexture(img));
+        m_textures.append(texture);
     }
 
     return getUniformLocations();
@@ -204,6 +210,7 @@ bool Tilemap::insertTile(int x, int y, int tileIndex, int tileset)
     }
 
     m_update = true;
+    markDirty();
 
     return true;
 }
@@ -261,6 +268,7 @@ bool Tilemap::replaceTile(int x, int y, int tileIndex, int tileset)
     }
 
     m_update = true;
+    markDirty();
 
     return true;
 }
@@ -291,6 +299,7 @@ void Tilemap::removeAllTiles()
     m_vertices.clear();
     m_ids.clear();
     m_update = true;
+    markDirty();
 }
 
 
@@ -308,7 +317,7 @@ void Tilemap::destroy()
     {
         for (QOpenGLTexture* t : m_textures)
         {
-            delete t;
+            TextureCache::instance()->release(t);
         }
     }
 
@@ -334,6 +343,8 @@ void Tilemap::update(const GameTime& time)
 
 void Tilemap::render()
 {
+    cranProfile("Tilemap::render");
+
     if (!prepareRendering())
     {
         return;
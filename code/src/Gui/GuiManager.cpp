@@ -20,12 +20,14 @@
 
 
 // Cranberry headers
-#include <Cranberry/Graphics/SpriteBatch.hpp>
 #include <Cranberry/Gui/GuiManager.hpp>
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/OpenGL/OpenGLShader.hpp>
+#include <Cranberry/OpenGL/OpenGLVertex.hpp>
 #include <Cranberry/System/Debug.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 
 // Qt headers
@@ -35,6 +37,7 @@
 #include <QQuickRenderControl>
 #include <QQuickWindow>
 #include <QOffscreenSurface>
+#include <QOpenGLBuffer>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
@@ -42,20 +45,23 @@
 
 // Constants
 CRANBERRY_CONST_VAR(QString, e_01, "%0 [%1] - Qml root item is invalid.")
+CRANBERRY_CONST_VAR(QString, e_02, "%0 [%1] - Vertex buffer creation failed.")
 
 
 CRANBERRY_USING_NAMESPACE
 
 
 GuiManager::GuiManager()
-    : m_batch(new SpriteBatch)
-    , m_offscreenSurface(new QOffscreenSurface)
+    : m_offscreenSurface(new QOffscreenSurface)
     , m_renderControl(new QQuickRenderControl)
     , m_renderWindow(new QQuickWindow(m_renderControl))
     , m_qmlEngine(new QQmlEngine)
     , m_qmlComponent(nullptr)
     , m_rootItem(nullptr)
     , m_fbo(nullptr)
+    , m_vertexBuffer(nullptr)
+    , m_effect(EffectNone)
+    , m_updateRate(0)
     , m_requiresUpdate(false)
     , m_isInitialized(false)
     , m_isVisible(true)
@@ -90,7 +96,6 @@ GuiManager::~GuiManager()
 {
     destroy();
 
-    delete m_batch;
     delete m_offscreenSurface;
     delete m_renderControl;
     delete m_renderWindow;
@@ -140,6 +145,12 @@ QPointF GuiManager::topLeft() const
 }
 
 
+int GuiManager::updateRate() const
+{
+    return m_updateRate;
+}
+
+
 void GuiManager::setVisible(bool visible)
 {
     m_isVisible = visible;
@@ -160,7 +171,17 @@ void GuiManager::setTransparentToMouseInput(bool transparent)
 
 void GuiManager::setEffect(Effect effect)
 {
-    m_batch->setEffect(effect);
+    if (effect != m_effect)
+    {
+        m_effect = effect;
+        markDirty();
+    }
+}
+
+
+void GuiManager::setUpdateRate(int rate)
+{
+    m_updateRate = qMax(0, rate);
 }
 
 
@@ -199,7 +220,7 @@ bool GuiManager::create(const QString& qml, Window* rt)
 bool GuiManager::isNull() const
 {
     return RenderBase::isNull()      ||
-           m_batch->isNull()         ||
+           m_vertexBuffer == nullptr ||
            m_qmlComponent == nullptr ||
            m_qmlComponent->isNull()  ||
            m_rootItem == nullptr     ||
@@ -215,50 +236,42 @@ void GuiManager::destroy()
     renderTarget()->unregisterQmlWindow(this);
 
     delete m_fbo;
+    delete m_vertexBuffer;
     delete m_qmlComponent;
     delete m_rootItem;
 
     m_fbo = nullptr;
+    m_vertexBuffer = nullptr;
     m_qmlComponent = nullptr;
     m_rootItem = nullptr;
-
-    m_batch->destroy();
 }
 
 
 void GuiManager::update(const GameTime& time)
 {
     updateTransform(time);
-
-    // Copies all transformations.
-    m_batch->setShaderProgram(shaderProgram());
-    m_batch->copyTransform(this, m_batch);
 }
 
 
 void GuiManager::render()
 {
-    makeCurrent();
-    clearFbo();
+    cranProfile("GuiManager::render");
 
-    if (m_requiresUpdate)
-    {
-        m_renderControl->polishItems();
-        m_renderControl->sync();
-        m_renderControl->render();
-        m_requiresUpdate = false;
-    }
-    else
+    // The last image of the scene stays valid until the scene changes.
+    if (m_requiresUpdate && m_isInitialized)
     {
-        m_renderControl->render();
+        const qint64 interval = (m_updateRate > 0) ? 1000 / m_updateRate : 0;
+        if (!m_updateTimer.isValid() || m_updateTimer.elapsed() >= interval)
+        {
+            renderScene();
+            m_updateTimer.start();
+        }
     }
 
     if (RenderBase::prepareRendering())
     {
-        // Needs to pass OS renderer through.
         renderTarget()->restoreOpenGLSettings();
-        m_batch->setOffscreenRenderer(offscreenRenderer());
-        m_batch->render();
+        drawFbo();
     }
 }
 
@@ -271,12 +284,11 @@ TreeModelItem* GuiManager::rootModelItem()
 
 void GuiManager::createProperties(TreeModel* model)
 {
-    m_batch->createProperties(nullptr);
-
     TreeModelItem* tmiInit = new TreeModelItem("Is initialized?", m_isInitialized);
     TreeModelItem* tmiVisi = new TreeModelItem("Is visible?", m_isVisible);
     TreeModelItem* tmiKeyi = new TreeModelItem("Allow key input?", !m_noKeyInput);
     TreeModelItem* tmiUpda = new TreeModelItem("Requires update?", m_requiresUpdate);
+    TreeModelItem* tmiRate = new TreeModelItem("Update rate", m_updateRate);
     TreeModelItem* tmiGFbo = new TreeModelItem("Qml frame buffer", m_fbo->handle());
 
     m_rootModelItem = new TreeModelItem("GuiManager");
@@ -284,8 +296,8 @@ void GuiManager::createProperties(TreeModel* model)
     m_rootModelItem->appendChild(tmiVisi);
     m_rootModelItem->appendChild(tmiKeyi);
     m_rootModelItem->appendChild(tmiUpda);
+    m_rootModelItem->appendChild(tmiRate);
     m_rootModelItem->appendChild(tmiGFbo);
-    m_rootModelItem->appendChild(m_batch->rootModelItem());
 
     model->addItem(m_rootModelItem);
 
@@ -295,13 +307,12 @@ void GuiManager::createProperties(TreeModel* model)
 
 void GuiManager::updateProperties()
 {
-    m_batch->updateProperties();
-
     m_rootModelItem->childAt(0)->setValue(m_isInitialized);
     m_rootModelItem->childAt(1)->setValue(m_isVisible);
     m_rootModelItem->childAt(2)->setValue(!m_noKeyInput);
     m_rootModelItem->childAt(3)->setValue(m_requiresUpdate);
-    m_rootModelItem->childAt(4)->setValue(m_fbo->handle());
+    m_rootModelItem->childAt(4)->setValue(m_updateRate);
+    m_rootModelItem->childAt(5)->setValue(m_fbo->handle());
 
     RenderBase::updateProperties();
 }
@@ -410,8 +421,8 @@ void GuiManager::createFbo()
         &GuiManagerReceiver::resizeFbo
         );
 
-    // Create the underlying sprite batch.
-    m_batch->create(m_fbo, renderTarget());
+    writeVertices();
+    requestUpdate();
 }
 
 
@@ -420,12 +431,118 @@ void GuiManager::resizeFbo()
     if (m_rootItem)
     {
         makeCurrent();
-        m_batch->destroy();
+        delete m_fbo;
         createFbo();
     }
 }
 
 
+void GuiManager::renderScene()
+{
+    makeCurrent();
+    clearFbo();
+
+    m_renderControl->polishItems();
+    m_renderControl->sync();
+    m_renderControl->render();
+    m_requiresUpdate = false;
+    markDirty();
+}
+
+
+void GuiManager::drawFbo()
+{
+    // Draws the texture of the Qml scene as a single quad.
+    OpenGLShader* program = OpenGLDefaultShaders::getVariant(shaderProgram(), BlendNone, m_effect);
+
+    glDebug(gl->glBindFramebuffer(GL_FRAMEBUFFER, offscreenRenderer()));
+    glDebug(gl->glActiveTexture(GL_TEXTURE0));
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, m_fbo->texture()));
+    glDebug(m_vertexBuffer->bind());
+
+    glDebug(program->bind());
+    glDebug(program->setSampler(GL_TEXTURE0));
+    glDebug(program->setMvpMatrix(matrix(this)));
+    glDebug(program->setOpacity(opacity()));
+    glDebug(program->setEffect(m_effect));
+    glDebug(program->setBlendMode(BlendNone));
+    glDebug(program->setUvOffset(QPointF()));
+
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::xyzAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::uvAttrib()));
+    glDebug(gl->glEnableVertexAttribArray(priv::TextureVertex::rgbaAttrib()));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::xyzAttrib(),
+                priv::TextureVertex::xyzLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::xyzOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::uvAttrib(),
+                priv::TextureVertex::uvLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::uvOffset()
+                ));
+
+    glDebug(gl->glVertexAttribPointer(
+                priv::TextureVertex::rgbaAttrib(),
+                priv::TextureVertex::rgbaLength(),
+                GL_FLOAT,
+                GL_FALSE,
+                priv::TextureVertex::size(),
+                priv::TextureVertex::rgbaOffset()
+                ));
+
+    glDebug(gl->glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+
+    glDebug(program->release());
+    glDebug(m_vertexBuffer->release());
+    glDebug(gl->glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+
+bool GuiManager::writeVertices()
+{
+    if (m_vertexBuffer == nullptr)
+    {
+        m_vertexBuffer = new QOpenGLBuffer(QOpenGLBuffer::VertexBuffer);
+        if (!m_vertexBuffer->create())
+        {
+            delete m_vertexBuffer;
+            m_vertexBuffer = nullptr;
+            return cranError(ERRARG(e_02));
+        }
+    }
+
+    // Textures of framebuffers are upside down.
+    const float w = m_fbo->width();
+    const float h = m_fbo->height();
+    priv::QuadVertices vertices;
+
+    vertices.at(0).xyz(0.f, 0.f, 0.f); vertices.at(0).uv(0.f, 1.f);
+    vertices.at(1).xyz(w,   0.f, 0.f); vertices.at(1).uv(1.f, 1.f);
+    vertices.at(2).xyz(w,   h,   0.f); vertices.at(2).uv(1.f, 0.f);
+    vertices.at(3).xyz(0.f, h,   0.f); vertices.at(3).uv(0.f, 0.f);
+
+    for (priv::TextureVertex& v : vertices)
+    {
+        v.rgba(1.f, 1.f, 1.f, 1.f);
+    }
+
+    glDebug(m_vertexBuffer->bind());
+    glDebug(m_vertexBuffer->allocate(vertices.data(), priv::TextureVertex::size() * 4));
+    glDebug(m_vertexBuffer->release());
+
+    return true;
+}
+
+
 void GuiManager::requestUpdate()
 {
     m_requiresUpdate = true;
@@ -22,19 +22,44 @@
 // Cranberry headers
 #include <Cranberry/Input/KeyboardState.hpp>
 
+// Constants
+CRANBERRY_CONST_VAR(int, c_latinSlots, 512)
+CRANBERRY_CONST_VAR(int, c_specialBase, 0x01000000)
+CRANBERRY_CONST_VAR(int, c_flagDown, 1)
+CRANBERRY_CONST_VAR(int, c_flagPressed, 2)
+CRANBERRY_CONST_VAR(int, c_flagReleased, 4)
+
 
 CRANBERRY_USING_NAMESPACE
 
 
+KeyboardState::KeyboardState()
+    : m_modifiers(0)
+{
+}
+
+
 bool KeyboardState::isKeyDown(int key) const
 {
-    return m_keyStates.value(key);
+    return testKey(m_down, key, c_flagDown);
 }
 
 
 bool KeyboardState::isKeyUp(int key) const
 {
-    return !m_keyStates.value(key);
+    return !testKey(m_down, key, c_flagDown);
+}
+
+
+bool KeyboardState::isKeyPressed(int key) const
+{
+    return testKey(m_pressed, key, c_flagPressed);
+}
+
+
+bool KeyboardState::isKeyReleased(int key) const
+{
+    return testKey(m_released, key, c_flagReleased);
 }
 
 
@@ -52,7 +77,25 @@ bool KeyboardState::isModifierUp(int mod) const
 
 void KeyboardState::setKeyState(int key, bool state)
 {
-    m_keyStates[key] = state;
+    const int i = slot(key);
+    if (i >= 0)
+    {
+        if (m_down.test(i) != state)
+        {
+            (state ? m_pressed : m_released).set(i);
+        }
+
+        m_down.set(i, state);
+        return;
+    }
+
+    int& flags = m_otherKeys[key];
+    if (((flags & c_flagDown) != 0) != state)
+    {
+        flags |= (state) ? c_flagPressed : c_flagReleased;
+    }
+
+    flags = (state) ? (flags | c_flagDown) : (flags & ~c_flagDown);
 }
 
 
@@ -60,3 +103,45 @@ void KeyboardState::setModifiers(int mods)
 {
     m_modifiers = mods;
 }
+
+
+void KeyboardState::advanceFrame()
+{
+    m_pressed.reset();
+    m_released.reset();
+
+    for (auto it = m_otherKeys.begin(); it != m_otherKeys.end();)
+    {
+        it.value() &= c_flagDown;
+        it = (it.value() == 0) ? m_otherKeys.erase(it) : it + 1;
+    }
+}
+
+
+int KeyboardState::slot(int key)
+{
+    // Latin keys occupy the lower half, special keys (Qt::Key_Escape and
+    // onwards) the upper half.
+    if (key >= 0 && key < c_latinSlots)
+    {
+        return key;
+    }
+    if (key >= c_specialBase && key < c_specialBase + c_latinSlots)
+    {
+        return c_latinSlots + (key - c_specialBase);
+    }
+
+    return -1;
+}
+
+
+bool KeyboardState::testKey(const KeyBits& bits, int key, int flag) const
+{
+    const int i = slot(key);
+    if (i >= 0)
+    {
+        return bits.test(i);
+    }
+
+    return (m_otherKeys.value(key) & flag) != 0;
+}
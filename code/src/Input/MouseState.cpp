@@ -26,19 +26,53 @@
 CRANBERRY_USING_NAMESPACE
 
 
+MouseState::MouseState()
+    : m_down(0)
+    , m_pressed(0)
+    , m_released(0)
+{
+}
+
+
 bool MouseState::isButtonDown(int button) const
 {
-    return m_buttonStates.value(button);
+    return (m_down & quint32(button)) != 0;
 }
 
 
 bool MouseState::isButtonUp(int button) const
 {
-    return !m_buttonStates.value(button);
+    return (m_down & quint32(button)) == 0;
+}
+
+
+bool MouseState::isButtonPressed(int button) const
+{
+    return (m_pressed & quint32(button)) != 0;
+}
+
+
+bool MouseState::isButtonReleased(int button) const
+{
+    return (m_released & quint32(button)) != 0;
 }
 
 
 void MouseState::setButtonState(int button, bool state)
 {
-    m_buttonStates[button] = state;
+    // Qt::MouseButton values are single bits.
+    const quint32 bit = quint32(button);
+    if (((m_down & bit) != 0) != state)
+    {
+        (state ? m_pressed : m_released) |= bit;
+    }
+
+    m_down = (state) ? (m_down | bit) : (m_down & ~bit);
+}
+
+
+void MouseState::advanceFrame()
+{
+    m_pressed = 0;
+    m_released = 0;
 }
@@ -22,11 +22,14 @@
 // Cranberry headers
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
 
 // Qt headers
 #include <QHash>
 #include <QMutex>
 #include <QVector>
+#include <QOpenGLContext>
 #include <QOpenGLShaderProgram>
 
 // Standard headers
@@ -36,64 +39,180 @@
 CRANBERRY_USING_NAMESPACE
 
 
+// Types
+struct DeferredShader
+{
+    const char* vert;     ///< Base name of the vertex shader
+    const char* frag;     ///< Base name of the fragment shader
+    const char* define;   ///< Definition for a shared fragment shader
+    bool        update;   ///< Update u_time every frame?
+    bool        variants; ///< Has compile-time variants?
+};
+
+typedef QHash<QString, DeferredShader> DeferredShaderMap;
+typedef QHash<OpenGLShader*, DeferredShader> VariantSources;
+
+
 CRANBERRY_CONST_VAR(QString, c_path, ":/cb/glsl/%0_%1.glsl")
+CRANBERRY_CONST_VAR(QString, e_01, "OpenGLDefaultShaders: %0 requested without a current OpenGL context.")
+CRANBERRY_CONST_VAR(QString, e_02, "OpenGLDefaultShaders: %0 could not be linked.")
 CRANBERRY_GLOBAL_VAR(ShaderMap, g_programs)
+CRANBERRY_GLOBAL_VAR(DeferredShaderMap, g_deferred)
 CRANBERRY_GLOBAL_VAR(ShaderUpdateList, g_updateList)
+CRANBERRY_GLOBAL_VAR(VariantCache, g_variants)
+CRANBERRY_GLOBAL_VAR(VariantSources, g_variantSources)
 CRANBERRY_GLOBAL_VAR(QMutex, g_mutex)
 
 
-bool OpenGLDefaultShaders::add(
-        const QString& name,
-        OpenGLShader* program,
-        bool update
-        )
+namespace
 {
-    if (g_programs.contains(name))
+    ////////////////////////////////////////////////////////////////////////////
+    /// Inserts \p program; g_mutex must be locked by the caller.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool insertProgram(const QString& name, OpenGLShader* program, bool update)
     {
-        return false;
+        if (g_programs.contains(name) || g_deferred.contains(name))
+        {
+            return false;
+        }
+        else if (update)
+        {
+            g_updateList.append(program);
+        }
+
+        g_programs.insert(name, program);
+
+        return true;
     }
-    else if (update)
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Deletes the program \p name; g_mutex must be locked by the caller.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    bool eraseProgram(const QString& name)
     {
-        g_updateList.append(program);
+        if (g_deferred.remove(name) > 0)
+        {
+            return true;
+        }
+        else if (!g_programs.contains(name))
+        {
+            return false;
+        }
+
+        auto* program = g_programs.take(name);
+        g_updateList.removeOne(program);
+        delete program;
+        return true;
     }
+}
 
-    g_programs.insert(name, program);
 
-    return true;
+bool OpenGLDefaultShaders::add(
+        const QString& name,
+        OpenGLShader* program,
+        bool update
+        )
+{
+    QMutexLocker locker(&g_mutex);
+    return insertProgram(name, program, update);
 }
 
 
 bool OpenGLDefaultShaders::remove(const QString& name)
 {
-    if (!g_programs.contains(name))
+    QMutexLocker locker(&g_mutex);
+    return eraseProgram(name);
+}
+
+
+OpenGLShader* OpenGLDefaultShaders::get(const QString& name)
+{
+    QMutexLocker locker(&g_mutex);
+
+    OpenGLShader* result = g_programs.value(name, nullptr);
+    if (result == nullptr && g_deferred.contains(name))
     {
-        return false;
+        // Compiling requires the context; the program stays deferred and is
+        // compiled by the next call from the render thread.
+        if (QOpenGLContext::currentContext() == nullptr)
+        {
+            cranError(e_01.arg(name));
+            return nullptr;
+        }
+
+        result = cranberryCompileShader(name);
     }
 
-    auto* program = g_programs.take(name);
-    delete program;
-    return true;
+    return result;
 }
 
 
-OpenGLShader* OpenGLDefaultShaders::get(const QString& name)
+OpenGLShader* OpenGLDefaultShaders::getVariant(
+        OpenGLShader* program,
+        BlendModes modes,
+        Effect effect
+        )
 {
-    OpenGLShader* result = nullptr;
+    QMutexLocker locker(&g_mutex);
 
-    g_mutex.lock();
-    result = g_programs[name];
-    g_mutex.unlock();
+    auto source = g_variantSources.constFind(program);
+    if (source == g_variantSources.cend())
+    {
+        return program;
+    }
 
-    return result;
+    const int key = (static_cast<int>(modes) << 8) | static_cast<int>(effect);
+    VariantMap& variants = g_variants[program];
+    OpenGLShader* variant = variants.value(key, nullptr);
+
+    if (variant == nullptr)
+    {
+        // Falls back to the uber-shader until there is a context.
+        if (QOpenGLContext::currentContext() == nullptr)
+        {
+            return program;
+        }
+
+        QStringList defines = {
+            "CB_VARIANT",
+            QString("CB_BLEND_MODE %0").arg(static_cast<int>(modes)),
+            QString("CB_EFFECT %0").arg(static_cast<int>(effect))
+            };
+
+        if (source->define != nullptr)
+        {
+            defines.append(source->define);
+        }
+
+        variant = cranberryGetShader(source->vert, source->frag, defines);
+
+        // Falls back to the uber-shader rather than drawing nothing.
+        if (!variant->isLinked())
+        {
+            delete variant;
+            variant = program;
+        }
+
+        variants.insert(key, variant);
+    }
+
+    return variant;
 }
 
 
-OpenGLShader* OpenGLDefaultShaders::cranberryGetShader(const char* name)
+OpenGLShader* OpenGLDefaultShaders::cranberryGetShader(
+        const char* vert,
+        const char* frag,
+        const QStringList& defines
+        )
 {
-    QString vpath = c_path.arg(name, "vert");
-    QString fpath = c_path.arg(name, "frag");
+    QString vpath = c_path.arg(vert, "vert");
+    QString fpath = c_path.arg(frag, "frag");
     OpenGLShader* s = new OpenGLShader;
 
+    s->setDefines(defines);
     s->setVertexShaderFromFile(vpath);
     s->setFragmentShaderFromFile(fpath);
 
@@ -101,51 +220,144 @@ OpenGLShader* OpenGLDefaultShaders::cranberryGetShader(const char* name)
 }
 
 
+void OpenGLDefaultShaders::cranberryDeferShader(
+        const QString& name,
+        const char* file,
+        bool update,
+        bool variants
+        )
+{
+    g_deferred.insert(name, { file, file, nullptr, update, variants });
+}
+
+
+void OpenGLDefaultShaders::cranberryDeferShader(
+        const QString& name,
+        const char* vert,
+        const char* frag,
+        const char* define,
+        bool update,
+        bool variants
+        )
+{
+    // Compiles the fragment shader of another program with the given define,
+    // so that it needs no copy of its own.
+    g_deferred.insert(name, { vert, frag, define, update, variants });
+}
+
+
+OpenGLShader* OpenGLDefaultShaders::cranberryCompileShader(const QString& name)
+{
+    cranProfile("OpenGLDefaultShaders::compile");
+
+    const DeferredShader shader = g_deferred.take(name);
+    OpenGLShader* program = cranberryGetShader(
+                shader.vert,
+                shader.frag,
+                (shader.define != nullptr) ? QStringList(shader.define) : QStringList()
+                );
+
+    // A broken program is reported once rather than recompiled on every
+    // call; get() returns a null pointer for it from now on.
+    if (!program->isLinked())
+    {
+        delete program;
+        cranError(e_02.arg(name));
+        return nullptr;
+    }
+
+    insertProgram(name, program, shader.update);
+    if (shader.variants)
+    {
+        g_variantSources.insert(program, shader);
+    }
+
+    // Leaves no program bound, since this may happen in the middle of a frame.
+    glDebug(cranberryInitShader(name, program->program()));
+    glDebug(program->program()->release());
+
+    return program;
+}
+
+
 void OpenGLDefaultShaders::cranberryLoadDefaultShaders()
 {
+    QMutexLocker locker(&g_mutex);
+
+    // Programs are compiled on first use; see get().
     // Normal shaders
-    add("cb.glsl.texture", cranberryGetShader("texture"));
-    add("cb.glsl.shape", cranberryGetShader("shape"));
-    add("cb.glsl.hatch", cranberryGetShader("hatch"));
-    add("cb.glsl.lens", cranberryGetShader("lens"));
-    add("cb.glsl.kaleido", cranberryGetShader("kaleido"));
-    add("cb.glsl.spiral", cranberryGetShader("spiral"));
-    add("cb.glsl.fisheye", cranberryGetShader("fisheye"));
-    add("cb.glsl.radialblur", cranberryGetShader("radialblur"));
-    add("cb.glsl.blur", cranberryGetShader("blur"));
-    add("cb.glsl.pixel", cranberryGetShader("pixel"));
-    add("cb.glsl.tilemap", cranberryGetShader("tilemap"));
-    add("cb.glsl.text", cranberryGetShader("text"));
+    cranberryDeferShader("cb.glsl.texture", "texture", false, true);
+    cranberryDeferShader("cb.glsl.particle", "particle", "texture", "CB_PARTICLE", false, true);
+    cranberryDeferShader("cb.glsl.shape", "shape");
+    cranberryDeferShader("cb.glsl.hatch", "hatch");
+    cranberryDeferShader("cb.glsl.lens", "lens");
+    cranberryDeferShader("cb.glsl.kaleido", "kaleido");
+    cranberryDeferShader("cb.glsl.spiral", "spiral");
+    cranberryDeferShader("cb.glsl.fisheye", "fisheye");
+    cranberryDeferShader("cb.glsl.radialblur", "radialblur");
+    cranberryDeferShader("cb.glsl.blur", "blur");
+    cranberryDeferShader("cb.glsl.pixel", "pixel");
+    cranberryDeferShader("cb.glsl.tilemap", "tilemap");
+    cranberryDeferShader("cb.glsl.text", "text");
+    cranberryDeferShader("cb.glsl.sdftext", "sdftext");
+    cranberryDeferShader("cb.glsl.gauss", "gauss");
+    cranberryDeferShader("cb.glsl.bright", "bright");
+    cranberryDeferShader("cb.glsl.bloom", "bloom");
 
     // Updatable shaders
-    add("cb.glsl.film", cranberryGetShader("film"), true);
+    cranberryDeferShader("cb.glsl.film", "film", true);
 }
 
 
 void OpenGLDefaultShaders::cranberryFreeDefaultShaders()
 {
+    QMutexLocker locker(&g_mutex);
+
     g_updateList.clear();
+    g_deferred.clear();
 
-    remove("cb.glsl.texture");
-    remove("cb.glsl.shape");
-    remove("cb.glsl.film");
-    remove("cb.glsl.blur");
-    remove("cb.glsl.pixel");
-    remove("cb.glsl.hatch");
-    remove("cb.glsl.lens");
-    remove("cb.glsl.kaleido");
-    remove("cb.glsl.spiral");
-    remove("cb.glsl.fisheye");
-    remove("cb.glsl.radialblur");
-    remove("cb.glsl.tilemap");
-    remove("cb.glsl.text");
+    for (auto it = g_variants.begin(); it != g_variants.end(); ++it)
+    {
+        for (OpenGLShader* variant : it.value())
+        {
+            if (variant != it.key())
+            {
+                delete variant;
+            }
+        }
+    }
+
+    g_variants.clear();
+    g_variantSources.clear();
+
+    eraseProgram("cb.glsl.texture");
+    eraseProgram("cb.glsl.particle");
+    eraseProgram("cb.glsl.shape");
+    eraseProgram("cb.glsl.film");
+    eraseProgram("cb.glsl.blur");
+    eraseProgram("cb.glsl.pixel");
+    eraseProgram("cb.glsl.hatch");
+    eraseProgram("cb.glsl.lens");
+    eraseProgram("cb.glsl.kaleido");
+    eraseProgram("cb.glsl.spiral");
+    eraseProgram("cb.glsl.fisheye");
+    eraseProgram("cb.glsl.radialblur");
+    eraseProgram("cb.glsl.tilemap");
+    eraseProgram("cb.glsl.text");
+    eraseProgram("cb.glsl.sdftext");
+    eraseProgram("cb.glsl.gauss");
+    eraseProgram("cb.glsl.bright");
+    eraseProgram("cb.glsl.bloom");
 }
 
 
-void OpenGLDefaultShaders::cranberryInitDefaultShaders()
+void OpenGLDefaultShaders::cranberryInitShader(
+        const QString& name,
+        QOpenGLShaderProgram* p
+        )
 {
     // Film
-    QOpenGLShaderProgram* p = get("cb.glsl.film")->program();
+    if (name == "cb.glsl.film")
     {
         p->bind();
         p->setUniformValue("u_time", (float) clock());
@@ -155,7 +367,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Blur
-    p = get("cb.glsl.blur")->program();
+    if (name == "cb.glsl.blur")
     {
         p->bind();
         p->setUniformValue("u_blurH", 1.0f);
@@ -163,7 +375,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Pixel
-    p = get("cb.glsl.pixel")->program();
+    if (name == "cb.glsl.pixel")
     {
         p->bind();
         p->setUniformValue("u_pixelW", 8.0f);
@@ -171,7 +383,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Hatch
-    p = get("cb.glsl.hatch")->program();
+    if (name == "cb.glsl.hatch")
     {
         p->bind();
         p->setUniformValue("u_offset", 5.0f);
@@ -182,7 +394,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Lens
-    p = get("cb.glsl.lens")->program();
+    if (name == "cb.glsl.lens")
     {
         p->bind();
         p->setUniformValue("u_radiusX", 0.50f);
@@ -191,7 +403,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Kaleido
-    p = get("cb.glsl.kaleido")->program();
+    if (name == "cb.glsl.kaleido")
     {
         p->bind();
         p->setUniformValue("u_sides", 6.0f);
@@ -199,7 +411,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Spiral
-    p = get("cb.glsl.spiral")->program();
+    if (name == "cb.glsl.spiral")
     {
         p->bind();
         p->setUniformValue("u_angle", 0.8f);
@@ -209,7 +421,7 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Fisheye
-    p = get("cb.glsl.fisheye")->program();
+    if (name == "cb.glsl.fisheye")
     {
         p->bind();
         p->setUniformValue("u_radius", 3.0f);
@@ -217,18 +429,42 @@ void OpenGLDefaultShaders::cranberryInitDefaultShaders()
     }
 
     // Radial blur
-    p = get("cb.glsl.radialblur")->program();
+    if (name == "cb.glsl.radialblur")
     {
         p->bind();
         p->setUniformValue("u_blur", 0.1f);
         p->setUniformValue("u_bright", 1.0f);
         p->setUniformValue("u_offset", 30);
     }
+
+    // Gauss
+    if (name == "cb.glsl.gauss")
+    {
+        p->bind();
+        p->setUniformValue("u_direction", QVector2D(1.f, 0.f));
+        p->setUniformValue("u_radius", 1.0f);
+    }
+
+    // Bright
+    if (name == "cb.glsl.bright")
+    {
+        p->bind();
+        p->setUniformValue("u_threshold", 0.8f);
+    }
+
+    // Bloom
+    if (name == "cb.glsl.bloom")
+    {
+        p->bind();
+        p->setUniformValue("u_intensity", 1.0f);
+    }
 }
 
 
 void OpenGLDefaultShaders::cranberryUpdateDefaultShaders()
 {
+    QMutexLocker locker(&g_mutex);
+
     int t = static_cast<int>(clock());
     for (OpenGLShader* s : g_updateList)
     {
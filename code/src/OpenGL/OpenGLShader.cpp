@@ -63,6 +63,8 @@ OpenGLShader::OpenGLShader()
     , m_locMode(-1)
     , m_locEffect(-1)
     , m_locSize(-1)
+    , m_locRect(-1)
+    , m_locOffset(-1)
 {
 }
 
@@ -96,6 +98,24 @@ QOpenGLShader* OpenGLShader::fragmentShader()
 }
 
 
+bool OpenGLShader::isLinked() const
+{
+    return m_program != nullptr && m_program->isLinked();
+}
+
+
+const QStringList& OpenGLShader::defines() const
+{
+    return m_defines;
+}
+
+
+void OpenGLShader::setDefines(const QStringList& defines)
+{
+    m_defines = defines;
+}
+
+
 bool OpenGLShader::setVertexShaderFromCode(const QString& code)
 {
     return loadShaderPrivate(QOpenGLShader::Vertex, code);
@@ -198,6 +218,21 @@ void OpenGLShader::setSourceRect(const QRectF& rect)
 }
 
 
+bool OpenGLShader::hasUvOffset() const
+{
+    return m_locOffset != -1;
+}
+
+
+void OpenGLShader::setUvOffset(const QPointF& offset)
+{
+    if (m_locOffset != -1)
+    {
+        ensure_bound(glDebug(m_program->setUniformValue(m_locOffset, offset)));
+    }
+}
+
+
 int OpenGLShader::uniformLocation(const QString& name)
 {
     return m_program->uniformLocation(name);
@@ -310,31 +345,59 @@ bool OpenGLShader::loadShaderPrivate(int type, QString code)
         code.replace("%0", "330");
     }
 
-    // Adds the shader to the program and links it if required.
-    if (!m_program->addShaderFromSourceCode(shaderType, code))
+    // Inserts the definitions after #version, which must come first.
+    if (!m_defines.isEmpty())
     {
-        return cranError(e_03 + m_program->log());
+        const int version = code.indexOf("#version");
+        const int line = (version < 0) ? -1 : code.indexOf('\n', version);
+
+        QString block;
+        for (const QString& define : m_defines)
+        {
+            block += "#define " + define + "\n";
+        }
+
+        code.insert(line + 1, block);
     }
 
+    // Defers compilation until both shaders are known, so that the linked
+    // program can be restored from Qt's program binary disk cache instead.
     if (shaderType == QOpenGLShader::Vertex)
     {
-        m_vertex = m_program->shaders().last();
+        m_vertCode = code;
     }
     else
     {
-        m_fragment = m_program->shaders().last();
+        m_fragCode = code;
     }
 
-    if (m_vertex != nullptr && m_fragment != nullptr)
+    if (m_vertCode.isEmpty() || m_fragCode.isEmpty())
     {
-        if (!link())
-        {
-            return false;
-        }
+        return true;
+    }
 
-        glDebug(afterLink());
+    auto addShader = [this] (QOpenGLShader::ShaderType type, const QString& source)
+    {
+    #if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+        return m_program->addCacheableShaderFromSourceCode(type, source);
+    #else
+        return m_program->addShaderFromSourceCode(type, source);
+    #endif
+    };
+
+    if (!addShader(QOpenGLShader::Vertex, m_vertCode) ||
+        !addShader(QOpenGLShader::Fragment, m_fragCode))
+    {
+        return cranError(e_03 + m_program->log());
+    }
+
+    if (!link())
+    {
+        return false;
     }
 
+    glDebug(afterLink());
+
     return true;
 }
 
@@ -346,6 +409,19 @@ bool OpenGLShader::link()
         return cranError(e_04.arg(m_vertName, m_fragName) + m_program->log());
     }
 
+    // No shader is compiled at all if the binary was found in the cache.
+    for (QOpenGLShader* shader : m_program->shaders())
+    {
+        if (shader->shaderType() == QOpenGLShader::Vertex)
+        {
+            m_vertex = shader;
+        }
+        else
+        {
+            m_fragment = shader;
+        }
+    }
+
     // Loads common cranberry uniforms.
     glDebug(m_locTex = m_program->uniformLocation("u_tex"));
     glDebug(m_locMvp = m_program->uniformLocation("u_mvp"));
@@ -354,17 +430,23 @@ bool OpenGLShader::link()
     glDebug(m_locEffect = m_program->uniformLocation("u_effect"));
     glDebug(m_locSize = m_program->uniformLocation("u_winSize"));
     glDebug(m_locRect = m_program->uniformLocation("u_sourceRect"));
+    glDebug(m_locOffset = m_program->uniformLocation("u_uvOffset"));
 
     // Stores all invalid attributes in a list.
     QStringList attr;
     if (m_locTex == -1) attr << "u_tex";
     if (m_locMvp == -1) attr << "u_mvp";
     if (m_locOpac == -1) attr << "u_opac";
-    if (m_locMode == -1) attr << "u_mode";
     if (m_locSize == -1) attr << "u_winSize";
-    if (m_locEffect == -1) attr << "u_effect";
     if (m_locRect == -1) attr << "u_sourceRect";
 
+    // Variants usually have the blend mode and effect compiled in.
+    if (m_defines.isEmpty())
+    {
+        if (m_locMode == -1) attr << "u_mode";
+        if (m_locEffect == -1) attr << "u_effect";
+    }
+
     if (!attr.isEmpty())
     {
         return cranWarning(e_06.arg(m_vertName, m_fragName, attr.join(", ")));
@@ -174,3 +174,50 @@ const float* priv::MapVertex::data() const
 {
     return m_fields;
 }
+
+
+priv::GlyphVertex::GlyphVertex()
+{
+    for (float& field : m_fields)
+    {
+        field = 0;
+    }
+}
+
+
+void priv::GlyphVertex::xy(float x, float y)
+{
+    m_fields[0] = x;
+    m_fields[1] = y;
+}
+
+
+void priv::GlyphVertex::uv(float u, float v)
+{
+    m_fields[2] = u;
+    m_fields[3] = v;
+}
+
+
+void priv::GlyphVertex::rgba(const QColor& color)
+{
+    m_fields[4] = color.redF();
+    m_fields[5] = color.greenF();
+    m_fields[6] = color.blueF();
+    m_fields[7] = color.alphaF();
+}
+
+
+void priv::GlyphVertex::outline(const QColor& color)
+{
+    m_fields[8] = color.redF();
+    m_fields[9] = color.greenF();
+    m_fields[10] = color.blueF();
+    m_fields[11] = color.alphaF();
+}
+
+
+const float* priv::GlyphVertex::data() const
+{
+    return m_fields;
+}
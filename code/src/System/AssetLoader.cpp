@@ -0,0 +1,527 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/AssetLoader.hpp>
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
+
+// Qt headers
+#include <QCoreApplication>
+#include <QFile>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLTexture>
+#include <QThread>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "AssetLoader: Asset %0 could not be loaded.")
+CRANBERRY_CONST_VAR(QString, e_02, "AssetLoader: Worker context could not be created; loading synchronously.")
+CRANBERRY_CONST_VAR(qreal, c_decoded, 0.4)
+CRANBERRY_CONST_VAR(qreal, c_uploaded, 0.8)
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Loads assets with its own context, which shares resources with all
+/// windows. The surface and the context must be created on the GUI thread.
+///
+////////////////////////////////////////////////////////////////////////////////
+class AssetWorker : public QThread
+{
+public:
+
+    AssetWorker(AssetLoader* loader)
+        : m_loader(loader)
+        , m_surface(nullptr)
+        , m_context(nullptr)
+    {
+        setObjectName("AssetWorker");
+    }
+
+    bool createContext()
+    {
+        QOpenGLContext* share = QOpenGLContext::globalShareContext();
+        if (share == nullptr)
+        {
+            return false;
+        }
+
+        m_surface = new QOffscreenSurface;
+        m_surface->setFormat(share->format());
+        m_surface->create();
+
+        m_context = new QOpenGLContext;
+        m_context->setFormat(share->format());
+        m_context->setShareContext(share);
+
+        if (!m_surface->isValid() || !m_context->create())
+        {
+            return false;
+        }
+
+        m_context->moveToThread(this);
+        return true;
+    }
+
+    void destroyContext()
+    {
+        delete m_context;
+        delete m_surface;
+
+        m_context = nullptr;
+        m_surface = nullptr;
+    }
+
+    static void load(AssetLoader* loader, AssetLoader::Job& job, bool useFences)
+    {
+        cranProfile("AssetLoader::load");
+
+        AssetLoader::Asset& asset = job.asset;
+        QFile file(asset.path);
+
+        switch (asset.type)
+        {
+        case AssetLoader::AssetTexture:
+        {
+            QImage img(asset.path);
+            if (img.isNull()) return;
+
+            loader->setProgress(asset.id, c_decoded);
+
+            asset.texture = TextureCache::upload(img, job.options);
+            if (asset.texture == nullptr) return;
+
+            // The texture may only be used by other contexts once the GPU
+            // finished the upload.
+            QOpenGLExtraFunctions* gl = QOpenGLContext::currentContext()->extraFunctions();
+            if (useFences)
+            {
+                job.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                gl->glFlush();
+            }
+            else
+            {
+                gl->glFinish();
+            }
+
+            loader->setProgress(asset.id, c_uploaded);
+            break;
+        }
+        case AssetLoader::AssetJson:
+        {
+            if (!file.open(QIODevice::ReadOnly)) return;
+
+            QJsonParseError error;
+            asset.json = QJsonDocument::fromJson(file.readAll(), &error);
+            if (error.error != QJsonParseError::NoError) return;
+
+            break;
+        }
+        case AssetLoader::AssetXml:
+        {
+            if (!file.open(QIODevice::ReadOnly)) return;
+            if (!asset.xml.setContent(&file)) return;
+
+            break;
+        }
+        }
+
+        asset.success = true;
+    }
+
+
+protected:
+
+    void run() override
+    {
+        m_context->makeCurrent(m_surface);
+
+        // Fence sync objects require OpenGL 3.2 or OpenGL ES 3.0.
+        const QSurfaceFormat format = m_context->format();
+        const bool useFences = m_context->isOpenGLES()
+                ? format.majorVersion() >= 3
+                : format.version() >= qMakePair(3, 2);
+
+        AssetLoader::Job job;
+        while (m_loader->takeJob(job))
+        {
+            load(m_loader, job, useFences);
+            m_loader->finishJob(job);
+        }
+
+        // Hands the context back, so that it can be destroyed.
+        m_context->doneCurrent();
+        m_context->moveToThread(QCoreApplication::instance()->thread());
+    }
+
+
+private:
+
+    AssetLoader*       m_loader;
+    QOffscreenSurface* m_surface;
+    QOpenGLContext*    m_context;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+CRANBERRY_USING_NAMESPACE
+
+
+AssetLoader::AssetLoader()
+    : m_workerCount(qMax(1, QThread::idealThreadCount() / 2))
+    , m_nextId(1)
+    , m_requested(0)
+    , m_quit(false)
+    , m_started(false)
+{
+}
+
+
+AssetLoader::~AssetLoader()
+{
+    stop();
+}
+
+
+AssetLoader* AssetLoader::instance()
+{
+    static AssetLoader loader;
+    return &loader;
+}
+
+
+AssetLoaderEmitter* AssetLoader::signals()
+{
+    return &m_emitter;
+}
+
+
+int AssetLoader::workerCount() const
+{
+    return m_workerCount;
+}
+
+
+void AssetLoader::setWorkerCount(int count)
+{
+    m_workerCount = qMax(1, count);
+}
+
+
+int AssetLoader::loadTexture(
+        const QString& path,
+        const Callback& callback,
+        const TextureCache::Options& options
+        )
+{
+    Job job;
+    job.options = options;
+
+    return enqueue(AssetTexture, path, callback, job);
+}
+
+
+int AssetLoader::loadJson(const QString& path, const Callback& callback)
+{
+    return enqueue(AssetJson, path, callback, Job());
+}
+
+
+int AssetLoader::loadXml(const QString& path, const Callback& callback)
+{
+    return enqueue(AssetXml, path, callback, Job());
+}
+
+
+qreal AssetLoader::progress(int id) const
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (id <= 0 || id >= m_nextId)
+    {
+        return 0.0;
+    }
+
+    return m_progress.value(id, 1.0);
+}
+
+
+qreal AssetLoader::progress() const
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (m_requested == 0)
+    {
+        return 1.0;
+    }
+
+    qreal sum = m_requested - m_progress.size();
+    for (qreal p : m_progress)
+    {
+        sum += p;
+    }
+
+    return sum / m_requested;
+}
+
+
+bool AssetLoader::isLoading() const
+{
+    QMutexLocker lock(&m_mutex);
+    return !m_progress.isEmpty();
+}
+
+
+void AssetLoader::update()
+{
+    QList<Job> ready;
+
+    // Collects all jobs whose uploads are complete.
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_finished.isEmpty())
+        {
+            return;
+        }
+
+        QOpenGLExtraFunctions* gl = QOpenGLContext::currentContext()->extraFunctions();
+        for (int i = 0; i < m_finished.size(); i++)
+        {
+            Job& job = m_finished[i];
+            if (job.fence != nullptr)
+            {
+                GLsync sync = static_cast<GLsync>(job.fence);
+                GLenum state = gl->glClientWaitSync(sync, 0, 0);
+                if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED)
+                {
+                    continue;
+                }
+
+                gl->glDeleteSync(sync);
+                job.fence = nullptr;
+            }
+
+            ready.append(m_finished.takeAt(i--));
+        }
+    }
+
+    cranProfile("AssetLoader::deliver");
+
+    for (Job& job : ready)
+    {
+        deliver(job);
+    }
+}
+
+
+void AssetLoader::stop()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_quit = true;
+        m_queue.clear();
+        m_wake.wakeAll();
+    }
+
+    for (priv::AssetWorker* worker : m_workers)
+    {
+        worker->wait();
+    }
+
+    // Discards all assets that were not delivered yet.
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    for (const Job& job : m_finished)
+    {
+        if (context != nullptr && job.fence != nullptr)
+        {
+            context->extraFunctions()->glDeleteSync(static_cast<GLsync>(job.fence));
+        }
+        if (context != nullptr)
+        {
+            delete job.asset.texture;
+        }
+    }
+
+    m_finished.clear();
+    m_progress.clear();
+    m_requested = 0;
+}
+
+
+void AssetLoader::destroy()
+{
+    for (priv::AssetWorker* worker : m_workers)
+    {
+        worker->destroyContext();
+        delete worker;
+    }
+
+    m_workers.clear();
+    m_quit = false;
+    m_started = false;
+}
+
+
+int AssetLoader::enqueue(
+        AssetType type,
+        const QString& path,
+        const Callback& callback,
+        Job job
+        )
+{
+    if (!m_started)
+    {
+        start();
+    }
+
+    job.asset.id = m_nextId++;
+    job.asset.type = type;
+    job.asset.path = path;
+    job.asset.success = false;
+    job.asset.texture = nullptr;
+    job.callback = callback;
+    job.fence = nullptr;
+
+    // Without workers, the asset is loaded right away in the current context.
+    if (m_workers.isEmpty())
+    {
+        {
+            QMutexLocker lock(&m_mutex);
+            m_progress.insert(job.asset.id, 0.0);
+            m_requested++;
+        }
+
+        priv::AssetWorker::load(this, job, false);
+        finishJob(job);
+        return job.asset.id;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    m_progress.insert(job.asset.id, 0.0);
+    m_queue.enqueue(job);
+    m_requested++;
+    m_wake.wakeOne();
+
+    return job.asset.id;
+}
+
+
+bool AssetLoader::takeJob(Job& job)
+{
+    QMutexLocker lock(&m_mutex);
+    while (m_queue.isEmpty() && !m_quit)
+    {
+        m_wake.wait(&m_mutex);
+    }
+
+    if (m_quit)
+    {
+        return false;
+    }
+
+    job = m_queue.dequeue();
+    return true;
+}
+
+
+void AssetLoader::finishJob(const Job& job)
+{
+    QMutexLocker lock(&m_mutex);
+    m_finished.append(job);
+}
+
+
+void AssetLoader::setProgress(int id, qreal progress)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_progress.contains(id))
+    {
+        m_progress[id] = progress;
+    }
+}
+
+
+void AssetLoader::deliver(Job& job)
+{
+    Asset& asset = job.asset;
+    if (!asset.success)
+    {
+        cranError(e_01.arg(asset.path));
+        delete asset.texture;
+        asset.texture = nullptr;
+    }
+    else if (asset.type == AssetTexture)
+    {
+        asset.texture = TextureCache::instance()->adopt(asset.path, asset.texture, job.options);
+    }
+
+    if (job.callback)
+    {
+        job.callback(asset);
+    }
+
+    bool finished;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_progress.remove(asset.id);
+        finished = m_progress.isEmpty();
+    }
+
+    m_emitter.emitLoadedAsset(asset.id, asset.success);
+    m_emitter.emitProgressChanged(progress());
+
+    if (finished)
+    {
+        {
+            QMutexLocker lock(&m_mutex);
+            m_requested = 0;
+        }
+
+        m_emitter.emitFinishedLoading();
+    }
+}
+
+
+void AssetLoader::start()
+{
+    m_quit = false;
+    m_started = true;
+
+    for (int i = 0; i < m_workerCount; i++)
+    {
+        priv::AssetWorker* worker = new priv::AssetWorker(this);
+        if (!worker->createContext())
+        {
+            worker->destroyContext();
+            delete worker;
+            cranError(e_02);
+            break;
+        }
+
+        m_workers.append(worker);
+        worker->start();
+    }
+}
@@ -0,0 +1,458 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+#include <Cranberry/System/Profiler.hpp>
+
+// Qt headers
+#include <QList>
+#include <QThread>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, e_01, "JobSystem: The task graph contains a cycle.")
+CRANBERRY_CONST_VAR(int, c_chunksPerThread, 4)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+// Queue of the current thread; -1 for threads that are not workers.
+static thread_local int t_queue = -1;
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// The owner takes jobs from the back, so that it works on the jobs it
+/// pushed last while their data is still in the cache. Thieves take jobs
+/// from the front, i.e. the largest amount of remaining work.
+///
+////////////////////////////////////////////////////////////////////////////////
+class JobQueue final
+{
+public:
+
+    void push(const QVector<JobSystem::Job>& jobs)
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const JobSystem::Job& job : jobs)
+        {
+            m_jobs.append(job);
+        }
+    }
+
+    bool pop(JobSystem::Job* job)
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_jobs.isEmpty())
+        {
+            return false;
+        }
+
+        *job = m_jobs.takeLast();
+        return true;
+    }
+
+    bool steal(JobSystem::Job* job)
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_jobs.isEmpty())
+        {
+            return false;
+        }
+
+        *job = m_jobs.takeFirst();
+        return true;
+    }
+
+
+private:
+
+    QMutex                 m_mutex;
+    QList<JobSystem::Job>  m_jobs;
+};
+
+
+class JobWorker final : public QThread
+{
+public:
+
+    JobWorker(JobSystem* system, int queue)
+        : m_system(system)
+        , m_queue(queue)
+    {
+        setObjectName(QString("JobWorker %0").arg(queue));
+    }
+
+
+protected:
+
+    void run() override
+    {
+        t_queue = m_queue;
+
+        JobSystem::Job job;
+        for (;;)
+        {
+            if (m_system->takeJob(m_queue, &job))
+            {
+                m_system->execute(job);
+                continue;
+            }
+
+            // Jobs are counted before the workers are woken, thus no wake-up
+            // is lost between the check and the wait.
+            QMutexLocker lock(&m_system->m_mutex);
+            while (m_system->m_queued.load() == 0 && !m_system->m_quit)
+            {
+                m_system->m_wake.wait(&m_system->m_mutex);
+            }
+
+            if (m_system->m_quit)
+            {
+                return;
+            }
+        }
+    }
+
+
+private:
+
+    JobSystem* m_system;
+    int        m_queue;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+int TaskGraph::count() const
+{
+    return m_tasks.size();
+}
+
+
+int TaskGraph::add(const std::function<void()>& job)
+{
+    m_tasks.append({ job, QVector<int>(), 0 });
+    return m_tasks.size() - 1;
+}
+
+
+void TaskGraph::precede(int before, int after)
+{
+    m_tasks[before].successors.append(after);
+    m_tasks[after].dependencies++;
+}
+
+
+void TaskGraph::clear()
+{
+    m_tasks.clear();
+}
+
+
+JobSystem::JobSystem()
+    : m_queued(0)
+    , m_workerCount(qMax(0, QThread::idealThreadCount() - 1))
+    , m_quit(false)
+    , m_started(false)
+{
+}
+
+
+JobSystem::~JobSystem()
+{
+    stop();
+}
+
+
+JobSystem* JobSystem::instance()
+{
+    static JobSystem system;
+    return &system;
+}
+
+
+int JobSystem::workerCount() const
+{
+    return m_workerCount;
+}
+
+
+void JobSystem::setWorkerCount(int count)
+{
+    m_workerCount = qMax(0, count);
+}
+
+
+void JobSystem::parallelFor(int count, const std::function<void(int)>& body, int grain)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    start();
+
+    const int threads = m_workers.size() + 1;
+    if (grain <= 0)
+    {
+        grain = qMax(1, count / (threads * c_chunksPerThread));
+    }
+
+    if (m_workers.isEmpty() || count <= grain)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            body(i);
+        }
+
+        return;
+    }
+
+    const int chunks = (count + grain - 1) / grain;
+    QAtomicInt pending(chunks);
+    QVector<Job> jobs;
+    jobs.reserve(chunks);
+
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        const int end = qMin(count, begin + grain);
+        jobs.append({ [&body, begin, end]
+        {
+            for (int i = begin; i < end; i++)
+            {
+                body(i);
+            }
+        }, &pending });
+    }
+
+    push(jobs);
+    wait(&pending);
+}
+
+
+bool JobSystem::run(const TaskGraph& graph)
+{
+    const QVector<TaskGraph::Task>& tasks = graph.m_tasks;
+    const int count = tasks.size();
+    if (count == 0)
+    {
+        return true;
+    }
+
+    // Kahn's algorithm; a graph with a cycle would never finish.
+    QVector<int> remaining(count);
+    QVector<int> ready;
+    for (int i = 0; i < count; i++)
+    {
+        remaining[i] = tasks.at(i).dependencies;
+        if (remaining.at(i) == 0) ready.append(i);
+    }
+
+    const QVector<int> roots = ready;
+    for (int visited = 0; visited < ready.size(); visited++)
+    {
+        for (int s : tasks.at(ready.at(visited)).successors)
+        {
+            if (--remaining[s] == 0) ready.append(s);
+        }
+    }
+
+    if (ready.size() != count)
+    {
+        return cranError(e_01);
+    }
+
+    start();
+
+    QVector<QAtomicInt> dependencies(count);
+    for (int i = 0; i < count; i++)
+    {
+        dependencies[i].store(tasks.at(i).dependencies);
+    }
+
+    // Every finished task pushes the successors it was the last one to wait
+    // for; those run on whichever thread is free.
+    QAtomicInt pending(count);
+    std::function<void(int)> runTask = [&] (int i)
+    {
+        tasks.at(i).job();
+
+        QVector<Job> next;
+        for (int s : tasks.at(i).successors)
+        {
+            if (!dependencies[s].deref())
+            {
+                next.append({ [&runTask, s] { runTask(s); }, &pending });
+            }
+        }
+
+        push(next);
+    };
+
+    QVector<Job> jobs;
+    jobs.reserve(roots.size());
+    for (int i : roots)
+    {
+        jobs.append({ [&runTask, i] { runTask(i); }, &pending });
+    }
+
+    push(jobs);
+    wait(&pending);
+
+    return true;
+}
+
+
+void JobSystem::stop()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_quit = true;
+        m_wake.wakeAll();
+    }
+
+    for (priv::JobWorker* worker : m_workers)
+    {
+        worker->wait();
+    }
+
+    qDeleteAll(m_workers);
+    qDeleteAll(m_queues);
+
+    m_workers.clear();
+    m_queues.clear();
+    m_started = false;
+}
+
+
+void JobSystem::start()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_started)
+    {
+        return;
+    }
+
+    m_quit = false;
+
+    // The last queue is shared by all threads that are not workers.
+    for (int i = 0; i <= m_workerCount; i++)
+    {
+        m_queues.append(new priv::JobQueue);
+    }
+
+    for (int i = 0; i < m_workerCount; i++)
+    {
+        priv::JobWorker* worker = new priv::JobWorker(this, i);
+        m_workers.append(worker);
+        worker->start();
+    }
+
+    m_started = true;
+}
+
+
+void JobSystem::push(const QVector<Job>& jobs)
+{
+    if (jobs.isEmpty())
+    {
+        return;
+    }
+
+    // Counted first, so that the count never falls below the actual amount.
+    m_queued.fetchAndAddOrdered(jobs.size());
+    m_queues.at(currentQueue())->push(jobs);
+
+    QMutexLocker lock(&m_mutex);
+    if (jobs.size() == 1)
+    {
+        m_wake.wakeOne();
+    }
+    else
+    {
+        m_wake.wakeAll();
+    }
+}
+
+
+bool JobSystem::takeJob(int queue, Job* job)
+{
+    if (m_queued.load() == 0)
+    {
+        return false;
+    }
+
+    // Own queue first, then steals from the others in turn.
+    const int count = m_queues.size();
+    for (int i = 0; i < count; i++)
+    {
+        priv::JobQueue* q = m_queues.at((queue + i) % count);
+        if ((i == 0) ? q->pop(job) : q->steal(job))
+        {
+            m_queued.deref();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void JobSystem::execute(const Job& job)
+{
+    cranProfile("JobSystem::execute");
+
+    job.work();
+    job.pending->deref();
+}
+
+
+void JobSystem::wait(QAtomicInt* pending)
+{
+    // Helps out instead of blocking, which also makes nested parallelFor()
+    // calls from within jobs safe.
+    const int queue = currentQueue();
+
+    Job job;
+    while (pending->load() > 0)
+    {
+        if (takeJob(queue, &job))
+        {
+            execute(job);
+        }
+        else
+        {
+            QThread::yieldCurrentThread();
+        }
+    }
+}
+
+
+int JobSystem::currentQueue() const
+{
+    return (t_queue >= 0) ? t_queue : m_queues.size() - 1;
+}
@@ -30,6 +30,8 @@ TreeModelItem::TreeModelItem(QVariant member, QVariant value, TreeModelItem* par
     : m_member(member)
     , m_value(value)
     , m_parent(parent)
+    , m_changed(false)
+    , m_structureChanged(false)
 {
 }
 
@@ -39,6 +41,8 @@ TreeModelItem::TreeModelItem(const TreeModelItem& other)
     , m_member(other.m_member)
     , m_value(other.m_value)
     , m_parent(other.m_parent)
+    , m_changed(other.m_changed)
+    , m_structureChanged(other.m_structureChanged)
 {
 }
 
@@ -53,6 +57,7 @@ void TreeModelItem::appendChild(TreeModelItem* child)
 {
     m_items.append(child);
     child->m_parent = this;
+    m_structureChanged = true;
 }
 
 
@@ -60,6 +65,7 @@ void TreeModelItem::insertChild(int index, TreeModelItem* child)
 {
     m_items.insert(index, child);
     child->m_parent = this;
+    m_structureChanged = true;
 }
 
 
@@ -69,6 +75,7 @@ void TreeModelItem::removeChild(int index)
     {
         auto* item = m_items.takeAt(index);
         delete item;
+        m_structureChanged = true;
     }
 }
 
@@ -77,6 +84,7 @@ void TreeModelItem::removeAllChildren()
 {
     qDeleteAll(m_items);
     m_items.clear();
+    m_structureChanged = true;
 }
 
 
@@ -136,11 +144,19 @@ QVariant TreeModelItem::value() const
 
 void TreeModelItem::setMember(const QVariant& m)
 {
-    m_member = m;
+    if (m != m_member)
+    {
+        m_member = m;
+        m_changed = true;
+    }
 }
 
 
 void TreeModelItem::setValue(const QVariant& v)
 {
-    m_value = v;
+    if (v != m_value)
+    {
+        m_value = v;
+        m_changed = true;
+    }
 }
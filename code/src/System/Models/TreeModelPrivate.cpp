@@ -64,11 +64,32 @@ void priv::TreeModelPrivate::finalizeInsertion()
     endInsertRows();
 
     m_insertionQueue.clear();
+
+    // Forgets the changes made while the items were built up.
+    QVector<QModelIndex> ranges;
+    bool structureChanged;
+    collectChanges(m_rootItem, QModelIndex(), &ranges, &structureChanged);
 }
 
 
 void priv::TreeModelPrivate::update()
 {
+    QVector<QModelIndex> ranges;
+    bool structureChanged = false;
+    collectChanges(m_rootItem, QModelIndex(), &ranges, &structureChanged);
+
+    // Only changed rows are announced, in as few ranges as possible.
+    if (!structureChanged)
+    {
+        for (int i = 0; i < ranges.size(); i += 2)
+        {
+            Q_EMIT dataChanged(ranges.at(i), ranges.at(i + 1), { Qt::UserRole, Qt::UserRole + 1 });
+        }
+
+        return;
+    }
+
+    // Children were added or removed; lays out the whole tree again.
     layoutAboutToBeChanged();
 
     QModelIndex first = index(m_rootItem->row(), 0);
@@ -81,6 +102,46 @@ void priv::TreeModelPrivate::update()
 }
 
 
+void priv::TreeModelPrivate::collectChanges(
+    TreeModelItem* item,
+    const QModelIndex& parent,
+    QVector<QModelIndex>* ranges,
+    bool* structureChanged
+    )
+{
+    *structureChanged |= item->m_structureChanged;
+    item->m_structureChanged = false;
+
+    // Consecutive changed rows are merged into one range.
+    const int count = item->childCount();
+    int first = -1;
+
+    for (int row = 0; row <= count; row++)
+    {
+        TreeModelItem* child = (row < count) ? item->childAt(row) : nullptr;
+        if (child != nullptr && child->m_changed)
+        {
+            child->m_changed = false;
+            if (first < 0)
+            {
+                first = row;
+            }
+        }
+        else if (first >= 0)
+        {
+            ranges->append(index(first, 0, parent));
+            ranges->append(index(row - 1, 1, parent));
+            first = -1;
+        }
+
+        if (child != nullptr && child->childCount() > 0)
+        {
+            collectChanges(child, index(row, 0, parent), ranges, structureChanged);
+        }
+    }
+}
+
+
 QVariant priv::TreeModelPrivate::data(const QModelIndex& index, int role) const
 {
     if (!index.isValid())
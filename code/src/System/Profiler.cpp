@@ -0,0 +1,369 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/Profiler.hpp>
+
+// Qt headers
+#include <QAtomicInteger>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+
+// Constants
+CRANBERRY_CONST_VAR(QString, w_01, "Profiler: Trace %0 could not be written.")
+CRANBERRY_CONST_VAR(QString, w_02, "Profiler: Frame took %0 ms; dumped the last %1 frames to %2.")
+CRANBERRY_CONST_VAR(QString, c_spikeFile, "cranberry-spike-%0.json")
+CRANBERRY_CONST_VAR(quint32, c_bufferSize, 1u << 15)
+CRANBERRY_CONST_VAR(double, c_defaultBudget, 1000.0 / 30.0)
+CRANBERRY_CONST_VAR(int, c_defaultFrames, 120)
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Holds the most recent scopes of one thread. Only the owning thread writes;
+/// readers copy the events and discard those overwritten while copying.
+///
+////////////////////////////////////////////////////////////////////////////////
+class ProfileBuffer
+{
+public:
+
+    struct Event
+    {
+        const char* name;  ///< String literal of the scope
+        qint64      begin; ///< Start in nanoseconds
+        qint64      end;   ///< End in nanoseconds
+    };
+
+    ProfileBuffer(int id, const QString& name)
+        : m_events(c_bufferSize)
+        , m_head(0)
+        , m_id(id)
+        , m_name(name)
+    {
+    }
+
+    int id() const
+    {
+        return m_id;
+    }
+
+    const QString& name() const
+    {
+        return m_name;
+    }
+
+    void push(const char* name, qint64 begin, qint64 end)
+    {
+        const quint32 head = m_head.load();
+        m_events[head & (c_bufferSize - 1)] = { name, begin, end };
+        m_head.storeRelease(head + 1);
+    }
+
+    QVector<Event> snapshot() const
+    {
+        const quint32 head = m_head.loadAcquire();
+        const quint32 count = qMin(head, c_bufferSize);
+
+        QVector<Event> events;
+        events.reserve(static_cast<int>(count));
+        for (quint32 i = head - count; i != head; i++)
+        {
+            events.append(m_events.at(i & (c_bufferSize - 1)));
+        }
+
+        // Events the writer lapped while copying may be torn.
+        const quint32 lapped = m_head.loadAcquire() - head;
+        events.remove(0, static_cast<int>(qMin(lapped, count)));
+
+        return events;
+    }
+
+
+private:
+
+    QVector<Event>          m_events;
+    QAtomicInteger<quint32> m_head;
+    int                     m_id;
+    QString                 m_name;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+// Buffer of the current thread; created on its first scope.
+static thread_local priv::ProfileBuffer* t_buffer = nullptr;
+
+
+Profiler::Profiler()
+    : m_spikeDir(QDir::tempPath())
+    , m_budget(c_defaultBudget)
+    , m_frameCount(0)
+    , m_spikeFrames(c_defaultFrames)
+    , m_cooldown(0)
+{
+    m_clock.start();
+}
+
+
+Profiler::~Profiler()
+{
+    qDeleteAll(m_buffers);
+}
+
+
+Profiler* Profiler::instance()
+{
+    static Profiler profiler;
+    return &profiler;
+}
+
+
+bool Profiler::isCompiledIn()
+{
+#ifdef CRANBERRY_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+double Profiler::frameBudget() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_budget;
+}
+
+
+int Profiler::spikeFrames() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_spikeFrames;
+}
+
+
+QString Profiler::spikeDirectory() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_spikeDir;
+}
+
+
+void Profiler::setFrameBudget(double ms)
+{
+    QMutexLocker lock(&m_mutex);
+    m_budget = ms;
+}
+
+
+void Profiler::setSpikeFrames(int frames)
+{
+    QMutexLocker lock(&m_mutex);
+    m_spikeFrames = qMax(1, frames);
+}
+
+
+void Profiler::setSpikeDirectory(const QString& dir)
+{
+    QMutexLocker lock(&m_mutex);
+    m_spikeDir = dir;
+}
+
+
+bool Profiler::exportTrace(const QString& path)
+{
+    return writeTrace(path, 0);
+}
+
+
+void Profiler::beginFrame()
+{
+    const qint64 time = now();
+    qint64 last = -1;
+    double spike = 0.0;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_frames.isEmpty())
+        {
+            last = m_frames.last();
+            const double ms = (time - last) / 1000000.0;
+
+            if (m_cooldown > 0)
+            {
+                m_cooldown--;
+            }
+            else if (m_budget > 0.0 && ms > m_budget)
+            {
+                spike = ms;
+                m_cooldown = m_spikeFrames;
+            }
+        }
+
+        // Keeps the start of the frames to dump, plus the current one.
+        m_frames.append(time);
+        if (m_frames.size() > m_spikeFrames + 1)
+        {
+            m_frames.remove(0, m_frames.size() - m_spikeFrames - 1);
+        }
+
+        m_frameCount++;
+    }
+
+    // Spans the whole frame, so that its scopes appear beneath.
+    if (last >= 0)
+    {
+        record("Frame", last, time);
+    }
+
+    if (spike > 0.0)
+    {
+        dumpSpike(spike);
+    }
+}
+
+
+qint64 Profiler::now() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+
+void Profiler::record(const char* name, qint64 begin, qint64 end)
+{
+    if (t_buffer == nullptr)
+    {
+        t_buffer = createBuffer();
+    }
+
+    t_buffer->push(name, begin, end);
+}
+
+
+void Profiler::dumpSpike(double ms)
+{
+    QString path;
+    qint64 from;
+    int frames;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        path = QDir(m_spikeDir).filePath(c_spikeFile.arg(m_frameCount));
+        from = m_frames.first();
+        frames = m_frames.size() - 1;
+    }
+
+    if (writeTrace(path, from))
+    {
+        cranWarning(w_02.arg(ms, 0, 'f', 1).arg(frames).arg(path));
+    }
+}
+
+
+bool Profiler::writeTrace(const QString& path, qint64 from)
+{
+    QVector<priv::ProfileBuffer*> buffers;
+    {
+        QMutexLocker lock(&m_mutex);
+        buffers = m_buffers;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return cranWarning(w_01.arg(path));
+    }
+
+    // Written by hand; building a QJsonDocument of this size takes too long
+    // for a spike dump.
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    for (const priv::ProfileBuffer* buffer : buffers)
+    {
+        const QByteArray tid = QByteArray::number(buffer->id());
+        QByteArray name = buffer->name().toUtf8();
+        name.replace('\\', "\\\\").replace('"', "\\\"");
+
+        json += first ? "" : ",";
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid;
+        json += ",\"args\":{\"name\":\"" + name + "\"}}";
+        first = false;
+
+        for (const priv::ProfileBuffer::Event& e : buffer->snapshot())
+        {
+            if (e.begin < from)
+            {
+                continue;
+            }
+
+            json += ",{\"name\":\"";
+            json += e.name;
+            json += "\",\"ph\":\"X\",\"pid\":" + pid + ",\"tid\":" + tid;
+            json += ",\"ts\":" + QByteArray::number(e.begin / 1000.0, 'f', 3);
+            json += ",\"dur\":" + QByteArray::number((e.end - e.begin) / 1000.0, 'f', 3);
+            json += "}";
+        }
+    }
+
+    json += "]}";
+
+    if (file.write(json) != json.size())
+    {
+        return cranWarning(w_01.arg(path));
+    }
+
+    return true;
+}
+
+
+priv::ProfileBuffer* Profiler::createBuffer()
+{
+    QMutexLocker lock(&m_mutex);
+
+    // Names the threads like cranberry does, in case they have no name.
+    QThread* thread = QThread::currentThread();
+    QString name = thread->objectName();
+    if (QCoreApplication::instance() != nullptr && thread == QCoreApplication::instance()->thread())
+    {
+        name = "Main";
+    }
+    else if (name.isEmpty())
+    {
+        name = QString("Thread %0").arg(m_buffers.size());
+    }
+
+    auto* buffer = new priv::ProfileBuffer(m_buffers.size(), name);
+    m_buffers.append(buffer);
+
+    return buffer;
+}
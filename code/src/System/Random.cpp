@@ -23,8 +23,14 @@
 #include <Cranberry/System/Random.hpp>
 
 // Standard headers
+#include <cstring>
 #include <ctime>
 
+// Constants
+CRANBERRY_CONST_VAR(int, c_fillBlock, 8)
+CRANBERRY_CONST_VAR(float, c_float24, 1.0f / 16777216.0f)
+CRANBERRY_CONST_VAR(double, c_double53, 1.0 / 9007199254740992.0)
+
 
 CRANBERRY_USING_NAMESPACE
 
@@ -35,23 +41,31 @@ namespace
     constexpr char c_ascii[] = " !#$%&()*+'-./0123456789:;<=>?@"
                                "ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
                                "abcdefghijklmnopqrstuvwxyz{|}~";
+
+    // Amount of integers in [min, max]; zero stands for all 2^32.
+    quint32 rangeOf(int min, int max)
+    {
+        return quint32(qint64(max) - qint64(min) + 1);
+    }
 }
 
 
 Random::Random()
-    : m_engine(std::time(0))
-    , m_charset(c_ascii)
+    : m_charset(c_ascii)
     , m_fmin(0.0)
     , m_fmax(1.0)
     , m_imin(0)
     , m_imax(std::numeric_limits<int>::max())
 {
+    std::random_device device;
+    setSeed(device() ^ static_cast<uint>(std::time(0)));
 }
 
 
 void Random::setSeed(uint seed)
 {
     m_engine.seed(seed);
+    m_bulk.seed(m_engine());
 }
 
 
@@ -77,45 +91,89 @@ void Random::setCharset(const QString& charset)
 
 void Random::setDistribution(const Distribution& dist)
 {
-    m_dist = dist;
+    // Vose's alias method: every outcome gets one column of height 1/n. A
+    // column holds its own outcome up to m_aliasProb and its alias above.
+    const std::vector<double> probs = dist.probabilities();
+    const int n = static_cast<int>(probs.size());
+
+    m_aliasProb.fill(1.0f, n);
+    m_alias.resize(n);
+
+    QVector<double> scaled(n);
+    QVector<int> small, large;
+
+    for (int i = 0; i < n; i++)
+    {
+        m_alias[i] = i;
+        scaled[i] = probs[i] * n;
+        (scaled[i] < 1.0 ? small : large).append(i);
+    }
+
+    while (!small.isEmpty() && !large.isEmpty())
+    {
+        const int s = small.takeLast();
+        const int l = large.last();
+
+        m_aliasProb[s] = static_cast<float>(scaled[s]);
+        m_alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+
+        if (scaled[l] < 1.0)
+        {
+            small.append(large.takeLast());
+        }
+    }
 }
 
 
 bool Random::nextBoolean() const
 {
-    double factor = static_cast<double>(m_engine.max());
-    return static_cast<bool>(round(static_cast<double>(m_engine()) / factor));
+    return (m_engine() >> 63) != 0;
 }
 
 
 int Random::nextNumber() const
 {
-    return m_imin + m_engine() % (m_imax+1 - m_imin);
+    const quint32 range = rangeOf(m_imin, m_imax);
+    const quint32 bits = quint32(m_engine() >> 32);
+
+    return static_cast<int>(qint64(m_imin) + nextBounded(range, bits));
 }
 
 
 int Random::nextDiscrete() const
 {
-    return m_dist(m_engine);
+    const int n = m_alias.size();
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    // The upper half picks the column, the lower half the side of it.
+    const quint64 bits = m_engine();
+    const int column = static_cast<int>(nextBounded(quint32(n), quint32(bits >> 32)));
+    const float side = (bits & 0xFFFFFF) * c_float24;
+
+    return (side < m_aliasProb.at(column)) ? column : m_alias.at(column);
 }
 
 
 double Random::nextDouble() const
 {
-    double factor = static_cast<double>(m_engine.max()) / (m_fmax - m_fmin);
-    return m_fmin + static_cast<double>(m_engine()) / factor;
+    return m_fmin + (m_engine() >> 11) * c_double53 * (m_fmax - m_fmin);
 }
 
 
 const QString Random::nextString(int size) const
 {
     QString result;
-    int max = m_charset.size();
+    result.reserve(size);
+    const quint32 max = quint32(m_charset.size());
 
     // Chooses random characters, capped by 'max'.
     for (int i = 0; i < size; i++)
     {
-        int value = m_engine() % max;
+        int value = static_cast<int>(nextBounded(max, quint32(m_engine() >> 32)));
         result.append(m_charset.at(value));
     }
 
@@ -125,12 +183,113 @@ const QString Random::nextString(int size) const
 
 const QByteArray Random::nextBlob(int size) const
 {
-    QByteArray result;
-    for (int i = 0; i < size; i++)
+    QByteArray result(size, Qt::Uninitialized);
+    for (int i = 0; i < size; i += 8)
     {
-        uchar value = static_cast<uchar>(m_engine() % 256);
-        result.append((char) value);
+        const quint64 value = m_engine();
+        std::memcpy(result.data() + i, &value, qMin(8, size - i));
     }
 
     return result;
 }
+
+
+void Random::fill(float* data, int count) const
+{
+    const float min = static_cast<float>(m_fmin);
+    const float scale = static_cast<float>(m_fmax - m_fmin) * c_float24;
+
+    // Every 64-bit value yields two floats with 24 random bits each; four
+    // streams are advanced at once.
+    quint64 bits[4];
+    float block[c_fillBlock];
+
+    for (int i = 0; i < count; i += c_fillBlock)
+    {
+        m_bulk.next(bits);
+        for (int j = 0; j < 4; j++)
+        {
+            block[j * 2 + 0] = min + (bits[j] >> 40) * scale;
+            block[j * 2 + 1] = min + ((bits[j] >> 8) & 0xFFFFFF) * scale;
+        }
+
+        std::memcpy(data + i, block, sizeof(float) * qMin(c_fillBlock, count - i));
+    }
+}
+
+
+void Random::fill(int* data, int count) const
+{
+    const quint32 range = rangeOf(m_imin, m_imax);
+    const qint64 min = m_imin;
+
+    // Lemire's method with the threshold computed once per call: products
+    // whose lower half is below it would favor some values and are redrawn.
+    const quint32 threshold = (range != 0) ? quint32(-range) % range : 0;
+
+    quint64 bits[4];
+    quint64 spare[4];
+    int spareCount = 0;
+    int block[c_fillBlock];
+
+    auto bounded = [&] (quint32 value) -> int
+    {
+        if (range == 0)
+        {
+            return static_cast<int>(min + value);
+        }
+
+        quint64 product = quint64(value) * range;
+        while (quint32(product) < threshold)
+        {
+            // Redraws from the bulk engine, four values at a time.
+            if (spareCount == 0)
+            {
+                m_bulk.next(spare);
+                spareCount = 4;
+            }
+
+            product = quint64(quint32(spare[--spareCount] >> 32)) * range;
+        }
+
+        return static_cast<int>(min + qint64(product >> 32));
+    };
+
+    for (int i = 0; i < count; i += c_fillBlock)
+    {
+        m_bulk.next(bits);
+        for (int j = 0; j < 4; j++)
+        {
+            block[j * 2 + 0] = bounded(quint32(bits[j] >> 32));
+            block[j * 2 + 1] = bounded(quint32(bits[j]));
+        }
+
+        std::memcpy(data + i, block, sizeof(int) * qMin(c_fillBlock, count - i));
+    }
+}
+
+
+quint32 Random::nextBounded(quint32 range, quint32 bits) const
+{
+    if (range == 0)
+    {
+        return bits;
+    }
+
+    // Lemire's method: maps 32 random bits to [0, range) by a multiplication.
+    // Only the rare products that would favor some values are redrawn.
+    quint64 product = quint64(bits) * range;
+    quint32 low = quint32(product);
+
+    if (low < range)
+    {
+        const quint32 threshold = quint32(-range) % range;
+        while (low < threshold)
+        {
+            product = quint64(quint32(m_engine() >> 32)) * range;
+            low = quint32(product);
+        }
+    }
+
+    return quint32(product >> 32);
+}
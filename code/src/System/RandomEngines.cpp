@@ -0,0 +1,193 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/RandomEngines.hpp>
+
+// Constants
+CRANBERRY_CONST_VAR(quint32, c_philoxM0, 0xD2511F53)
+CRANBERRY_CONST_VAR(quint32, c_philoxM1, 0xCD9E8D57)
+CRANBERRY_CONST_VAR(quint32, c_philoxW0, 0x9E3779B9)
+CRANBERRY_CONST_VAR(quint32, c_philoxW1, 0xBB67AE85)
+CRANBERRY_CONST_VAR(int, c_philoxRounds, 10)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    // Expands a single seed into well-mixed state words.
+    quint64 splitMix64(quint64& x)
+    {
+        quint64 z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
+
+
+Xoshiro256::Xoshiro256(quint64 seed)
+{
+    this->seed(seed);
+}
+
+
+void Xoshiro256::seed(quint64 seed)
+{
+    for (quint64& word : m_s)
+    {
+        word = splitMix64(seed);
+    }
+}
+
+
+void Xoshiro256::jump()
+{
+    static const quint64 jump[] =
+    {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    quint64 s[4] = { 0, 0, 0, 0 };
+    for (quint64 word : jump)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (word & (quint64(1) << b))
+            {
+                s[0] ^= m_s[0];
+                s[1] ^= m_s[1];
+                s[2] ^= m_s[2];
+                s[3] ^= m_s[3];
+            }
+
+            operator()();
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        m_s[i] = s[i];
+    }
+}
+
+
+Xoshiro256x4::Xoshiro256x4(quint64 seed)
+{
+    this->seed(seed);
+}
+
+
+void Xoshiro256x4::seed(quint64 seed)
+{
+    Xoshiro256 stream(seed);
+    for (int i = 0; i < 4; i++)
+    {
+        for (int w = 0; w < 4; w++)
+        {
+            m_s[w][i] = stream.m_s[w];
+        }
+
+        stream.jump();
+    }
+}
+
+
+Pcg32::Pcg32(quint64 seed, quint64 stream)
+{
+    this->seed(seed, stream);
+}
+
+
+void Pcg32::seed(quint64 seed, quint64 stream)
+{
+    m_state = 0;
+    m_increment = (stream << 1) | 1;
+
+    operator()();
+    m_state += seed;
+    operator()();
+}
+
+
+Philox4x32::Philox4x32(quint64 key, quint64 stream)
+{
+    seed(key, stream);
+}
+
+
+void Philox4x32::seed(quint64 key, quint64 stream)
+{
+    m_key[0] = quint32(key);
+    m_key[1] = quint32(key >> 32);
+    m_stream = stream;
+    m_block = 0;
+    m_index = 4;
+}
+
+
+void Philox4x32::seek(quint64 position)
+{
+    m_block = position >> 2;
+    generate();
+    m_index = int(position & 3);
+}
+
+
+void Philox4x32::generate()
+{
+    quint32 c[4] =
+    {
+        quint32(m_block), quint32(m_block >> 32),
+        quint32(m_stream), quint32(m_stream >> 32)
+    };
+
+    quint32 k0 = m_key[0];
+    quint32 k1 = m_key[1];
+
+    for (int r = 0; r < c_philoxRounds; r++)
+    {
+        const quint64 p0 = quint64(c_philoxM0) * c[0];
+        const quint64 p1 = quint64(c_philoxM1) * c[2];
+
+        const quint32 n0 = quint32(p1 >> 32) ^ c[1] ^ k0;
+        const quint32 n2 = quint32(p0 >> 32) ^ c[3] ^ k1;
+
+        c[0] = n0;
+        c[1] = quint32(p1);
+        c[2] = n2;
+        c[3] = quint32(p0);
+
+        k0 += c_philoxW0;
+        k1 += c_philoxW1;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        m_output[i] = c[i];
+    }
+
+    m_block++;
+    m_index = 0;
+}
@@ -0,0 +1,81 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Window/InputRing.hpp>
+
+// Standard headers
+#include <utility>
+
+// Constants
+CRANBERRY_CONST_VAR(int, c_capacity, 1024)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+priv::InputRing::InputRing()
+    : m_events(c_capacity)
+    , m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+{
+}
+
+
+int priv::InputRing::dropped() const
+{
+    return m_dropped.load();
+}
+
+
+bool priv::InputRing::push(const InputEvent& event)
+{
+    // The indices only ever grow; their difference is the amount of events
+    // in the ring, even after they overflow.
+    const int head = m_head.load();
+    if (head - m_tail.loadAcquire() >= c_capacity)
+    {
+        m_dropped.ref();
+        return false;
+    }
+
+    m_events[head & (c_capacity - 1)] = event;
+    m_head.storeRelease(head + 1);
+
+    return true;
+}
+
+
+bool priv::InputRing::pop(InputEvent* event)
+{
+    const int tail = m_tail.load();
+    if (tail == m_head.loadAcquire())
+    {
+        return false;
+    }
+
+    // Moves the text out, so that the slot holds no reference to it.
+    *event = std::move(m_events[tail & (c_capacity - 1)]);
+    m_tail.storeRelease(tail + 1);
+
+    return true;
+}
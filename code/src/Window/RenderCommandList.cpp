@@ -20,54 +20,41 @@
 
 
 // Cranberry headers
-#include <Cranberry/Game/Mapping/MapTileProperties.hpp>
-
-// Global variables
-CRANBERRY_GLOBAL_VAR(QVariant, g_default)
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/RenderCommandList.hpp>
 
 
 CRANBERRY_USING_NAMESPACE
 
 
-bool MapTileProperties::isValid() const
+int priv::RenderCommandList::recordedCount() const
 {
-    return m_properties.isEmpty() == false;
+    return m_commands.size();
 }
 
 
-const QVariant& MapTileProperties::value(const QString& name) const
+void priv::RenderCommandList::record(const Command& command)
 {
-    auto it = m_properties.find(name);
-    if (it == m_properties.end())
-    {
-        return g_default;
-    }
-    else
-    {
-        return it.value();
-    }
+    m_commands.append(command);
 }
 
 
-QMap<QString, QVariant>& MapTileProperties::properties()
+void priv::RenderCommandList::execute()
 {
-    return m_properties;
-}
-
-
-void MapTileProperties::setValue(const QString& name, const QVariant& value)
-{
-    m_properties[name] = value;
-}
+    cranProfile("RenderCommandList::execute");
 
+    for (const Command& command : m_commands)
+    {
+        command();
+    }
 
-void MapTileProperties::addProperty(const QString& name, const QVariant& value)
-{
-    m_properties.insert(name, value);
+    // Keeps the capacity, so that steady frames allocate nothing but the
+    // captures of their commands.
+    m_commands.resize(0);
 }
 
 
-void MapTileProperties::removeProperty(const QString& name)
+void priv::RenderCommandList::clear()
 {
-    m_properties.remove(name);
+    m_commands.resize(0);
 }
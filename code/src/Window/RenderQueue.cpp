@@ -0,0 +1,172 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/Base/RenderBase.hpp>
+#include <Cranberry/System/Profiler.hpp>
+#include <Cranberry/Window/RenderQueue.hpp>
+
+// Standard headers
+#include <cstring>
+#include <utility>
+
+// Constants
+CRANBERRY_CONST_VAR(int, c_layerShift, 56)
+CRANBERRY_CONST_VAR(int, c_depthShift, 33)
+CRANBERRY_CONST_VAR(int, c_orderedShift, 32)
+CRANBERRY_CONST_VAR(int, c_shaderShift, 16)
+CRANBERRY_CONST_VAR(quint64, c_depthMask, 0x7FFFFF)
+CRANBERRY_CONST_VAR(quint64, c_shaderMask, 0xFFFF)
+CRANBERRY_CONST_VAR(quint64, c_textureMask, 0xFFFF)
+CRANBERRY_CONST_VAR(quint64, c_sequenceMask, 0xFFFFFFFF)
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+int priv::RenderQueue::recordedCount() const
+{
+    return m_packets.size();
+}
+
+
+void priv::RenderQueue::push(RenderBase* object)
+{
+    // Layers are signed; the offset keeps negative layers in front of the
+    // positive ones in unsigned order.
+    const quint64 layer = quint64(qBound(-128, object->layer(), 127) + 128);
+    const quint64 depth = quint64(qBound(0.0f, object->depth(), 1.0f) * c_depthMask);
+    const bool opaque = object->isOpaque() && object->opacity() >= 1.0f;
+
+    // There is no depth test; objects are rendered back to front in any
+    // case. Blending depends on the order, so objects of equal depth keep
+    // the order they were enqueued in. Only objects marked as opaque are
+    // grouped by shader and texture, in front of the others of their depth.
+    quint64 key = (layer << c_layerShift) | (depth << c_depthShift);
+    if (opaque)
+    {
+        key |= (denseId(m_shaders, quintptr(object->shaderProgram())) & c_shaderMask) << c_shaderShift;
+        key |= (denseId(m_textures, quintptr(object->textureId())) & c_textureMask);
+    }
+    else
+    {
+        key |= (quint64(1) << c_orderedShift);
+        key |= (quint64(m_packets.size()) & c_sequenceMask);
+    }
+
+    m_packets.append({ key, object });
+}
+
+
+void priv::RenderQueue::execute()
+{
+    cranProfile("RenderQueue::execute");
+
+    sort();
+
+    for (const Packet& packet : m_packets)
+    {
+        packet.object->render();
+    }
+
+    m_packets.resize(0);
+    m_shaders.clear();
+    m_textures.clear();
+}
+
+
+void priv::RenderQueue::clear()
+{
+    m_packets.resize(0);
+    m_shaders.clear();
+    m_textures.clear();
+}
+
+
+quint64 priv::RenderQueue::denseId(IdMap& ids, quintptr value)
+{
+    // Assigns small ids in the order the shaders and textures are seen, so
+    // that unrelated ones never share their part of the key.
+    auto it = ids.find(value);
+    if (it == ids.end())
+    {
+        it = ids.insert(value, quint64(ids.size()));
+    }
+
+    return it.value();
+}
+
+
+void priv::RenderQueue::sort()
+{
+    const int count = m_packets.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    // Builds the histograms of all eight bytes in one run.
+    int counts[8][256];
+    std::memset(counts, 0, sizeof(counts));
+
+    for (const Packet& packet : m_packets)
+    {
+        for (int b = 0; b < 8; b++)
+        {
+            counts[b][(packet.key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    // Stable LSD radix sort. Bytes that are equal for all packets, e.g. the
+    // layer in most frames, are skipped.
+    m_scratch.resize(count);
+    Packet* src = m_packets.data();
+    Packet* dst = m_scratch.data();
+
+    for (int b = 0; b < 8; b++)
+    {
+        int* histogram = counts[b];
+        if (histogram[(src[0].key >> (b * 8)) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        int offset = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            const int n = histogram[i];
+            histogram[i] = offset;
+            offset += n;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            dst[histogram[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != m_packets.data())
+    {
+        m_packets.swap(m_scratch);
+    }
+}
@@ -106,6 +106,31 @@ uint Window::vao() const
 }
 
 
+PrimitiveBatch* Window::draw() const
+{
+    return m_priv->m_draw;
+}
+
+
+const KeyboardState& Window::keyboard() const
+{
+    return m_priv->m_keyState;
+}
+
+
+const MouseState& Window::mouse() const
+{
+    return m_priv->m_mouseState;
+}
+
+
+float Window::inputLatency() const
+{
+    const int us = m_priv->m_inputLatency.load();
+    return (us < 0) ? -1.0f : us / 1000.0f;
+}
+
+
 void Window::restoreOpenGLSettings()
 {
     m_priv->restoreOpenGLSettings();
@@ -130,6 +155,18 @@ void Window::hideDebugOverlay()
 }
 
 
+void Window::submit(const std::function<void()>& command)
+{
+    m_priv->m_commands.record(command);
+}
+
+
+void Window::enqueue(RenderBase* object)
+{
+    m_priv->m_queue.push(object);
+}
+
+
 void Window::setSettings(const WindowSettings& settings)
 {
     m_priv->setSettings(settings);
@@ -20,18 +20,27 @@
 
 
 // Cranberry headers
+#include <Cranberry/Graphics/Base/GlyphAtlas.hpp>
+#include <Cranberry/Graphics/Base/RenderTargetPool.hpp>
+#include <Cranberry/Graphics/Base/TextCache.hpp>
+#include <Cranberry/Graphics/Base/TextureCache.hpp>
+#include <Cranberry/Graphics/PrimitiveBatch.hpp>
 #include <Cranberry/Gui/GuiManager.hpp>
 #include <Cranberry/OpenGL/OpenGLDebug.hpp>
 #include <Cranberry/OpenGL/OpenGLDefaultShaders.hpp>
 #include <Cranberry/OpenGL/OpenGLShader.hpp>
+#include <Cranberry/System/AssetLoader.hpp>
 #include <Cranberry/System/Debug.hpp>
+#include <Cranberry/System/JobSystem.hpp>
 #include <Cranberry/System/Models/TreeModel.hpp>
 #include <Cranberry/System/Models/TreeModelPrivate.hpp>
+#include <Cranberry/System/Profiler.hpp>
 #include <Cranberry/Window/Window.hpp>
 #include <Cranberry/Window/WindowPrivate.hpp>
 
 // Qt headers
 #include <QApplication>
+#include <QDebug>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QQuickItem>
@@ -41,18 +50,113 @@
 #include <QOpenGLFunctions>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLVertexArrayObject>
+#include <QMutex>
 #include <QScreen>
+#include <QThread>
 #include <QtEvents>
+#include <QWaitCondition>
 
 
 CRANBERRY_USING_NAMESPACE
 
 
 CRANBERRY_GLOBAL_VAR(priv::WindowPrivate*, g_window)
-CRANBERRY_CONST_VAR(uint, c_dbgInterval, 16)
 CRANBERRY_CONST_VAR(uint, c_clearMask, GL_COLOR_BUFFER_BIT   |
                                        GL_STENCIL_BUFFER_BIT |
                                        GL_DEPTH_BUFFER_BIT   )
+CRANBERRY_CONST_VAR(double, c_titleInterval, 0.25)
+CRANBERRY_CONST_VAR(QString, c_firstFrame, "Window: First frame presented %0 ms after initializing OpenGL.")
+
+
+CRANBERRY_BEGIN_PRIV_NAMESPACE
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Runs the update of one frame at a time, while the thread that owns the
+/// OpenGL context swaps the buffers of the previous frame and processes
+/// events. The frame is only rendered after the update has finished.
+///
+////////////////////////////////////////////////////////////////////////////////
+class UpdateThread : public QThread
+{
+public:
+
+    UpdateThread(WindowPrivate* window)
+        : m_window(window)
+        , m_pending(false)
+        , m_quit(false)
+    {
+        setObjectName("UpdateThread");
+    }
+
+    void begin()
+    {
+        QMutexLocker lock(&m_mutex);
+        m_pending = true;
+        m_wake.wakeOne();
+    }
+
+    void finish()
+    {
+        QMutexLocker lock(&m_mutex);
+        while (m_pending)
+        {
+            m_done.wait(&m_mutex);
+        }
+    }
+
+    void stop()
+    {
+        finish();
+
+        m_mutex.lock();
+        m_quit = true;
+        m_wake.wakeOne();
+        m_mutex.unlock();
+
+        wait();
+    }
+
+
+protected:
+
+    void run() override
+    {
+        QMutexLocker lock(&m_mutex);
+        for (;;)
+        {
+            while (!m_pending && !m_quit)
+            {
+                m_wake.wait(&m_mutex);
+            }
+
+            if (m_quit)
+            {
+                return;
+            }
+
+            lock.unlock();
+            m_window->updateFrame();
+            lock.relock();
+
+            m_pending = false;
+            m_done.wakeAll();
+        }
+    }
+
+
+private:
+
+    WindowPrivate* m_window;
+    QMutex         m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_done;
+    bool           m_pending;
+    bool           m_quit;
+};
+
+
+CRANBERRY_END_PRIV_NAMESPACE
 
 
 priv::WindowPrivate::WindowPrivate(cran::Window* w)
@@ -61,12 +165,20 @@ priv::WindowPrivate::WindowPrivate(cran::Window* w)
     , m_window(w)
     , m_dbgOverlay(nullptr)
     , m_guiOverlay(new GuiManager)
+    , m_draw(new PrimitiveBatch)
     , m_debugModel(new TreeModel)
     , m_activeGui(nullptr)
+    , m_updateThread(nullptr)
+    , m_inputLatency(-1)
+    , m_inputSampled(-1)
+    , m_inputShown(-1)
+    , m_initStarted(-1)
+    , m_firstFrame(-1)
+    , m_fpsTime(0.0)
     , m_keyCount(0)
     , m_padCount(0)
     , m_btnCount(0)
-    , m_dbgFrames(0)
+    , m_fpsFrames(0)
     , m_isMainWindow(false)
     , m_fakeFocusOut(false)
 {
@@ -91,12 +203,16 @@ priv::WindowPrivate::WindowPrivate(cran::Window* w)
     setFormat(fmt);
     setSurfaceType(QOpenGLWindow::OpenGLSurface);
     connect(this, SIGNAL(frameSwapped()), this, SLOT(update()));
+    connect(this, &QOpenGLWindow::frameSwapped, this, [this] { measureLatency(); measureStartup(); });
+
+    m_inputClock.start();
 }
 
 
 priv::WindowPrivate::~WindowPrivate()
 {
     delete m_debugModel;
+    delete m_draw;
 }
 
 
@@ -211,6 +327,7 @@ priv::WindowPrivate* priv::WindowPrivate::activeWindow()
 
 void priv::WindowPrivate::initializeGL()
 {
+    m_initStarted = m_inputClock.nsecsElapsed();
     m_gl = context()->functions();
     m_gl->initializeOpenGLFunctions();
 
@@ -232,9 +349,9 @@ void priv::WindowPrivate::initializeGL()
     if (m_isMainWindow)
     {
         OpenGLDefaultShaders::cranberryLoadDefaultShaders();
-        OpenGLDefaultShaders::cranberryInitDefaultShaders();
     }
 
+    m_draw->create(m_window);
     m_window->onInit();
 
     // Tries to find a monospace font for our overlay.
@@ -405,6 +522,10 @@ void priv::WindowPrivate::parseSettings()
 
 void priv::WindowPrivate::destroyGL()
 {
+    stopUpdateThread();
+    m_commands.clear();
+    m_queue.clear();
+
     // Unloads all the default shader programs only once - for the main window.
     if (m_isMainWindow)
     {
@@ -412,42 +533,194 @@ void priv::WindowPrivate::destroyGL()
     }
 
     m_window->onExit();
+    m_draw->destroy();
+
+    // Shared text and texture resources outlive all objects; free them after
+    // onExit().
+    if (m_isMainWindow)
+    {
+        JobSystem::instance()->stop();
+        AssetLoader::instance()->stop();
+        GlyphAtlas::instance()->destroy();
+        priv::TextCache::clear();
+        priv::RenderTargetPool::clear();
+        TextureCache::instance()->clear();
+        AssetLoader::instance()->destroy();
+    }
 }
 
 
 void priv::WindowPrivate::paintGL()
 {
+    if (m_isMainWindow)
+    {
+        cranProfileFrame();
+    }
+
+    cranProfile("Window::paintGL");
+
+    // Rendering reads the live game objects and uploads what they loaded;
+    // waits until the update of this frame has finished. A thread that was
+    // just started has not updated this frame yet.
+    const bool updated = (m_updateThread != nullptr);
+    finishUpdate();
+
+    if (m_settings.isThreaded() != (m_updateThread != nullptr))
+    {
+        m_settings.isThreaded() ? startUpdateThread() : stopUpdateThread();
+    }
+
+    // Hands assets loaded in the background to their callbacks.
+    if (m_isMainWindow)
+    {
+        AssetLoader::instance()->update();
+    }
+
+    if (!updated)
+    {
+        updateFrame();
+    }
+
+    swapFrame();
+    renderFrame();
+
+    // Updates the next frame while this one is swapped and presented.
+    if (m_updateThread != nullptr)
+    {
+        m_updateThread->begin();
+    }
+}
+
+
+void priv::WindowPrivate::pollInput()
+{
+    m_keyState.advanceFrame();
+    m_mouseState.advanceFrame();
+
+    // A key that is pressed and released within one frame would otherwise
+    // never be reported as down; flushes the pending down event first.
+    bool keyPending = false;
+    bool btnPending = false;
+
+    InputEvent e;
+    while (m_input.pop(&e))
+    {
+        if (m_inputSampled < 0)
+        {
+            m_inputSampled = e.time;
+        }
+
+        switch (e.type)
+        {
+        case InputEvent::KeyPress:
+            // Emits also a key character event if key has not been pressed
+            // before or if the given key was repeated.
+            if (!e.text.isEmpty() && (!m_keyState.isKeyDown(e.code) || e.autoRepeat))
+            {
+                m_window->onKeyCharacter(e.text);
+            }
+            if (!e.autoRepeat)
+            {
+                m_keyState.setKeyState(e.code, true);
+                m_keyCount++;
+                keyPending = true;
+            }
+
+            m_keyState.setModifiers(e.modifiers);
+            break;
+
+        case InputEvent::KeyRelease:
+            if (!e.autoRepeat)
+            {
+                if (keyPending) m_window->onKeyDown(m_keyState);
+
+                m_keyState.setKeyState(e.code, false);
+                m_keyState.setModifiers(e.modifiers);
+                m_keyCount--;
+                keyPending = false;
+
+                m_window->onKeyReleased(KeyReleaseEvent(e.code, e.modifiers));
+            }
+            break;
+
+        case InputEvent::ButtonPress:
+            m_mouseState.setButtonState(e.code, true);
+            m_btnCount++;
+            btnPending = true;
+            break;
+
+        case InputEvent::ButtonRelease:
+            if (btnPending) m_window->onMouseButtonDown(m_mouseState);
+
+            m_mouseState.setButtonState(e.code, false);
+            m_btnCount--;
+            btnPending = false;
+
+            m_window->onMouseButtonReleased(MouseReleaseEvent(e.pos, e.code));
+            break;
+        }
+    }
+
     // Forward key-down, mouse-down and pad-down events when needed.
     // Qt (logically) can not repeat sending events when e.g. a key is
     // still being held, therefore we have to do it manually every frame.
     if (m_keyCount > 0) m_window->onKeyDown(m_keyState);
     if (m_padCount > 0) m_window->onGamepadButtonDown(m_padState);
     if (m_btnCount > 0) m_window->onMouseButtonDown(m_mouseState);
+}
+
+
+void priv::WindowPrivate::updateFrame()
+{
+    // Samples input as late as possible, right before the update.
+    pollInput();
 
-    // Updating & rendering.
     m_time.update();
 
+    cranProfile("Window::onUpdate");
+    m_window->onUpdate(m_time);
+}
+
+
+void priv::WindowPrivate::swapFrame()
+{
+    m_draw->update(m_time);
+
     if_debug(calculateFramerate())
 
+    // The input sampled for the frame is shown once it has been rendered.
+    m_inputShown = m_inputSampled;
+    m_inputSampled = -1;
+}
+
+
+void priv::WindowPrivate::renderFrame()
+{
     // Update shaders that require time for noise.
     OpenGLDefaultShaders::cranberryUpdateDefaultShaders();
 
-    m_window->onUpdate(m_time);
     glDebug(m_gl->glClear(c_clearMask));
-    m_window->onRender();
+
+    {
+        cranProfile("Window::onRender");
+        m_window->onRender();
+    }
+
+    m_queue.execute();
+    m_commands.execute();
+    m_draw->flush();
+
+    // Frees render targets of sizes that are not in use anymore.
+    if (m_isMainWindow)
+    {
+        priv::RenderTargetPool::collect();
+    }
 
     if (m_dbgOverlay != nullptr)
     {
-        if (m_dbgFrames >= c_dbgInterval)
-        {
-            m_dbgFrames = 0;
-            m_dbgOverlay->updateProperties();
-            m_debugModel->update();
-        }
-        else
-        {
-            m_dbgFrames++;
-        }
+        // Only rows whose values changed are sent to the overlay.
+        m_dbgOverlay->updateProperties();
+        m_debugModel->update();
 
         renderDebugOverlay();
     }
@@ -468,20 +741,26 @@ void priv::WindowPrivate::mouseMoveEvent(QMouseEvent* event)
 
 void priv::WindowPrivate::mousePressEvent(QMouseEvent* event)
 {
-    m_mouseState.setButtonState(event->button(), true);
-    m_btnCount++;
-    m_window->onMouseButtonDown(m_mouseState);
+    InputEvent e = InputEvent();
+    e.time = m_inputClock.nsecsElapsed();
+    e.type = InputEvent::ButtonPress;
+    e.code = event->button();
+    e.pos = event->pos();
 
+    m_input.push(e);
     dispatchEvents(event);
 }
 
 
 void priv::WindowPrivate::mouseReleaseEvent(QMouseEvent* event)
 {
-    m_mouseState.setButtonState(event->button(), false);
-    m_btnCount--;
+    InputEvent e = InputEvent();
+    e.time = m_inputClock.nsecsElapsed();
+    e.type = InputEvent::ButtonRelease;
+    e.code = event->button();
+    e.pos = event->pos();
 
-    m_window->onMouseButtonReleased(MouseReleaseEvent(event->pos(), event->button()));
+    m_input.push(e);
     dispatchEvents(event);
 }
 
@@ -495,35 +774,30 @@ void priv::WindowPrivate::mouseDoubleClickEvent(QMouseEvent* event)
 
 void priv::WindowPrivate::keyPressEvent(QKeyEvent* event)
 {
-    if (!event->text().isEmpty())
-    {
-        // Emits also a key character event if key has not been pressed before
-        // or if the given key was repeated.
-        if (!m_keyState.isKeyDown(event->key()) || event->isAutoRepeat())
-        {
-            m_window->onKeyCharacter(event->text());
-        }
-    }
-
-    m_keyState.setKeyState(event->key(), true);
-    m_keyState.setModifiers(event->modifiers());
-    m_keyCount++;
-    m_window->onKeyDown(m_keyState);
+    InputEvent e = InputEvent();
+    e.time = m_inputClock.nsecsElapsed();
+    e.type = InputEvent::KeyPress;
+    e.code = event->key();
+    e.modifiers = event->modifiers();
+    e.autoRepeat = event->isAutoRepeat();
+    e.text = event->text();
 
+    m_input.push(e);
     //dispatchEvents(event);
 }
 
 
 void priv::WindowPrivate::keyReleaseEvent(QKeyEvent* event)
 {
-    m_keyState.setKeyState(event->key(), false);
-    m_keyCount--;
+    InputEvent e = InputEvent();
+    e.time = m_inputClock.nsecsElapsed();
+    e.type = InputEvent::KeyRelease;
+    e.code = event->key();
+    e.modifiers = event->modifiers();
+    e.autoRepeat = event->isAutoRepeat();
 
-    if (!event->isAutoRepeat())
-    {
-        m_window->onKeyReleased(KeyReleaseEvent(event->key(), event->modifiers()));
-        // dispatchEvents(event);
-    }
+    m_input.push(e);
+    // dispatchEvents(event);
 }
 
 
@@ -579,8 +853,67 @@ void priv::WindowPrivate::focusOutEvent(QFocusEvent*)
 }
 
 
+void priv::WindowPrivate::startUpdateThread()
+{
+    m_updateThread = new UpdateThread(this);
+    m_updateThread->start();
+}
+
+
+void priv::WindowPrivate::stopUpdateThread()
+{
+    if (m_updateThread != nullptr)
+    {
+        m_updateThread->stop();
+        delete m_updateThread;
+        m_updateThread = nullptr;
+    }
+}
+
+
+void priv::WindowPrivate::finishUpdate()
+{
+    if (m_updateThread != nullptr)
+    {
+        m_updateThread->finish();
+    }
+}
+
+
+void priv::WindowPrivate::measureLatency()
+{
+    if (m_inputShown >= 0)
+    {
+        const qint64 ns = m_inputClock.nsecsElapsed() - m_inputShown;
+        m_inputLatency.store(int(ns / 1000));
+        m_inputShown = -1;
+    }
+}
+
+
+void priv::WindowPrivate::measureStartup()
+{
+    if (m_firstFrame >= 0 || m_initStarted < 0)
+    {
+        return;
+    }
+
+    // Includes compiling the default shaders that the first frame uses.
+    m_firstFrame = m_inputClock.nsecsElapsed() - m_initStarted;
+
+    if_debug(qDebug().noquote() << c_firstFrame.arg(m_firstFrame / 1000000.0))
+}
+
+
 bool priv::WindowPrivate::event(QEvent* event)
 {
+    // Input handlers must not run while the game is being updated. Key
+    // events only enter the input ring and need not wait.
+    if (event->type() != QEvent::KeyPress && event->type() != QEvent::KeyRelease)
+    {
+        finishUpdate();
+    }
+
     if (event->type() == QEvent::Close)
     {
         makeCurrent();
@@ -632,9 +965,31 @@ if_debug
 void priv::WindowPrivate::calculateFramerate()
 {
     const static QString format = "%0 (%1 fps)";
-    double ms = m_time.deltaTime() * 1000.0;
-    double fps = 1000.0 / ms;
+    const static QString latency = "%0 (%1 fps, %2 ms input)";
+
+    // Setting the title is expensive; averages the frame rate over a few
+    // frames instead.
+    m_fpsTime += m_time.deltaTime();
+    m_fpsFrames++;
 
-    setTitle(format.arg(m_settings.title(), QString::number(fps)));
+    if (m_fpsTime < c_titleInterval)
+    {
+        return;
+    }
+
+    double fps = m_fpsFrames / m_fpsTime;
+    int us = m_inputLatency.load();
+
+    m_fpsTime = 0.0;
+    m_fpsFrames = 0;
+
+    if (us < 0)
+    {
+        setTitle(format.arg(m_settings.title(), QString::number(fps)));
+    }
+    else
+    {
+        setTitle(latency.arg(m_settings.title(), QString::number(fps), QString::number(us / 1000.0)));
+    }
 }
 )
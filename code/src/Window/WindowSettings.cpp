@@ -35,6 +35,7 @@ WindowSettings::WindowSettings()
     , m_isFullscreen(false)
     , m_isDoubleBuffered(true)
     , m_useVerticalSync(false)
+    , m_isThreaded(false)
     , m_size(800, 600)
     , m_pos(-1, -1)
     , m_clearColor(100, 149, 237)
@@ -67,6 +68,12 @@ bool WindowSettings::useVerticalSync() const
 }
 
 
+bool WindowSettings::isThreaded() const
+{
+    return m_isThreaded;
+}
+
+
 const QString& WindowSettings::title() const
 {
     return m_title;
@@ -115,6 +122,12 @@ void WindowSettings::setVerticalSync(bool value)
 }
 
 
+void WindowSettings::setThreaded(bool value)
+{
+    m_isThreaded = value;
+}
+
+
 void WindowSettings::setTitle(const QString& title)
 {
     m_title = title;
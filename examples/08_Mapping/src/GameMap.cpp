@@ -25,8 +25,8 @@
 
 void GameMap::onAboutStepTile(const TileEvent& event)
 {
-    const QVariant& solid = event.properties().value("solid");
-    if (solid.isValid() && solid.toBool())
+    static const MapPropertyKey solid = MapPropertyKeys::intern("solid");
+    if (event.properties().toBool(solid))
     {
         event.reject();
     }
@@ -0,0 +1,271 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/Game/Mapping/MapNavigationGrid.hpp>
+#include <Cranberry/Game/Mapping/MapPathfinder.hpp>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QPair>
+#include <QPoint>
+#include <QVector>
+
+// Standard headers
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    const int c_size = 1024;
+    const int c_queries = 200;
+    const double c_wallDensity = 0.2;
+    const int c_dirX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    const int c_dirY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+    double elapsedMs(const QElapsedTimer& timer)
+    {
+        return timer.nsecsElapsed() / 1000000.0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Plain A* on an array of walkable flags, the way it is usually written on
+    /// top of MapTileLayer::tiles(). Allocates its buffers on every search.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    int baselinePath(const std::vector<char>& walkable, const QPoint& start, const QPoint& goal)
+    {
+        auto isWalkable = [&walkable] (int x, int y) -> bool
+        {
+            return x >= 0 && y >= 0 && x < c_size && y < c_size && walkable[y * c_size + x];
+        };
+
+        auto heuristic = [&goal] (int x, int y) -> int
+        {
+            const int dx = qAbs(x - goal.x());
+            const int dy = qAbs(y - goal.y());
+            return 14 * qMin(dx, dy) + 10 * (qMax(dx, dy) - qMin(dx, dy));
+        };
+
+        typedef std::pair<int, int> Node;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
+        std::vector<int> costs(c_size * c_size, INT_MAX);
+        std::vector<char> closed(c_size * c_size, 0);
+
+        const int startIndex = start.y() * c_size + start.x();
+        const int goalIndex = goal.y() * c_size + goal.x();
+        costs[startIndex] = 0;
+        open.push(Node(heuristic(start.x(), start.y()), startIndex));
+
+        while (!open.empty())
+        {
+            const int index = open.top().second;
+            open.pop();
+
+            if (index == goalIndex)
+            {
+                return costs[index];
+            }
+
+            if (closed[index])
+            {
+                continue;
+            }
+
+            closed[index] = 1;
+
+            const int x = index % c_size;
+            const int y = index / c_size;
+            for (int d = 0; d < 8; d++)
+            {
+                const int nx = x + c_dirX[d];
+                const int ny = y + c_dirY[d];
+                const bool diagonal = (d & 1) != 0;
+
+                // Diagonal steps must not cut corners, like in MapPathfinder.
+                if (!isWalkable(nx, ny) || (diagonal && (!isWalkable(nx, y) || !isWalkable(x, ny))))
+                {
+                    continue;
+                }
+
+                const int next = ny * c_size + nx;
+                const int cost = costs[index] + (diagonal ? 14 : 10);
+                if (cost < costs[next])
+                {
+                    costs[next] = cost;
+                    open.push(Node(cost + heuristic(nx, ny), next));
+                }
+            }
+        }
+
+        return -1;
+    }
+
+    int pathCost(const QPoint& start, const QVector<QPoint>& path)
+    {
+        int cost = 0;
+        QPoint prev = start;
+
+        for (const QPoint& p : path)
+        {
+            cost += (p.x() != prev.x() && p.y() != prev.y()) ? 14 : 10;
+            prev = p;
+        }
+
+        return cost;
+    }
+}
+
+
+int main()
+{
+    std::mt19937 engine(1024);
+    std::bernoulli_distribution isWall(c_wallDensity);
+    std::uniform_int_distribution<int> coord(0, c_size - 1);
+
+    MapNavigationGrid grid;
+    MapPathfinder pathfinder(&grid);
+    std::vector<char> walkable(c_size * c_size, 1);
+    QElapsedTimer timer;
+
+    // Generates a map with randomly scattered walls.
+    grid.create(c_size, c_size);
+    for (int y = 0; y < c_size; y++)
+    {
+        for (int x = 0; x < c_size; x++)
+        {
+            if (isWall(engine))
+            {
+                grid.setWalkable(x, y, false);
+                walkable[y * c_size + x] = 0;
+            }
+        }
+    }
+
+    QVector<QPair<QPoint, QPoint>> queries;
+    while (queries.size() < c_queries)
+    {
+        const QPoint start(coord(engine), coord(engine));
+        const QPoint goal(coord(engine), coord(engine));
+
+        if (grid.isWalkable(start.x(), start.y()) && grid.isWalkable(goal.x(), goal.y()))
+        {
+            queries.append(qMakePair(start, goal));
+        }
+    }
+
+    std::printf("Map: %dx%d tiles, %d%% walls, %d paths\n\n",
+                c_size, c_size, int(c_wallDensity * 100), c_queries);
+
+    // Single agent paths.
+    QVector<int> expected;
+    timer.start();
+    for (const auto& query : queries)
+    {
+        expected.append(baselinePath(walkable, query.first, query.second));
+    }
+
+    const double baselineMs = elapsedMs(timer);
+
+    QVector<int> found;
+    QVector<QPoint> path;
+    timer.restart();
+    for (const auto& query : queries)
+    {
+        found.append(pathfinder.findPath(query.first, query.second, path)
+                ? pathCost(query.first, path)
+                : -1);
+    }
+
+    const double jpsMs = elapsedMs(timer);
+
+    int mismatches = 0;
+    for (int i = 0; i < c_queries; i++)
+    {
+        mismatches += (found.at(i) != expected.at(i));
+    }
+
+    std::printf("Plain A*:            %8.3f ms per path\n", baselineMs / c_queries);
+    std::printf("Jump point search:   %8.3f ms per path\n", jpsMs / c_queries);
+    std::printf("Paths with a different cost: %d\n\n", mismatches);
+
+    // Flow fields towards one goal.
+    const QPoint goal = queries.first().second;
+
+    timer.restart();
+    MapFlowField field = pathfinder.flowField(goal);
+    std::printf("Flow field, built:   %8.3f ms\n", elapsedMs(timer));
+
+    timer.restart();
+    field = pathfinder.flowField(goal);
+    std::printf("Flow field, cached:  %8.3f ms\n", elapsedMs(timer));
+
+    // A wall closed off from the goal does not affect the flow field.
+    QPoint enclosed(-1, -1);
+    for (int i = 0; i < c_size * c_size && enclosed.x() == -1; i++)
+    {
+        const int x = i % c_size;
+        const int y = i / c_size;
+        bool reachable = false;
+
+        for (int d = 0; d < 8 && !reachable; d++)
+        {
+            reachable = field.isReachable(x + c_dirX[d], y + c_dirY[d]);
+        }
+
+        if (!walkable[i] && !reachable)
+        {
+            enclosed = QPoint(x, y);
+        }
+    }
+
+    if (enclosed.x() != -1)
+    {
+        timer.restart();
+        grid.setWalkable(enclosed.x(), enclosed.y(), true);
+        field = pathfinder.flowField(goal);
+        std::printf("Flow field, unrelated tile changed: %8.3f ms\n", elapsedMs(timer));
+    }
+
+    // A wall on a tile the flow field reaches rebuilds it.
+    for (const auto& query : queries)
+    {
+        const QPoint& blocked = query.first;
+        if (blocked != goal && field.isReachable(blocked.x(), blocked.y()))
+        {
+            timer.restart();
+            grid.setWalkable(blocked.x(), blocked.y(), false);
+            field = pathfinder.flowField(goal);
+            std::printf("Flow field, reached tile changed:   %8.3f ms\n", elapsedMs(timer));
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/Random.hpp>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QVector>
+
+// Standard headers
+#include <cstdio>
+#include <random>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    const int c_count = 10000000;
+    const int c_min = 0;
+    const int c_max = 999;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// The former implementation of Random: a Mersenne Twister with a modulo
+    /// per integer, a division per double and std::discrete_distribution.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    class LegacyRandom
+    {
+    public:
+
+        LegacyRandom()
+            : m_engine(1024)
+            , m_dist({ 1.0, 2.0, 4.0, 8.0, 16.0, 32.0, 64.0, 128.0 })
+        {
+        }
+
+        int nextNumber()
+        {
+            return c_min + m_engine() % (c_max + 1 - c_min);
+        }
+
+        double nextDouble()
+        {
+            const double factor = static_cast<double>(m_engine.max());
+            return static_cast<double>(m_engine()) / factor;
+        }
+
+        int nextDiscrete()
+        {
+            return m_dist(m_engine);
+        }
+
+    private:
+
+        std::mt19937                 m_engine;
+        std::discrete_distribution<> m_dist;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Runs \p fn once and prints the time per value. The sum of all values
+    /// is printed as well, so that the work cannot be optimized away.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    template <typename Fn>
+    void measure(const char* name, Fn fn)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const double sum = fn();
+        const double ns = static_cast<double>(timer.nsecsElapsed()) / c_count;
+
+        std::printf("%-30s %7.2f ns per value (sum %.0f)\n", name, ns, sum);
+    }
+}
+
+
+int main()
+{
+    LegacyRandom legacy;
+    Random random;
+    random.setSeed(1024);
+    random.setMinMax(c_min, c_max);
+    random.setMinMax(0.0, 1.0);
+    random.setDistribution(Random::Distribution({ 1.0, 2.0, 4.0, 8.0, 16.0, 32.0, 64.0, 128.0 }));
+
+    QVector<int> ints(c_count);
+    QVector<float> floats(c_count);
+
+    std::printf("%d values per run\n\n", c_count);
+
+    measure("Legacy nextNumber()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += legacy.nextNumber();
+        return sum;
+    });
+
+    measure("Random::nextNumber()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += random.nextNumber();
+        return sum;
+    });
+
+    measure("Random::fill(int*)", [&] {
+        random.fill(ints.data(), c_count);
+        double sum = 0;
+        for (int value : ints) sum += value;
+        return sum;
+    });
+
+    std::printf("\n");
+
+    measure("Legacy nextDouble()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += legacy.nextDouble();
+        return sum;
+    });
+
+    measure("Random::nextDouble()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += random.nextDouble();
+        return sum;
+    });
+
+    measure("Random::fill(float*)", [&] {
+        random.fill(floats.data(), c_count);
+        double sum = 0;
+        for (float value : floats) sum += value;
+        return sum;
+    });
+
+    std::printf("\n");
+
+    measure("Legacy nextDiscrete()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += legacy.nextDiscrete();
+        return sum;
+    });
+
+    measure("Random::nextDiscrete()", [&] {
+        double sum = 0;
+        for (int i = 0; i < c_count; i++) sum += random.nextDiscrete();
+        return sum;
+    });
+
+    return 0;
+}
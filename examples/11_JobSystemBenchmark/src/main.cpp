@@ -0,0 +1,161 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Cranberry headers
+#include <Cranberry/System/GameTime.hpp>
+#include <Cranberry/System/JobSystem.hpp>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QThread>
+#include <QVector>
+
+// Standard headers
+#include <cmath>
+#include <cstdio>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+namespace
+{
+    const int c_agents = 100000;
+    const int c_frames = 30;
+    const int c_steps = 32;
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Stands in for a game object whose update only touches its own state,
+    /// i.e. one that may be marked with TransformBase::setThreadSafe().
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    class Agent
+    {
+    public:
+
+        explicit Agent(int seed)
+            : m_x(seed % 1024)
+            , m_y(seed / 1024)
+            , m_angle(seed * 0.01f)
+        {
+        }
+
+        bool isThreadSafe() const
+        {
+            return true;
+        }
+
+        void update(const GameTime&)
+        {
+            // Steers along a few integration steps per frame.
+            for (int i = 0; i < c_steps; i++)
+            {
+                m_angle += 0.05f * std::sin(m_x * 0.01f + m_y * 0.02f);
+                m_x += std::cos(m_angle) * 0.1f;
+                m_y += std::sin(m_angle) * 0.1f;
+            }
+        }
+
+        float checksum() const
+        {
+            return m_x + m_y;
+        }
+
+    private:
+
+        float m_x;
+        float m_y;
+        float m_angle;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// Updates fresh agents for a few frames with \p workers worker threads
+    /// and returns the milliseconds per frame.
+    ///
+    ////////////////////////////////////////////////////////////////////////////
+    double measure(int workers, double* checksum)
+    {
+        QVector<Agent*> agents;
+        for (int i = 0; i < c_agents; i++)
+        {
+            agents.append(new Agent(i));
+        }
+
+        JobSystem jobs;
+        jobs.setWorkerCount(workers);
+
+        // Starts the workers before the clock runs.
+        GameTime time;
+        jobs.updateObjects(agents, time);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < c_frames; i++)
+        {
+            jobs.updateObjects(agents, time);
+        }
+
+        const double ms = timer.nsecsElapsed() / 1000000.0 / c_frames;
+
+        *checksum = 0;
+        for (Agent* agent : agents)
+        {
+            *checksum += agent->checksum();
+            delete agent;
+        }
+
+        return ms;
+    }
+}
+
+
+int main()
+{
+    const int cores = QThread::idealThreadCount();
+    std::printf("%d agents, %d logical cores\n\n", c_agents, cores);
+    std::printf("Workers   ms per frame   Speedup   Checksum\n");
+
+    QVector<int> counts = { 0 };
+    for (int workers = 1; workers < cores; workers *= 2)
+    {
+        counts.append(workers);
+    }
+
+    if (cores > 1 && counts.last() != cores - 1)
+    {
+        counts.append(cores - 1);
+    }
+
+    double serial = 0;
+    for (int workers : counts)
+    {
+        double checksum;
+        const double ms = measure(workers, &checksum);
+        if (workers == 0)
+        {
+            serial = ms;
+        }
+
+        std::printf("%7d   %12.3f   %6.2fx   %.1f\n", workers, ms, serial / ms, checksum);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Example headers
+#include <GameWindow.hpp>
+
+// Qt headers
+#include <QDebug>
+
+// Standard headers
+#include <algorithm>
+
+// Constants
+#define WINDOW_WIDTH  800
+#define WINDOW_HEIGHT 600
+#define WINDOW_SIZE   QSize(WINDOW_WIDTH, WINDOW_HEIGHT)
+#define REPORT_EVERY  50
+
+
+GameWindow::GameWindow(bool threaded, bool vsync)
+    : Window()
+    , m_pending(0)
+{
+    WindowSettings settings;
+    settings.setResizable(false);
+    settings.setVerticalSync(vsync);
+    settings.setDoubleBuffered(true);
+    settings.setThreaded(threaded);
+    settings.setSize(WINDOW_SIZE);
+    settings.setPosition(Qt::AlignCenter);
+    settings.setTitle("12_InputLatency - press space or click");
+    setSettings(settings);
+
+    qDebug().noquote() << "Threaded:" << threaded << "V-Sync:" << vsync;
+}
+
+
+GameWindow::~GameWindow()
+{
+}
+
+
+void GameWindow::onUpdate(const GameTime&)
+{
+    // The latency is known once the frame that consumed the press has been
+    // swapped; in threaded mode that swap overlaps with the next update.
+    if (m_pending > 0 && --m_pending == 0 && inputLatency() >= 0)
+    {
+        m_samples.append(inputLatency());
+        if (m_samples.size() % REPORT_EVERY == 0)
+        {
+            report();
+        }
+    }
+
+    if (m_pending == 0 &&
+        (keyboard().isKeyPressed(Qt::Key_Space) ||
+         mouse().isButtonPressed(Qt::LeftButton)))
+    {
+        m_pending = 2;
+    }
+}
+
+
+void GameWindow::report()
+{
+    QVector<float> sorted = m_samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&sorted] (int p) -> float
+    {
+        return sorted.at((sorted.size() - 1) * p / 100);
+    };
+
+    qDebug().noquote() << QString("%0 presses: min %1 ms, median %2 ms, p95 %3 ms, max %4 ms")
+            .arg(sorted.size())
+            .arg(sorted.first(), 0, 'f', 2)
+            .arg(percentile(50), 0, 'f', 2)
+            .arg(percentile(95), 0, 'f', 2)
+            .arg(sorted.last(), 0, 'f', 2);
+}
@@ -0,0 +1,23 @@
+﻿#include <Cranberry/Game/Game.hpp>
+#include <GameWindow.hpp>
+
+// Standard headers
+#include <cstring>
+
+
+int main(int argc, char *argv[])
+{
+    bool threaded = false;
+    bool vsync = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--threaded") == 0) threaded = true;
+        if (std::strcmp(argv[i], "--no-vsync") == 0) vsync = false;
+    }
+
+    Game game(argc, argv);
+    GameWindow gameWindow(threaded, vsync);
+
+    return game.run(&gameWindow);
+}
@@ -0,0 +1,66 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#ifndef CRANBERRY_GAMEWINDOW_HPP
+#define CRANBERRY_GAMEWINDOW_HPP
+
+
+// Cranberry headers
+#include <Cranberry/Graphics/ParticleSystem.hpp>
+#include <Cranberry/Window/Window.hpp>
+
+// Qt headers
+#include <QElapsedTimer>
+
+
+CRANBERRY_USING_NAMESPACE
+
+
+class GameWindow : public Window
+{
+public:
+
+    GameWindow();
+    ~GameWindow();
+
+
+protected:
+
+    void onInit() override;
+    void onExit() override;
+    void onCrash() override;
+    void onUpdate(const GameTime&) override;
+    void onRender() override;
+
+
+private:
+
+    ParticleSystem* m_particles;
+    QElapsedTimer   m_clock;      // runs since onInit()
+    qint64          m_reportAt;   // next report, in ns
+    qint64          m_updateTime; // ns spent in update() since the last report
+    qint64          m_renderTime; // ns spent in render() since the last report
+    int             m_frames;     // frames since the last report
+};
+
+
+#endif
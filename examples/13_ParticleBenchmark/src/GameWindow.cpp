@@ -0,0 +1,156 @@
+﻿////////////////////////////////////////////////////////////////////////////////
+//
+// Cranberry - C++ game engine based on the Qt framework.
+// Copyright (C) 2017 Nicolas Kogler
+//
+// Cranberry is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Cranberry is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Cranberry. If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Example headers
+#include <GameWindow.hpp>
+
+// Qt headers
+#include <QDebug>
+#include <QImage>
+#include <QOpenGLTexture>
+#include <QPainter>
+#include <QRadialGradient>
+
+// Constants
+#define WINDOW_WIDTH  1280
+#define WINDOW_HEIGHT 720
+#define WINDOW_SIZE   QSize(WINDOW_WIDTH, WINDOW_HEIGHT)
+#define CAPACITY      200000
+#define LIFETIME      2.5f
+#define NS_PER_SEC    1000000000LL
+
+
+GameWindow::GameWindow()
+    : Window()
+    , m_particles(nullptr)
+    , m_reportAt(NS_PER_SEC)
+    , m_updateTime(0)
+    , m_renderTime(0)
+    , m_frames(0)
+{
+    // V-Sync is off, so that the frame rate is not capped by the display.
+    WindowSettings settings;
+    settings.setResizable(false);
+    settings.setVerticalSync(false);
+    settings.setDoubleBuffered(true);
+    settings.setSize(WINDOW_SIZE);
+    settings.setPosition(Qt::AlignCenter);
+    settings.setTitle("13_ParticleBenchmark");
+    setSettings(settings);
+}
+
+
+GameWindow::~GameWindow()
+{
+}
+
+
+void GameWindow::onInit()
+{
+    // A soft dot, so that the example needs no resources.
+    QImage dot(16, 16, QImage::Format_ARGB32_Premultiplied);
+    dot.fill(Qt::transparent);
+
+    QRadialGradient gradient(8, 8, 8);
+    gradient.setColorAt(0, Qt::white);
+    gradient.setColorAt(1, Qt::transparent);
+
+    QPainter painter(&dot);
+    painter.fillRect(dot.rect(), gradient);
+    painter.end();
+
+    // Emits as many particles per second as die, which keeps the system at
+    // its capacity once the first particles expire.
+    ParticleSystem::Emitter fountain;
+    fountain.area = QSizeF(WINDOW_WIDTH / 2, 20);
+    fountain.rate = CAPACITY / LIFETIME;
+    fountain.minLife = LIFETIME;
+    fountain.maxLife = LIFETIME;
+    fountain.minSpeed = 150.0f;
+    fountain.maxSpeed = 400.0f;
+    fountain.direction = -90.0f;
+    fountain.spread = 25.0f;
+    fountain.minSpin = -90.0f;
+    fountain.maxSpin = 90.0f;
+    fountain.acceleration = QPointF(0, 200);
+    fountain.colors = { { 0.0, QColor(255, 200, 80) }, { 1.0, QColor(255, 40, 0, 0) } };
+    fountain.sizes = { { 0.0, 1.0 }, { 1.0, 0.3 } };
+
+    m_particles = new ParticleSystem;
+    m_particles->create(new QOpenGLTexture(dot), this);
+    m_particles->setCapacity(CAPACITY);
+    m_particles->setAdditive(true);
+    m_particles->addEmitter(fountain);
+    m_particles->setPosition(WINDOW_WIDTH / 2, WINDOW_HEIGHT - 40);
+
+    m_clock.start();
+}
+
+
+void GameWindow::onExit()
+{
+    if (m_particles != nullptr)
+    {
+        delete m_particles;
+        m_particles = nullptr;
+    }
+}
+
+
+void GameWindow::onCrash()
+{
+    onExit();
+}
+
+
+void GameWindow::onUpdate(const GameTime& time)
+{
+    const qint64 start = m_clock.nsecsElapsed();
+    m_particles->update(time);
+    m_updateTime += m_clock.nsecsElapsed() - start;
+}
+
+
+void GameWindow::onRender()
+{
+    const qint64 start = m_clock.nsecsElapsed();
+    m_particles->render();
+
+    const qint64 now = m_clock.nsecsElapsed();
+    m_renderTime += now - start;
+    m_frames++;
+
+    // The render time is the CPU side of the draw call; the GPU work shows in
+    // the frame rate only.
+    if (now >= m_reportAt)
+    {
+        qDebug().noquote() << QString("%0 particles: %1 fps, update %2 ms, render %3 ms")
+                .arg(m_particles->count())
+                .arg(m_frames)
+                .arg(m_updateTime / 1000000.0 / m_frames, 0, 'f', 3)
+                .arg(m_renderTime / 1000000.0 / m_frames, 0, 'f', 3);
+
+        m_reportAt = now + NS_PER_SEC;
+        m_updateTime = 0;
+        m_renderTime = 0;
+        m_frames = 0;
+    }
+}